@@ -0,0 +1,79 @@
+#pragma once
+
+#include "css_rules.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define ANCHOR_MAX 1024 // Element ids kept per chapter
+#define ANCHOR_SLOTS (ANCHOR_MAX * 2)
+#define ANCHOR_NONE 0xFFFF
+#define LINK_MAX 1024     // Links kept per chapter
+#define LINK_HREF_MAX 160 // Longer hrefs are not followed
+
+class EpubReader;
+
+// Fragment ids are told apart by hash, the same FNV-1a the CSS rules use;
+// 0 means "no fragment" (the top of the chapter)
+inline uint32_t AnchorHash(const char *id, size_t len) {
+  uint32_t h = CSS_HASH_INIT;
+  for (size_t i = 0; i < len; i++)
+    h = CssHashStep(h, id[i]);
+  return CssHashEnd(h);
+}
+
+// An element id and the chapter-wide index of the first word inside it
+struct ChapterAnchor {
+  uint32_t id;
+  int wordIndex;
+};
+
+// Words [firstWord, endWord) are a link to an anchor of spine item spineIndex
+struct ChapterLink {
+  int firstWord;
+  int endWord;
+  int spineIndex;
+  uint32_t anchor; // 0 = the top of that spine item
+};
+
+// Where a chapter's ids and links are, recorded by the tokenizer as it goes
+// (see HtmlTextExtractor::SetAnchors). Ids are hashed into a small open-
+// addressing table, so finding a link target's word is one probe. Links are
+// resolved to a spine index when recorded and kept in document order, so
+// the ones on a page are a binary search away.
+//
+// Re-tokenizing part of the chapter (a Seek back) records the same things
+// again: the first word recorded for an id wins, and a link is only added
+// past the last one. Whatever doesn't fit is dropped.
+class AnchorIndex {
+public:
+  AnchorIndex();
+
+  void Clear();
+  // Book and spine item relative hrefs are resolved against
+  void SetSource(EpubReader *reader, int chapter);
+
+  void AddAnchor(uint32_t id, int wordIndex);
+  // Chapter-wide word of an id, or -1 if not (yet) seen
+  int FindAnchor(uint32_t id) const;
+
+  // Spine index an href points to, or -1 (external or not in the book)
+  int Resolve(const char *href, uint32_t *anchor) const;
+  void AddLink(int firstWord, int endWord, int spineIndex, uint32_t anchor);
+  // First link ending after wordIndex; GetLinkCount() if there is none
+  int FindLink(int wordIndex) const;
+
+  int GetAnchorCount() const { return anchorCount; }
+  const ChapterAnchor *GetAnchors() const { return anchors; }
+  int GetLinkCount() const { return linkCount; }
+  const ChapterLink &GetLink(int i) const { return links[i]; }
+  const ChapterLink *GetLinks() const { return links; }
+
+private:
+  ChapterAnchor anchors[ANCHOR_MAX];
+  uint16_t slots[ANCHOR_SLOTS]; // Into anchors; ANCHOR_NONE marks empty
+  int anchorCount;
+  ChapterLink links[LINK_MAX];
+  int linkCount;
+  EpubReader *reader;
+  int chapter;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ASYNC_READ_MAX_REQUESTS 16
+
+class FileBackend;
+
+typedef uint32_t AsyncReadId; // 0 = invalid
+
+enum AsyncReadPriority {
+  ASYNC_PRIORITY_LOW = 0,    // Library thumbnails
+  ASYNC_PRIORITY_NORMAL = 1, // Chapter read-ahead
+  ASYNC_PRIORITY_HIGH = 2    // Data the reader is about to block on
+};
+
+enum class AsyncReadStatus {
+  INVALID, // Unknown id, or result already collected
+  QUEUED,
+  RUNNING,
+  DONE,
+  FAILED, // Short read
+  CANCELLED
+};
+
+struct AsyncReadRequest {
+  FileBackend *file;
+  uint64_t offset;
+  void *buf; // Must stay valid until the request is collected or cancelled
+  size_t size;
+  int priority;
+};
+
+// Positional reads executed off the main thread. Requests run one at a time,
+// highest priority first (FIFO within a priority). Polling a finished
+// request collects it and frees its slot.
+//
+// The service never serializes access to a FileBackend: callers must not
+// touch a backend themselves while they have a request on it in flight.
+// ZipIo takes care of that for archive reads.
+//
+// This interface is the platform hook: a PSP implementation on top of
+// sceIoReadAsync/sceIoPollAsync can replace the threaded one below without
+// touching ZipIo or its callers.
+class AsyncReadService {
+public:
+  virtual ~AsyncReadService() {}
+
+  virtual AsyncReadId Submit(const AsyncReadRequest &request) = 0;
+  virtual AsyncReadStatus Poll(AsyncReadId id, size_t *bytesRead) = 0;
+  // Blocks until the request leaves QUEUED/RUNNING, then collects it
+  virtual AsyncReadStatus Wait(AsyncReadId id, size_t *bytesRead) = 0;
+  // A queued request is dropped; a running one can't be stopped (false), so
+  // the caller has to Wait before reusing its buffer
+  virtual bool Cancel(AsyncReadId id) = 0;
+};
+
+// Single worker thread (SDL threads: pthreads on Linux, a kernel thread on
+// the PSP, where a blocking sceIoRead in the worker yields the CPU back to
+// the main loop)
+class ThreadedAsyncReadService : public AsyncReadService {
+public:
+  ThreadedAsyncReadService();
+  ~ThreadedAsyncReadService();
+
+  bool Start(); // false: no thread, callers fall back to blocking reads
+  void Stop();  // Cancels everything still queued
+
+  AsyncReadId Submit(const AsyncReadRequest &request) override;
+  AsyncReadStatus Poll(AsyncReadId id, size_t *bytesRead) override;
+  AsyncReadStatus Wait(AsyncReadId id, size_t *bytesRead) override;
+  bool Cancel(AsyncReadId id) override;
+
+private:
+  struct Slot {
+    AsyncReadId id; // 0 = free
+    AsyncReadRequest request;
+    AsyncReadStatus status;
+    size_t bytesRead;
+    uint32_t sequence; // Submission order within a priority
+  };
+
+  Slot slots[ASYNC_READ_MAX_REQUESTS];
+  AsyncReadId nextId;
+  uint32_t nextSequence;
+  bool stopping;
+
+  void *thread; // SDL_Thread
+  void *mutex;  // SDL_mutex
+  void *queued; // SDL_cond: work available / stopping
+  void *done;   // SDL_cond: a request finished
+
+  Slot *Find(AsyncReadId id);
+  Slot *NextQueued();
+  AsyncReadStatus Collect(Slot *slot, size_t *bytesRead);
+  static int WorkerMain(void *self);
+};
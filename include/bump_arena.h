@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BUMP_ARENA_FIRST_CHUNK 4096
+#define BUMP_ARENA_CHUNK_SIZE (64 * 1024) // Growth stops here
+#define BUMP_ARENA_ALIGN 8
+
+struct BumpArenaStats {
+  uint32_t allocs;    // Requests served
+  uint32_t chunks;    // malloc calls made for them
+  size_t bytesUsed;   // Handed out, including alignment padding
+  size_t bytesMapped; // Chunk memory held (the arena's peak footprint)
+};
+
+// Bump allocator for short-lived parse state. Allocations are never freed
+// individually; everything goes back to the heap in one shot on Release()
+// or destruction, so a parse leaves no small holes behind in the heap.
+class BumpArena {
+public:
+  explicit BumpArena(size_t chunkSize = BUMP_ARENA_CHUNK_SIZE);
+  ~BumpArena();
+
+  void *Alloc(size_t size);
+  char *Strdup(const char *s);
+  void Release();
+
+  const BumpArenaStats &GetStats() const { return stats; }
+
+private:
+  struct Chunk {
+    Chunk *next;
+    size_t size; // Usable bytes after the header
+  };
+
+  Chunk *chunks; // Most recent first; bumping happens in the head
+  size_t chunkSize;
+  size_t nextChunkSize;
+  size_t used; // In the head chunk
+  BumpArenaStats stats;
+};
+
+// Routes pugixml's allocations into an arena for the lifetime of the scope.
+// Every xml_document created inside must also be destroyed inside it.
+class PugiArenaScope {
+public:
+  explicit PugiArenaScope(BumpArena &arena);
+  ~PugiArenaScope();
+
+private:
+  void *(*previousAlloc)(size_t);
+  void (*previousFree)(void *);
+  BumpArena *previousArena;
+};
+
+// Append-only key -> value string table in an arena. Add everything, Seal()
+// once, then Find() by binary search. The first value added for a key wins.
+class ArenaStringTable {
+public:
+  explicit ArenaStringTable(BumpArena &arena);
+
+  void Add(const char *key, const char *value); // Both are copied
+  void Seal();
+  const char *Find(const char *key) const; // nullptr if absent
+  int GetCount() const { return count; }
+
+private:
+  struct Entry {
+    const char *key;
+    const char *value;
+    int order; // Insertion order, to keep the first duplicate
+  };
+
+  BumpArena &arena;
+  Entry *entries;
+  int count;
+  int capacity;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) && !defined(BYTE_SCAN_SCALAR)
+#include <emmintrin.h>
+#endif
+
+// Word-at-a-time scanning kernels for the HTML tokenizer. Each inspects a
+// whole register per step: 16 bytes with SSE2 on x86 hosts, otherwise
+// SWAR on a native word (4 bytes on the PSP, 8 on 64-bit hosts). Build
+// with -DBYTE_SCAN_SCALAR to use the byte-loop references instead; both
+// must give identical results, so diffing the tokenizer output of the two
+// builds tests the kernels.
+
+#define BYTE_SCAN_ONES (~(uintptr_t)0 / 0xFF) // 0x01 in every byte
+#define BYTE_SCAN_HIGHS (BYTE_SCAN_ONES * 0x80)
+
+static inline bool IsScanAlnum(uint8_t c) {
+  return (c >= '0' && c <= '9') || (uint8_t)((c | 0x20) - 'a') < 26;
+}
+
+// Scalar references -----------------------------------------------------------
+
+// Length of the leading run of ASCII letters and digits
+static inline int ScanAlnumRunScalar(const char *s, int len) {
+  int i = 0;
+  while (i < len && IsScanAlnum((uint8_t)s[i]))
+    i++;
+  return i;
+}
+
+// Index of the first '<' or '>', or len if there is none
+static inline int ScanTagDelimiterScalar(const char *s, int len) {
+  int i = 0;
+  while (i < len && s[i] != '<' && s[i] != '>')
+    i++;
+  return i;
+}
+
+#ifdef BYTE_SCAN_SCALAR
+
+static inline int ScanAlnumRun(const char *s, int len) {
+  return ScanAlnumRunScalar(s, len);
+}
+
+static inline int ScanTagDelimiter(const char *s, int len) {
+  return ScanTagDelimiterScalar(s, len);
+}
+
+#elif defined(__SSE2__)
+
+static inline int ScanAlnumRun(const char *s, int len) {
+  int i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+    // Signed compares: bytes >= 0x80 are negative and match neither range
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i letter =
+        _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                      _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                  _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    int mask = _mm_movemask_epi8(_mm_or_si128(letter, digit));
+    if (mask != 0xFFFF)
+      return i + __builtin_ctz(~mask);
+  }
+  return i + ScanAlnumRunScalar(s + i, len - i);
+}
+
+static inline int ScanTagDelimiter(const char *s, int len) {
+  int i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+    // '<' (0x3C) and '>' (0x3E) differ only in bit 1
+    __m128i hit = _mm_cmpeq_epi8(_mm_or_si128(v, _mm_set1_epi8(0x02)),
+                                 _mm_set1_epi8('>'));
+    int mask = _mm_movemask_epi8(hit);
+    if (mask)
+      return i + __builtin_ctz(mask);
+  }
+  return i + ScanTagDelimiterScalar(s + i, len - i);
+}
+
+#else
+
+// 0x80 in each byte of x that is > m and < n (0 <= m < n <= 128). Exact:
+// no byte's arithmetic can carry into its neighbour
+#define BYTE_SCAN_BETWEEN(x, m, n)                                             \
+  ((BYTE_SCAN_ONES * (127 + (n)) - ((x) & ~BYTE_SCAN_HIGHS)) & ~(x) &          \
+   (((x) & ~BYTE_SCAN_HIGHS) + BYTE_SCAN_ONES * (127 - (m))) & BYTE_SCAN_HIGHS)
+
+// 0x80 in each zero byte of x, also exact
+#define BYTE_SCAN_ZEROS(x)                                                     \
+  (~((((x) & ~BYTE_SCAN_HIGHS) + ~BYTE_SCAN_HIGHS) | (x) | ~BYTE_SCAN_HIGHS))
+
+// Offset of the first marked byte in memory order; marks must be nonzero
+static inline int FirstMarkedByte(uintptr_t marks) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return (sizeof(marks) == 8 ? __builtin_clzll(marks)
+                             : __builtin_clz((unsigned)marks)) >> 3;
+#else
+  return (sizeof(marks) == 8 ? __builtin_ctzll(marks)
+                             : __builtin_ctz((unsigned)marks)) >> 3;
+#endif
+}
+
+static inline int ScanAlnumRun(const char *s, int len) {
+  int i = 0;
+  for (; i + (int)sizeof(uintptr_t) <= len; i += sizeof(uintptr_t)) {
+    uintptr_t x;
+    memcpy(&x, s + i, sizeof(x)); // Unaligned load
+    uintptr_t lower = x | (BYTE_SCAN_ONES * 0x20);
+    uintptr_t alnum = BYTE_SCAN_BETWEEN(x, '0' - 1, '9' + 1) |
+                      BYTE_SCAN_BETWEEN(lower, 'a' - 1, 'z' + 1);
+    if (alnum != BYTE_SCAN_HIGHS)
+      return i + FirstMarkedByte(alnum ^ BYTE_SCAN_HIGHS);
+  }
+  return i + ScanAlnumRunScalar(s + i, len - i);
+}
+
+static inline int ScanTagDelimiter(const char *s, int len) {
+  int i = 0;
+  for (; i + (int)sizeof(uintptr_t) <= len; i += sizeof(uintptr_t)) {
+    uintptr_t x;
+    memcpy(&x, s + i, sizeof(x));
+    // '<' (0x3C) and '>' (0x3E) differ only in bit 1, so one compare
+    // (a zero byte after the xor) finds either
+    uintptr_t y = (x | (BYTE_SCAN_ONES * 0x02)) ^ (BYTE_SCAN_ONES * '>');
+    uintptr_t hits = BYTE_SCAN_ZEROS(y);
+    if (hits)
+      return i + FirstMarkedByte(hits);
+  }
+  return i + ScanTagDelimiterScalar(s + i, len - i);
+}
+
+#endif
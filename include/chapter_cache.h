@@ -0,0 +1,59 @@
+#pragma once
+
+#include "chapter_prefetcher.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define CHAPTER_CACHE_BUDGET (2 * 1024 * 1024)
+
+struct ChapterCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  size_t bytesUsed;
+  int entries;
+};
+
+// Compact copies of recently tokenized chapters (word text, lengths, flags,
+// style runs, anchors and links), keyed by spine index and evicted
+// least-recently-used first once the byte budget is exceeded. Restoring one
+// skips both miniz and the HTML tokenizer. Only chapters that fit in a single
+// window are kept.
+class ChapterCache {
+public:
+  ChapterCache();
+  ~ChapterCache();
+
+  void SetBudget(size_t bytes);
+  void Clear(); // Book changed
+
+  bool Store(const ChapterBuffer &chapter);
+  bool Restore(int chapterIndex, ChapterBuffer &chapter);
+
+  const ChapterCacheStats &GetStats() const { return stats; }
+
+private:
+  struct Entry {
+    int chapterIndex;
+    int wordCount;
+    int textBytes;
+    int runCount;
+    int anchorCount;
+    int linkCount;
+    // runs[runCount], anchors[anchorCount], links[linkCount],
+    // lens[wordCount], flags[wordCount], text
+    uint8_t *data;
+    size_t size;
+    uint32_t lastUse;
+  };
+
+  std::vector<Entry> entries;
+  size_t budget;
+  uint32_t clock;
+  ChapterCacheStats stats;
+
+  int Find(int chapterIndex);
+  void Evict(int slot);
+  void EvictToFit(size_t incoming);
+};
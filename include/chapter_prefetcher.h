@@ -0,0 +1,157 @@
+#pragma once
+
+#include "epub_reader.h"
+#include "html_text_extractor.h"
+#include <climits>
+
+class ChapterCache;
+
+// Reader Constraints
+#define MAX_WORDS 20000
+#define MAX_STYLE_RUNS (MAX_WORDS / 8) // Window pauses early if styles churn
+#define WORD_BUFFER_SIZE 262144
+#define CHAPTER_BLOCK_SIZE 16384 // Decompressed bytes fed per tokenizer step
+#define CHAPTER_SLICE_SIZE 4096  // Finest step: budget checks, first page
+#define CHAPTER_FRAME_BUDGET_US 4000 // Tokenizer time per frame while reading
+#define PREFETCH_SLOTS 2
+#define CHAPTER_CHECKPOINTS 32
+#define CHECKPOINT_SPACING (MAX_WORDS / 4) // Initial words between snapshots
+
+// Tokenizer snapshot at a block boundary, used to rebuild an earlier window
+struct ChapterCheckpoint {
+  uint32_t streamOffset; // Decompressed bytes consumed before this point
+  int wordIndex;         // Chapter-wide index of the next word
+  HtmlTextExtractor::ParseState state;
+};
+
+// A tokenized chapter together with the stream still feeding it. The reader
+// keeps one active buffer; spares are filled by the prefetcher and swapped
+// in by pointer on navigation.
+//
+// The arrays hold a window of the chapter starting at word windowBase.
+// When they fill up, tokenization pauses (IsStalled) until the consumer drops
+// words with Discard(); Seek() rebuilds the window at an earlier word from
+// the nearest checkpoint. Memory stays fixed however long the chapter is.
+//
+// Words are interned into tokens as they are stored (see TokenTable), and
+// the chapter's ids and links recorded as they are met (see AnchorIndex).
+//
+// A chapter that fits in wordBuffer once decompressed (most do) is inflated
+// straight into it and tokenized in place, so no word is copied. Such a
+// chapter has no checkpoints: going back re-inflates it from the start.
+struct ChapterBuffer {
+  uint32_t wordOffsets[MAX_WORDS]; // Into wordBuffer; see WordText()
+  uint8_t wordLens[MAX_WORDS];     // Words never exceed 255 bytes
+  uint8_t wordFlags[MAX_WORDS];    // WORD_GLUED, WORD_NEWLINE
+  uint16_t wordTokens[MAX_WORDS];  // Into tokens; TOKEN_NONE for newlines
+  StyleRun styleRuns[MAX_STYLE_RUNS];
+  char wordBuffer[WORD_BUFFER_SIZE];
+  int chapterIndex;
+  int windowBase; // Chapter-wide index of the first word
+
+  ChapterStream stream;
+  HtmlTextExtractor extractor;
+  EpubReader *reader; // Where stream came from
+  bool inPlace;       // wordBuffer holds the chapter text itself
+  int copyChapter;    // Last chapter whose text didn't fit in place
+  // Distinct words of the chapter, kept across Seek() so token IDs (and any
+  // widths layout has for them) stay valid while the window moves. Anchors
+  // are kept the same way, so ids behind the window can still be found.
+  TokenTable tokens;
+  AnchorIndex anchors;
+  int tablesChapter;
+
+  // Decompressed block being fed; the tail survives a full window. In place
+  // blockPos is the tokenizer's position in wordBuffer instead.
+  char block[CHAPTER_BLOCK_SIZE];
+  int blockPos;
+  int blockLen;
+  uint32_t streamOffset;
+
+  ChapterCheckpoint checkpoints[CHAPTER_CHECKPOINTS];
+  int checkpointCount;
+  int checkpointSpacing;
+
+  ChapterBuffer()
+      : chapterIndex(-1), windowBase(0), reader(nullptr), inPlace(false),
+        copyChapter(-1), tablesChapter(-1) {}
+
+  bool Load(EpubReader &reader, int chapter);
+  // Returns true once IsReady(). Reads at most maxBlocks new blocks and
+  // tokenizes at most maxBytes; whatever is left resumes on the next call.
+  bool Pump(int maxBlocks, int maxBytes = INT_MAX);
+  // Tokenize a slice at a time until IsReady() or budgetUs has passed
+  bool PumpFor(uint32_t budgetUs);
+  void Reset();
+  // Book changed: also forget the tables kept for the chapter index
+  void Close();
+
+  // Mark a complete chapter already copied into the arrays (ChapterCache)
+  void Adopt(int chapter, int wordCount, int bufferUsed, int runCount);
+
+  void Discard(int count); // Slide the window forward
+  // Window starts at wordIndex; false (and unloaded) if the chapter can't
+  // be read again to get there
+  bool Seek(EpubReader &reader, int wordIndex);
+
+  int WordCount() const { return extractor.GetWordCount(); }
+  int WindowEnd() const { return windowBase + extractor.GetWordCount(); }
+  int RunCount() const { return extractor.GetRunCount(); }
+  // Window-local word i; wordLens[i] bytes, not terminated
+  const char *WordText(int i) const { return wordBuffer + wordOffsets[i]; }
+
+  // Run holding window-local word i. *cursor remembers the last answer, so
+  // walking forward through the window costs O(1) per word.
+  const StyleRun &RunAt(int i, int *cursor) const {
+    int r = *cursor;
+    if (r >= RunCount() || styleRuns[r].start > i)
+      r = 0; // Window slid or layout went back
+    while (r + 1 < RunCount() && styleRuns[r + 1].start <= i)
+      r++;
+    *cursor = r;
+    return styleRuns[r];
+  }
+
+  bool IsLoaded() const { return chapterIndex >= 0; }
+  bool IsComplete() const { return chapterIndex >= 0 && !stream.IsOpen(); }
+  bool IsStalled() const {
+    return chapterIndex >= 0 && stream.IsOpen() && extractor.IsFull();
+  }
+  bool IsReady() const { return IsComplete() || IsStalled(); }
+
+private:
+  void BeginWindow(int wordIndex);
+  void BindTables(int chapter);
+  void Checkpoint();
+  bool PumpInPlace(int maxBlocks, int maxBytes);
+  bool RestartCopying(int maxBlocks, int maxBytes);
+  static size_t ReadSize(int maxBytes);
+};
+
+// Idle-time decompression + tokenization of the chapters the reader is most
+// likely to open next: the one under the chapter-menu cursor, then N+1, N-1
+class ChapterPrefetcher {
+public:
+  ChapterPrefetcher();
+
+  void Init(ChapterBuffer *spares[PREFETCH_SLOTS]);
+  void SetCache(ChapterCache *cache) { this->cache = cache; }
+  void Reset(); // Book changed, drop everything
+
+  void SetTargets(int currentChapter, int menuSelection, int chapterCount);
+  void Step(EpubReader &reader, int maxBlocks);
+
+  // Swap a resident (possibly still streaming) chapter into *active
+  bool Take(int chapterIndex, ChapterBuffer *&active);
+  // A resident copy of a chapter, loaded into a spare slot if there is none
+  // (link previews); nullptr if it can't be opened
+  ChapterBuffer *Fetch(EpubReader &reader, int chapterIndex);
+
+private:
+  ChapterBuffer *slots[PREFETCH_SLOTS];
+  int targets[PREFETCH_SLOTS];
+  ChapterCache *cache; // Optional; recycled slots are stored, targets looked up
+
+  ChapterBuffer *FindSlot(int chapterIndex);
+  bool IsTarget(int chapterIndex) const;
+};
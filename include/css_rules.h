@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define CSS_RULE_SLOTS 256 // Power of two
+#define CSS_MAX_RULES (CSS_RULE_SLOTS * 3 / 4)
+#define CSS_MAX_CLASSES 4 // Classes of one element that are looked up
+#define CSS_MAX_SHEET_SIZE (512 * 1024)
+
+// Declarations a rule makes
+#define CSS_SET_DISPLAY 0x01
+#define CSS_SET_WEIGHT 0x02
+#define CSS_SET_SLANT 0x04
+#define CSS_SET_SIZE 0x08
+
+// FNV-1a, fed one byte at a time so the tokenizer can hash names as they
+// stream past. 0 is reserved for "no name".
+#define CSS_HASH_INIT 2166136261u
+inline uint32_t CssHashStep(uint32_t h, char c) {
+  return (h ^ (uint8_t)c) * 16777619u;
+}
+inline uint32_t CssHashEnd(uint32_t h) { return h ? h : 1; }
+
+// What one selector (or the merge of every selector matching an element)
+// declares. Fields only count where set has their bit.
+struct CssRule {
+  uint32_t tag;     // Element name hash; 0 = any element
+  uint32_t cls;     // Class name hash; 0 = no class
+  uint8_t set;      // CSS_SET_*
+  uint8_t hidden;   // display: none
+  uint8_t emphasis; // TEXT_BOLD | TEXT_ITALIC
+  uint8_t style;    // TextStyle from font-size
+};
+
+// The part of a book's stylesheets the reader can act on, compiled once per
+// book into a flat open-addressing table. Only simple selectors are kept
+// (p, .class, p.class) and only display: none, font-weight, font-style and
+// font-size; everything else, including rules on html and body, is skipped.
+// An element is matched with one probe per tag/class pair.
+class CssRuleTable {
+public:
+  CssRuleTable();
+
+  void Clear();
+  // Adds a stylesheet's rules; later ones override earlier ones. css must be
+  // NUL-terminated (as LoadFile returns it); comments are blanked in place.
+  void Compile(char *css, size_t len);
+
+  bool IsEmpty() const { return count == 0; }
+  int GetCount() const { return count; }
+
+  // Merged rules for an element: tag first, then its classes, then
+  // tag.class. Returns false if nothing the reader acts on applies.
+  bool Match(uint32_t tag, const uint32_t *classes, int classCount,
+             CssRule *out) const;
+
+  // Book index (.idx) serialization
+  bool Save(FILE *f) const;
+  bool Load(FILE *f);
+
+private:
+  CssRule slots[CSS_RULE_SLOTS]; // set == 0 marks an empty slot
+  int count;
+
+  const CssRule *Find(uint32_t tag, uint32_t cls) const;
+  void Add(const CssRule &rule);
+  void AddSelectors(const char *selectors, const char *end,
+                    const CssRule &decl);
+};
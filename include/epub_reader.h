@@ -1,24 +1,110 @@
 #pragma once
 
+#include "css_rules.h"
+#include "href_resolver.h"
+#include "inflate_backend.h"
+#include "zip_io.h"
 #include <stdint.h>
 #include <string>
 #include <vector>
 
+#define EPUB_NO_FILE_INDEX 0xFFFFFFFFu
+#define EPUB_COVER_MAX_SIZE (2 * 1024 * 1024)
+
 struct ChapterInfo {
   char id[64];
   char title[128];
-  char href[128];
-  uint32_t zipOffset;
+  char href[128];     // Normalized archive path (percent-decoded, no ../)
+  uint32_t fileIndex; // Central directory index (EPUB_NO_FILE_INDEX if absent)
+  uint32_t zipOffset; // Local header offset
   uint32_t compSize;
   uint32_t uncompSize;
 };
 
+// A table of contents entry: where in the spine, and where in that item
+struct TocEntry {
+  char title[128];
+  int spineIndex;
+  uint32_t anchor; // AnchorHash of the fragment; 0 = the top of the item
+  int depth;       // Nesting level, 0 for top-level entries
+};
+
 struct EpubMetadata {
   char title[128];
   char author[128];
   char language[16];
-  char coverHref[128];
+  char coverHref[HREF_MAX_PATH]; // As normalized; fits any archive path
+  uint32_t coverFileIndex;
   std::vector<ChapterInfo> spine;
+  std::vector<TocEntry> toc; // NCX order; empty if the book has none
+};
+
+// Incremental reader for a single archive entry (spine items, and
+// internally the OPF, NCX and covers). Output is produced in caller-sized
+// blocks, so peak memory stays at one compressed input block plus the
+// inflate backend's dictionary no matter how large the entry is. STORED
+// entries skip inflate entirely and are read straight from the archive into
+// the caller's buffer.
+class ChapterStream {
+public:
+  ChapterStream();
+  ~ChapterStream();
+
+  size_t Read(void *buf, size_t size);
+  // Advance without delivering; deflated entries are inflated through scratch
+  bool Skip(uint32_t bytes, void *scratch, size_t scratchSize);
+  void Close();
+
+  bool IsOpen() const { return io != nullptr; }
+  bool IsDone() const { return remaining == 0; }
+  uint32_t Remaining() const { return remaining; }
+  bool IsStored() const { return io != nullptr && inflater == nullptr; }
+  // The delivered bytes didn't match the entry's CRC-32; the last Read
+  // returned 0 instead of its bytes
+  bool IsCorrupt() const { return corrupt; }
+
+private:
+  friend class EpubReader;
+  ZipIo *io;
+  uint64_t dataOffset; // Archive position of the next unread (compressed) byte
+  uint32_t remaining;  // Uncompressed bytes still to deliver
+  uint32_t crc;        // Of the bytes delivered so far
+  uint32_t expectedCrc;
+  bool checkCrc; // Off once a stored entry is skipped into (nothing read)
+  bool corrupt;
+
+  // DEFLATE entries
+  Inflater *inflater;
+  uint32_t compRemaining; // Compressed bytes not yet read from the archive
+  uint8_t *input;         // INFLATE_INPUT_SIZE staging block
+  uint32_t inputPos, inputLen;
+
+  size_t ReadStored(void *buf, size_t size);
+  void ReadAhead(size_t size);
+};
+
+// Background load of one archive entry (covers). The entry's bytes are read
+// on the async service; a deflated entry is inflated when it is collected.
+struct EpubFileLoad {
+  AsyncReadId id; // 0 when nothing is in flight
+  uint8_t *data;  // Entry bytes as stored in the archive
+  uint32_t compSize;
+  uint32_t uncompSize;
+  uint32_t crc;
+  bool deflated;
+  bool ready; // data holds the whole entry
+
+  EpubFileLoad()
+      : id(0), data(nullptr), compSize(0), uncompSize(0), crc(0),
+        deflated(false), ready(false) {}
+};
+
+class BumpArena;
+
+enum class EpubOpenMode {
+  FULL,     // Metadata, spine and TOC (reading)
+  METADATA, // Title/author/language/cover href only (library scans)
+  ARCHIVE   // Central directory only; caller supplies hrefs (thumbnails)
 };
 
 // EPUB parser class
@@ -27,18 +113,81 @@ public:
   EpubReader();
   ~EpubReader();
 
-  bool Open(const char *path);
+  bool Open(const char *path, EpubOpenMode mode = EpubOpenMode::FULL);
   void Close();
 
   const EpubMetadata &GetMetadata() const { return metadata; }
+  // The book's stylesheets, compiled at open (FULL mode)
+  const CssRuleTable &GetStyles() const { return styles; }
   uint8_t *LoadChapter(int chapterIndex);
+  bool OpenChapterStream(int chapterIndex, ChapterStream &stream);
   uint8_t *LoadCover(size_t *outSize);
+  // Spine index an href in spine item fromChapter points to, or -1; the
+  // fragment's AnchorHash goes to *anchor (0 if there is none)
+  int ResolveHref(int fromChapter, const char *href, uint32_t *anchor);
+  uint8_t *LoadFile(const char *href, size_t *outSize, size_t maxSize);
+
+  // Non-blocking LoadFile. Begin falls back to a blocking read when no async
+  // service is attached; Poll returns QUEUED until the data is in, then DONE
+  // with a malloc'd buffer (or FAILED).
+  bool BeginLoadFile(const char *href, size_t maxSize, int priority,
+                     EpubFileLoad &load);
+  AsyncReadStatus PollLoadFile(EpubFileLoad &load, uint8_t **outData,
+                               size_t *outSize);
+  void CancelLoadFile(EpubFileLoad &load);
+
+  // I/O layer: applies from the next Open
+  void SetFileBackend(FileBackend *backend) { io.SetBackend(backend); }
+  void ConfigureReadAhead(uint32_t blockSize, int blockCount) {
+    io.Configure(blockSize, blockCount);
+  }
+  const ZipIoStats &GetIoStats() const { return io.GetStats(); }
+  // Chapter read-ahead and BeginLoadFile go through this when set
+  void SetAsyncReads(AsyncReadService *service) {
+    io.SetAsyncService(service);
+  }
+
+  // Decoder for DEFLATE entries, InflateBackend::GetDefault(): chosen at
+  // build time (make INFLATE_BACKEND=zlib)
+  InflateBackend *GetInflateBackend() const { return inflateBackend; }
 
 private:
   void *zipArchive;
+  ZipIo io;
+  InflateBackend *inflateBackend;
+  HrefResolver resolver; // Built on the first lookup after Open
   EpubMetadata metadata;
+  CssRuleTable styles;
+  std::vector<int> spineOfFile; // Zip entry index -> spine index, or -1
+
+  void ResetMetadata();
+  void BuildResolver();
+  void BuildSpineMap();
+  uint32_t LocateFile(const char *href);
+  uint8_t *ExtractToHeap(uint32_t fileIndex, const char *name, size_t *outSize,
+                         size_t maxSize);
+  uint8_t *ReadEntry(uint32_t fileIndex, size_t *outSize); // NUL-terminated
+  bool LocateEntryData(uint32_t fileIndex, uint64_t *dataOffset,
+                       uint32_t *compSize, uint32_t *uncompSize,
+                       uint32_t *crc, bool *deflated);
+  bool OpenEntryStream(uint32_t fileIndex, ChapterStream &stream);
+  uint8_t *InflateBuffer(const uint8_t *src, uint32_t compSize,
+                         uint32_t uncompSize);
+  char *ExtractPrefix(const char *href, const char *terminator,
+                      size_t *outSize, bool *truncated);
+
+  // Per-book sidecar (<book>.idx) holding the parsed OPF/NCX, resolved
+  // spine, TOC and compiled stylesheet rules, keyed by the EPUB's size +
+  // mtime
+  bool LoadIndex(const char *indexPath, uint32_t fileSize, uint32_t mtime);
+  void SaveIndex(const char *indexPath, uint32_t fileSize, uint32_t mtime);
 
+  // Cold open: container.xml, then the OPF (and NCX for FULL)
+  bool ReadPackage(EpubOpenMode mode, BumpArena &arena);
   bool ReadContainerXml(char *outPath);
-  bool ParseContentOpf(const uint8_t *data, size_t size,
-                       const std::string &rootDir);
+  bool ReadOpfMetadata(const char *opfPath, const char *rootDir);
+  bool ParseContentOpf(uint8_t *data, size_t size, const char *rootDir,
+                       BumpArena &arena);
+  void LoadStylesheet(const char *href);
+  void ParseNcx(const char *ncxHref);
 };
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define HREF_MAX_PATH 256
+
+// Archive path -> zip entry lookup. Built once per open book from the central
+// directory into a flat open-addressing table, so resolving a chapter, cover,
+// NCX or image href costs one hash and (normally) one string compare.
+class HrefResolver {
+public:
+  HrefResolver();
+  ~HrefResolver();
+
+  void Begin(int entryCount); // Sizes the table; drops any previous contents
+  void Add(const char *archiveName, uint32_t fileIndex,
+           uint32_t localHeaderOfs);
+  void Clear();
+
+  // href may be percent-encoded and contain ./ and ../ segments; a fragment
+  // is ignored. Tries the decoded form first, then the literal one.
+  bool Lookup(const char *href, uint32_t *fileIndex,
+              uint32_t *localHeaderOfs) const;
+
+  bool IsBuilt() const { return slots != nullptr; }
+  int GetCount() const { return count; }
+
+  // Join baseDir (ending in '/', may be empty) with a relative href and
+  // collapse ./.. segments. Absolute hrefs ignore baseDir.
+  static void Normalize(const char *baseDir, const char *href, bool decode,
+                        char *out, size_t outSize);
+
+private:
+  struct Slot {
+    uint32_t hash;
+    uint32_t fileIndex;
+    uint32_t localHeaderOfs;
+    uint32_t nameOffset; // Into names
+  };
+
+  Slot *slots;
+  uint32_t mask;
+  int count;
+  std::vector<char> names;
+
+  const Slot *Find(const char *path) const;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#define ENTITY_MAX_NAME 32 // Longest HTML5 name is 31 ("CounterClockwise...")
+
+// Looks up the HTML5 named character reference name[0..len), without the
+// '&' and ';'. Returns the number of code points it stands for (1 or 2,
+// stored in cps) or 0 if there is no such name. *legacy is set for the
+// names HTML also accepts without the semicolon (&amp, &nbsp, &eacute...).
+int LookupNamedEntity(const char *name, int len, uint32_t *cps, bool *legacy);
+
+// Code point for the numeric reference &#value; with HTML's fixups: C1
+// controls map through windows-1252 (&#151; is an em dash), and NUL,
+// surrogates and values beyond Unicode become U+FFFD
+uint32_t ResolveNumericEntity(uint32_t value);
@@ -1,21 +1,233 @@
 #pragma once
 
+#include "anchor_index.h"
+#include "css_rules.h"
+#include "html_entities.h"
+#include "line_break.h"
 #include "text_renderer.h"
+#include "token_table.h"
+
+// Word flags
+#define WORD_GLUED 0x01   // No space before: the break isn't at whitespace
+#define WORD_NEWLINE 0x02 // Paragraph break; the word has no text
+
+#define INLINE_STACK_DEPTH 16 // Nested <b>/<i>-like elements tracked
+#define STYLED_STACK_DEPTH 16 // Nested elements the book's CSS applies to
+
+// Consecutive words sharing a TextStyle and emphasis. A run lasts until the
+// next one starts (the last one to the end of the words). Styles change
+// every few dozen words at most, so runs cost far less than a per-word array.
+struct StyleRun {
+  int start;        // Index of the first word
+  uint8_t style;    // TextStyle
+  uint8_t emphasis; // TEXT_BOLD | TEXT_ITALIC
+};
 
 // Simple HTML-to-text extractor for EPUB chapters with style detection
 // Optimized for PSP-1000 (32MB RAM)
+//
+// The extractor is resumable: Begin() binds the output arrays, Feed() accepts
+// arbitrarily sized blocks (tags, words and UTF-8 sequences may straddle
+// block boundaries) and Finish() flushes whatever is still pending.
+//
+// Words are the text between UAX #14 line break opportunities (see
+// line_break.h), so CJK comes out one ideograph per word with kinsoku
+// punctuation attached, "well-" and "known" are separate words, and
+// "10 %" or "mot !" stay in one. A word that follows a break with no
+// whitespace in the source is flagged WORD_GLUED. Character references
+// (&amp;, &mdash;, &#8212;) are decoded first, so they break and measure
+// like the characters they stand for.
+//
+// Styles are emitted as runs (see StyleRun). Headings set the TextStyle;
+// <b>/<strong> and <i>/<em>/<cite>/<dfn>/<var> push emphasis onto a stack
+// that closing tags pop, so nesting and misnesting both work out. A word
+// takes the emphasis in effect where it starts.
+//
+// With the book's stylesheet rules attached (SetStyles), the class attribute
+// is read as well. Elements the rules hide are skipped like scripts, their
+// emphasis joins the stack, and a block of body text whose font-size makes
+// it a heading gets that TextStyle and a paragraph break either side.
+//
+// With an AnchorIndex attached (SetAnchors), id attributes (and <a name>)
+// are recorded at the word their element starts at, and each <a href> as
+// the words it spans and the spine item and anchor it points to.
+//
+// With a TokenTable attached (SetTokens), every word is also interned as it
+// is stored and its token ID written alongside; newlines get TOKEN_NONE.
+//
+// Chapters larger than the output arrays are handled as a sliding window:
+// Feed() stops consuming once the arrays are full, the caller drops words it
+// no longer needs with Discard() and feeds the remainder of the block.
+//
+// Words are stored as an offset into wordBuffer and a length, with no
+// terminator. Normally each one is copied there as it completes. In place,
+// the chapter itself is in wordBuffer and Feed() is given slices of it: a
+// word is left where it was parsed, and only one that markup or a reference
+// split up is rewritten, over its own source bytes. The few things that
+// decode longer than their source (malformed UTF-8, &nGt;) may not fit; the
+// extractor then stops and HasOverflowed() tells the caller to start over
+// without in-place mode.
 
 class HtmlTextExtractor {
 public:
+  // An open element the book's CSS applies to, or one of the same name
+  // nested in it, so end tags pair up
+  struct StyledElement {
+    uint32_t tagHash;
+    uint8_t emphasis;
+    bool hidden;
+    bool restyled;     // Set the TextStyle; prevStyle comes back at the end
+    uint8_t prevStyle;
+  };
+
+  // Parser state carried across Feed() calls. Plain data, so a chapter can be
+  // re-tokenized from a snapshot taken at a block boundary.
+  struct ParseState {
+    bool inTag;
+    bool inScript;
+    bool inStyle;
+    bool readingTagName;
+    bool closingTag;
+    char tagName[8];
+    int tagNameLen;
+    TextStyle currentStyle;
+    char currentWord[256];
+    int currentWordLen;
+    bool wordGlued;    // No space between currentWord and the previous word
+    bool pendingSpace; // Whitespace since the line's last character
+    uint8_t lastClass; // LineBreakClass of that character; LB_COUNT if none
+    Utf8Decoder utf8;
+    bool inEntity;                    // Inside a character reference
+    char entity[ENTITY_MAX_NAME + 1]; // What follows its '&' so far
+    int entityLen;
+    uint8_t inlineStack[INLINE_STACK_DEPTH]; // Emphasis each open tag adds
+    int inlineDepth;
+    uint8_t emphasis;     // Union of both stacks
+    uint8_t wordEmphasis; // Emphasis where currentWord started
+    // CSS rules and anchors: the tag being read and its attributes
+    uint32_t tagHash;
+    uint8_t attrState;
+    int8_t attrMatch;     // Characters the attribute name has matched
+    uint8_t attrNames;    // Names (bits of ATTR_IS_*) it may still be
+    uint8_t attrKind;     // Attribute whose value is being read
+    char attrQuote;       // Quote around the value being read, if any
+    bool tagSlash;        // Last byte read was '/': <span class="x"/>
+    uint32_t valueHash;   // Class name or id being read
+    int valueLen;
+    uint32_t classes[CSS_MAX_CLASSES];
+    int classCount;
+    uint32_t elementId;   // Hash of the tag's id; 0 if it has none
+    char href[LINK_HREF_MAX]; // Of an <a>; not terminated
+    int hrefLen;              // -1 if it didn't fit
+    bool inLink;              // An <a href> is open
+    int linkStart;            // Its first word, chapter-wide
+    int linkSpine;
+    uint32_t linkAnchor;
+    StyledElement styled[STYLED_STACK_DEPTH];
+    int styledDepth;
+    int hiddenDepth; // Open elements with display: none
+  };
+
   HtmlTextExtractor();
   ~HtmlTextExtractor();
 
   // Extract words from HTML with style flags
   // Returns number of words found.
-  int ExtractWords(const char *html, char **words, TextStyle *styles,
-                   int *wordLens, int maxWords, char *wordBuffer,
-                   int bufferSize);
+  int ExtractWords(const char *html, uint32_t *wordOffsets, uint8_t *flags,
+                   uint8_t *wordLens, int maxWords, StyleRun *runs,
+                   int maxRuns, char *wordBuffer, int bufferSize);
+
+  // Incremental interface used for streamed chapters
+  void Begin(uint32_t *wordOffsets, uint8_t *flags, uint8_t *wordLens,
+             int maxWords, StyleRun *runs, int maxRuns, char *wordBuffer,
+             int bufferSize, bool inPlace = false);
+  // Returns bytes consumed. In place, a UTF-8 sequence cut off at the end of
+  // data is left unconsumed until the rest of it follows.
+  int Feed(const char *data, int len);
+  int Finish();
+
+  // Drop the first count words and compact the rest to the front
+  void Discard(int count);
+
+  // Take over words already written into the bound arrays (after Begin)
+  void Adopt(int wordCount, int bufferUsed, int runCount);
+
+  // Book-wide rules consulted per element; nullptr or empty for none
+  void SetStyles(const CssRuleTable *styles);
+
+  // Intern words into tokens, IDs to wordTokens[] (parallel to the word
+  // arrays bound by Begin); nullptr for none
+  void SetTokens(TokenTable *tokens, uint16_t *wordTokens);
+
+  // Record ids and links into anchors; nullptr for none. Word indices there
+  // are chapter-wide: wordBase is the index of the first word after Begin.
+  void SetAnchors(AnchorIndex *anchors);
+  void SetWordBase(int wordBase) { this->wordBase = wordBase; }
+
+  // Snapshot/restore around Begin(); word output is not part of the state
+  void SaveState(ParseState &out) const { out = state; }
+  void RestoreState(const ParseState &in) { state = in; }
+
+  int GetWordCount() const { return wordCount; }
+  int GetRunCount() const { return runCount; }
+  bool IsFull() const;
+  bool HasOverflowed() const { return overflowed; }
 
 private:
   bool IsWhitespace(char c);
+  void CommitWord();
+  void PushNewline();
+  void HandleTagName();
+  void OpenRun(uint8_t style, uint8_t emphasis);
+  void SyncRun();
+  void PushEmphasis(uint8_t bits);
+  void PopEmphasis(uint8_t bits);
+  void UpdateEmphasis();
+  int ScanAttributes(const char *data, int len);
+  void EndClassName();
+  void EndAttribute();
+  void OpenElement();
+  void OpenLink();
+  void CloseLink();
+  void OpenStyledElement();
+  void CloseStyledElement();
+  void PushCodepoint(uint32_t cp, LineBreakClass cls, const char *bytes,
+                     int len, const char *src, const char *srcEnd);
+  template <bool InPlace> int FeedText(const char *text, int len);
+  bool FeedEntity(char c);
+  void ResolveEntity(bool semicolon);
+  void PushLiteral(const char *text, int len, int at);
+  template <bool InPlace>
+  int CopyAlnumRun(const char *text, int len, int *pos, int wordLen,
+                   uint8_t *lastClass);
+  void Overflow();
+  // In place: the writable address of input text
+  char *TextAt(const char *p) { return wordBuffer + (p - wordBuffer); }
+
+  // Output binding
+  uint32_t *wordOffsets;
+  uint8_t *flags;
+  uint8_t *wordLens;
+  int maxWords;
+  StyleRun *runs;
+  int maxRuns;
+  int runCount;
+  bool runStale; // Style changed since the last run was checked
+  int wordLimit; // maxWords, lower while the run table is nearly full
+  char *wordBuffer;
+  int bufferSize;
+  int wordCount;
+  int bufferPos;
+  bool inPlace;
+  bool overflowed;       // In place: a character didn't fit its source
+  char *wordOut;         // currentWord's bytes: state.currentWord or in place
+  const char *entitySrc; // In place: the '&' of the reference being read
+  const CssRuleTable *styles;
+  TokenTable *tokens;
+  uint16_t *wordTokens;
+  AnchorIndex *anchors;
+  int wordBase;      // Chapter-wide index of word 0
+  uint8_t attrsRead; // ATTR_IS_* bits worth scanning attributes for
+
+  ParseState state;
 };
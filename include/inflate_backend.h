@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define INFLATE_INPUT_SIZE 16384 // Compressed bytes staged per archive read
+
+enum class InflateResult {
+  OK,   // Progress made (or more input needed); call again
+  DONE, // End of the deflate stream
+  ERROR // Corrupt data or allocation failure
+};
+
+struct InflateStats {
+  uint32_t entries;  // Decoders created
+  uint64_t bytesIn;  // Compressed bytes consumed
+  uint64_t bytesOut; // Bytes produced
+  uint64_t timeUs;   // Spent inside the decoder
+  size_t liveBytes;  // Decoder state currently allocated
+  size_t peakBytes;
+};
+
+class InflateBackend;
+
+// One raw-DEFLATE (zip method 8) entry being decoded. Input and output are
+// caller-sized; decoders keep whatever history they need internally.
+class Inflater {
+public:
+  virtual ~Inflater();
+
+  // On entry *inSize / *outSize are the bytes available; on return they hold
+  // the bytes consumed / produced. moreInput is false once in holds the tail
+  // of the entry.
+  InflateResult Run(const uint8_t *in, size_t *inSize, uint8_t *out,
+                    size_t *outSize, bool moreInput);
+
+protected:
+  explicit Inflater(InflateBackend *owner);
+
+  virtual InflateResult Decode(const uint8_t *in, size_t *inSize, uint8_t *out,
+                               size_t *outSize, bool moreInput) = 0;
+
+  // Decoder state accounting for the owner's peak-memory stat
+  void Track(size_t bytes);
+  void Untrack(size_t bytes);
+
+  InflateBackend *owner;
+  size_t trackedBytes;
+};
+
+// Decoder factory. EpubReader uses one for chapter streams, covers and
+// metadata; stats accumulate across books so backends can be compared from
+// debug.log.
+class InflateBackend {
+public:
+  InflateBackend();
+  virtual ~InflateBackend() {}
+
+  virtual const char *GetName() const = 0;
+  virtual Inflater *Create() = 0; // Caller deletes; nullptr on failure
+
+  const InflateStats &GetStats() const { return stats; }
+  void ResetStats();
+  void LogStats() const;
+
+  // The reader's decoder: zlib when compiled with -DINFLATE_DEFAULT_ZLIB
+  // (make INFLATE_BACKEND=zlib), otherwise miniz's tinfl. Compare them with
+  // make bench-inflate.
+  static InflateBackend *GetDefault();
+
+protected:
+  friend class Inflater;
+  InflateStats stats;
+
+  void TrackAlloc(size_t bytes);
+  void TrackFree(size_t bytes);
+};
+
+// miniz's tinfl, decoding through its own 32 KB wrapping dictionary
+class TinflInflateBackend : public InflateBackend {
+public:
+  const char *GetName() const override { return "tinfl"; }
+  Inflater *Create() override;
+};
+
+// System zlib (already linked for SDL_image/freetype), decoding straight
+// into the caller's buffer
+class ZlibInflateBackend : public InflateBackend {
+public:
+  const char *GetName() const override { return "zlib"; }
+  Inflater *Create() override;
+};
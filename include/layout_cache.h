@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define LAYOUT_CACHE_VERSION 2
+#define LAYOUT_CACHE_MAX_BYTES (4 * 1024 * 1024) // Started over past this
+#define LAYOUT_CACHE_MAX_LINES 65536 // Longer chapters aren't kept
+#define LINE_MAX_SPANS 4 // Emphasis changes kept per line; later ones merge
+#define MAX_LINE_LEN 256 // Bytes of text a line keeps; longer lines are cut
+
+// Part of a line drawn in one emphasis
+struct LineSpan {
+  uint8_t start; // Offset into LineInfo::text
+  uint8_t emphasis;
+  int16_t x; // Pixels from the start of the line
+};
+
+// A laid-out line without its text: which words it holds and how they are
+// drawn. The text is copied back from the tokenized chapter.
+struct LayoutLine {
+  int startWord; // Chapter-wide
+  uint16_t wordCount;
+  uint8_t style;
+  uint8_t spanCount;
+  int16_t width;
+  LineSpan spans[LINE_MAX_SPANS];
+};
+
+struct LayoutCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t stores;
+  uint32_t fileBytes;
+  int entries;
+};
+
+// Line tables of chapters already laid out, kept next to the book as
+// <book>.lay. An entry is one chapter laid out with one set of layout
+// parameters (key): its lines and page anchors, varint-packed. Entries are
+// appended as chapters finish and Open() reads only their headers, so
+// loading a chapter's lines is a seek and a single read. A file written for
+// another copy of the book, or grown past LAYOUT_CACHE_MAX_BYTES, is started
+// over.
+class LayoutCache {
+public:
+  LayoutCache();
+  ~LayoutCache();
+
+  bool Open(const char *bookPath);
+  void Close();
+
+  // Lines and page anchors of a chapter laid out with key before
+  bool Load(int chapter, uint32_t key, std::vector<LayoutLine> &lines,
+            std::vector<int> &pageAnchors);
+  void Store(int chapter, uint32_t key, const std::vector<LayoutLine> &lines,
+             const std::vector<int> &pageAnchors);
+
+  const LayoutCacheStats &GetStats() const { return stats; }
+
+private:
+  struct Entry {
+    int chapter;
+    uint32_t key;
+    uint32_t offset; // Of the payload
+    uint32_t size;
+    uint32_t lineCount;
+    uint32_t pageCount;
+  };
+
+  std::string path;
+  uint32_t bookSize;
+  uint32_t bookMtime;
+  std::vector<Entry> entries;
+  std::vector<uint8_t> scratch; // Payload being packed or unpacked
+  LayoutCacheStats stats;
+
+  bool Restart();
+  int Find(int chapter, uint32_t key) const;
+};
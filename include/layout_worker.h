@@ -0,0 +1,131 @@
+#pragma once
+
+#include "chapter_prefetcher.h"
+#include "layout_cache.h"
+#include "text_renderer.h"
+#include <atomic>
+#include <stdint.h>
+
+#define LAYOUT_FEED_WORDS 2048  // Words handed over and not yet laid out
+#define LAYOUT_FEED_BYTES 16384 // Their text
+#define LAYOUT_RING_LINES 256   // Lines laid out and not yet taken
+#define LAYOUT_BATCH_LINES 16   // Lines published at a time
+
+// What a run of lines is laid out with; see LayoutWorker::Begin()
+struct LayoutJob {
+  int startWord; // Chapter-wide; the first line starts here
+  int maxWidth;
+  int spaceWidths[6]; // Per TextStyle
+  float fontScale;
+  FontMode fontMode;
+  uint32_t widthsEpoch; // Changes when token ids or fonts do: widths go
+};
+
+// A word handed to the worker, with the run it is drawn in
+struct LayoutWord {
+  uint32_t textPos; // Into the text ring, free-running
+  uint16_t token;
+  uint8_t len;
+  uint8_t flags; // WORD_GLUED, WORD_NEWLINE, LAYOUT_WORD_END
+  uint8_t style;
+  uint8_t emphasis;
+};
+
+#define LAYOUT_WORD_END 0x80 // No more words: the last line is complete
+
+// Measuring and line breaking on a thread of its own. The main loop keeps
+// tokenizing and hands the worker copies of the words it needs (Feed), so
+// the worker never reads a ChapterBuffer, whose window moves under Discard()
+// and Seek(). Lines come back as LayoutLine records (Peek/Pop), and the main
+// loop copies their text as it does for lines replayed from LayoutCache.
+//
+// Both directions are single-producer/single-consumer rings over
+// free-running counters: each side stores only its own counter (release)
+// and loads the other's (acquire), so no lock is taken per word or line.
+// The mutex and conds are for sleeping on an empty or full ring, and for
+// Begin/Cancel, which wait until the worker has let go of the rings.
+//
+// The worker measures with a TextRenderer of its own, so no FreeType face
+// is shared between threads. It runs below the main loop's priority: on
+// the PSP's single core it gets the CPU while the main loop waits on vsync
+// or on it.
+class LayoutWorker {
+public:
+  LayoutWorker();
+  ~LayoutWorker();
+
+  bool Start(); // false: no thread, layout stays on the main loop
+  void Stop();
+  bool IsRunning() const { return thread != nullptr; }
+
+  // Drop the current run of lines, then lay out from job.startWord
+  void Begin(const LayoutJob &job);
+  // Drop the current run; returns once the worker is out of the rings
+  void Cancel();
+
+  // Hands over window-local words [from, WordCount()) of chapter as far as
+  // the rings have room, and the end of the chapter once it is complete.
+  // Returns the first word not handed over.
+  int Feed(const ChapterBuffer &chapter, int from, int *runCursor);
+
+  // Next line laid out, or nullptr if none is ready. With wait, blocks while
+  // the worker still has words it can lay out. Valid until Pop().
+  const LayoutLine *Peek(bool wait);
+  void Pop();
+
+  // Distinct words measured since the job's widths were reset
+  int Measured() const { return measured.load(std::memory_order_relaxed); }
+
+private:
+  // Main -> worker
+  LayoutWord feedWords[LAYOUT_FEED_WORDS];
+  char feedText[LAYOUT_FEED_BYTES];
+  std::atomic<uint32_t> feedHead; // Words handed over
+  std::atomic<uint32_t> feedTail; // Words laid out
+  std::atomic<uint32_t> textTail; // Text bytes no longer needed
+  uint32_t textHead;              // Main loop only
+  bool endFed;                    // Main loop only
+
+  // Worker -> main
+  LayoutLine lines[LAYOUT_RING_LINES];
+  std::atomic<uint32_t> lineHead;
+  std::atomic<uint32_t> lineTail;
+
+  // Under mutex
+  LayoutJob job;
+  uint32_t jobSerial;    // Bumped by Begin()
+  uint32_t workerSerial; // Job the worker has taken up
+  bool hasJob;
+  bool busy; // Worker is outside the mutex, using the rings
+  bool stopping;
+  // Checked by the worker every word, so a cancel doesn't wait on a line
+  std::atomic<uint32_t> generation;
+
+  // Worker thread only
+  TextRenderer renderer;
+  LayoutJob current;
+  uint32_t widthsEpoch;
+  int widths[TOKEN_MAX]; // By token, -1 = unmeasured
+  std::atomic<int> measured;
+  int nextWord;  // Chapter-wide index of the next word read
+  bool done;     // Took LAYOUT_WORD_END
+  LayoutLine line; // Being filled; wordCount 0 when there is none
+  int lineFill;    // Width as fillLine() counts it, for the break test
+  int lineLen;     // Text bytes, as processLayout() copies them
+  int lineX;       // Pen position after the copied words
+  uint32_t emitted; // Lines written to the ring, published or not
+
+  void *thread;   // SDL_Thread
+  void *mutex;    // SDL_mutex
+  void *wake;     // SDL_cond: job, words or room for lines
+  void *progress; // SDL_cond: lines published, or the worker went idle
+
+  bool HasWork() const;
+  void StartJob();
+  void Run(); // Lays out until out of words or room, or cancelled
+  int Measure(const LayoutWord &word);
+  void AddWord(const LayoutWord &word);
+  void EmitLine();
+  void Publish();
+  static int WorkerMain(void *self);
+};
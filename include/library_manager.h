@@ -10,10 +10,12 @@ struct BookEntry {
   std::string filename;
   std::string title;
   std::string author;
+  std::string coverHref; // Recorded at scan time so thumbnails skip the OPF
+  bool coverKnown;
   SDL_Texture *thumbnail;
   int thumbW, thumbH;
 
-  BookEntry() : thumbnail(nullptr), thumbW(0), thumbH(0) {}
+  BookEntry() : coverKnown(false), thumbnail(nullptr), thumbW(0), thumbH(0) {}
 };
 
 class LibraryManager {
@@ -24,14 +26,27 @@ public:
   bool ScanDirectory(const std::string &path);
   void Clear();
 
+  // Covers load one at a time in the background; call every frame for the
+  // visible books until their thumbnail appears
   void LoadThumbnail(SDL_Renderer *renderer, int index);
   void UnloadThumbnail(int index);
+  void SetAsyncReads(AsyncReadService *service) {
+    thumbReader.SetAsyncReads(service);
+  }
 
   const std::vector<BookEntry> &GetBooks() const { return books; }
 
 private:
   std::vector<BookEntry> books;
-  SDL_Texture *CreateThumbnail(SDL_Renderer *renderer, EpubReader &reader);
+
+  // Cover read in flight
+  EpubReader thumbReader;
+  EpubFileLoad thumbLoad;
+  int thumbLoading; // Book index, -1 if idle
+
+  void CancelThumbnailLoad();
+  SDL_Texture *CreateThumbnail(SDL_Renderer *renderer, uint8_t *data,
+                               size_t size);
 
   void LoadCache(const std::string &path);
   void SaveCache(const std::string &path);
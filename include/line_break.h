@@ -0,0 +1,197 @@
+#pragma once
+
+#include <stdint.h>
+
+// Unicode line breaking (UAX #14) for the tokenizer.
+//
+// Classes are the UAX #14 set after the LB1 resolutions a reader without
+// dictionaries needs: AI/XX/SG/HL/RI/SA resolve to AL, CJ to NS (strict
+// kinsoku, so small kana never start a line), Hangul syllables and emoji
+// to ID, and hard breaks to SP (HTML collapses them anyway).
+enum LineBreakClass : uint8_t {
+  LB_AL, // Alphabetic (the default)
+  LB_SP,
+  LB_OP, // Opening punctuation
+  LB_CL, // Closing punctuation
+  LB_CP, // Closing parenthesis
+  LB_QU, // Ambiguous quotation
+  LB_GL, // Non-breaking glue (NBSP, narrow NBSP)
+  LB_NS, // Non-starters (small kana, iteration marks)
+  LB_EX, // ! ?
+  LB_SY, // /
+  LB_IS, // Infix numeric separators , . : ;
+  LB_PR, // Prefix numeric ($, currency)
+  LB_PO, // Postfix numeric (%, degree signs)
+  LB_NU,
+  LB_ID, // Ideographic: breaks before and after
+  LB_IN, // Inseparable leaders
+  LB_HY, // Hyphen-minus
+  LB_BA, // Break after
+  LB_BB, // Break before
+  LB_B2, // Em dash: break before and after, not between two
+  LB_ZW, // Zero width space
+  LB_CM, // Combining marks, inherit the base's class
+  LB_WJ, // Word joiner
+  LB_ZWJ,
+  LB_COUNT
+};
+
+enum LineBreakAction : uint8_t {
+  LB_BREAK_DIRECT,     // Break allowed, whether or not there is space
+  LB_BREAK_INDIRECT,   // Break allowed only across spaces
+  LB_BREAK_PROHIBITED  // No break, even across spaces
+};
+
+#define LB_BLOCK_SHIFT 6 // BMP table granularity: 64 code points
+#define LB_BLOCK_SIZE (1 << LB_BLOCK_SHIFT)
+#define LB_BMP_BLOCKS (0x10000 >> LB_BLOCK_SHIFT)
+
+// Generated at compile time in line_break.cpp. The lookups are inline since
+// the tokenizer does one per character.
+extern const uint8_t *const lineBreakBlockIndex;  // [LB_BMP_BLOCKS]
+extern const LineBreakClass *const lineBreakData; // 64 per distinct block
+extern const LineBreakAction *const lineBreakPairs; // [LB_COUNT * LB_COUNT]
+
+LineBreakClass GetSupplementaryLineBreakClass(uint32_t cp);
+
+inline LineBreakClass GetLineBreakClass(uint32_t cp) {
+  if (cp >= 0x10000)
+    return GetSupplementaryLineBreakClass(cp);
+  return lineBreakData[(lineBreakBlockIndex[cp >> LB_BLOCK_SHIFT]
+                        << LB_BLOCK_SHIFT) +
+                       (cp & (LB_BLOCK_SIZE - 1))];
+}
+
+// ASCII always occupies the first two blocks of the table
+inline LineBreakClass GetAsciiLineBreakClass(uint8_t c) {
+  return lineBreakData[c];
+}
+
+// Break between a character of class before and one of class after, with
+// any spaces in between left out. Neither may be SP or CM.
+inline LineBreakAction GetLineBreakAction(LineBreakClass before,
+                                          LineBreakClass after) {
+  return lineBreakPairs[before * LB_COUNT + after];
+}
+
+#define UTF8_REPLACEMENT 0xFFFD
+
+// Decodes the sequence at s, which has avail bytes. Returns its length, or 0
+// if it continues past avail (feed those bytes to a Utf8Decoder instead).
+// A malformed sequence yields U+FFFD and the length of its broken prefix,
+// matching Utf8Decoder.
+inline int DecodeUtf8(const uint8_t *s, int avail, uint32_t *cp) {
+  uint8_t b = s[0];
+  int len;
+  uint32_t minimum;
+  if (b < 0x80) {
+    *cp = b;
+    return 1;
+  } else if ((b & 0xE0) == 0xC0) {
+    len = 2;
+    minimum = 0x80;
+    *cp = b & 0x1F;
+  } else if ((b & 0xF0) == 0xE0) {
+    len = 3;
+    minimum = 0x800;
+    *cp = b & 0x0F;
+  } else if ((b & 0xF8) == 0xF0) {
+    len = 4;
+    minimum = 0x10000;
+    *cp = b & 0x07;
+  } else {
+    *cp = UTF8_REPLACEMENT;
+    return 1;
+  }
+  for (int i = 1; i < len; i++) {
+    if (i == avail)
+      return 0;
+    if ((s[i] & 0xC0) != 0x80) {
+      *cp = UTF8_REPLACEMENT;
+      return i;
+    }
+    *cp = (*cp << 6) | (s[i] & 0x3F);
+  }
+  if (*cp < minimum || *cp > 0x10FFFF || (*cp >= 0xD800 && *cp <= 0xDFFF))
+    *cp = UTF8_REPLACEMENT;
+  return len;
+}
+
+// Incremental UTF-8 decoder; plain data, so it can live in a parse snapshot.
+// Malformed input (stray continuation bytes, truncated or overlong sequences,
+// surrogates) decodes to U+FFFD.
+struct Utf8Decoder {
+  uint32_t cp;
+  uint8_t need; // Continuation bytes still expected
+  uint8_t len;  // Sequence length, for the overlong check
+
+  void Reset() {
+    cp = 0;
+    need = 0;
+    len = 0;
+  }
+
+  // Returns true when cp holds a complete code point. A byte that cuts a
+  // sequence short yields U+FFFD and sets *again; feed it once more.
+  bool Push(uint8_t b, bool *again) {
+    *again = false;
+    if (need > 0) {
+      if ((b & 0xC0) == 0x80) {
+        cp = (cp << 6) | (b & 0x3F);
+        if (--need > 0)
+          return false;
+        static const uint32_t minimum[5] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < minimum[len] || cp > 0x10FFFF ||
+            (cp >= 0xD800 && cp <= 0xDFFF))
+          cp = UTF8_REPLACEMENT;
+        return true;
+      }
+      need = 0;
+      cp = UTF8_REPLACEMENT;
+      *again = true;
+      return true;
+    }
+    if (b < 0x80) {
+      cp = b;
+    } else if ((b & 0xE0) == 0xC0) {
+      cp = b & 0x1F;
+      need = 1;
+      len = 2;
+    } else if ((b & 0xF0) == 0xE0) {
+      cp = b & 0x0F;
+      need = 2;
+      len = 3;
+    } else if ((b & 0xF8) == 0xF0) {
+      cp = b & 0x07;
+      need = 3;
+      len = 4;
+    } else {
+      cp = UTF8_REPLACEMENT;
+    }
+    return need == 0;
+  }
+};
+
+// Returns the byte count (1-4); cp must be a valid scalar value
+inline int EncodeUtf8(uint32_t cp, char *out) {
+  if (cp < 0x80) {
+    out[0] = (char)cp;
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = (char)(0xC0 | (cp >> 6));
+    out[1] = (char)(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = (char)(0xF0 | (cp >> 18));
+  out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = (char)(0x80 | (cp & 0x3F));
+  return 4;
+}
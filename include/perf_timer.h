@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __PSP__
+#include <pspkernel.h>
+#else
+#include <time.h>
+#endif
+
+// Microsecond timestamp for profiling logs (SDL_GetTicks is only ms)
+static inline uint64_t PerfNowUs() {
+#ifdef __PSP__
+  return sceKernelGetSystemTimeWide();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+#endif
+}
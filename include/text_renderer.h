@@ -19,6 +19,14 @@ enum class TextStyle {
   SMALL  // For footer/status
 };
 
+// Inline emphasis, orthogonal to TextStyle
+#define TEXT_BOLD 0x01
+#define TEXT_ITALIC 0x02
+
+#define GLYPH_DENSE_COUNT 0x500 // Latin, Greek and Cyrillic: indexed directly
+#define GLYPH_KERN_FIRST 0x20   // Printable ASCII pairs: a dense kerning table
+#define GLYPH_KERN_COUNT 0x60
+
 enum class FontMode { SMART, INTER_ONLY, FALLBACK_ONLY };
 
 class TextRenderer {
@@ -32,26 +40,38 @@ public:
   bool LoadFont(float scale);
 
   void SetFontMode(FontMode mode);
+  FontMode GetFontMode() const { return currentMode; }
 
+  // emphasis is TEXT_BOLD/TEXT_ITALIC; those fonts are opened on first use
   void RenderText(const char *text, int x, int y, uint32_t color,
-                  TextStyle style = TextStyle::NORMAL, float angle = 0.0f);
+                  TextStyle style = TextStyle::NORMAL, float angle = 0.0f,
+                  uint8_t emphasis = 0);
   void RenderTextWithKey(const char *text, uint64_t key, int x, int y,
                          uint32_t color, TextStyle style = TextStyle::NORMAL,
-                         float angle = 0.0f);
+                         float angle = 0.0f, uint8_t emphasis = 0);
 
   void RenderTextCentered(const char *text, int y, uint32_t color,
                           TextStyle style = TextStyle::NORMAL,
-                          float angle = 0.0f);
+                          float angle = 0.0f, uint8_t emphasis = 0);
   void RenderTextCenteredWithKey(const char *text, uint64_t key, int y,
                                  uint32_t color,
                                  TextStyle style = TextStyle::NORMAL,
-                                 float angle = 0.0f);
-
-  int MeasureTextWidth(const char *text, TextStyle style = TextStyle::NORMAL);
-  int MeasureTextWidthWithKey(const char *text, uint64_t key, TextStyle style);
+                                 float angle = 0.0f, uint8_t emphasis = 0);
+
+  int MeasureTextWidth(const char *text, TextStyle style = TextStyle::NORMAL,
+                       uint8_t emphasis = 0);
+  int MeasureTextWidthWithKey(const char *text, uint64_t key, TextStyle style,
+                              uint8_t emphasis = 0);
+  // Unterminated text (a tokenized word), summed from glyph advances
+  int MeasureWordWidth(const char *text, int len, TextStyle style,
+                       uint8_t emphasis = 0);
   int GetLineHeight(TextStyle style = TextStyle::NORMAL);
+  // Font text is drawn and measured with; *face tells which one it is
+  TTF_Font *GetFont(const char *text, int len, TextStyle style,
+                    uint8_t emphasis, int *face = nullptr);
 
-  uint64_t GetCacheKey(const char *text, TextStyle style);
+  uint64_t GetCacheKey(const char *text, TextStyle style,
+                       uint8_t emphasis = 0);
 
   float GetFontScale() const { return fontScale; }
 
@@ -67,6 +87,9 @@ private:
   SDL_Renderer *renderer;
   std::unordered_map<TextStyle, TTF_Font *> fonts;
   std::unordered_map<TextStyle, TTF_Font *> fallbackFonts;
+  // Bold/italic faces keyed by VariantKey(); nullptr records a failed open
+  std::unordered_map<int, TTF_Font *> variantFonts;
+  int fontSizes[6]; // Point size per TextStyle at the current scale
   float fontScale;
   FontMode currentMode;
 
@@ -86,8 +109,32 @@ private:
   std::unordered_map<uint64_t, MetricsEntry> metricsCache;
   std::list<uint64_t> metricsLruList;
 
+  // Per-face glyph metrics, filled in as glyphs are first measured. A width
+  // is then what TTF_SizeUTF8 computes, without converting or shaping the
+  // text: advances and kerning summed, widened by the glyphs' overhang.
+  struct GlyphMetrics {
+    int16_t advance; // GLYPH_UNKNOWN until measured
+    int16_t minx;
+    int16_t maxx;
+  };
+  struct GlyphTable {
+    TTF_Font *font;
+    std::vector<GlyphMetrics> dense;                  // GLYPH_DENSE_COUNT
+    std::unordered_map<uint32_t, GlyphMetrics> wide;  // CJK and the rest
+    std::vector<int8_t> asciiKerning;                 // GLYPH_KERN_COUNT^2
+    std::unordered_map<uint64_t, int8_t> kerning;     // Other pairs
+  };
+  // Keyed like variantFonts, by the face text is measured with
+  std::unordered_map<int, GlyphTable> glyphTables;
+
   void CleanupCache();
   void CloseFonts();
+  GlyphTable *GetGlyphTable(const char *text, int len, TextStyle style,
+                            uint8_t emphasis);
+  const GlyphMetrics &Glyph(GlyphTable &table, uint32_t cp);
+  int Kerning(GlyphTable &table, uint32_t prev, uint32_t cp);
+  int SumAdvances(GlyphTable &table, const char *text, int len);
+  TTF_Font *GetVariant(TextStyle style, uint8_t emphasis, bool fallback);
   // Use a combined hash of string + style for faster lookups
   // uint64_t GetCacheKey(const char *text, TextStyle style); // Moved to public
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#define TOKEN_MAX 8192 // Distinct tokens per chapter
+#define TOKEN_SLOTS (TOKEN_MAX * 2)
+#define TOKEN_NONE 0xFFFF
+
+// Per-chapter dictionary of distinct tokens: a word's bytes together with the
+// TextStyle and emphasis it is drawn in, so one width fits every occurrence.
+// IDs are dense from 0, which lets layout keep widths in a plain array
+// indexed by token. Like the renderer's metrics cache, tokens are told apart
+// by a 64-bit hash rather than their text. Once TOKEN_MAX is reached, new
+// words get TOKEN_NONE and are measured one by one.
+class TokenTable {
+public:
+  TokenTable();
+
+  void Clear();
+  uint16_t Intern(const char *text, int len, uint8_t style, uint8_t emphasis);
+  int GetCount() const { return count; }
+
+private:
+  uint64_t keys[TOKEN_MAX];
+  uint16_t slots[TOKEN_SLOTS]; // Token IDs; TOKEN_NONE marks an empty slot
+  int count;
+};
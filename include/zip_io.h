@@ -0,0 +1,133 @@
+#pragma once
+
+#include "async_read.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ZIP_IO_SECTOR_SIZE 512
+#define ZIP_IO_DEFAULT_BLOCK_SIZE 16384
+#define ZIP_IO_DEFAULT_BLOCK_COUNT 4
+#define ZIP_IO_MAX_PENDING 4 // Background reads in flight per archive
+
+// Raw positional file access underneath the zip reader
+class FileBackend {
+public:
+  virtual ~FileBackend() {}
+
+  virtual bool Open(const char *path) = 0;
+  virtual void Close() = 0;
+  virtual uint64_t Size() const = 0;
+  virtual size_t ReadAt(uint64_t offset, void *buf, size_t size) = 0;
+};
+
+// Unbuffered stdio; the read-ahead cache above it is the only buffering
+class StdioFileBackend : public FileBackend {
+public:
+  StdioFileBackend();
+  ~StdioFileBackend();
+
+  bool Open(const char *path) override;
+  void Close() override;
+  uint64_t Size() const override { return size; }
+  size_t ReadAt(uint64_t offset, void *buf, size_t size) override;
+
+private:
+  FILE *file;
+  uint64_t size;
+  uint64_t position; // Skips the seek for back-to-back sequential reads
+};
+
+// Adds a fixed cost to every read to mimic Memory Stick seek latency when
+// profiling on a host machine
+class ThrottledFileBackend : public StdioFileBackend {
+public:
+  explicit ThrottledFileBackend(uint32_t latencyUs) : latencyUs(latencyUs) {}
+
+  size_t ReadAt(uint64_t offset, void *buf, size_t size) override;
+
+private:
+  uint32_t latencyUs;
+};
+
+struct ZipIoStats {
+  uint32_t reads;        // Requests from miniz
+  uint64_t bytes;        // Bytes delivered to miniz
+  uint32_t hits;         // Requests served entirely from cache
+  uint32_t backendReads; // Calls into the FileBackend
+  uint64_t backendBytes;
+  uint32_t asyncReads; // Backend reads that ran on the async service
+  uint32_t asyncWaits; // Times a blocking Read had to wait for one
+};
+
+// Sector-aligned read-ahead cache installed as miniz's m_pRead callback.
+// Small scattered reads (central directory, local headers) are served from
+// a handful of aligned blocks; reads covering whole blocks go straight
+// through to the backend.
+//
+// With an AsyncReadService attached, Prefetch() loads upcoming blocks on the
+// service's thread and SubmitRead() reads into a caller buffer there. ZipIo
+// never touches the backend itself while one of those is in flight; a
+// blocking Read that needs the disk waits for them first.
+class ZipIo {
+public:
+  ZipIo();
+  ~ZipIo();
+
+  // blockSize is rounded up to a multiple of ZIP_IO_SECTOR_SIZE
+  void Configure(uint32_t blockSize, int blockCount);
+  void SetBackend(FileBackend *backend); // nullptr = built-in stdio backend
+
+  bool Open(const char *path);
+  void Close();
+
+  uint64_t Size() const { return backend ? backend->Size() : 0; }
+  size_t Read(uint64_t offset, void *buf, size_t size);
+
+  void SetAsyncService(AsyncReadService *service); // nullptr = blocking only
+  // Start caching the blocks under [offset, offset + size) in the background.
+  // No-op without a service or for blocks already cached or in flight.
+  void Prefetch(uint64_t offset, size_t size);
+  // 0 if it can't be queued; use a blocking Read instead
+  AsyncReadId SubmitRead(uint64_t offset, void *buf, size_t size,
+                         int priority);
+  AsyncReadStatus PollRead(AsyncReadId id, size_t *bytesRead);
+  void CancelRead(AsyncReadId id); // buf is no longer written once this returns
+
+  uint32_t GetBlockSize() const { return blockSize; }
+  const ZipIoStats &GetStats() const { return stats; }
+
+private:
+  StdioFileBackend stdioBackend;
+  FileBackend *customBackend;
+  FileBackend *backend; // Active while open
+
+  uint32_t blockSize;
+  int blockCount;
+  uint8_t *blockData;
+  uint64_t *blockTags; // Block number held by each slot
+  uint32_t *blockAges; // LRU stamps
+  uint32_t clock;
+
+  ZipIoStats stats;
+
+  struct PendingRead {
+    AsyncReadId id;
+    int slot;         // Cache slot being filled, or -1 for SubmitRead
+    uint64_t blockNo; // Prefetches only
+    bool finished;    // SubmitRead result waiting for PollRead
+    AsyncReadStatus status;
+    size_t bytes;
+  };
+  AsyncReadService *asyncService;
+  PendingRead pending[ZIP_IO_MAX_PENDING];
+  int pendingCount;
+
+  int FindBlock(uint64_t blockNo);
+  int LoadBlock(uint64_t blockNo);
+  bool IsInFlight() const;
+  bool IsSlotPending(int slot) const;
+  bool IsBlockPending(uint64_t blockNo) const;
+  void Settle(bool wait); // Collect finished background reads
+  void CancelAll();
+};
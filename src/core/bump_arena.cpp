@@ -0,0 +1,147 @@
+#include "bump_arena.h"
+#include "pugixml.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#define ALIGN_UP(n) (((n) + BUMP_ARENA_ALIGN - 1) & ~(size_t)(BUMP_ARENA_ALIGN - 1))
+#define CHUNK_HEADER ALIGN_UP(sizeof(Chunk))
+
+BumpArena::BumpArena(size_t chunkSize)
+    : chunks(nullptr), chunkSize(chunkSize), nextChunkSize(0), used(0) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+BumpArena::~BumpArena() { Release(); }
+
+void *BumpArena::Alloc(size_t size) {
+  size = ALIGN_UP(size > 0 ? size : 1);
+
+  if (!chunks || used + size > chunks->size) {
+    // Chunks start small and double, so a tiny parse (metadata-only opens)
+    // doesn't pin a full chunk
+    if (nextChunkSize == 0)
+      nextChunkSize = BUMP_ARENA_FIRST_CHUNK < chunkSize ? BUMP_ARENA_FIRST_CHUNK
+                                                         : chunkSize;
+    // Oversized requests (pugixml's DOM pages, mostly) get a chunk of their
+    // own, linked behind the head so the head keeps bumping
+    bool dedicated = size > nextChunkSize / 2;
+    size_t usable = dedicated ? size : nextChunkSize;
+    Chunk *chunk = (Chunk *)malloc(CHUNK_HEADER + usable);
+    if (!chunk)
+      return nullptr;
+    chunk->size = usable;
+    stats.chunks++;
+    stats.bytesMapped += CHUNK_HEADER + usable;
+
+    if (dedicated && chunks) {
+      chunk->next = chunks->next;
+      chunks->next = chunk;
+      stats.allocs++;
+      stats.bytesUsed += size;
+      return (uint8_t *)chunk + CHUNK_HEADER;
+    }
+    chunk->next = chunks;
+    chunks = chunk;
+    used = 0;
+    if (!dedicated && nextChunkSize < chunkSize)
+      nextChunkSize *= 2;
+  }
+
+  void *p = (uint8_t *)chunks + CHUNK_HEADER + used;
+  used += size;
+  stats.allocs++;
+  stats.bytesUsed += size;
+  return p;
+}
+
+char *BumpArena::Strdup(const char *s) {
+  size_t len = strlen(s);
+  char *copy = (char *)Alloc(len + 1);
+  if (copy)
+    memcpy(copy, s, len + 1);
+  return copy;
+}
+
+void BumpArena::Release() {
+  while (chunks) {
+    Chunk *next = chunks->next;
+    free(chunks);
+    chunks = next;
+  }
+  used = 0;
+  nextChunkSize = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+// pugixml ---------------------------------------------------------------------
+
+static BumpArena *pugiArena = nullptr;
+
+static void *PugiArenaAlloc(size_t size) { return pugiArena->Alloc(size); }
+
+static void PugiArenaFree(void *) {
+  // Reclaimed with the arena
+}
+
+PugiArenaScope::PugiArenaScope(BumpArena &arena)
+    : previousAlloc(pugi::get_memory_allocation_function()),
+      previousFree(pugi::get_memory_deallocation_function()),
+      previousArena(pugiArena) {
+  pugiArena = &arena;
+  pugi::set_memory_management_functions(PugiArenaAlloc, PugiArenaFree);
+}
+
+PugiArenaScope::~PugiArenaScope() {
+  pugiArena = previousArena;
+  pugi::set_memory_management_functions(previousAlloc, previousFree);
+}
+
+// ArenaStringTable ------------------------------------------------------------
+
+ArenaStringTable::ArenaStringTable(BumpArena &arena)
+    : arena(arena), entries(nullptr), count(0), capacity(0) {}
+
+void ArenaStringTable::Add(const char *key, const char *value) {
+  if (count == capacity) {
+    // The old array stays in the arena; growth is geometric so the waste is
+    // bounded by the final size
+    int grown = capacity ? capacity * 2 : 64;
+    Entry *bigger = (Entry *)arena.Alloc(sizeof(Entry) * grown);
+    if (!bigger)
+      return;
+    if (count > 0)
+      memcpy(bigger, entries, sizeof(Entry) * count);
+    entries = bigger;
+    capacity = grown;
+  }
+
+  Entry &e = entries[count];
+  e.key = arena.Strdup(key);
+  e.value = arena.Strdup(value);
+  e.order = count;
+  if (e.key && e.value)
+    count++;
+}
+
+void ArenaStringTable::Seal() {
+  std::sort(entries, entries + count, [](const Entry &a, const Entry &b) {
+    int c = strcmp(a.key, b.key);
+    return c < 0 || (c == 0 && a.order < b.order);
+  });
+}
+
+const char *ArenaStringTable::Find(const char *key) const {
+  // Lower bound: the earliest-added entry among equal keys
+  int lo = 0, hi = count;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (strcmp(entries[mid].key, key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < count && strcmp(entries[lo].key, key) == 0)
+    return entries[lo].value;
+  return nullptr;
+}
@@ -0,0 +1,280 @@
+#include "layout_cache.h"
+#include "debug_logger.h"
+#include <cstring>
+#include <sys/stat.h>
+
+struct LayoutFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t bookSize; // The book the lines were laid out from
+  uint32_t bookMtime;
+};
+
+struct LayoutEntryHeader {
+  int32_t chapter;
+  uint32_t key;
+  uint32_t size; // Payload bytes that follow
+  uint32_t lineCount;
+  uint32_t pageCount;
+};
+
+// Fewest payload bytes a line is stored in: five one-byte fields with no
+// spans. A page anchor takes at least one.
+#define LAYOUT_LINE_MIN_BYTES 5
+
+static void PutVarint(std::vector<uint8_t> &out, uint32_t v) {
+  while (v >= 0x80) {
+    out.push_back((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((uint8_t)v);
+}
+
+static bool GetVarint(const uint8_t *&p, const uint8_t *end, uint32_t *v) {
+  uint32_t result = 0;
+  for (int shift = 0; shift < 35 && p < end; shift += 7) {
+    uint8_t b = *p++;
+    result |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      *v = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool GetByte(const uint8_t *&p, const uint8_t *end, uint8_t *v) {
+  if (p == end)
+    return false;
+  *v = *p++;
+  return true;
+}
+
+LayoutCache::LayoutCache() : bookSize(0), bookMtime(0) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+LayoutCache::~LayoutCache() { Close(); }
+
+bool LayoutCache::Open(const char *bookPath) {
+  Close();
+  struct stat st;
+  if (stat(bookPath, &st) != 0)
+    return false;
+  path = std::string(bookPath) + ".lay";
+  bookSize = (uint32_t)st.st_size;
+  bookMtime = (uint32_t)st.st_mtime;
+
+  FILE *f = fopen(path.c_str(), "rb");
+  LayoutFileHeader header;
+  if (!f || fread(&header, sizeof(header), 1, f) != 1 ||
+      memcmp(header.magic, "EPLY", 4) != 0 ||
+      header.version != LAYOUT_CACHE_VERSION || header.bookSize != bookSize ||
+      header.bookMtime != bookMtime) {
+    if (f)
+      fclose(f);
+    return Restart();
+  }
+
+  fseek(f, 0, SEEK_END);
+  uint32_t fileEnd = (uint32_t)ftell(f);
+  uint32_t offset = sizeof(header);
+  fseek(f, offset, SEEK_SET);
+  LayoutEntryHeader e;
+  bool ok = true;
+  while (offset < fileEnd) {
+    if (fileEnd - offset < sizeof(e) || fread(&e, sizeof(e), 1, f) != 1 ||
+        e.size > fileEnd - offset - sizeof(e)) {
+      ok = false; // Cut short by a write that didn't finish
+      break;
+    }
+    // Counts Load() allocates for: no more than the payload can hold
+    if (e.lineCount > LAYOUT_CACHE_MAX_LINES || e.pageCount > e.size ||
+        e.lineCount > (e.size - e.pageCount) / LAYOUT_LINE_MIN_BYTES) {
+      DebugLogger::Log("Layout cache: Ch %d entry corrupt", e.chapter);
+      ok = false;
+      break;
+    }
+    offset += sizeof(e);
+    int old = Find(e.chapter, e.key);
+    if (old >= 0)
+      entries.erase(entries.begin() + old); // Superseded
+    Entry entry = {e.chapter, e.key, offset, e.size, e.lineCount,
+                   e.pageCount};
+    entries.push_back(entry);
+    offset += e.size;
+    fseek(f, offset, SEEK_SET);
+  }
+  fclose(f);
+  if (!ok)
+    return Restart();
+
+  stats.fileBytes = offset;
+  stats.entries = (int)entries.size();
+  DebugLogger::Log("Layout cache: %d entries, %u KB", stats.entries,
+                   stats.fileBytes / 1024);
+  return true;
+}
+
+void LayoutCache::Close() {
+  if (!path.empty()) {
+    DebugLogger::Log("Layout cache: %u hits, %u misses, %u stored",
+                     stats.hits, stats.misses, stats.stores);
+  }
+  path.clear();
+  entries.clear();
+  std::vector<uint8_t>().swap(scratch);
+  memset(&stats, 0, sizeof(stats));
+}
+
+// Empty file for this copy of the book
+bool LayoutCache::Restart() {
+  entries.clear();
+  stats.fileBytes = 0;
+  stats.entries = 0;
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f) {
+    DebugLogger::Log("Could not write layout cache: %s", path.c_str());
+    return false;
+  }
+  LayoutFileHeader header;
+  memcpy(header.magic, "EPLY", 4);
+  header.version = LAYOUT_CACHE_VERSION;
+  header.bookSize = bookSize;
+  header.bookMtime = bookMtime;
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+  fclose(f);
+  stats.fileBytes = sizeof(header);
+  return ok;
+}
+
+int LayoutCache::Find(int chapter, uint32_t key) const {
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (entries[i].chapter == chapter && entries[i].key == key)
+      return (int)i;
+  }
+  return -1;
+}
+
+bool LayoutCache::Load(int chapter, uint32_t key,
+                       std::vector<LayoutLine> &lines,
+                       std::vector<int> &pageAnchors) {
+  int slot = path.empty() ? -1 : Find(chapter, key);
+  if (slot < 0) {
+    stats.misses++;
+    return false;
+  }
+  const Entry &entry = entries[slot];
+  scratch.resize(entry.size);
+  FILE *f = fopen(path.c_str(), "rb");
+  bool ok = f && fseek(f, entry.offset, SEEK_SET) == 0 &&
+            fread(scratch.data(), 1, entry.size, f) == entry.size;
+  if (f)
+    fclose(f);
+
+  // Lines: words skipped since the last one, word count, style, width and
+  // spans. Then the page anchors, as deltas.
+  const uint8_t *p = scratch.data();
+  const uint8_t *end = p + entry.size;
+  lines.resize(entry.lineCount);
+  int word = 0;
+  for (uint32_t i = 0; ok && i < entry.lineCount; i++) {
+    LayoutLine &line = lines[i];
+    uint32_t skip = 0, count = 0, width = 0;
+    ok = GetVarint(p, end, &skip) && GetVarint(p, end, &count) &&
+         GetByte(p, end, &line.style) && GetByte(p, end, &line.spanCount) &&
+         GetVarint(p, end, &width) && line.spanCount <= LINE_MAX_SPANS;
+    line.startWord = word + (int)skip;
+    line.wordCount = (uint16_t)count;
+    line.width = (int16_t)width;
+    word = line.startWord + line.wordCount;
+    for (int s = 0; ok && s < line.spanCount; s++) {
+      uint32_t x = 0;
+      ok = GetByte(p, end, &line.spans[s].start) &&
+           GetByte(p, end, &line.spans[s].emphasis) && GetVarint(p, end, &x);
+      line.spans[s].x = (int16_t)x;
+    }
+  }
+  pageAnchors.resize(entry.pageCount);
+  word = 0;
+  for (uint32_t i = 0; ok && i < entry.pageCount; i++) {
+    uint32_t delta = 0;
+    ok = GetVarint(p, end, &delta);
+    word += (int)delta;
+    pageAnchors[i] = word;
+  }
+
+  if (!ok || p != end) {
+    DebugLogger::Log("Layout cache: Ch %d entry unreadable", chapter);
+    entries.erase(entries.begin() + slot);
+    lines.clear();
+    pageAnchors.assign(1, 0);
+    stats.misses++;
+    return false;
+  }
+  stats.hits++;
+  DebugLogger::Log("Layout cache: Ch %d hit, %u lines (%u of %u lookups hit)",
+                   chapter, entry.lineCount, stats.hits,
+                   stats.hits + stats.misses);
+  return true;
+}
+
+void LayoutCache::Store(int chapter, uint32_t key,
+                        const std::vector<LayoutLine> &lines,
+                        const std::vector<int> &pageAnchors) {
+  if (path.empty() || lines.size() > LAYOUT_CACHE_MAX_LINES)
+    return;
+
+  scratch.clear();
+  int word = 0;
+  for (size_t i = 0; i < lines.size(); i++) {
+    const LayoutLine &line = lines[i];
+    PutVarint(scratch, (uint32_t)(line.startWord - word));
+    PutVarint(scratch, line.wordCount);
+    scratch.push_back(line.style);
+    scratch.push_back(line.spanCount);
+    PutVarint(scratch, (uint16_t)line.width);
+    for (int s = 0; s < line.spanCount; s++) {
+      scratch.push_back(line.spans[s].start);
+      scratch.push_back(line.spans[s].emphasis);
+      PutVarint(scratch, (uint16_t)line.spans[s].x);
+    }
+    word = line.startWord + line.wordCount;
+  }
+  word = 0;
+  for (size_t i = 0; i < pageAnchors.size(); i++) {
+    PutVarint(scratch, (uint32_t)(pageAnchors[i] - word));
+    word = pageAnchors[i];
+  }
+
+  LayoutEntryHeader e;
+  e.chapter = chapter;
+  e.key = key;
+  e.size = (uint32_t)scratch.size();
+  e.lineCount = (uint32_t)lines.size();
+  e.pageCount = (uint32_t)pageAnchors.size();
+  if (stats.fileBytes + sizeof(e) + e.size > LAYOUT_CACHE_MAX_BYTES &&
+      !Restart())
+    return;
+
+  FILE *f = fopen(path.c_str(), "ab");
+  if (!f)
+    return;
+  bool ok = fwrite(&e, sizeof(e), 1, f) == 1 &&
+            fwrite(scratch.data(), 1, e.size, f) == e.size;
+  fclose(f);
+  if (!ok) {
+    Restart(); // Don't leave a partial entry for the next Open
+    return;
+  }
+
+  int old = Find(chapter, key);
+  if (old >= 0)
+    entries.erase(entries.begin() + old);
+  Entry entry = {chapter, key, stats.fileBytes + (uint32_t)sizeof(e), e.size,
+                 e.lineCount, e.pageCount};
+  entries.push_back(entry);
+  stats.fileBytes += sizeof(e) + e.size;
+  stats.entries = (int)entries.size();
+  stats.stores++;
+}
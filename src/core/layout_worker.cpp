@@ -0,0 +1,340 @@
+#include "layout_worker.h"
+#include "debug_logger.h"
+#include <SDL2/SDL.h>
+#include <cstring>
+
+LayoutWorker::LayoutWorker()
+    : feedHead(0), feedTail(0), textTail(0), textHead(0), endFed(false),
+      lineHead(0), lineTail(0), jobSerial(0), workerSerial(0), hasJob(false),
+      busy(false), stopping(false), generation(0), widthsEpoch(0),
+      measured(0), nextWord(0), done(false), lineFill(0), lineLen(0),
+      lineX(0), emitted(0), thread(nullptr), mutex(nullptr), wake(nullptr),
+      progress(nullptr) {
+  memset(&job, 0, sizeof(job));
+  memset(&current, 0, sizeof(current));
+  memset(&line, 0, sizeof(line));
+}
+
+LayoutWorker::~LayoutWorker() { Stop(); }
+
+bool LayoutWorker::Start() {
+  if (thread)
+    return true;
+
+  // Initialized here, on the main thread: TTF_Init isn't thread-safe
+  if (!renderer.Initialize(nullptr))
+    return false;
+  mutex = SDL_CreateMutex();
+  wake = SDL_CreateCond();
+  progress = SDL_CreateCond();
+  stopping = false;
+  if (mutex && wake && progress) {
+    thread = SDL_CreateThread(WorkerMain, "Layout", this);
+  }
+  if (!thread) {
+    DebugLogger::Log("Layout worker failed to start: %s", SDL_GetError());
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+void LayoutWorker::Stop() {
+  if (thread) {
+    SDL_LockMutex((SDL_mutex *)mutex);
+    stopping = true;
+    SDL_CondSignal((SDL_cond *)wake);
+    SDL_UnlockMutex((SDL_mutex *)mutex);
+    SDL_WaitThread((SDL_Thread *)thread, nullptr);
+    thread = nullptr;
+    renderer.Shutdown();
+  }
+  if (progress)
+    SDL_DestroyCond((SDL_cond *)progress);
+  if (wake)
+    SDL_DestroyCond((SDL_cond *)wake);
+  if (mutex)
+    SDL_DestroyMutex((SDL_mutex *)mutex);
+  progress = wake = mutex = nullptr;
+}
+
+void LayoutWorker::Cancel() {
+  if (!thread)
+    return;
+  SDL_LockMutex((SDL_mutex *)mutex);
+  hasJob = false;
+  generation.store(generation.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  SDL_CondSignal((SDL_cond *)wake);
+  while (busy)
+    SDL_CondWait((SDL_cond *)progress, (SDL_mutex *)mutex);
+
+  // The worker is parked and the next job starts from empty rings
+  feedHead.store(0, std::memory_order_relaxed);
+  feedTail.store(0, std::memory_order_relaxed);
+  textTail.store(0, std::memory_order_relaxed);
+  lineHead.store(0, std::memory_order_relaxed);
+  lineTail.store(0, std::memory_order_relaxed);
+  textHead = 0;
+  endFed = false;
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+}
+
+void LayoutWorker::Begin(const LayoutJob &job) {
+  if (!thread)
+    return;
+  Cancel();
+  SDL_LockMutex((SDL_mutex *)mutex);
+  this->job = job;
+  jobSerial++;
+  hasJob = true;
+  SDL_CondSignal((SDL_cond *)wake);
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+}
+
+int LayoutWorker::Feed(const ChapterBuffer &chapter, int from,
+                       int *runCursor) {
+  if (!thread || endFed)
+    return from;
+
+  uint32_t head = feedHead.load(std::memory_order_relaxed);
+  uint32_t tail = feedTail.load(std::memory_order_acquire);
+  uint32_t freed = textTail.load(std::memory_order_acquire);
+  int count = chapter.WordCount();
+  int i = from;
+  for (; i < count && head - tail < LAYOUT_FEED_WORDS; i++) {
+    int len = chapter.wordLens[i];
+    uint32_t pos = textHead;
+    if (pos % LAYOUT_FEED_BYTES + len > LAYOUT_FEED_BYTES)
+      pos += LAYOUT_FEED_BYTES - pos % LAYOUT_FEED_BYTES; // Kept contiguous
+    if (pos + len - freed > LAYOUT_FEED_BYTES)
+      break;
+    const StyleRun &run = chapter.RunAt(i, runCursor);
+    LayoutWord &word = feedWords[head % LAYOUT_FEED_WORDS];
+    word.textPos = pos;
+    word.token = chapter.wordTokens[i];
+    word.len = (uint8_t)len;
+    word.flags = chapter.wordFlags[i];
+    word.style = run.style;
+    word.emphasis = run.emphasis;
+    memcpy(feedText + pos % LAYOUT_FEED_BYTES, chapter.WordText(i), len);
+    textHead = pos + len;
+    head++;
+  }
+  if (i == count && chapter.IsComplete() &&
+      head - tail < LAYOUT_FEED_WORDS) {
+    LayoutWord &end = feedWords[head % LAYOUT_FEED_WORDS];
+    memset(&end, 0, sizeof(end));
+    end.textPos = textHead;
+    end.token = TOKEN_NONE;
+    end.flags = LAYOUT_WORD_END;
+    head++;
+    endFed = true;
+  }
+
+  if (head != feedHead.load(std::memory_order_relaxed)) {
+    feedHead.store(head, std::memory_order_release);
+    SDL_LockMutex((SDL_mutex *)mutex);
+    SDL_CondSignal((SDL_cond *)wake);
+    SDL_UnlockMutex((SDL_mutex *)mutex);
+  }
+  return i;
+}
+
+const LayoutLine *LayoutWorker::Peek(bool wait) {
+  if (!thread)
+    return nullptr;
+  uint32_t tail = lineTail.load(std::memory_order_relaxed);
+  if (wait && lineHead.load(std::memory_order_acquire) == tail) {
+    SDL_LockMutex((SDL_mutex *)mutex);
+    while (lineHead.load(std::memory_order_acquire) == tail &&
+           (busy || HasWork()))
+      SDL_CondWait((SDL_cond *)progress, (SDL_mutex *)mutex);
+    SDL_UnlockMutex((SDL_mutex *)mutex);
+  }
+  if (lineHead.load(std::memory_order_acquire) == tail)
+    return nullptr;
+  return &lines[tail % LAYOUT_RING_LINES];
+}
+
+void LayoutWorker::Pop() {
+  uint32_t tail = lineTail.load(std::memory_order_relaxed) + 1;
+  // Stored before lineHead is loaded, and the worker publishes before it
+  // loads lineTail (all seq_cst): if it saw the ring full, this sees the
+  // lines it published, so a worker waiting for room is always woken
+  lineTail.store(tail, std::memory_order_seq_cst);
+  if (lineHead.load(std::memory_order_seq_cst) - tail ==
+      LAYOUT_RING_LINES - 1) {
+    // The worker may be waiting for room
+    SDL_LockMutex((SDL_mutex *)mutex);
+    SDL_CondSignal((SDL_cond *)wake);
+    SDL_UnlockMutex((SDL_mutex *)mutex);
+  }
+}
+
+// Caller holds the mutex. A job not taken up yet, or words to lay out and
+// room for the lines.
+bool LayoutWorker::HasWork() const {
+  if (!hasJob)
+    return false;
+  if (workerSerial != jobSerial)
+    return true;
+  return feedHead.load(std::memory_order_acquire) !=
+             feedTail.load(std::memory_order_acquire) &&
+         lineHead.load(std::memory_order_acquire) -
+                 lineTail.load(std::memory_order_seq_cst) <
+             LAYOUT_RING_LINES;
+}
+
+void LayoutWorker::StartJob() {
+  renderer.LoadFont(current.fontScale);
+  renderer.SetFontMode(current.fontMode);
+  if (current.widthsEpoch != widthsEpoch) {
+    memset(widths, -1, sizeof(widths));
+    measured.store(0, std::memory_order_relaxed);
+    widthsEpoch = current.widthsEpoch;
+  }
+  nextWord = current.startWord;
+  done = false;
+  line.wordCount = 0;
+  line.spanCount = 0;
+  lineFill = lineLen = lineX = 0;
+  emitted = 0;
+}
+
+int LayoutWorker::Measure(const LayoutWord &word) {
+  if (word.token != TOKEN_NONE && widths[word.token] >= 0)
+    return widths[word.token];
+  int w = renderer.MeasureWordWidth(
+      feedText + word.textPos % LAYOUT_FEED_BYTES, word.len,
+      (TextStyle)word.style, word.emphasis);
+  if (word.token != TOKEN_NONE) {
+    widths[word.token] = w;
+    measured.store(measured.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  }
+  return w;
+}
+
+// The same greedy filling as fillLine() in the main loop, with the width
+// and spans worked out as processLayout() does when it copies the text
+void LayoutWorker::AddWord(const LayoutWord &word) {
+  int wordW = Measure(word);
+  bool glued = (word.flags & WORD_GLUED) != 0;
+  int spaceW = (lineFill == 0 || glued) ? 0 : current.spaceWidths[word.style];
+  if (lineFill + spaceW + wordW > current.maxWidth && lineFill > 0) {
+    EmitLine();
+    spaceW = 0;
+  }
+
+  if (line.wordCount == 0) {
+    line.startWord = nextWord;
+    line.style = word.style;
+  }
+  lineFill += spaceW + wordW;
+  if (lineLen + word.len + 2 < MAX_LINE_LEN) {
+    if (line.wordCount > 0 && !glued) {
+      lineLen++;
+      lineX += current.spaceWidths[word.style];
+    }
+    if (line.spanCount == 0 ||
+        (word.emphasis != line.spans[line.spanCount - 1].emphasis &&
+         line.spanCount < LINE_MAX_SPANS)) {
+      LineSpan &span = line.spans[line.spanCount++];
+      span.start = (uint8_t)lineLen;
+      span.emphasis = word.emphasis;
+      span.x = (int16_t)lineX;
+    }
+    lineLen += word.len;
+    lineX += wordW;
+  }
+  line.wordCount++;
+}
+
+void LayoutWorker::EmitLine() {
+  if (line.wordCount == 0)
+    return;
+  line.width = (int16_t)lineX;
+  lines[emitted % LAYOUT_RING_LINES] = line;
+  emitted++;
+  line.wordCount = 0;
+  line.spanCount = 0;
+  lineFill = lineLen = lineX = 0;
+  if (emitted - lineHead.load(std::memory_order_relaxed) >=
+      LAYOUT_BATCH_LINES)
+    Publish();
+}
+
+void LayoutWorker::Publish() {
+  if (emitted == lineHead.load(std::memory_order_relaxed))
+    return;
+  lineHead.store(emitted, std::memory_order_seq_cst); // See Pop()
+  SDL_LockMutex((SDL_mutex *)mutex);
+  SDL_CondBroadcast((SDL_cond *)progress);
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+}
+
+void LayoutWorker::Run() {
+  uint32_t gen = generation.load(std::memory_order_relaxed);
+  uint32_t tail = feedTail.load(std::memory_order_relaxed);
+  while (!done) {
+    if (generation.load(std::memory_order_relaxed) != gen)
+      return; // Cancelled: the rings are about to be emptied
+    if (tail == feedHead.load(std::memory_order_acquire))
+      break; // Out of words; the line so far waits for the next ones
+    // Any word can finish a line, so only go on with room for one
+    if (emitted - lineTail.load(std::memory_order_acquire) >=
+        LAYOUT_RING_LINES)
+      break;
+
+    const LayoutWord &word = feedWords[tail % LAYOUT_FEED_WORDS];
+    if (word.flags & LAYOUT_WORD_END) {
+      EmitLine();
+      done = true;
+    } else if (word.flags & WORD_NEWLINE) {
+      EmitLine();
+      nextWord++;
+    } else {
+      AddWord(word);
+      nextWord++;
+    }
+    tail++;
+    textTail.store(word.textPos + word.len, std::memory_order_release);
+    feedTail.store(tail, std::memory_order_release);
+  }
+  Publish();
+}
+
+int LayoutWorker::WorkerMain(void *self) {
+  LayoutWorker *worker = (LayoutWorker *)self;
+  SDL_mutex *mutex = (SDL_mutex *)worker->mutex;
+  // Below the main loop, which then never waits on layout for a frame
+  SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+
+  SDL_LockMutex(mutex);
+  while (!worker->stopping) {
+    if (!worker->HasWork()) {
+      worker->busy = false;
+      SDL_CondBroadcast((SDL_cond *)worker->progress);
+      SDL_CondWait((SDL_cond *)worker->wake, mutex);
+      continue;
+    }
+    bool fresh = worker->workerSerial != worker->jobSerial;
+    if (fresh) {
+      worker->current = worker->job;
+      worker->workerSerial = worker->jobSerial;
+    }
+    worker->busy = true;
+    SDL_UnlockMutex(mutex);
+
+    if (fresh)
+      worker->StartJob();
+    worker->Run();
+
+    SDL_LockMutex(mutex);
+  }
+  worker->busy = false;
+  SDL_CondBroadcast((SDL_cond *)worker->progress);
+  SDL_UnlockMutex(mutex);
+  return 0;
+}
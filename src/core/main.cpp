@@ -1,9 +1,14 @@
+#include "async_read.h"
+#include "chapter_cache.h"
+#include "chapter_prefetcher.h"
 #include "cover_renderer.h"
 #include "debug_logger.h"
 #include "epub_reader.h"
-#include "html_text_extractor.h"
 #include "input_handler.h"
+#include "layout_cache.h"
+#include "layout_worker.h"
 #include "library_manager.h"
+#include "perf_timer.h"
 #include "power_utils.h"
 #include "settings_manager.h"
 #include "text_renderer.h"
@@ -13,6 +18,7 @@ static uint32_t lastInputTicks = 0;
 static PowerMode currentPowerMode = POWER_MODE_BALANCED;
 #include <SDL2/SDL_image.h>
 #include <algorithm>
+#include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -30,9 +36,10 @@ static PowerMode currentPowerMode = POWER_MODE_BALANCED;
 
 // Reader Constraints
 #define MAX_CHAPTER_LINES 5000
-#define MAX_WORDS 20000
-#define WORD_BUFFER_SIZE 262144
-#define MAX_LINE_LEN 256
+#define LAYOUT_BACKTRACK_PAGES 16 // Pages re-laid before a backward jump
+#define NOTE_MAX_LINES 6 // Lines of a footnote preview
+#define PAGINATE_FRAME_BUDGET_US 3000 // Book pagination time per idle frame
+#define PAGINATE_BYTES_PER_PAGE 1024  // Guess before any chapter is counted
 
 // Reader Layout Constants
 #define LAYOUT_MARGIN 24
@@ -41,14 +48,20 @@ static PowerMode currentPowerMode = POWER_MODE_BALANCED;
 struct LineInfo {
   char text[MAX_LINE_LEN];
   TextStyle style;
-  int startWordIdx;  // Used for anchor tracking during reflow
-  uint64_t cacheKey; // Pre-calculated render key
+  int startWordIdx;  // Chapter-wide; used for anchor tracking during reflow
+  uint64_t cacheKey; // Pre-calculated render key (single-span lines)
+  LineSpan spans[LINE_MAX_SPANS];
+  int16_t width; // Sum of the word and space widths
+  uint8_t spanCount;
 };
 
 static int layoutMargin = 24;
 static int layoutStartY = 45;
 
+// Lines of pages pageBase onwards. Long chapters slide this window forward
+// as the reader advances and rebuild it from pageAnchors when paging back.
 static LineInfo chapterLines[MAX_CHAPTER_LINES];
+static int pageBase = 0;
 static int totalLines = 0;
 static int currentLine = 0;
 static float readerFontScale = 1.0f;
@@ -65,20 +78,83 @@ struct LayoutState {
   int lineCount = 0;
   bool complete = true;
   bool needsReset = false;
+  bool stalled = false;   // Line window full until the reader moves on
   int targetWordIdx = -1; // Resume at this word after reflow
+  bool toLastPage = false;   // Show the last page once it's laid out
+  uint32_t targetAnchor = 0; // Link target not tokenized yet; see goToAnchor
   int anchorWordIdx = 0;  // First word of current page
+  int runCursor = 0;      // Hint for ChapterBuffer::RunAt()
+  uint64_t busyUs = 0;    // Spent in processLayout, for the words/s log
+  // Lines come from layoutWorker, which has been handed the words before
+  // fedWord (chapter-wide). Its widths go when widthsEpoch changes.
+  bool workerJob = false;
+  int fedWord = 0;
+  int feedRunCursor = 0;
+  uint32_t widthsEpoch = 0;
 } layoutState;
 
-static std::vector<int> pageAnchors; // wordIndex for start of each page
+static std::vector<int> pageAnchors; // Chapter-wide wordIndex for each page
 static int currentPageIdx = 0;
+
+// Every line of the chapter so far (laid out), or all of them (replayed from
+// layoutCache). Chapter-wide line n is layoutLines[n] either way.
+static LayoutCache layoutCache;
+static std::vector<LayoutLine> layoutLines;
+static bool layoutReplay = false;
+
+// Link picked on the page (index into the active chapter's links, -1 for
+// none) and a preview of what it points to
+static int selectedLink = -1;
+static int selectedLinkLine = 0; // Chapter-wide line the page started at
+static char noteLines[NOTE_MAX_LINES][MAX_LINE_LEN];
+static int noteLineCount = 0;
 static bool showStatusOverlay = false;
 static CoverRenderer coverRenderer;
 
-static char *words[MAX_WORDS];
-static int wordLens[MAX_WORDS];
-static TextStyle wordStyles[MAX_WORDS];
-static int wordWidths[MAX_WORDS]; // Cached widths for O(N) layout
-static char wordBuffer[WORD_BUFFER_SIZE];
+// Tokenized chapters: one active buffer plus spares the prefetcher fills
+// during idle frames. A chapter turn swaps pointers instead of re-inflating.
+static ChapterBuffer chapterBuffers[1 + PREFETCH_SLOTS];
+static ChapterBuffer *activeChapter = &chapterBuffers[0];
+static ChapterPrefetcher prefetcher;
+static ChapterCache chapterCache; // Recently read chapters, already tokenized
+static ThreadedAsyncReadService asyncReads; // Disk reads off the main loop
+static LayoutWorker layoutWorker; // Measuring and line breaking, likewise
+
+// Widths by token of the active chapter (-1 = unmeasured): each distinct
+// word is measured once per chapter and font, however often it occurs
+static int tokenWidths[TOKEN_MAX];
+static int tokensMeasured = 0;
+
+// Book-wide pagination for the current layout parameters, counted a spine
+// item at a time in idle frames (see paginateStep). Items not counted yet
+// are estimated from their size.
+struct BookPages {
+  uint32_t key = 0; // layoutKey() the counts are for
+  int chapter = -1; // Spine item being counted; -1 once all are
+  int counted = 0;
+  std::vector<int> pages;     // Per spine item; -1 until counted
+  std::vector<int> words;     // Per spine item; -1 until counted
+  std::vector<int> firstPage; // Book page each item starts at (estimates
+                              // included), then the total
+  std::vector<int> firstWord; // Same for words; -1 past the first uncounted
+  std::vector<int> tocPage;   // Page of each TOC entry within its item
+  std::vector<std::vector<int>> itemStarts; // Per spine item: first word of
+                                            // each page, empty if no lines
+  uint64_t countedBytes = 0;  // Size of the counted items, for estimates
+  int countedPages = 0;
+
+  // The item being counted, in its own buffer so the reader's is untouched
+  std::vector<int> pageStarts; // Chapter-wide first word of each page
+  std::vector<LayoutLine> cachedLines; // From layoutCache, if it has them
+  bool cached = false; // Lines known; only tokenized for words and anchors
+  int wordIdx = 0;             // Window-local
+  int lines = 0;
+  int runCursor = 0;
+  int measured = 0;
+  uint64_t startUs = 0;
+} bookPages;
+static ChapterBuffer paginationBuffer;
+static int paginationWidths[TOKEN_MAX];
 static int cachedSpaceWidths[6]; // Cache space width per style
 static bool spaceWidthsDirty = true;
 
@@ -115,43 +191,105 @@ bool isRedundantMetadata(const char *text, const EpubMetadata &meta) {
   return false;
 }
 
-void resetLayout(int chapterIndex, EpubReader &reader,
-                 HtmlTextExtractor &extractor) {
-  if (chapterIndex < 0)
+// Everything line breaks depend on besides the text, packed: font scale in
+// hundredths, margin, spacing preset and orientation
+static uint32_t layoutKey() {
+  return (uint32_t)lroundf(readerFontScale * 100) << 16 |
+         (uint32_t)layoutMargin << 8 |
+         (uint32_t)SettingsManager::Get().GetSettings().spacing << 1 |
+         (isRotated ? 1 : 0);
+}
+
+// Lines from the current layout position on are laid out by layoutWorker
+static void beginLayoutJob(TextRenderer &renderer, int maxWidth) {
+  LayoutJob job;
+  job.startWord = activeChapter->windowBase + layoutState.wordIdx;
+  job.maxWidth = maxWidth;
+  memcpy(job.spaceWidths, cachedSpaceWidths, sizeof(job.spaceWidths));
+  job.fontScale = renderer.GetFontScale();
+  job.fontMode = renderer.GetFontMode();
+  job.widthsEpoch = layoutState.widthsEpoch;
+  layoutWorker.Begin(job);
+  layoutState.workerJob = true;
+  layoutState.fedWord = job.startWord;
+  layoutState.feedRunCursor = 0;
+}
+
+// Layout restarts somewhere else, or with other parameters
+static void cancelLayoutJob() {
+  if (!layoutState.workerJob)
     return;
+  layoutWorker.Cancel();
+  layoutState.workerJob = false;
+}
 
-  uint8_t *raw_data = reader.LoadChapter(chapterIndex);
-  if (!raw_data)
+// Hands the worker the words tokenized since the last call
+static void feedLayoutJob() {
+  if (!layoutState.workerJob)
     return;
+  int base = activeChapter->windowBase;
+  layoutState.fedWord =
+      base + layoutWorker.Feed(*activeChapter, layoutState.fedWord - base,
+                               &layoutState.feedRunCursor);
+}
 
-  memset(wordBuffer, 0, WORD_BUFFER_SIZE);
-  memset(words, 0, sizeof(words));
-  memset(wordStyles, 0, sizeof(wordStyles));
-  memset(wordLens, 0, sizeof(wordLens));
+// The chapter's lines for the current layout parameters, if it was laid out
+// with them before; layout then only copies their text
+static void loadLayoutLines(int chapterIndex) {
+  layoutLines.clear();
+  layoutReplay =
+      layoutCache.Load(chapterIndex, layoutKey(), layoutLines, pageAnchors);
+  if (!layoutReplay)
+    pageAnchors.assign(1, 0); // Page 1 starts at word 0
+}
 
-  extractor.ExtractWords((char *)raw_data, words, wordStyles, wordLens,
-                         MAX_WORDS, wordBuffer, WORD_BUFFER_SIZE);
-  free(raw_data);
+void resetLayout(int chapterIndex, EpubReader &reader) {
+  if (chapterIndex < 0)
+    return;
 
-  for (int i = 0; i < MAX_WORDS; i++) {
-    wordWidths[i] = -1; // -1 means unmeasured
+  cancelLayoutJob();
+
+  if (activeChapter->chapterIndex == chapterIndex) {
+    // Already resident (e.g. re-selected from the chapter menu)
+  } else if (!prefetcher.Take(chapterIndex, activeChapter)) {
+    // Keep the outgoing chapter's tokens before its buffer is reused
+    chapterCache.Store(*activeChapter);
+    if (!chapterCache.Restore(chapterIndex, *activeChapter)) {
+      if (!activeChapter->Load(reader, chapterIndex))
+        return;
+      // Only a first slice is tokenized up front, enough for the first page
+      // to start laying out; the rest streams in from the main loop
+      activeChapter->Pump(1, CHAPTER_SLICE_SIZE);
+    }
   }
-  memset(wordWidths, -1, sizeof(wordWidths)); // Double ensure
+  // A resident buffer may have slid past the start of a long chapter
+  if (!activeChapter->Seek(reader, 0))
+    return;
+
+  memset(tokenWidths, -1, sizeof(tokenWidths)); // New chapter, new tokens
+  tokensMeasured = 0;
+  layoutState.widthsEpoch++;
 
   layoutState.chapterIndex = chapterIndex;
   layoutState.wordIdx = 0;
   layoutState.lineCount = 0;
+  layoutState.busyUs = 0;
   layoutState.complete = false;
   layoutState.needsReset = false;
+  layoutState.stalled = false;
   layoutState.targetWordIdx = -1;
+  layoutState.toLastPage = false;
+  layoutState.targetAnchor = 0;
   layoutState.anchorWordIdx = 0;
 
+  pageBase = 0;
   totalLines = 0;
   currentLine = 0;
   currentPageIdx = 0;
-  pageAnchors.clear();
   pageAnchors.reserve(512); // Pre-allocate to prevent heap churn
-  pageAnchors.push_back(0); // Page 1 starts at word 0
+  loadLayoutLines(chapterIndex);
+  selectedLink = -1;
+  noteLineCount = 0;
 
   metadataCheck.checkedCount = 0;
   memset(metadataCheck.isRedundant, 0, sizeof(metadataCheck.isRedundant));
@@ -159,7 +297,7 @@ void resetLayout(int chapterIndex, EpubReader &reader,
   DebugLogger::Log("Layout Reset for Ch %d", chapterIndex);
 }
 
-void reflowLayout() {
+void reflowLayout(EpubReader &reader) {
   if (layoutState.chapterIndex < 0)
     return;
 
@@ -171,34 +309,83 @@ void reflowLayout() {
   } else {
     layoutState.targetWordIdx = 0;
   }
-
-  memset(wordWidths, -1, sizeof(wordWidths));
+  layoutState.toLastPage = false;
+
+  // Page boundaries depend on everything before them, so start over
+  cancelLayoutJob();
+  activeChapter->Seek(reader, 0);
+  memset(tokenWidths, -1, sizeof(tokenWidths)); // Same tokens, new font
+  tokensMeasured = 0;
+  layoutState.widthsEpoch++;
   spaceWidthsDirty = true;
 
   layoutState.wordIdx = 0;
+  layoutState.busyUs = 0;
   layoutState.lineCount = 0;
   layoutState.complete = false;
   layoutState.needsReset = false;
+  layoutState.stalled = false;
+  pageBase = 0;
   totalLines = 0;
   currentLine = 0;
   currentPageIdx = 0;
-  pageAnchors.clear();
-  pageAnchors.push_back(0);
+  loadLayoutLines(layoutState.chapterIndex);
+  selectedLink = -1;
+  noteLineCount = 0;
 
   DebugLogger::Log("Reflow started: targetWord=%d", layoutState.targetWordIdx);
 }
 
-bool processLayout(EpubReader &reader, TextRenderer &renderer,
-                   int maxWords = 200) {
-  if (layoutState.complete || layoutState.chapterIndex < 0)
-    return true;
+// The tokenizer window is full and layout has caught up with it: lines keep
+// their own copy of the text, so everything before the layout position can go
+static void discardLaidOutWords() {
+  int n = layoutState.wordIdx;
+  activeChapter->Discard(n);
+  layoutState.wordIdx = 0;
+}
 
-  int maxWidth = isRotated ? (SCREEN_HEIGHT - 2 * layoutMargin)
-                           : (SCREEN_WIDTH - 2 * layoutMargin);
-  int availableHeight =
-      (isRotated ? SCREEN_WIDTH : SCREEN_HEIGHT) - layoutStartY - 25;
-  int baseHeight = renderer.GetLineHeight(TextStyle::NORMAL);
+// Drop whole pages from the front of chapterLines. Only pages more than one
+// behind the reader go, and only in large batches to amortize the memmove.
+static bool slideLines() {
+  int completePages = totalLines / linesPerPage;
+  // While hunting for a reflow/resume target there's no reading position yet
+  int keepPage = layoutState.targetWordIdx >= 0 ? pageBase + completePages - 1
+                                                : currentPageIdx - 1;
+  int dropLines = (keepPage - pageBase) * linesPerPage;
+  if (dropLines < MAX_CHAPTER_LINES / 4)
+    return false;
+
+  memmove(chapterLines, chapterLines + dropLines,
+          (totalLines - dropLines) * sizeof(LineInfo));
+  totalLines -= dropLines;
+  currentLine = std::max(0, currentLine - dropLines);
+  pageBase += dropLines / linesPerPage;
+  currentPageIdx = std::max(currentPageIdx, pageBase);
+  DebugLogger::Log("Line window: now from page %d", pageBase);
+  return true;
+}
 
+// Width of window-local word i of chapter, from widths (by token) once it
+// has been measured. Words past the token table's capacity are measured
+// every time (from the renderer's glyph tables).
+static int measureWord(TextRenderer &renderer, const ChapterBuffer *chapter,
+                       int *widths, int *measured, int i,
+                       const StyleRun &run) {
+  uint16_t token = chapter->wordTokens[i];
+  if (token != TOKEN_NONE && widths[token] >= 0)
+    return widths[token];
+  int w = renderer.MeasureWordWidth(chapter->WordText(i), chapter->wordLens[i],
+                                    (TextStyle)run.style, run.emphasis);
+  if (token != TOKEN_NONE) {
+    widths[token] = w;
+    (*measured)++;
+  }
+  return w;
+}
+
+// Distance between lines for the current font and spacing preset
+static int lineStep(TextRenderer &renderer) {
+  int baseHeight = renderer.GetLineHeight(TextStyle::NORMAL);
   float spacingMult = 1.35f;
   switch (SettingsManager::Get().GetSettings().spacing) {
   case SpacingPreset::TIGHT:
@@ -211,15 +398,18 @@ bool processLayout(EpubReader &reader, TextRenderer &renderer,
     spacingMult = 1.6f;
     break;
   }
+  return (int)(baseHeight * spacingMult);
+}
 
-  int stepY = (int)(baseHeight * spacingMult);
-  linesPerPage = availableHeight / stepY;
+// Line width for the current margins and orientation. Also sets
+// linesPerPage and refreshes the space widths after a font change.
+static int updateLayoutMetrics(TextRenderer &renderer) {
+  int availableHeight =
+      (isRotated ? SCREEN_WIDTH : SCREEN_HEIGHT) - layoutStartY - 25;
+  linesPerPage = availableHeight / lineStep(renderer);
   if (linesPerPage < 1)
     linesPerPage = 1;
 
-  const EpubMetadata &meta = reader.GetMetadata();
-  int wordsProcessed = 0;
-
   // Pre-cache space widths for common styles if needed
   if (spaceWidthsDirty) {
     for (int i = 0; i < 6; i++) {
@@ -227,67 +417,425 @@ bool processLayout(EpubReader &reader, TextRenderer &renderer,
     }
     spaceWidthsDirty = false;
   }
+  return isRotated ? (SCREEN_HEIGHT - 2 * layoutMargin)
+                   : (SCREEN_WIDTH - 2 * layoutMargin);
+}
 
-  while (layoutState.wordIdx < MAX_WORDS &&
-         words[layoutState.wordIdx] != nullptr && wordsProcessed < maxWords) {
-    if (words[layoutState.wordIdx][0] == '\n') {
-      layoutState.wordIdx++;
-      wordsProcessed++;
+// Greedy line filling from window-local word `from`: returns the end of the
+// words that fit in maxWidth, stopping at a paragraph break or the end of
+// the window. A line is always filled whole, so where lines break depends
+// only on the text and the layout parameters (see paginateStep).
+static int fillLine(TextRenderer &renderer, const ChapterBuffer *chapter,
+                    int *widths, int *measured, int from, int maxWidth,
+                    int *runCursor) {
+  const uint8_t *wordFlags = chapter->wordFlags;
+  int wordCount = chapter->WordCount();
+  int lineWidth = 0;
+  int i = from;
+  for (; i < wordCount && !(wordFlags[i] & WORD_NEWLINE); i++) {
+    const StyleRun &run = chapter->RunAt(i, runCursor);
+    int wordW = measureWord(renderer, chapter, widths, measured, i, run);
+    bool glued = (wordFlags[i] & WORD_GLUED) != 0;
+    int spaceW = (lineWidth == 0 || glued) ? 0 : cachedSpaceWidths[run.style];
+
+    if (lineWidth + spaceW + wordW > maxWidth && lineWidth > 0)
+      break;
+    lineWidth += spaceW + wordW;
+  }
+  return i;
+}
+
+// Pages of an uncounted spine item, scaled by the pages per byte of those
+// counted so far
+static int estimatePages(const ChapterInfo &item) {
+  uint64_t pages =
+      bookPages.countedBytes > 0
+          ? (uint64_t)item.uncompSize * bookPages.countedPages /
+                bookPages.countedBytes
+          : item.uncompSize / PAGINATE_BYTES_PER_PAGE;
+  return std::max(1, (int)pages);
+}
+
+static void updateBookTotals(const EpubMetadata &meta) {
+  int n = (int)meta.spine.size();
+  bookPages.firstPage.resize(n + 1);
+  bookPages.firstWord.resize(n + 1);
+  int page = 0;
+  int word = 0;
+  for (int i = 0; i < n; i++) {
+    bookPages.firstPage[i] = page;
+    bookPages.firstWord[i] = word;
+    page += bookPages.pages[i] >= 0 ? bookPages.pages[i]
+                                    : estimatePages(meta.spine[i]);
+    if (word >= 0)
+      word = bookPages.words[i] >= 0 ? word + bookPages.words[i] : -1;
+  }
+  bookPages.firstPage[n] = page;
+  bookPages.firstWord[n] = word;
+}
+
+// Book opened or layout parameters changed: count again from the start
+static void resetBookPages(const EpubMetadata &meta) {
+  int n = (int)meta.spine.size();
+  paginationBuffer.Close();
+  bookPages.key = layoutKey();
+  bookPages.chapter = n > 0 ? 0 : -1;
+  bookPages.counted = 0;
+  bookPages.pages.assign(n, -1);
+  bookPages.words.assign(n, -1);
+  bookPages.tocPage.assign(meta.toc.size(), 0);
+  bookPages.itemStarts.assign(n, std::vector<int>());
+  bookPages.countedBytes = 0;
+  bookPages.countedPages = 0;
+  bookPages.startUs = PerfNowUs();
+  updateBookTotals(meta);
+}
+
+// A spine item's lines are counted, by paginateStep or by the reader's own
+// layout finishing it. pageStarts (chapter-wide first word of each page) and
+// anchors place its TOC entries.
+static void recordChapterPages(const EpubMetadata &meta, int chapter,
+                               int lines, int words,
+                               const std::vector<int> &pageStarts,
+                               const AnchorIndex &anchors) {
+  if (bookPages.pages[chapter] >= 0)
+    return;
+  int pages = std::max(1, (lines + linesPerPage - 1) / linesPerPage);
+  bookPages.pages[chapter] = pages;
+  bookPages.words[chapter] = words;
+  bookPages.counted++;
+  bookPages.countedBytes += meta.spine[chapter].uncompSize;
+  bookPages.countedPages += pages;
+  if (lines > 0)
+    bookPages.itemStarts[chapter] = pageStarts;
+  for (size_t t = 0; t < meta.toc.size(); t++) {
+    const TocEntry &entry = meta.toc[t];
+    int w = entry.anchor ? anchors.FindAnchor(entry.anchor) : -1;
+    if (entry.spineIndex != chapter || w < 0)
       continue;
+    int page = (int)(std::upper_bound(pageStarts.begin(), pageStarts.end(),
+                                      w) -
+                     pageStarts.begin()) -
+               1;
+    bookPages.tocPage[t] = std::min(std::max(page, 0), pages - 1);
+  }
+  updateBookTotals(meta);
+  if (bookPages.counted == (int)meta.spine.size()) {
+    DebugLogger::Log("Book paginated: %d pages, %d words in %u ms",
+                     bookPages.firstPage.back(), bookPages.firstWord.back(),
+                     (unsigned)((PerfNowUs() - bookPages.startUs) / 1000));
+  }
+}
+
+// Counts the lines of the next uncounted spine item for up to budgetUs,
+// with the reader's own line filling and the same redundant-title skipping,
+// so the counts match what paging through the book gives
+static void paginateStep(EpubReader &reader, TextRenderer &renderer,
+                         uint32_t budgetUs) {
+  const EpubMetadata &meta = reader.GetMetadata();
+  if (bookPages.key != layoutKey())
+    resetBookPages(meta);
+  if (bookPages.chapter < 0)
+    return;
+  int maxWidth = updateLayoutMetrics(renderer);
+  ChapterBuffer *ch = &paginationBuffer;
+  uint64_t startUs = PerfNowUs();
+
+  while (bookPages.chapter >= 0 && PerfNowUs() - startUs < budgetUs) {
+    int c = bookPages.chapter;
+    if (bookPages.pages[c] >= 0) {
+      // Counted already (the reader finished laying it out)
+      bookPages.chapter = c + 1 < (int)meta.spine.size() ? c + 1 : -1;
+      continue;
+    }
+    if (ch->chapterIndex != c) {
+      if (!chapterCache.Restore(c, *ch) && !ch->Load(reader, c)) {
+        DebugLogger::Log("Pagination: can't open Ch %d", c);
+        std::vector<int> none;
+        recordChapterPages(meta, c, 0, 0, none, ch->anchors);
+        continue;
+      }
+      memset(paginationWidths, -1, sizeof(paginationWidths));
+      bookPages.cached = layoutCache.Load(c, bookPages.key,
+                                          bookPages.cachedLines,
+                                          bookPages.pageStarts);
+      if (!bookPages.cached)
+        bookPages.pageStarts.assign(1, 0);
+      bookPages.wordIdx = 0;
+      bookPages.lines = 0;
+      bookPages.runCursor = 0;
+      bookPages.measured = 0;
     }
 
-    int currentLineWidth = 0;
-    int lineStartWordIdx = layoutState.wordIdx;
-    TextStyle currentLineStyle = wordStyles[layoutState.wordIdx];
+    if (bookPages.cached) {
+      if (ch->IsComplete()) {
+        recordChapterPages(meta, c, (int)bookPages.cachedLines.size(),
+                           ch->WindowEnd(), bookPages.pageStarts,
+                           ch->anchors);
+        continue;
+      }
+      if (ch->IsStalled())
+        ch->Discard(ch->WordCount());
+      ch->Pump(1, CHAPTER_SLICE_SIZE);
+      continue;
+    }
 
-    while (layoutState.wordIdx < MAX_WORDS &&
-           words[layoutState.wordIdx] != nullptr) {
-      if (words[layoutState.wordIdx][0] == '\n')
-        break;
+    int from = bookPages.wordIdx;
+    int wordCount = ch->WordCount();
+    if (from < wordCount && (ch->wordFlags[from] & WORD_NEWLINE)) {
+      bookPages.wordIdx++;
+      continue;
+    }
+    int end = from < wordCount
+                  ? fillLine(renderer, ch, paginationWidths,
+                             &bookPages.measured, from, maxWidth,
+                             &bookPages.runCursor)
+                  : from;
+    if (end >= wordCount) {
+      if (ch->IsComplete() && end == from) {
+        recordChapterPages(meta, c, bookPages.lines, ch->WindowEnd(),
+                           bookPages.pageStarts, ch->anchors);
+        continue;
+      }
+      if (!ch->IsComplete()) {
+        // The line may go on past the tokenizer: more text, then again
+        if (ch->IsStalled()) {
+          if (from == 0)
+            break; // Can't happen with lines far shorter than the window
+          ch->Discard(from);
+          bookPages.wordIdx = 0;
+        }
+        ch->Pump(1, CHAPTER_SLICE_SIZE);
+        continue;
+      }
+    }
 
-      // O(N) Layout: Use cached word widths
-      if (wordWidths[layoutState.wordIdx] == -1) {
-        wordWidths[layoutState.wordIdx] = renderer.MeasureTextWidth(
-            words[layoutState.wordIdx], wordStyles[layoutState.wordIdx]);
+    bool redundant = false;
+    if (bookPages.lines < 15) {
+      char text[MAX_LINE_LEN];
+      int len = 0;
+      for (int i = from; i < end; i++) {
+        int wlen = ch->wordLens[i];
+        if (len + wlen + 2 >= MAX_LINE_LEN)
+          continue;
+        if (i > from && !(ch->wordFlags[i] & WORD_GLUED))
+          text[len++] = ' ';
+        memcpy(text + len, ch->WordText(i), wlen);
+        len += wlen;
       }
+      text[len] = '\0';
+      redundant = isRedundantMetadata(text, meta);
+    }
+    if (!redundant && ++bookPages.lines % linesPerPage == 0)
+      bookPages.pageStarts.push_back(ch->windowBase + end);
+    bookPages.wordIdx = end;
+  }
+}
+
+// Lays out up to maxWords more words. Unless wait is false, it blocks until
+// the worker has lines for them or can't go on without more of the chapter.
+bool processLayout(EpubReader &reader, TextRenderer &renderer,
+                   int maxWords = 200, bool wait = true) {
+  if (layoutState.complete || layoutState.chapterIndex < 0)
+    return true;
 
-      int wordW = wordWidths[layoutState.wordIdx];
-      int spaceW =
-          (currentLineWidth == 0)
-              ? 0
-              : cachedSpaceWidths[(int)wordStyles[layoutState.wordIdx]];
+  uint64_t startUs = PerfNowUs();
+  int maxWidth = updateLayoutMetrics(renderer);
 
-      if (currentLineWidth + spaceW + wordW > maxWidth && currentLineWidth > 0)
+  const EpubMetadata &meta = reader.GetMetadata();
+  int wordsProcessed = 0;
+  const char *text = activeChapter->wordBuffer;
+  const uint32_t *wordOffsets = activeChapter->wordOffsets;
+  const uint8_t *wordLens = activeChapter->wordLens;
+  const uint8_t *wordFlags = activeChapter->wordFlags;
+  int wordCount = activeChapter->WordCount();
+  int base = activeChapter->windowBase; // layoutState.wordIdx is window-local
+  layoutState.stalled = false;
+  feedLayoutJob();
+
+  while (wordsProcessed < maxWords) {
+    if (layoutState.wordIdx >= wordCount) {
+      if (!activeChapter->IsStalled() || layoutState.wordIdx == 0)
         break;
+      discardLaidOutWords();
+      activeChapter->Pump(1);
+      feedLayoutJob();
+      wordCount = activeChapter->WordCount();
+      base = activeChapter->windowBase;
+      continue;
+    }
 
-      currentLineWidth += spaceW + wordW;
+    if (wordFlags[layoutState.wordIdx] & WORD_NEWLINE) {
       layoutState.wordIdx++;
       wordsProcessed++;
-      if (wordsProcessed >= maxWords)
+      continue;
+    }
+
+    // Chapter-wide index of this line, and the line itself when replaying
+    // or when the worker laid it out
+    int lineIndex = pageBase * linesPerPage + totalLines;
+    const LayoutLine *cached = nullptr;
+    LayoutLine workerLine;
+    bool fromWorker = false;
+    if (layoutReplay) {
+      if (lineIndex >= (int)layoutLines.size()) {
+        // Past the last line: only breaks and skipped titles are left
+        wordsProcessed += wordCount - layoutState.wordIdx;
+        layoutState.wordIdx = wordCount;
+        continue;
+      }
+      cached = &layoutLines[lineIndex];
+      int start = cached->startWord - base;
+      if (start < layoutState.wordIdx) {
+        DebugLogger::Log("Layout cache: Ch %d line %d doesn't match",
+                         layoutState.chapterIndex, lineIndex);
+        layoutReplay = false;
+        layoutLines.clear(); // Nor is it worth storing
+        cached = nullptr;
+      } else if (start > layoutState.wordIdx) {
+        // Skipped words (a redundant title) may not have streamed in yet
+        wordsProcessed += std::min(start, wordCount) - layoutState.wordIdx;
+        layoutState.wordIdx = std::min(start, wordCount);
+        continue;
+      }
+    } else if (layoutWorker.IsRunning()) {
+      if (!layoutState.workerJob) {
+        beginLayoutJob(renderer, maxWidth);
+        feedLayoutJob();
+      }
+      const LayoutLine *next = layoutWorker.Peek(wait);
+      if (!next) {
+        // The worker's line so far may go on past the window: once layout
+        // has caught up, make room for the rest
+        if (!activeChapter->IsStalled() || layoutState.wordIdx == 0 ||
+            layoutState.fedWord < activeChapter->WindowEnd())
+          break;
+        discardLaidOutWords();
+        activeChapter->Pump(1);
+        feedLayoutJob();
+        wordCount = activeChapter->WordCount();
+        base = activeChapter->windowBase;
+        continue;
+      }
+      if (next->startWord != base + layoutState.wordIdx) {
+        DebugLogger::Log("Layout worker: Ch %d line at word %d, expected %d",
+                         layoutState.chapterIndex, next->startWord,
+                         base + layoutState.wordIdx);
+        cancelLayoutJob(); // Started again from here
+        continue;
+      }
+      workerLine = *next; // The slot is the worker's again after Pop()
+      cached = &workerLine;
+      fromWorker = true;
+    }
+
+    int lineStartWordIdx = layoutState.wordIdx;
+    int lineRunCursor = layoutState.runCursor;
+    TextStyle currentLineStyle = (TextStyle)activeChapter
+                                     ->RunAt(lineStartWordIdx, &lineRunCursor)
+                                     .style;
+
+    if (cached) {
+      // Replayed: no measuring, the words only need to have streamed in
+      layoutState.wordIdx =
+          std::min(lineStartWordIdx + cached->wordCount, wordCount);
+    } else {
+      layoutState.wordIdx =
+          fillLine(renderer, activeChapter, tokenWidths, &tokensMeasured,
+                   lineStartWordIdx, maxWidth, &layoutState.runCursor);
+    }
+    wordsProcessed += layoutState.wordIdx - lineStartWordIdx;
+
+    // A line that ran into the tokenizer frontier may not be finished yet;
+    // rewind and lay it out again once more of the chapter has streamed in
+    if (!activeChapter->IsComplete() && layoutState.wordIdx >= wordCount) {
+      layoutState.wordIdx = lineStartWordIdx;
+      if (!activeChapter->IsStalled() || lineStartWordIdx == 0)
         break;
+      // Window full: make room behind this line and keep going
+      discardLaidOutWords();
+      activeChapter->Pump(1);
+      feedLayoutJob();
+      wordCount = activeChapter->WordCount();
+      base = activeChapter->windowBase;
+      continue;
+    }
+    if (cached &&
+        layoutState.wordIdx != lineStartWordIdx + cached->wordCount) {
+      if (fromWorker) {
+        cancelLayoutJob();
+      } else {
+        DebugLogger::Log("Layout cache: Ch %d ends early",
+                         layoutState.chapterIndex);
+        layoutReplay = false;
+        layoutLines.clear();
+      }
+      layoutState.wordIdx = lineStartWordIdx;
+      continue;
     }
 
     if (layoutState.wordIdx > lineStartWordIdx &&
-        totalLines < MAX_CHAPTER_LINES) {
-      // Reconstruct line string only once per line
-      char *linePtr = chapterLines[totalLines].text;
+        totalLines >= MAX_CHAPTER_LINES && !slideLines()) {
+      // Far enough ahead of the reader; resume once they page forward
+      layoutState.wordIdx = lineStartWordIdx;
+      layoutState.stalled = true;
+      break;
+    }
+    if (fromWorker)
+      layoutWorker.Pop();
+
+    if (layoutState.wordIdx > lineStartWordIdx) {
+      // Reconstruct line string only once per line, splitting it into
+      // spans wherever the emphasis changes
+      LineInfo &line = chapterLines[totalLines];
+      char *linePtr = line.text;
       int lineLen = 0;
+      int x = 0;
+      line.spanCount = 0;
       for (int i = lineStartWordIdx; i < layoutState.wordIdx; i++) {
         int wlen = wordLens[i];
+        if (cached) {
+          // Spans and width come with the line
+          if (lineLen + wlen + 2 < MAX_LINE_LEN) {
+            if (i > lineStartWordIdx && !(wordFlags[i] & WORD_GLUED))
+              linePtr[lineLen++] = ' ';
+            memcpy(linePtr + lineLen, text + wordOffsets[i], wlen);
+            lineLen += wlen;
+          }
+          continue;
+        }
+        const StyleRun &run = activeChapter->RunAt(i, &lineRunCursor);
         if (lineLen + wlen + 2 < MAX_LINE_LEN) {
-          if (i > lineStartWordIdx) {
+          if (i > lineStartWordIdx && !(wordFlags[i] & WORD_GLUED)) {
             linePtr[lineLen++] = ' ';
+            x += cachedSpaceWidths[run.style];
           }
-          if (words[i]) {
-            memcpy(linePtr + lineLen, words[i], wlen);
-            lineLen += wlen;
+          if (line.spanCount == 0 ||
+              (run.emphasis != line.spans[line.spanCount - 1].emphasis &&
+               line.spanCount < LINE_MAX_SPANS)) {
+            LineSpan &span = line.spans[line.spanCount++];
+            span.start = (uint8_t)lineLen;
+            span.emphasis = run.emphasis;
+            span.x = (int16_t)x;
           }
+          memcpy(linePtr + lineLen, text + wordOffsets[i], wlen);
+          lineLen += wlen;
+          x += measureWord(renderer, activeChapter, tokenWidths,
+                           &tokensMeasured, i, run);
         }
       }
       linePtr[lineLen] = '\0';
+      if (cached) {
+        currentLineStyle = (TextStyle)cached->style;
+        line.spanCount = cached->spanCount;
+        memcpy(line.spans, cached->spans, sizeof(line.spans));
+        x = cached->width;
+      }
+      line.width = (int16_t)x;
 
+      // Replayed lines are the ones kept, so they skip the check
       bool redundant = false;
-      if (totalLines < 15) {
+      if ((!cached || fromWorker) && pageBase == 0 && totalLines < 15) {
         redundant = isRedundantMetadata(chapterLines[totalLines].text, meta);
         metadataCheck.isRedundant[totalLines] = redundant;
         metadataCheck.checkedCount = totalLines + 1;
@@ -297,25 +845,49 @@ bool processLayout(EpubReader &reader, TextRenderer &renderer,
         // Skip metadata noise
       } else {
         chapterLines[totalLines].style = currentLineStyle;
-        chapterLines[totalLines].startWordIdx = lineStartWordIdx;
-        chapterLines[totalLines].cacheKey =
-            renderer.GetCacheKey(linePtr, currentLineStyle);
+        chapterLines[totalLines].startWordIdx = base + lineStartWordIdx;
+        chapterLines[totalLines].cacheKey = renderer.GetCacheKey(
+            linePtr, currentLineStyle,
+            line.spanCount > 0 ? line.spans[0].emphasis : 0);
+
+        // The tokenizer runs ahead of layout, so an anchor is found before
+        // layout gets to its line
+        if (layoutState.targetAnchor) {
+          int w = activeChapter->anchors.FindAnchor(layoutState.targetAnchor);
+          if (w >= 0) {
+            layoutState.targetWordIdx = w;
+            layoutState.targetAnchor = 0;
+          }
+        }
 
-        // Position Recovery Logic
+        // Position Recovery Logic (the first line reaching past the target:
+        // an anchor may be on a paragraph break, which no line holds)
         if (layoutState.targetWordIdx >= 0 &&
-            lineStartWordIdx <= layoutState.targetWordIdx &&
-            layoutState.wordIdx > layoutState.targetWordIdx) {
+            base + layoutState.wordIdx > layoutState.targetWordIdx) {
           currentLine = totalLines;
-          currentPageIdx = pageAnchors.size() - 1;
+          currentPageIdx = pageBase + totalLines / linesPerPage;
           layoutState.targetWordIdx = -1; // Position focused
         }
 
+        if (!layoutReplay && lineIndex == (int)layoutLines.size() &&
+            lineIndex < LAYOUT_CACHE_MAX_LINES) {
+          LayoutLine rec;
+          rec.startWord = base + lineStartWordIdx;
+          rec.wordCount = (uint16_t)(layoutState.wordIdx - lineStartWordIdx);
+          rec.style = (uint8_t)currentLineStyle;
+          rec.spanCount = line.spanCount;
+          rec.width = line.width;
+          memcpy(rec.spans, line.spans, sizeof(rec.spans));
+          layoutLines.push_back(rec);
+        }
+
         totalLines++;
         layoutState.lineCount++;
 
-        // Pagination Tracking
-        if (totalLines > 0 && totalLines % linesPerPage == 0) {
-          pageAnchors.push_back(layoutState.wordIdx);
+        // Pagination Tracking (pages before a rewind are already known)
+        if (totalLines > 0 && totalLines % linesPerPage == 0 &&
+            pageBase + totalLines / linesPerPage == (int)pageAnchors.size()) {
+          pageAnchors.push_back(base + layoutState.wordIdx);
         }
       }
     }
@@ -323,16 +895,371 @@ bool processLayout(EpubReader &reader, TextRenderer &renderer,
     if (wordsProcessed >= maxWords)
       break;
   }
+  layoutState.busyUs += PerfNowUs() - startUs;
 
-  if (layoutState.wordIdx >= MAX_WORDS ||
-      words[layoutState.wordIdx] == nullptr) {
+  if (layoutState.wordIdx >= activeChapter->WordCount() &&
+      activeChapter->IsComplete()) {
     layoutState.complete = true;
-    DebugLogger::Log("Layout Complete: %d lines", totalLines);
+    DebugLogger::Log("Layout Complete: %d lines, %d tokens measured, "
+                     "%u words/s",
+                     totalLines,
+                     layoutState.workerJob ? layoutWorker.Measured()
+                                           : tokensMeasured,
+                     (unsigned)(activeChapter->WindowEnd() * 1000000ULL /
+                                std::max<uint64_t>(layoutState.busyUs, 1)));
+    if (!layoutReplay &&
+        (int)layoutLines.size() == pageBase * linesPerPage + totalLines)
+      layoutCache.Store(layoutState.chapterIndex, layoutKey(), layoutLines,
+                        pageAnchors);
+    if (bookPages.key != layoutKey())
+      resetBookPages(meta);
+    recordChapterPages(meta, layoutState.chapterIndex,
+                       pageBase * linesPerPage + totalLines,
+                       activeChapter->WindowEnd(), pageAnchors,
+                       activeChapter->anchors);
+    if (layoutState.toLastPage) {
+      // Paged back into a chapter nothing had paginated yet
+      layoutState.toLastPage = false;
+      layoutState.targetWordIdx = -1;
+      currentLine = std::max(0, (totalLines - 1) / linesPerPage) * linesPerPage;
+      currentPageIdx = pageBase + currentLine / linesPerPage;
+    } else if (layoutState.targetAnchor) {
+      // Dangling link: the top of the chapter, if its lines are still here
+      DebugLogger::Log("Anchor %08x not in Ch %d", layoutState.targetAnchor,
+                       layoutState.chapterIndex);
+      layoutState.targetAnchor = 0;
+      layoutState.targetWordIdx = -1;
+      if (pageBase == 0) {
+        currentLine = 0;
+        currentPageIdx = 0;
+      }
+    }
   }
 
   return layoutState.complete;
 }
 
+// A line whose emphasis changes part way is drawn one span at a time, each
+// at the offset layout measured for it
+static void renderSpans(TextRenderer &renderer, const LineInfo &li, int y,
+                        uint32_t color) {
+  int lineW = isRotated ? SCREEN_HEIGHT : SCREEN_WIDTH;
+  int x0 =
+      li.style == TextStyle::NORMAL ? layoutMargin : (lineW - li.width) / 2;
+  int textLen = (int)strlen(li.text);
+  char part[MAX_LINE_LEN];
+  for (int s = 0; s < li.spanCount; s++) {
+    const LineSpan &span = li.spans[s];
+    int end = s + 1 < li.spanCount ? li.spans[s + 1].start : textLen;
+    while (end > span.start && li.text[end - 1] == ' ')
+      end--; // The gap before the next span is already in its offset
+    memcpy(part, li.text + span.start, end - span.start);
+    part[end - span.start] = '\0';
+    if (isRotated)
+      renderer.RenderText(part, SCREEN_WIDTH - y, x0 + span.x, color,
+                          li.style, 90.0f, span.emphasis);
+    else
+      renderer.RenderText(part, x0 + span.x, y, color, li.style, 0.0f,
+                          span.emphasis);
+  }
+}
+
+// Paging back past the start of the line window: rebuild it backtrack pages
+// before targetLine (chapter-wide) and lay out through the target page
+static void rewindLayout(EpubReader &reader, TextRenderer &renderer,
+                         int targetLine, int backtrack) {
+  int targetPage = targetLine / linesPerPage;
+  int startPage = std::max(0, targetPage - backtrack);
+  cancelLayoutJob();
+  if (!activeChapter->Seek(reader, pageAnchors[startPage]))
+    return;
+
+  layoutState.wordIdx = 0;
+  layoutState.lineCount = 0;
+  layoutState.complete = false;
+  layoutState.stalled = false;
+  layoutState.targetWordIdx = -1;
+  pageBase = startPage;
+  totalLines = 0;
+  currentLine = targetLine - startPage * linesPerPage;
+  currentPageIdx = targetPage;
+
+  while (!layoutState.complete && activeChapter->IsLoaded() &&
+         totalLines < currentLine + linesPerPage) {
+    activeChapter->Pump(1);
+    processLayout(reader, renderer, 1000);
+  }
+  DebugLogger::Log("Line window: rewound to page %d", pageBase);
+}
+
+// Show the page holding chapter-wide word w: straight there if layout has
+// paginated that far, otherwise once it gets there
+static void jumpToWord(EpubReader &reader, TextRenderer &renderer, int w) {
+  int page = (int)(std::upper_bound(pageAnchors.begin(), pageAnchors.end(),
+                                    w) -
+                   pageAnchors.begin()) -
+             1;
+  if (page < 0)
+    page = 0;
+  if (page + 1 < (int)pageAnchors.size() || layoutState.complete) {
+    if (page >= pageBase) {
+      currentLine = (page - pageBase) * linesPerPage;
+      currentPageIdx = page;
+    } else {
+      rewindLayout(reader, renderer, page * linesPerPage,
+                   LAYOUT_BACKTRACK_PAGES);
+    }
+    return;
+  }
+  layoutState.targetWordIdx = w;
+}
+
+// Paging back into the chapter just opened. Its last page, when the layout
+// cache or the book's pagination knows where it starts, is laid out on its
+// own and the pages before it as the reader pages back to them; otherwise
+// layout runs from the top on idle frames and lands there once complete.
+// False if the first spine item has no lines, so there's no page at all.
+static bool showLastPage(EpubReader &reader, TextRenderer &renderer) {
+  int c = layoutState.chapterIndex;
+  int pages = -1;
+  if (layoutReplay) {
+    pages = ((int)layoutLines.size() + linesPerPage - 1) / linesPerPage;
+  } else if (bookPages.key == layoutKey() &&
+             c < (int)bookPages.pages.size() && bookPages.pages[c] >= 0) {
+    const std::vector<int> &starts = bookPages.itemStarts[c];
+    pages = starts.empty() ? 0 : bookPages.pages[c];
+    if (!starts.empty())
+      pageAnchors = starts;
+  }
+  if (pages == 0 && c == 0)
+    return false;
+  if (pages > 1) {
+    rewindLayout(reader, renderer, (pages - 1) * linesPerPage, 0);
+    return true;
+  }
+  if (pages < 0) {
+    // No target word to keep, so the line window slides freely
+    layoutState.targetWordIdx = INT_MAX;
+    layoutState.toLastPage = true;
+  }
+  processLayout(reader, renderer, 500);
+  return true;
+}
+
+// Link and TOC targets. The anchor's word is one probe into the chapter's
+// AnchorIndex, and another chapter is one load. An anchor the tokenizer
+// hasn't reached yet is looked for by layout as the chapter streams in.
+static void goToAnchor(EpubReader &reader, TextRenderer &renderer,
+                       int chapter, uint32_t anchor, int &currentChapter) {
+  if (chapter == currentChapter && chapter == layoutState.chapterIndex) {
+    int w = anchor ? activeChapter->anchors.FindAnchor(anchor) : 0;
+    if (w >= 0) {
+      jumpToWord(reader, renderer, w);
+    } else if (!layoutState.complete) {
+      layoutState.targetAnchor = anchor;
+      layoutState.targetWordIdx = INT_MAX;
+    }
+    return;
+  }
+  currentChapter = chapter;
+  resetLayout(chapter, reader);
+  if (anchor) {
+    int w = activeChapter->anchors.FindAnchor(anchor);
+    layoutState.targetAnchor = w >= 0 ? 0 : anchor;
+    layoutState.targetWordIdx = w >= 0 ? w : INT_MAX;
+  }
+  processLayout(reader, renderer, 1000);
+}
+
+// Chapter-wide words [*first, *end) of the page on screen
+static void pageWordRange(int *first, int *end) {
+  *first = currentLine < totalLines ? chapterLines[currentLine].startWordIdx
+                                    : INT_MAX;
+  int next = currentLine + linesPerPage;
+  if (next < totalLines)
+    *end = chapterLines[next].startWordIdx;
+  else if (!layoutState.complete)
+    *end = activeChapter->windowBase + layoutState.wordIdx;
+  else
+    *end = INT_MAX;
+}
+
+// Steps through the links on the page, then back to none
+static void selectNextLink() {
+  const AnchorIndex &anchors = activeChapter->anchors;
+  int first, end;
+  pageWordRange(&first, &end);
+  int pageLine = pageBase * linesPerPage + currentLine;
+  int next = selectedLink >= 0 && selectedLinkLine == pageLine
+                 ? selectedLink + 1
+                 : anchors.FindLink(first);
+  selectedLink = next < anchors.GetLinkCount() &&
+                         anchors.GetLink(next).firstWord < end
+                     ? next
+                     : -1;
+  selectedLinkLine = pageLine;
+}
+
+// Footnote preview: the target's words up to the end of their paragraph,
+// wrapped into noteLines. They come from the active chapter if it holds
+// them, otherwise from a spare buffer, so this is at most one chapter load.
+static void openNotePreview(EpubReader &reader, TextRenderer &renderer,
+                            const ChapterLink &link) {
+  const EpubMetadata &meta = reader.GetMetadata();
+  noteLineCount = 0;
+  if (link.anchor == 0) {
+    // A whole chapter: its title will do
+    snprintf(noteLines[0], MAX_LINE_LEN, "%s",
+             meta.spine[link.spineIndex].title);
+    noteLineCount = 1;
+    return;
+  }
+
+  ChapterBuffer *src = activeChapter;
+  int w = link.spineIndex == src->chapterIndex
+              ? src->anchors.FindAnchor(link.anchor)
+              : -1;
+  if (w < src->windowBase || w >= src->WindowEnd()) {
+    src = prefetcher.Fetch(reader, link.spineIndex);
+    if (!src)
+      return;
+    // Tokenize until the anchor turns up, sliding the window if it must
+    // (and giving up if the chapter can't be read)
+    while (((w = src->anchors.FindAnchor(link.anchor)) < 0 ||
+            w >= src->WindowEnd()) &&
+           src->IsLoaded() && !src->IsComplete()) {
+      if (src->IsStalled())
+        src->Discard(w < 0 ? src->WordCount() : w - src->windowBase);
+      src->Pump(1);
+    }
+    if (!src->IsLoaded() || w < 0 ||
+        (w < src->windowBase && !src->Seek(reader, w)))
+      return;
+  }
+
+  int maxWidth = (isRotated ? SCREEN_HEIGHT : SCREEN_WIDTH) -
+                 2 * layoutMargin - 16;
+  int spaceW = renderer.MeasureTextWidth(" ", TextStyle::SMALL);
+  int lineW = 0;
+  int len = 0;
+  for (int i = w - src->windowBase; i < src->WordCount(); i++) {
+    if (src->wordFlags[i] & WORD_NEWLINE) {
+      if (len > 0 || noteLineCount > 0)
+        break;
+      continue; // The anchor was on the break before its paragraph
+    }
+    int wlen = src->wordLens[i];
+    int wordW = renderer.MeasureWordWidth(src->WordText(i), wlen,
+                                          TextStyle::SMALL, 0);
+    int gap = len == 0 || (src->wordFlags[i] & WORD_GLUED) ? 0 : spaceW;
+    if ((lineW + gap + wordW > maxWidth && len > 0) ||
+        len + wlen + 2 >= MAX_LINE_LEN) {
+      noteLines[noteLineCount++][len] = '\0';
+      if (noteLineCount == NOTE_MAX_LINES)
+        return;
+      len = 0;
+      lineW = 0;
+      gap = 0;
+    }
+    char *line = noteLines[noteLineCount];
+    if (gap)
+      line[len++] = ' ';
+    memcpy(line + len, src->WordText(i), wlen);
+    len += wlen;
+    lineW += gap + wordW;
+  }
+  if (len > 0)
+    noteLines[noteLineCount++][len] = '\0';
+}
+
+static void renderNotePreview(SDL_Renderer *sdlRenderer,
+                              TextRenderer &renderer) {
+  int pageW = isRotated ? SCREEN_HEIGHT : SCREEN_WIDTH;
+  int pageH = isRotated ? SCREEN_WIDTH : SCREEN_HEIGHT;
+  int lineH = renderer.GetLineHeight(TextStyle::SMALL);
+  int boxX = layoutMargin - 8;
+  int boxW = pageW - 2 * boxX;
+  int boxH = noteLineCount * lineH + 12;
+  int boxY = pageH - boxH - 28;
+  SDL_Rect box = {boxX, boxY, boxW, boxH};
+  if (isRotated)
+    box = {SCREEN_WIDTH - boxY - boxH, boxX, boxH, boxW};
+  SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 220);
+  SDL_RenderFillRect(sdlRenderer, &box);
+  for (int i = 0; i < noteLineCount; i++) {
+    int y = boxY + 6 + i * lineH;
+    if (isRotated)
+      renderer.RenderText(noteLines[i], SCREEN_WIDTH - y, boxX + 8,
+                          0xFFFFFFFF, TextStyle::SMALL, 90.0f);
+    else
+      renderer.RenderText(noteLines[i], boxX + 8, y, 0xFFFFFFFF,
+                          TextStyle::SMALL, 0.0f);
+  }
+}
+
+// How far into the book the reader is: by words once every spine item has
+// been counted, by pages until then
+static int readPercent(int chapter) {
+  if (chapter < 0 || chapter >= (int)bookPages.pages.size())
+    return 0;
+  int totalWords = bookPages.firstWord.back();
+  if (totalWords > 0) {
+    int word = currentLine < totalLines ? chapterLines[currentLine].startWordIdx
+                                        : 0;
+    return (int)((int64_t)(bookPages.firstWord[chapter] + word) * 100 /
+                 totalWords);
+  }
+  int page = bookPages.firstPage[chapter] + currentPageIdx;
+  return page * 100 / std::max(page + 1, bookPages.firstPage.back());
+}
+
+static int menuItemCount(const EpubMetadata &meta) {
+  return meta.toc.empty() ? (int)meta.spine.size() : (int)meta.toc.size();
+}
+
+static int menuItemChapter(const EpubMetadata &meta, int item) {
+  return meta.toc.empty() ? item : meta.toc[item].spineIndex;
+}
+
+static const char *menuItemTitle(const EpubMetadata &meta, int item) {
+  return meta.toc.empty() ? meta.spine[item].title : meta.toc[item].title;
+}
+
+// Book page a menu entry starts at, "~" marking an estimate
+static void menuItemPage(const EpubMetadata &meta, int item, char *buf,
+                         size_t size) {
+  int chapter = menuItemChapter(meta, item);
+  if (chapter < 0 || chapter >= (int)bookPages.pages.size()) {
+    buf[0] = '\0';
+    return;
+  }
+  int page = bookPages.firstPage[chapter] + 1;
+  if (!meta.toc.empty())
+    page += bookPages.tocPage[item];
+  // Exact once the item and everything before it has been counted
+  bool exact = bookPages.firstWord[chapter] >= 0 &&
+               bookPages.pages[chapter] >= 0;
+  snprintf(buf, size, exact ? "%d" : "~%d", page);
+}
+
+// The entry the reader is in: the last one starting at or before word
+static int menuItemAt(const EpubMetadata &meta, int chapter, int word) {
+  if (meta.toc.empty())
+    return chapter < 0 ? 0 : chapter;
+  int item = 0;
+  for (int i = 0; i < (int)meta.toc.size(); i++) {
+    const TocEntry &entry = meta.toc[i];
+    int w = 0;
+    if (entry.anchor != 0)
+      w = activeChapter ? activeChapter->anchors.FindAnchor(entry.anchor) : -1;
+    if (entry.spineIndex < chapter ||
+        (entry.spineIndex == chapter && w >= 0 && w <= word))
+      item = i;
+  }
+  return item;
+}
+
 int main(int argc, char *argv[]) {
   printf("PSP-BookReader: main() starting...\n");
   DebugLogger::Init();
@@ -381,9 +1308,22 @@ int main(int argc, char *argv[]) {
   printf("Library Object Initialized (Deferred Scan)\n");
 
   EpubReader reader;
-  HtmlTextExtractor htmlExtractor;
   int currentChapter = -1;
 
+  ChapterBuffer *spares[PREFETCH_SLOTS];
+  for (int i = 0; i < PREFETCH_SLOTS; i++)
+    spares[i] = &chapterBuffers[1 + i];
+  prefetcher.Init(spares);
+  prefetcher.SetCache(&chapterCache);
+
+  // Without the worker everything still works, with blocking reads
+  if (asyncReads.Start()) {
+    reader.SetAsyncReads(&asyncReads);
+    library.SetAsyncReads(&asyncReads);
+  }
+  // Likewise for layout, which then breaks lines on the main thread
+  layoutWorker.Start();
+
   InputHandler input;
   running = 1;
 
@@ -502,8 +1442,14 @@ int main(int argc, char *argv[]) {
         if (input.CrossPressed()) {
           // DebugLogger::Log("Opening book: %s",
           //                  books[libSelection].filename.c_str());
+          // Streams reference the previous archive
+          activeChapter->Close();
+          prefetcher.Reset();
+          chapterCache.Clear();
           if (reader.Open(books[libSelection].filename.c_str())) {
             // DebugLogger::Log("Book opened successfully");
+            layoutCache.Open(books[libSelection].filename.c_str());
+            resetBookPages(reader.GetMetadata());
             currentState = STATE_READER;
             currentChapter = -1;
             layoutState.complete = true;
@@ -511,16 +1457,7 @@ int main(int argc, char *argv[]) {
             renderer.LoadFont(readerFontScale);
             renderer.SetTheme(SettingsManager::Get().GetSettings().theme);
 
-            // Resume Logic
-            const BookProgress &prog = SettingsManager::Get().GetProgress();
-            if (strcmp(prog.path, books[libSelection].filename.c_str()) == 0) {
-              currentChapter = prog.chapterIndex;
-              if (currentChapter >= 0) {
-                resetLayout(currentChapter, reader, htmlExtractor);
-                layoutState.targetWordIdx = prog.wordIndex;
-                processLayout(reader, renderer, 1000);
-              }
-            }
+            // Before any layout: widths are kept per token for the chapter
             const char *lang = reader.GetMetadata().language;
             if (lang &&
                 (strncmp(lang, "zh", 2) == 0 || strncmp(lang, "ja", 2) == 0 ||
@@ -533,6 +1470,17 @@ int main(int argc, char *argv[]) {
                                lang ? lang : "none");
             }
 
+            // Resume Logic
+            const BookProgress &prog = SettingsManager::Get().GetProgress();
+            if (strcmp(prog.path, books[libSelection].filename.c_str()) == 0) {
+              currentChapter = prog.chapterIndex;
+              if (currentChapter >= 0) {
+                resetLayout(currentChapter, reader);
+                layoutState.targetWordIdx = prog.wordIndex;
+                processLayout(reader, renderer, 1000);
+              }
+            }
+
             if (!renderer.IsValid()) {
               DebugLogger::Log("ERROR: Fonts failed to load!");
             }
@@ -672,10 +1620,16 @@ int main(int argc, char *argv[]) {
     } else if (currentState == STATE_READER) {
       // --- READER LOGIC ---
       const EpubMetadata &meta = reader.GetMetadata();
+      // Background decompression + tokenization, a few ms per frame
+      if (!activeChapter->IsComplete()) {
+        activeChapter->PumpFor(CHAPTER_FRAME_BUDGET_US);
+      }
+
       // Background layout processing
       if (!layoutState.complete) {
-        processLayout(reader, renderer,
-                      500); // Throttled to 500 words for better frame timing
+        // Throttled to 500 words for better frame timing; the worker catches
+        // up with the rest on later frames
+        processLayout(reader, renderer, 500, false);
       }
 
       bool layoutNeedsReset = false;
@@ -688,16 +1642,21 @@ int main(int argc, char *argv[]) {
         }
         if (input.DownPressed()) {
           menuSelection =
-              std::min((int)meta.spine.size() - 1, menuSelection + 1);
+              std::min(menuItemCount(meta) - 1, menuSelection + 1);
           if (menuSelection >= menuScroll + visibleMax)
             menuScroll = menuSelection - visibleMax + 1;
         }
         if (input.CrossPressed()) {
-          currentChapter = menuSelection;
-          layoutNeedsReset = true;
-          currentLine = 0;
-          showChapterMenu = false;
           showChapterMenu = false;
+          if (meta.toc.empty()) {
+            currentChapter = menuSelection;
+            layoutNeedsReset = true;
+            currentLine = 0;
+          } else {
+            const TocEntry &entry = meta.toc[menuSelection];
+            goToAnchor(reader, renderer, entry.spineIndex, entry.anchor,
+                       currentChapter);
+          }
         }
         if (input.TrianglePressed())
           showChapterMenu = false;
@@ -710,7 +1669,7 @@ int main(int argc, char *argv[]) {
         if (input.NextPage()) {
           if (currentChapter == -1) {
             currentChapter = 0;
-            resetLayout(currentChapter, reader, htmlExtractor);
+            resetLayout(currentChapter, reader);
             processLayout(reader, renderer, 500); // Immediate feel
             if (totalLines == 0) {
               currentChapter = 1;
@@ -725,6 +1684,7 @@ int main(int argc, char *argv[]) {
               currentPageIdx++;
             } else {
               // Speed up layout if user is waiting
+              activeChapter->Pump(1);
               processLayout(reader, renderer, 1000);
             }
           } else if (currentChapter < (int)meta.spine.size() - 1) {
@@ -738,50 +1698,84 @@ int main(int argc, char *argv[]) {
             currentLine -= linesPerPage;
             if (currentPageIdx > 0)
               currentPageIdx--;
+          } else if (pageBase > 0) {
+            rewindLayout(reader, renderer,
+                         pageBase * linesPerPage + currentLine - linesPerPage,
+                         LAYOUT_BACKTRACK_PAGES);
           } else if (currentChapter > 0) {
             currentChapter--;
-            resetLayout(currentChapter, reader, htmlExtractor);
-            processLayout(reader, renderer, 10000);
-            if (currentChapter == 0 && totalLines == 0) {
-              currentChapter = -1;
-            } else {
-              currentLine = ((totalLines - 1) / linesPerPage) * linesPerPage;
-              if (currentLine < 0)
-                currentLine = 0;
-            }
+            resetLayout(currentChapter, reader);
+            if (!showLastPage(reader, renderer))
+              currentChapter = -1; // An empty first item: the cover
           } else if (currentChapter == 0) {
             currentChapter = -1;
           }
         }
         if (input.CirclePressed()) {
           isRotated = !isRotated;
-          reflowLayout();
+          reflowLayout(reader);
           renderer.ClearCache();
         }
-        if (input.TrianglePressed()) {
+        // Cross steps through the page's links, previewing each; Triangle
+        // follows the one picked
+        if (input.CrossPressed() && currentChapter >= 0) {
+          selectNextLink();
+          noteLineCount = 0;
+          if (selectedLink >= 0)
+            openNotePreview(reader, renderer,
+                            activeChapter->anchors.GetLink(selectedLink));
+        }
+        if (input.TrianglePressed() && selectedLink >= 0) {
+          ChapterLink link = activeChapter->anchors.GetLink(selectedLink);
+          selectedLink = -1;
+          noteLineCount = 0;
+          goToAnchor(reader, renderer, link.spineIndex, link.anchor,
+                     currentChapter);
+        } else if (input.TrianglePressed()) {
+          int word = currentLine < totalLines
+                         ? chapterLines[currentLine].startWordIdx
+                         : 0;
           showChapterMenu = true;
-          menuSelection = (currentChapter < 0) ? 0 : currentChapter;
+          menuSelection = menuItemAt(meta, currentChapter, word);
           menuScroll = std::max(0, menuSelection - 3);
         }
 
         if (input.UpPressed()) {
           readerFontScale = std::min(3.0f, readerFontScale + 0.1f);
           renderer.LoadFont(readerFontScale);
-          reflowLayout();
+          reflowLayout(reader);
         }
         if (input.DownPressed()) {
           readerFontScale = std::max(0.4f, readerFontScale - 0.1f);
           renderer.LoadFont(readerFontScale);
-          reflowLayout();
+          reflowLayout(reader);
         }
       } // End if(!showChapterMenu)
 
       if (layoutNeedsReset && currentChapter >= 0) {
-        resetLayout(currentChapter, reader, htmlExtractor);
+        resetLayout(currentChapter, reader);
         processLayout(reader, renderer, 500); // Instant first page
         layoutNeedsReset = false;
       }
 
+      // Anything that moved the page drops the link picked on it
+      if (selectedLink >= 0 &&
+          selectedLinkLine != pageBase * linesPerPage + currentLine) {
+        selectedLink = -1;
+        noteLineCount = 0;
+      }
+
+      // Idle frames warm the chapters the reader is likely to open next
+      prefetcher.SetTargets(
+          currentChapter,
+          showChapterMenu ? menuItemChapter(meta, menuSelection) : -1,
+          (int)meta.spine.size());
+      if ((layoutState.complete || layoutState.stalled) &&
+          activeChapter->IsReady() && !input.HasActiveInput()) {
+        prefetcher.Step(reader, 1);
+        paginateStep(reader, renderer, PAGINATE_FRAME_BUDGET_US);
+      }
+
       // --- READER RENDER ---
       SDL_SetRenderDrawColor(sdlRenderer, (themeColors.background >> 0) & 0xFF,
                              (themeColors.background >> 8) & 0xFF,
@@ -835,48 +1829,63 @@ int main(int argc, char *argv[]) {
           renderer.RenderTextCentered(headerTitle, 10, 0xFF888888,
                                       TextStyle::SMALL, 0.0f);
 
-        int baseHeight = renderer.GetLineHeight(TextStyle::NORMAL);
-        float spacingMult = 1.35f;
-        switch (SettingsManager::Get().GetSettings().spacing) {
-        case SpacingPreset::TIGHT:
-          spacingMult = 1.15f;
-          break;
-        case SpacingPreset::NORMAL:
-          spacingMult = 1.35f;
-          break;
-        case SpacingPreset::LOOSE:
-          spacingMult = 1.6f;
-          break;
-        }
-        int stepY = (int)(baseHeight * spacingMult);
+        int stepY = lineStep(renderer);
 
+        const ChapterLink *link =
+            selectedLink >= 0 ? &activeChapter->anchors.GetLink(selectedLink)
+                              : nullptr;
         for (int i = 0; i < linesPerPage && (currentLine + i) < totalLines;
              i++) {
           const LineInfo &li = chapterLines[currentLine + i];
           TextStyle s = li.style;
+          int nextWord = currentLine + i + 1 < totalLines
+                             ? chapterLines[currentLine + i + 1].startWordIdx
+                             : INT_MAX;
+          if (link && li.startWordIdx < link->endWord &&
+              nextWord > link->firstWord) {
+            // Lines don't keep word positions, so the whole line is marked
+            int y = layoutStartY + i * stepY;
+            int w = (isRotated ? SCREEN_HEIGHT : SCREEN_WIDTH) -
+                    2 * layoutMargin + 8;
+            SDL_Rect mark = {layoutMargin - 4, y, w, stepY};
+            if (isRotated)
+              mark = {SCREEN_WIDTH - y - stepY, layoutMargin - 4, stepY, w};
+            SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
+            SDL_SetRenderDrawColor(sdlRenderer,
+                                   themeColors.selection & 0xFF,
+                                   (themeColors.selection >> 8) & 0xFF,
+                                   (themeColors.selection >> 16) & 0xFF, 60);
+            SDL_RenderFillRect(sdlRenderer, &mark);
+          }
           const char *txt = li.text;
           uint64_t key = li.cacheKey;
+          uint8_t em = li.spanCount > 0 ? li.spans[0].emphasis : 0;
 
           if (!txt || txt[0] == '\0')
             continue;
-          if (s == TextStyle::NORMAL) {
+          if (li.spanCount > 1) {
+            renderSpans(renderer, li, layoutStartY + i * stepY,
+                        s == TextStyle::NORMAL ? themeColors.text
+                                               : themeColors.heading);
+          } else if (s == TextStyle::NORMAL) {
             if (isRotated)
               renderer.RenderTextWithKey(
                   txt, key, SCREEN_WIDTH - (layoutStartY + i * stepY),
-                  layoutMargin, themeColors.text, s, 90.0f);
+                  layoutMargin, themeColors.text, s, 90.0f, em);
             else
               renderer.RenderTextWithKey(txt, key, layoutMargin,
                                          layoutStartY + i * stepY,
-                                         themeColors.text, s, 0.0f);
+                                         themeColors.text, s, 0.0f, em);
           } else {
             if (isRotated)
-              renderer.RenderTextCenteredWithKey(txt, key,
-                                                 (layoutStartY + i * stepY),
-                                                 themeColors.heading, s, 90.0f);
+              renderer.RenderTextCenteredWithKey(
+                  txt, key, (layoutStartY + i * stepY), themeColors.heading, s,
+                  90.0f, em);
             else
               renderer.RenderTextCenteredWithKey(txt, key,
                                                  layoutStartY + i * stepY,
-                                                 themeColors.heading, s, 0.0f);
+                                                 themeColors.heading, s, 0.0f,
+                                                 em);
           }
         }
       }
@@ -890,6 +1899,11 @@ int main(int argc, char *argv[]) {
         char statusBuf[64];
         snprintf(statusBuf, sizeof(statusBuf), "%02d:%02d  |  %d%%",
                  pspTime.hour, pspTime.minute, battery);
+        if (currentChapter >= 0) {
+          size_t len = strlen(statusBuf);
+          snprintf(statusBuf + len, sizeof(statusBuf) - len, "  |  %d%% read",
+                   readPercent(currentChapter));
+        }
 
         SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
         SDL_SetRenderDrawColor(sdlRenderer, 0, 0, 0, 180);
@@ -907,9 +1921,20 @@ int main(int argc, char *argv[]) {
         }
       }
 
+      if (noteLineCount > 0 && !showChapterMenu)
+        renderNotePreview(sdlRenderer, renderer);
+
       if (currentChapter >= 0 && !showChapterMenu) {
-        char pageBuf[16];
-        snprintf(pageBuf, sizeof(pageBuf), "%d", currentPageIdx + 1);
+        char pageBuf[32];
+        if (currentChapter < (int)bookPages.pages.size()) {
+          // Book-wide; the total is an estimate until every item is counted
+          int page = bookPages.firstPage[currentChapter] + currentPageIdx + 1;
+          int total = std::max(page, bookPages.firstPage.back());
+          snprintf(pageBuf, sizeof(pageBuf),
+                   bookPages.chapter < 0 ? "%d / %d" : "%d / ~%d", page, total);
+        } else {
+          snprintf(pageBuf, sizeof(pageBuf), "%d", currentPageIdx + 1);
+        }
         if (isRotated) {
           renderer.RenderTextCentered(pageBuf, 455, 0xFF888888,
                                       TextStyle::SMALL, 90.0f);
@@ -932,10 +1957,21 @@ int main(int argc, char *argv[]) {
         int visibleItems = isRotated ? 22 : 12;
 
         for (int i = 0;
-             i < visibleItems && (menuScroll + i) < (int)meta.spine.size();
+             i < visibleItems && (menuScroll + i) < menuItemCount(meta);
              i++) {
           int idx = menuScroll + i;
-          const char *title = meta.spine[idx].title;
+          const char *title = menuItemTitle(meta, idx);
+          int indent = meta.toc.empty()
+                           ? 0
+                           : std::min(meta.toc[idx].depth, 3) * 12;
+          char pageLabel[16];
+          menuItemPage(meta, idx, pageLabel, sizeof(pageLabel));
+          int pageW = pageLabel[0]
+                          ? renderer.MeasureTextWidth(pageLabel,
+                                                      TextStyle::NORMAL)
+                          : 0;
+          int textX = menuX + indent;
+          int textWidth = menuWidth - indent - (pageW ? pageW + 12 : 0);
           uint32_t color = (idx == menuSelection) ? 0xFFFFFFFF : 0xFF888888;
 
           if (idx == menuSelection) {
@@ -953,37 +1989,46 @@ int main(int argc, char *argv[]) {
 
           int textW = renderer.MeasureTextWidth(title, TextStyle::NORMAL);
           int offset = 0;
-          bool clipped = false;
+          // Long titles stop short of the page number; the selected one
+          // scrolls
+          bool clipped = textW > textWidth;
 
-          if (idx == menuSelection && textW > menuWidth) {
+          if (idx == menuSelection && clipped) {
             uint32_t ticks = SDL_GetTicks();
             offset = (ticks / 20) % (textW + 60);
             if (offset > textW + 20)
               offset = -20;
             if (offset < 0)
               offset = 0;
-            clipped = true;
           }
 
           if (isRotated) {
             int visualY = menuY + i * 18;
             if (clipped) {
-              SDL_Rect clip = {480 - visualY - 22, menuX, 24, menuWidth};
+              SDL_Rect clip = {480 - visualY - 22, textX, 24, textWidth};
               SDL_RenderSetClipRect(sdlRenderer, &clip);
             }
-            renderer.RenderText(title, 480 - visualY, menuX - offset, color,
+            renderer.RenderText(title, 480 - visualY, textX - offset, color,
                                 TextStyle::NORMAL, 90.0f);
             if (clipped)
               SDL_RenderSetClipRect(sdlRenderer, NULL);
+            if (pageW)
+              renderer.RenderText(pageLabel, 480 - visualY,
+                                  menuX + menuWidth - pageW, color,
+                                  TextStyle::NORMAL, 90.0f);
           } else {
             if (clipped) {
-              SDL_Rect clip = {menuX, menuY + i * 18, menuWidth, 20};
+              SDL_Rect clip = {textX, menuY + i * 18, textWidth, 20};
               SDL_RenderSetClipRect(sdlRenderer, &clip);
             }
-            renderer.RenderText(title, menuX - offset, menuY + i * 18, color,
+            renderer.RenderText(title, textX - offset, menuY + i * 18, color,
                                 TextStyle::NORMAL, 0.0f);
             if (clipped)
               SDL_RenderSetClipRect(sdlRenderer, NULL);
+            if (pageW)
+              renderer.RenderText(pageLabel, menuX + menuWidth - pageW,
+                                  menuY + i * 18, color, TextStyle::NORMAL,
+                                  0.0f);
           }
         }
       }
@@ -1016,7 +2061,7 @@ int main(int argc, char *argv[]) {
           s.fontScale = f;
           readerFontScale = f;
           renderer.LoadFont(readerFontScale);
-          reflowLayout();
+          reflowLayout(reader);
         } break;
         case 2: // Margins
           s.margin = (MarginPreset)(((int)s.margin + dir + 3) % 3);
@@ -1031,11 +2076,11 @@ int main(int argc, char *argv[]) {
             layoutMargin = 40;
             break;
           }
-          reflowLayout();
+          reflowLayout(reader);
           break;
         case 3: // Spacing
           s.spacing = (SpacingPreset)(((int)s.spacing + dir + 3) % 3);
-          reflowLayout();
+          reflowLayout(reader);
           break;
         case 4: // Status Overlay
           s.showStatus = !s.showStatus;
@@ -1119,8 +2164,16 @@ int main(int argc, char *argv[]) {
   } // End while(running)
 
   DebugLogger::Log("App exiting, shutting down systems...");
+  layoutWorker.Stop(); // Before the fonts it shares the library with go
   renderer.Shutdown();
+  activeChapter->Reset();
+  paginationBuffer.Reset();
+  prefetcher.Reset();
+  chapterCache.Clear();
+  layoutCache.Close();
   reader.Close();
+  library.Clear();
+  asyncReads.Stop();
   SettingsManager::Get().Save();
   if (joy)
     SDL_JoystickClose(joy);
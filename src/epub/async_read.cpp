@@ -0,0 +1,187 @@
+#include "async_read.h"
+#include "debug_logger.h"
+#include "zip_io.h"
+#include <SDL2/SDL.h>
+#include <cstring>
+
+ThreadedAsyncReadService::ThreadedAsyncReadService()
+    : nextId(1), nextSequence(0), stopping(false), thread(nullptr),
+      mutex(nullptr), queued(nullptr), done(nullptr) {
+  memset(slots, 0, sizeof(slots));
+}
+
+ThreadedAsyncReadService::~ThreadedAsyncReadService() { Stop(); }
+
+bool ThreadedAsyncReadService::Start() {
+  if (thread)
+    return true;
+
+  mutex = SDL_CreateMutex();
+  queued = SDL_CreateCond();
+  done = SDL_CreateCond();
+  stopping = false;
+  if (mutex && queued && done) {
+    thread = SDL_CreateThread(WorkerMain, "AsyncRead", this);
+  }
+  if (!thread) {
+    DebugLogger::Log("Async read worker failed to start: %s", SDL_GetError());
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+void ThreadedAsyncReadService::Stop() {
+  if (thread) {
+    SDL_LockMutex((SDL_mutex *)mutex);
+    stopping = true;
+    for (int i = 0; i < ASYNC_READ_MAX_REQUESTS; i++) {
+      if (slots[i].id && slots[i].status == AsyncReadStatus::QUEUED)
+        slots[i].status = AsyncReadStatus::CANCELLED;
+    }
+    SDL_CondSignal((SDL_cond *)queued);
+    SDL_UnlockMutex((SDL_mutex *)mutex);
+    SDL_WaitThread((SDL_Thread *)thread, nullptr);
+    thread = nullptr;
+  }
+  if (done)
+    SDL_DestroyCond((SDL_cond *)done);
+  if (queued)
+    SDL_DestroyCond((SDL_cond *)queued);
+  if (mutex)
+    SDL_DestroyMutex((SDL_mutex *)mutex);
+  done = queued = mutex = nullptr;
+}
+
+ThreadedAsyncReadService::Slot *ThreadedAsyncReadService::Find(AsyncReadId id) {
+  if (id == 0)
+    return nullptr;
+  for (int i = 0; i < ASYNC_READ_MAX_REQUESTS; i++) {
+    if (slots[i].id == id)
+      return &slots[i];
+  }
+  return nullptr;
+}
+
+ThreadedAsyncReadService::Slot *ThreadedAsyncReadService::NextQueued() {
+  Slot *best = nullptr;
+  for (int i = 0; i < ASYNC_READ_MAX_REQUESTS; i++) {
+    Slot *s = &slots[i];
+    if (!s->id || s->status != AsyncReadStatus::QUEUED)
+      continue;
+    if (!best || s->request.priority > best->request.priority ||
+        (s->request.priority == best->request.priority &&
+         (int32_t)(s->sequence - best->sequence) < 0))
+      best = s;
+  }
+  return best;
+}
+
+AsyncReadId ThreadedAsyncReadService::Submit(const AsyncReadRequest &request) {
+  if (!thread || !request.file || !request.buf)
+    return 0;
+
+  SDL_LockMutex((SDL_mutex *)mutex);
+  Slot *slot = nullptr;
+  for (int i = 0; i < ASYNC_READ_MAX_REQUESTS && !slot; i++) {
+    if (!slots[i].id)
+      slot = &slots[i];
+  }
+  AsyncReadId id = 0;
+  if (slot) {
+    id = nextId++;
+    if (nextId == 0)
+      nextId = 1;
+    slot->id = id;
+    slot->request = request;
+    slot->status = AsyncReadStatus::QUEUED;
+    slot->bytesRead = 0;
+    slot->sequence = nextSequence++;
+    SDL_CondSignal((SDL_cond *)queued);
+  }
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+  return id;
+}
+
+// Caller holds the mutex
+AsyncReadStatus ThreadedAsyncReadService::Collect(Slot *slot,
+                                                  size_t *bytesRead) {
+  AsyncReadStatus status = slot->status;
+  if (bytesRead)
+    *bytesRead = slot->bytesRead;
+  if (status != AsyncReadStatus::QUEUED && status != AsyncReadStatus::RUNNING)
+    slot->id = 0;
+  return status;
+}
+
+AsyncReadStatus ThreadedAsyncReadService::Poll(AsyncReadId id,
+                                               size_t *bytesRead) {
+  if (!thread)
+    return AsyncReadStatus::INVALID;
+  SDL_LockMutex((SDL_mutex *)mutex);
+  Slot *slot = Find(id);
+  AsyncReadStatus status =
+      slot ? Collect(slot, bytesRead) : AsyncReadStatus::INVALID;
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+  return status;
+}
+
+AsyncReadStatus ThreadedAsyncReadService::Wait(AsyncReadId id,
+                                               size_t *bytesRead) {
+  if (!thread)
+    return AsyncReadStatus::INVALID;
+  SDL_LockMutex((SDL_mutex *)mutex);
+  Slot *slot = Find(id);
+  while (slot && (slot->status == AsyncReadStatus::QUEUED ||
+                  slot->status == AsyncReadStatus::RUNNING))
+    SDL_CondWait((SDL_cond *)done, (SDL_mutex *)mutex);
+  AsyncReadStatus status =
+      slot ? Collect(slot, bytesRead) : AsyncReadStatus::INVALID;
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+  return status;
+}
+
+bool ThreadedAsyncReadService::Cancel(AsyncReadId id) {
+  if (!thread)
+    return false;
+  SDL_LockMutex((SDL_mutex *)mutex);
+  Slot *slot = Find(id);
+  bool cancelled = false;
+  if (slot && slot->status != AsyncReadStatus::RUNNING) {
+    // Queued or already finished: either way nothing will touch buf again
+    slot->id = 0;
+    cancelled = true;
+  }
+  SDL_UnlockMutex((SDL_mutex *)mutex);
+  return cancelled;
+}
+
+int ThreadedAsyncReadService::WorkerMain(void *self) {
+  ThreadedAsyncReadService *service = (ThreadedAsyncReadService *)self;
+  SDL_mutex *mutex = (SDL_mutex *)service->mutex;
+
+  SDL_LockMutex(mutex);
+  while (!service->stopping) {
+    Slot *slot = service->NextQueued();
+    if (!slot) {
+      SDL_CondWait((SDL_cond *)service->queued, mutex);
+      continue;
+    }
+
+    slot->status = AsyncReadStatus::RUNNING;
+    AsyncReadRequest request = slot->request;
+    SDL_UnlockMutex(mutex);
+
+    size_t got =
+        request.file->ReadAt(request.offset, request.buf, request.size);
+
+    SDL_LockMutex(mutex);
+    // The slot can't be reused while RUNNING, so it is still ours
+    slot->bytesRead = got;
+    slot->status = got == request.size ? AsyncReadStatus::DONE
+                                       : AsyncReadStatus::FAILED;
+    SDL_CondBroadcast((SDL_cond *)service->done);
+  }
+  SDL_UnlockMutex(mutex);
+  return 0;
+}
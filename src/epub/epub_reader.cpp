@@ -1,61 +1,182 @@
 #include "epub_reader.h"
+#include "anchor_index.h"
+#include "bump_arena.h"
 #include "debug_logger.h"
 #include "miniz.h"
+#include "perf_timer.h"
 #include "pugixml.hpp"
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <map>
 #include <string>
+#include <sys/stat.h>
 
-EpubReader::EpubReader() : zipArchive(nullptr) {
-  // Clear metadata
-  metadata.title[0] = '\0';
-  metadata.author[0] = '\0';
-  metadata.language[0] = '\0';
-  metadata.coverHref[0] = '\0';
-  metadata.spine.clear();
+#define BOOK_INDEX_VERSION 5
+#define BOOK_INDEX_MAX_SPINE 4096
+#define BOOK_INDEX_MAX_TOC 16384
+#define OPF_PREFIX_CHUNK 4096
+
+struct BookIndexHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t fileSize;
+  uint32_t mtime;
+  uint32_t spineCount;
+};
+
+EpubReader::EpubReader()
+    : zipArchive(nullptr), inflateBackend(InflateBackend::GetDefault()) {
+  ResetMetadata();
 }
 
 EpubReader::~EpubReader() { Close(); }
 
-bool EpubReader::Open(const char *path) {
+void EpubReader::ResetMetadata() {
+  memset(metadata.title, 0, sizeof(metadata.title));
+  memset(metadata.author, 0, sizeof(metadata.author));
+  memset(metadata.language, 0, sizeof(metadata.language));
+  memset(metadata.coverHref, 0, sizeof(metadata.coverHref));
+  metadata.coverFileIndex = EPUB_NO_FILE_INDEX;
+  metadata.spine.clear();
+  metadata.toc.clear();
+  styles.Clear();
+  spineOfFile.clear();
+}
+
+// dc:title/creator/language; returns the EPUB 2 <meta name="cover"> id
+static const char *ReadDcMetadata(pugi::xml_node metadataNode,
+                                  EpubMetadata &meta) {
+  strncpy(meta.title, metadataNode.child("dc:title").text().as_string(), 127);
+  strncpy(meta.author, metadataNode.child("dc:creator").text().as_string(),
+          127);
+  strncpy(meta.language, metadataNode.child("dc:language").text().as_string(),
+          15);
+
+  for (pugi::xml_node node : metadataNode.children("meta")) {
+    if (strcmp(node.attribute("name").value(), "cover") == 0)
+      return node.attribute("content").value();
+  }
+  return "";
+}
+
+// miniz read callback routed through the read-ahead cache
+static size_t ZipIoRead(void *opaque, mz_uint64 offset, void *buf, size_t n) {
+  return ((ZipIo *)opaque)->Read(offset, buf, n);
+}
+
+// Cover is either the EPUB 2 id match or the EPUB 3 property
+static bool IsCoverItem(pugi::xml_node item, const char *coverId) {
+  const char *itemId = item.attribute("id").value();
+  const char *itemProps = item.attribute("properties").value();
+  return (coverId[0] != '\0' && strcmp(itemId, coverId) == 0) ||
+         (itemProps && strstr(itemProps, "cover-image"));
+}
+
+bool EpubReader::Open(const char *path, EpubOpenMode mode) {
   Close(); // Ensure any previous file is closed
+  uint64_t startUs = PerfNowUs();
+
+  struct stat st;
+  bool haveStat = stat(path, &st) == 0;
+  std::string indexPath = std::string(path) + ".idx";
+  bool warm = mode != EpubOpenMode::ARCHIVE && haveStat &&
+              LoadIndex(indexPath.c_str(), (uint32_t)st.st_size,
+                        (uint32_t)st.st_mtime);
+
   zipArchive = malloc(sizeof(mz_zip_archive));
-  if (!zipArchive)
+  if (!zipArchive) {
+    ResetMetadata();
     return false;
+  }
 
   mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
   memset(zip, 0, sizeof(mz_zip_archive));
 
-  if (!mz_zip_reader_init_file(zip, path, 0)) {
+  if (!io.Open(path)) {
     free(zipArchive);
     zipArchive = nullptr;
+    ResetMetadata();
     return false;
   }
+  zip->m_pRead = ZipIoRead;
+  zip->m_pIO_opaque = &io;
 
-  char opfPath[256];
-  if (!ReadContainerXml(opfPath)) {
-    Close();
+  // Name lookups go through the href resolver, so miniz never needs its
+  // sorted central directory
+  if (!mz_zip_reader_init(zip, io.Size(),
+                          MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)) {
+    io.Close();
+    free(zipArchive);
+    zipArchive = nullptr;
+    ResetMetadata();
     return false;
   }
 
-  size_t opfSize;
-  void *opfData = mz_zip_reader_extract_file_to_heap(zip, opfPath, &opfSize, 0);
-  if (!opfData) {
+  if (warm) {
+    DebugLogger::Log("Open (warm): %d chapters in %u us",
+                     (int)metadata.spine.size(),
+                     (uint32_t)(PerfNowUs() - startUs));
+    return true;
+  }
+
+  if (mode == EpubOpenMode::ARCHIVE)
+    return true;
+
+  // Everything the parse allocates (pugixml DOMs, manifest and TOC tables)
+  // comes from one arena and goes back to the heap in a single pass, before
+  // the reader starts allocating chapter buffers
+  BumpArena arena;
+  bool success;
+  {
+    PugiArenaScope pugiScope(arena);
+    success = ReadPackage(mode, arena);
+  }
+  const BumpArenaStats &arenaStats = arena.GetStats();
+  DebugLogger::Log("Parse arena: %u allocs in %u chunks, %u KB peak",
+                   arenaStats.allocs, arenaStats.chunks,
+                   (uint32_t)(arenaStats.bytesMapped / 1024));
+  arena.Release();
+
+  if (!success) {
     Close();
-    return false;
+  } else if (mode == EpubOpenMode::FULL && haveStat) {
+    SaveIndex(indexPath.c_str(), (uint32_t)st.st_size, (uint32_t)st.st_mtime);
   }
 
-  std::string rootDir = "";
-  std::string opfPathStr = opfPath;
-  size_t lastSlash = opfPathStr.find_last_of("\\/");
-  if (lastSlash != std::string::npos) {
-    rootDir = opfPathStr.substr(0, lastSlash + 1);
+  if (mode == EpubOpenMode::METADATA) {
+    DebugLogger::Log("Open (metadata): %s in %u us", success ? "ok" : "failed",
+                     (uint32_t)(PerfNowUs() - startUs));
+  } else {
+    DebugLogger::Log("Open (cold): %d chapters in %u us",
+                     (int)metadata.spine.size(),
+                     (uint32_t)(PerfNowUs() - startUs));
   }
+  return success;
+}
 
-  bool success = ParseContentOpf((const uint8_t *)opfData, opfSize, rootDir);
-  mz_free(opfData);
+bool EpubReader::ReadPackage(EpubOpenMode mode, BumpArena &arena) {
+  char opfPath[256];
+  if (!ReadContainerXml(opfPath))
+    return false;
+
+  // Manifest hrefs are relative to the OPF's directory
+  char rootDir[256];
+  strcpy(rootDir, opfPath);
+  char *lastSlash = strrchr(rootDir, '/');
+  if (!lastSlash)
+    lastSlash = strrchr(rootDir, '\\');
+  *(lastSlash ? lastSlash + 1 : rootDir) = '\0';
+
+  if (mode == EpubOpenMode::METADATA)
+    return ReadOpfMetadata(opfPath, rootDir);
 
+  size_t opfSize;
+  uint8_t *opfData = ReadEntry(LocateFile(opfPath), &opfSize);
+  if (!opfData)
+    return false;
+
+  bool success = ParseContentOpf(opfData, opfSize, rootDir, arena);
+  free(opfData);
   return success;
 }
 
@@ -65,154 +186,388 @@ void EpubReader::Close() {
     mz_zip_reader_end(zip);
     free(zipArchive);
     zipArchive = nullptr;
+
+    const ZipIoStats &stats = io.GetStats();
+    DebugLogger::Log("Zip IO: %u reads (%u KB), %u cache hits, %u backend "
+                     "reads (%u KB), %u async (%u waits)",
+                     stats.reads, (uint32_t)(stats.bytes / 1024), stats.hits,
+                     stats.backendReads, (uint32_t)(stats.backendBytes / 1024),
+                     stats.asyncReads, stats.asyncWaits);
+    inflateBackend->LogStats();
+    io.Close();
   }
-  metadata.spine.clear();
+  resolver.Clear();
+  ResetMetadata();
 }
 
-bool EpubReader::ReadContainerXml(char *outPath) {
+uint32_t EpubReader::LocateFile(const char *href) {
+  if (!zipArchive || !href || href[0] == '\0')
+    return EPUB_NO_FILE_INDEX;
+  if (!resolver.IsBuilt())
+    BuildResolver();
+  uint32_t fileIndex;
+  return resolver.Lookup(href, &fileIndex, nullptr) ? fileIndex
+                                                    : EPUB_NO_FILE_INDEX;
+}
+
+void EpubReader::BuildResolver() {
+  uint64_t startUs = PerfNowUs();
   mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
+  mz_uint fileCount = mz_zip_reader_get_num_files(zip);
+
+  resolver.Begin((int)fileCount);
+  mz_zip_archive_file_stat fileStat;
+  for (mz_uint i = 0; i < fileCount; i++) {
+    if (mz_zip_reader_file_stat(zip, i, &fileStat))
+      resolver.Add(fileStat.m_filename, i,
+                   (uint32_t)fileStat.m_local_header_ofs);
+  }
+  DebugLogger::Log("Href index: %d entries in %u us", resolver.GetCount(),
+                   (uint32_t)(PerfNowUs() - startUs));
+}
+
+// Strings read back from a sidecar end inside their fields, whatever the
+// file on the memory stick holds
+template <size_t N> static void Terminate(char (&s)[N]) { s[N - 1] = '\0'; }
+
+bool EpubReader::LoadIndex(const char *indexPath, uint32_t fileSize,
+                           uint32_t mtime) {
+  FILE *f = fopen(indexPath, "rb");
+  if (!f)
+    return false;
+
+  BookIndexHeader header;
+  bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+            memcmp(header.magic, "EPIX", 4) == 0 &&
+            header.version == BOOK_INDEX_VERSION &&
+            header.fileSize == fileSize && header.mtime == mtime &&
+            header.spineCount > 0 && header.spineCount <= BOOK_INDEX_MAX_SPINE;
+
+  ok = ok && fread(metadata.title, sizeof(metadata.title), 1, f) == 1 &&
+       fread(metadata.author, sizeof(metadata.author), 1, f) == 1 &&
+       fread(metadata.language, sizeof(metadata.language), 1, f) == 1 &&
+       fread(metadata.coverHref, sizeof(metadata.coverHref), 1, f) == 1 &&
+       fread(&metadata.coverFileIndex, sizeof(uint32_t), 1, f) == 1;
+  Terminate(metadata.title);
+  Terminate(metadata.author);
+  Terminate(metadata.language);
+  Terminate(metadata.coverHref);
+
+  if (ok) {
+    metadata.spine.resize(header.spineCount);
+    ok = fread(metadata.spine.data(), sizeof(ChapterInfo), header.spineCount,
+               f) == header.spineCount;
+    for (ChapterInfo &item : metadata.spine) {
+      Terminate(item.id);
+      Terminate(item.title);
+      Terminate(item.href);
+    }
+  }
+  uint32_t tocCount = 0;
+  ok = ok && fread(&tocCount, sizeof(tocCount), 1, f) == 1 &&
+       tocCount <= BOOK_INDEX_MAX_TOC;
+  if (ok) {
+    metadata.toc.resize(tocCount);
+    ok = fread(metadata.toc.data(), sizeof(TocEntry), tocCount, f) == tocCount;
+    for (TocEntry &entry : metadata.toc) {
+      Terminate(entry.title);
+      if (entry.spineIndex < 0 ||
+          entry.spineIndex >= (int)header.spineCount)
+        ok = false;
+    }
+  }
+  ok = ok && styles.Load(f);
+  fclose(f);
+
+  if (!ok) {
+    DebugLogger::Log("Book index unusable, parsing again: %s", indexPath);
+    ResetMetadata();
+    return false;
+  }
+  return true;
+}
+
+// Written under a temporary name and renamed into place, so a write cut
+// short (full memory stick, battery pulled) never leaves a sidecar that
+// LoadIndex() would half-read
+void EpubReader::SaveIndex(const char *indexPath, uint32_t fileSize,
+                           uint32_t mtime) {
+  std::string tmpPath = std::string(indexPath) + ".tmp";
+  FILE *f = fopen(tmpPath.c_str(), "wb");
+  if (!f) {
+    DebugLogger::Log("Could not write book index: %s", indexPath);
+    return;
+  }
+
+  BookIndexHeader header;
+  memcpy(header.magic, "EPIX", 4);
+  header.version = BOOK_INDEX_VERSION;
+  header.fileSize = fileSize;
+  header.mtime = mtime;
+  header.spineCount = (uint32_t)metadata.spine.size();
+  uint32_t tocCount = (uint32_t)metadata.toc.size();
+
+  bool ok =
+      fwrite(&header, sizeof(header), 1, f) == 1 &&
+      fwrite(metadata.title, sizeof(metadata.title), 1, f) == 1 &&
+      fwrite(metadata.author, sizeof(metadata.author), 1, f) == 1 &&
+      fwrite(metadata.language, sizeof(metadata.language), 1, f) == 1 &&
+      fwrite(metadata.coverHref, sizeof(metadata.coverHref), 1, f) == 1 &&
+      fwrite(&metadata.coverFileIndex, sizeof(uint32_t), 1, f) == 1 &&
+      fwrite(metadata.spine.data(), sizeof(ChapterInfo),
+             metadata.spine.size(), f) == metadata.spine.size() &&
+      fwrite(&tocCount, sizeof(tocCount), 1, f) == 1 &&
+      fwrite(metadata.toc.data(), sizeof(TocEntry), tocCount, f) ==
+          tocCount &&
+      styles.Save(f);
+  ok = fclose(f) == 0 && ok;
+
+  // rename() won't replace an existing file on every platform
+  if (ok && rename(tmpPath.c_str(), indexPath) != 0) {
+    remove(indexPath);
+    ok = rename(tmpPath.c_str(), indexPath) == 0;
+  }
+  if (!ok) {
+    DebugLogger::Log("Could not write book index: %s", indexPath);
+    remove(tmpPath.c_str());
+  }
+}
+
+bool EpubReader::ReadContainerXml(char *outPath) {
   size_t containerSize;
-  void *containerData = mz_zip_reader_extract_file_to_heap(
-      zip, "META-INF/container.xml", &containerSize, 0);
+  uint8_t *containerData =
+      ReadEntry(LocateFile("META-INF/container.xml"), &containerSize);
   if (!containerData)
     return false;
 
   pugi::xml_document doc;
-  pugi::xml_parse_result result = doc.load_buffer(containerData, containerSize);
-  mz_free(containerData);
-  if (!result)
-    return false;
-
+  pugi::xml_parse_result result = doc.load_buffer_inplace(
+      containerData, containerSize, pugi::parse_minimal);
   pugi::xml_node rootfile =
       doc.child("container").child("rootfiles").child("rootfile");
   const char *fullPath = rootfile.attribute("full-path").value();
-  if (!fullPath || strlen(fullPath) == 0)
+  bool found = result && fullPath && fullPath[0] != '\0';
+
+  if (found) {
+    strncpy(outPath, fullPath, 255);
+    outPath[255] = '\0';
+  }
+  free(containerData);
+  return found;
+}
+
+char *EpubReader::ExtractPrefix(const char *href, const char *terminator,
+                                size_t *outSize, bool *truncated) {
+  ChapterStream stream;
+  if (!OpenEntryStream(LocateFile(href), stream))
+    return nullptr;
+
+  size_t total = stream.remaining;
+  size_t termLen = strlen(terminator);
+  size_t len = 0;
+  char *data = nullptr;
+  *truncated = false;
+
+  while (len < total) {
+    size_t want = total - len < OPF_PREFIX_CHUNK ? total - len
+                                                 : OPF_PREFIX_CHUNK;
+    char *grown = (char *)realloc(data, len + want + 1);
+    if (!grown)
+      break;
+    data = grown;
+
+    size_t n = stream.Read(data + len, want);
+    if (n == 0)
+      break;
+
+    // Search only the new bytes plus enough overlap for a split terminator
+    size_t from = len > termLen ? len - termLen : 0;
+    len += n;
+    data[len] = '\0';
+    const char *hit = strstr(data + from, terminator);
+    if (hit) {
+      len = (size_t)(hit - data) + termLen;
+      data[len] = '\0';
+      *truncated = len < total;
+      break;
+    }
+  }
+  stream.Close();
+
+  if (data && len == 0) {
+    free(data);
+    data = nullptr;
+  }
+  *outSize = len;
+  return data;
+}
+
+bool EpubReader::ReadOpfMetadata(const char *opfPath, const char *rootDir) {
+  // Inflate only up to </manifest>; the spine, which dominates large OPFs,
+  // is never decompressed or parsed
+  size_t opfSize = 0;
+  bool truncated = false;
+  char *opfData = ExtractPrefix(opfPath, "</manifest>", &opfSize, &truncated);
+  if (!opfData)
     return false;
 
-  strncpy(outPath, fullPath, 255);
-  outPath[255] = '\0';
-  return true;
+  pugi::xml_document doc;
+  pugi::xml_parse_result result = doc.load_buffer_inplace(
+      opfData, opfSize, pugi::parse_minimal | pugi::parse_escapes);
+  // Cutting the document short leaves <package> unclosed
+  bool parsed =
+      result ||
+      (truncated && result.status == pugi::status_end_element_mismatch);
+
+  pugi::xml_node package = doc.child("package");
+  if (parsed && package) {
+    const char *coverId = ReadDcMetadata(package.child("metadata"), metadata);
+    for (pugi::xml_node item : package.child("manifest").children("item")) {
+      if (IsCoverItem(item, coverId)) {
+        char fullHref[HREF_MAX_PATH];
+        HrefResolver::Normalize(rootDir, item.attribute("href").value(), true,
+                                fullHref, sizeof(fullHref));
+        strcpy(metadata.coverHref, fullHref);
+        break;
+      }
+    }
+  }
+  free(opfData);
+  return parsed && package;
 }
 
-// Recursive helper for NCX parsing
-void RecursiveParseNcx(pugi::xml_node parent, const std::string &rootDir,
-                       std::map<std::string, std::string> &hrefToTitle) {
+// Spine index of an archive path, through the zip entry it names
+static int SpineIndexOf(const HrefResolver &resolver,
+                        const std::vector<int> &spineOfFile,
+                        const char *path) {
+  uint32_t fileIndex;
+  if (!resolver.Lookup(path, &fileIndex, nullptr) ||
+      fileIndex >= spineOfFile.size())
+    return -1;
+  return spineOfFile[fileIndex];
+}
+
+// Recursive helper for NCX parsing. Every navPoint that lands in the spine
+// becomes a TOC entry, sub-sections included, with its fragment kept as an
+// anchor. A spine item is titled by the first entry pointing into it, so
+// sub-sections don't overwrite their main chapter.
+static void RecursiveParseNcx(pugi::xml_node parent, const char *ncxDir,
+                              int depth, const HrefResolver &resolver,
+                              const std::vector<int> &spineOfFile,
+                              EpubMetadata &meta) {
   for (pugi::xml_node navPoint : parent.children("navPoint")) {
     const char *label =
         navPoint.child("navLabel").child("text").text().as_string();
     const char *src = navPoint.child("content").attribute("src").value();
 
-    if (label && src) {
-      std::string srcStr = src;
-      size_t hash = srcStr.find('#');
-      if (hash != std::string::npos)
-        srcStr = srcStr.substr(0, hash);
-
-      // Resolve relative path
-      std::string fullHref = rootDir + srcStr;
+    char fullHref[HREF_MAX_PATH];
+    HrefResolver::Normalize(ncxDir, src, false, fullHref, sizeof(fullHref));
+    int spineIndex = SpineIndexOf(resolver, spineOfFile, fullHref);
+    if (spineIndex >= 0 && meta.toc.size() < BOOK_INDEX_MAX_TOC) {
+      TocEntry entry;
+      memset(&entry, 0, sizeof(entry));
+      strncpy(entry.title, label, 127);
+      entry.spineIndex = spineIndex;
+      const char *fragment = strchr(src, '#');
+      if (fragment && fragment[1] != '\0')
+        entry.anchor = AnchorHash(fragment + 1, strlen(fragment + 1));
+      entry.depth = depth;
+      meta.toc.push_back(entry);
 
-      // Only use the first title encountered for a href to avoid overwriting
-      // main chapters with sub-sections
-      if (hrefToTitle.find(fullHref) == hrefToTitle.end()) {
-        hrefToTitle[fullHref] = label;
-        // DebugLogger::Log("NCX Match: %s -> %s", fullHref.c_str(), label);
-      }
+      ChapterInfo &chapter = meta.spine[spineIndex];
+      if (chapter.title[0] == '\0')
+        strncpy(chapter.title, label, 127);
     }
 
     // Recurse into sub-points
-    RecursiveParseNcx(navPoint, rootDir, hrefToTitle);
+    RecursiveParseNcx(navPoint, ncxDir, depth + 1, resolver, spineOfFile,
+                      meta);
+  }
+}
+
+void EpubReader::ParseNcx(const char *ncxHref) {
+  uint32_t ncxIndex = LocateFile(ncxHref);
+  if (ncxIndex == EPUB_NO_FILE_INDEX)
+    return;
+  size_t ncxSize;
+  uint8_t *ncxData = ReadEntry(ncxIndex, &ncxSize);
+  if (!ncxData)
+    return;
+
+  char ncxDir[HREF_MAX_PATH];
+  const char *slash = strrchr(ncxHref, '/');
+  size_t dirLen = slash ? (size_t)(slash - ncxHref) + 1 : 0;
+  memcpy(ncxDir, ncxHref, dirLen);
+  ncxDir[dirLen] = '\0';
+  {
+    pugi::xml_document ncxDoc;
+    if (ncxDoc.load_buffer_inplace(ncxData, ncxSize)) {
+      if (spineOfFile.empty())
+        BuildSpineMap();
+      RecursiveParseNcx(ncxDoc.child("ncx").child("navMap"), ncxDir, 0,
+                        resolver, spineOfFile, metadata);
+    }
   }
+  free(ncxData);
 }
 
-bool EpubReader::ParseContentOpf(const uint8_t *data, size_t size,
-                                 const std::string &rootDir) {
+bool EpubReader::ParseContentOpf(uint8_t *data, size_t size,
+                                 const char *rootDir, BumpArena &arena) {
   pugi::xml_document doc;
-  pugi::xml_parse_result result = doc.load_buffer(data, size);
+  pugi::xml_parse_result result = doc.load_buffer_inplace(data, size);
   if (!result)
     return false;
 
   pugi::xml_node package = doc.child("package");
-  pugi::xml_node metadataNode = package.child("metadata");
-
-  strncpy(metadata.title, metadataNode.child("dc:title").text().as_string(),
-          127);
-  strncpy(metadata.author, metadataNode.child("dc:creator").text().as_string(),
-          127);
-  strncpy(metadata.language,
-          metadataNode.child("dc:language").text().as_string(), 15);
-
-  // EPUB 2 cover detection
-  std::string coverId = "";
-  for (pugi::xml_node meta : metadataNode.children("meta")) {
-    if (strcmp(meta.attribute("name").value(), "cover") == 0) {
-      coverId = meta.attribute("content").value();
-      break;
-    }
-  }
+  const char *coverId = ReadDcMetadata(package.child("metadata"), metadata);
 
   const char *ncxId = package.child("spine").attribute("toc").value();
-  std::map<std::string, std::string> manifestHrefs;
-  std::string ncxHref = "";
+  ArenaStringTable manifestHrefs(arena);
+  const char *ncxHref = "";
 
   pugi::xml_node manifest = package.child("manifest");
   for (pugi::xml_node item : manifest.children("item")) {
     const char *itemId = item.attribute("id").value();
     const char *itemHref = item.attribute("href").value();
-    const char *itemProps = item.attribute("properties").value();
 
-    std::string fullHref = rootDir + itemHref;
-    manifestHrefs[itemId] = fullHref;
+    char fullHref[HREF_MAX_PATH];
+    HrefResolver::Normalize(rootDir, itemHref, true, fullHref,
+                            sizeof(fullHref));
+    manifestHrefs.Add(itemId, fullHref);
 
-    // Detect cover (EPUB 2 ID match or EPUB 3 property)
-    if ((!coverId.empty() && strcmp(itemId, coverId.c_str()) == 0) ||
-        (itemProps && strstr(itemProps, "cover-image"))) {
-      strncpy(metadata.coverHref, fullHref.c_str(), 127);
+    if (IsCoverItem(item, coverId)) {
+      strcpy(metadata.coverHref, fullHref);
+      metadata.coverFileIndex = LocateFile(metadata.coverHref);
       DebugLogger::Log("Cover Detected: %s", metadata.coverHref);
     }
 
     if (ncxId && strcmp(itemId, ncxId) == 0) {
-      ncxHref = fullHref;
+      ncxHref = arena.Strdup(fullHref);
     }
-  }
 
-  // Recursive NCX parsing for all sub-chapters
-  std::map<std::string, std::string> hrefToTitle;
-  if (!ncxHref.empty()) {
-    mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
-    size_t ncxSize;
-    void *ncxData =
-        mz_zip_reader_extract_file_to_heap(zip, ncxHref.c_str(), &ncxSize, 0);
-    if (ncxData) {
-      pugi::xml_document ncxDoc;
-      if (ncxDoc.load_buffer(ncxData, ncxSize)) {
-        RecursiveParseNcx(ncxDoc.child("ncx").child("navMap"), rootDir,
-                          hrefToTitle);
-      }
-      mz_free(ncxData);
-    }
+    if (strcmp(item.attribute("media-type").value(), "text/css") == 0)
+      LoadStylesheet(fullHref);
   }
+  manifestHrefs.Seal();
 
   pugi::xml_node spine = package.child("spine");
-  int chapterIdx = 1;
   for (pugi::xml_node itemref : spine.children("itemref")) {
     const char *idref = itemref.attribute("idref").value();
-    if (manifestHrefs.count(idref)) {
+    const char *href = manifestHrefs.Find(idref);
+    if (href) {
       ChapterInfo chapter;
+      memset(&chapter, 0, sizeof(chapter));
       strncpy(chapter.id, idref, 63);
-      strncpy(chapter.href, manifestHrefs[idref].c_str(), 127);
-
-      if (hrefToTitle.count(chapter.href)) {
-        strncpy(chapter.title, hrefToTitle[chapter.href].c_str(), 127);
-      } else {
-        snprintf(chapter.title, 127, "Chapter %d", chapterIdx);
-      }
-      chapterIdx++;
+      strncpy(chapter.href, href, 127);
 
       mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
-      int fileIndex = mz_zip_reader_locate_file(zip, chapter.href, nullptr, 0);
-      if (fileIndex >= 0) {
+      chapter.fileIndex = EPUB_NO_FILE_INDEX;
+      if (!resolver.IsBuilt())
+        BuildResolver();
+      if (resolver.Lookup(chapter.href, &chapter.fileIndex,
+                          &chapter.zipOffset)) {
         mz_zip_archive_file_stat fileStat;
-        if (mz_zip_reader_file_stat(zip, fileIndex, &fileStat)) {
+        if (mz_zip_reader_file_stat(zip, chapter.fileIndex, &fileStat)) {
           chapter.compSize = fileStat.m_comp_size;
           chapter.uncompSize = fileStat.m_uncomp_size;
         }
@@ -221,53 +576,489 @@ bool EpubReader::ParseContentOpf(const uint8_t *data, size_t size,
     }
   }
 
+  // Recursive NCX parsing for all sub-chapters; it titles the spine too
+  ParseNcx(ncxHref);
+  for (size_t i = 0; i < metadata.spine.size(); i++) {
+    if (metadata.spine[i].title[0] == '\0')
+      snprintf(metadata.spine[i].title, 127, "Chapter %d", (int)i + 1);
+  }
+
   return metadata.spine.size() > 0;
 }
 
+// Every stylesheet in the manifest is compiled into one table, rather than
+// per chapter from its <link>s: books rarely give chapters different sheets
+void EpubReader::LoadStylesheet(const char *href) {
+  uint64_t startUs = PerfNowUs();
+  size_t size;
+  uint8_t *css = LoadFile(href, &size, CSS_MAX_SHEET_SIZE);
+  if (!css)
+    return;
+  styles.Compile((char *)css, size);
+  free(css);
+  DebugLogger::Log("Stylesheet %s compiled in %u us", href,
+                   (uint32_t)(PerfNowUs() - startUs));
+}
+
 uint8_t *EpubReader::LoadChapter(int chapterIndex) {
   if (chapterIndex < 0 || chapterIndex >= (int)metadata.spine.size())
     return nullptr;
-  mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
   ChapterInfo &chapter = metadata.spine[chapterIndex];
+  uint32_t fileIndex = chapter.fileIndex != EPUB_NO_FILE_INDEX
+                           ? chapter.fileIndex
+                           : LocateFile(chapter.href);
+  size_t size;
+  return ReadEntry(fileIndex, &size);
+}
 
-  uint8_t *buffer = (uint8_t *)malloc(chapter.uncompSize + 1);
-  if (!buffer)
-    return nullptr;
-
-  if (!mz_zip_reader_extract_file_to_mem(zip, chapter.href, buffer,
-                                         chapter.uncompSize, 0)) {
-    free(buffer);
-    return nullptr;
+void EpubReader::BuildSpineMap() {
+  mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
+  spineOfFile.assign(zip ? mz_zip_reader_get_num_files(zip) : 0, -1);
+  // Listed twice: the first occurrence is where links land
+  for (int i = (int)metadata.spine.size() - 1; i >= 0; i--) {
+    uint32_t fileIndex = metadata.spine[i].fileIndex;
+    if (fileIndex < spineOfFile.size())
+      spineOfFile[fileIndex] = i;
   }
+}
+
+int EpubReader::ResolveHref(int fromChapter, const char *href,
+                            uint32_t *anchor) {
+  *anchor = 0;
+  if (!zipArchive || fromChapter < 0 ||
+      fromChapter >= (int)metadata.spine.size())
+    return -1;
+  const char *fragment = strchr(href, '#');
+  if (fragment && fragment[1] != '\0')
+    *anchor = AnchorHash(fragment + 1, strlen(fragment + 1));
+  if (href[0] == '#')
+    return fromChapter;
+  // "http:", "mailto:": a scheme before any path separator
+  const char *colon = strchr(href, ':');
+  if (colon && (!fragment || colon < fragment) &&
+      strcspn(href, "/?") > (size_t)(colon - href))
+    return -1;
 
-  buffer[chapter.uncompSize] = '\0';
-  return buffer;
+  const char *chapterHref = metadata.spine[fromChapter].href;
+  const char *slash = strrchr(chapterHref, '/');
+  char baseDir[HREF_MAX_PATH];
+  size_t dirLen = slash ? (size_t)(slash - chapterHref) + 1 : 0;
+  memcpy(baseDir, chapterHref, dirLen);
+  baseDir[dirLen] = '\0';
+
+  // Joined only: the lookup percent-decodes
+  char path[HREF_MAX_PATH];
+  HrefResolver::Normalize(baseDir, href, false, path, sizeof(path));
+  if (!resolver.IsBuilt())
+    BuildResolver();
+  if (spineOfFile.empty())
+    BuildSpineMap();
+  return SpineIndexOf(resolver, spineOfFile, path);
 }
 
 uint8_t *EpubReader::LoadCover(size_t *outSize) {
   if (!zipArchive || metadata.coverHref[0] == '\0')
     return nullptr;
-  mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
 
-  int fileIndex =
-      mz_zip_reader_locate_file(zip, metadata.coverHref, nullptr, 0);
-  if (fileIndex < 0)
+  uint32_t fileIndex = metadata.coverFileIndex;
+  if (fileIndex == EPUB_NO_FILE_INDEX)
+    fileIndex = LocateFile(metadata.coverHref);
+
+  // Cover Guard: Refuse to load if uncompressed size > 2MB to prevent OOM
+  return ExtractToHeap(fileIndex, metadata.coverHref, outSize,
+                       EPUB_COVER_MAX_SIZE);
+}
+
+uint8_t *EpubReader::LoadFile(const char *href, size_t *outSize,
+                              size_t maxSize) {
+  if (!zipArchive || !href || href[0] == '\0')
     return nullptr;
+  return ExtractToHeap(LocateFile(href), href, outSize, maxSize);
+}
+
+uint8_t *EpubReader::ExtractToHeap(uint32_t fileIndex, const char *name,
+                                   size_t *outSize, size_t maxSize) {
+  if (fileIndex == EPUB_NO_FILE_INDEX)
+    return nullptr;
+  mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
 
   mz_zip_archive_file_stat fileStat;
   if (!mz_zip_reader_file_stat(zip, fileIndex, &fileStat))
     return nullptr;
 
-  // Cover Guard: Refuse to load if uncompressed size > 2MB to prevent OOM
-  if (fileStat.m_uncomp_size > 2 * 1024 * 1024) {
-    DebugLogger::Log("Cover too large: %u bytes. Skipping.",
+  if (fileStat.m_uncomp_size > maxSize) {
+    DebugLogger::Log("%s too large: %u bytes. Skipping.", name,
                      (uint32_t)fileStat.m_uncomp_size);
     return nullptr;
   }
 
-  DebugLogger::Log("LoadCover: Extracting %s (%u bytes)", metadata.coverHref,
-                   (uint32_t)fileStat.m_uncomp_size);
+  DebugLogger::Log("Extracting %s (%u bytes, %s)", name,
+                   (uint32_t)fileStat.m_uncomp_size,
+                   fileStat.m_method == 0 ? "stored" : inflateBackend->GetName());
+  return ReadEntry(fileIndex, outSize);
+}
+
+uint8_t *EpubReader::ReadEntry(uint32_t fileIndex, size_t *outSize) {
+  ChapterStream stream;
+  if (!OpenEntryStream(fileIndex, stream))
+    return nullptr;
+
+  uint32_t size = stream.remaining;
+  uint8_t *data = (uint8_t *)malloc(size + 1);
+  if (!data)
+    return nullptr;
+
+  uint32_t len = 0;
+  while (len < size) {
+    size_t n = stream.Read(data + len, size - len);
+    if (n == 0)
+      break;
+    len += (uint32_t)n;
+  }
+  if (len < size || stream.IsCorrupt()) {
+    free(data);
+    return nullptr;
+  }
+
+  data[size] = '\0';
+  *outSize = size;
+  return data;
+}
+
+bool EpubReader::LocateEntryData(uint32_t fileIndex, uint64_t *dataOffset,
+                                 uint32_t *compSize, uint32_t *uncompSize,
+                                 uint32_t *crc, bool *deflated) {
+  mz_zip_archive *zip = (mz_zip_archive *)zipArchive;
+  mz_zip_archive_file_stat fileStat;
+  if (!zip || fileIndex == EPUB_NO_FILE_INDEX ||
+      !mz_zip_reader_file_stat(zip, fileIndex, &fileStat))
+    return false;
+  if (fileStat.m_is_encrypted ||
+      (fileStat.m_method != 0 && fileStat.m_method != MZ_DEFLATED) ||
+      (fileStat.m_method == 0 &&
+       fileStat.m_comp_size != fileStat.m_uncomp_size))
+    return false;
+
+  // The data follows the local header, whose name/extra lengths may differ
+  // from the central directory's copy
+  uint8_t header[30];
+  if (io.Read(fileStat.m_local_header_ofs, header, sizeof(header)) !=
+      sizeof(header))
+    return false;
+  if (header[0] != 'P' || header[1] != 'K' || header[2] != 3 || header[3] != 4)
+    return false;
+
+  uint32_t nameLen = header[26] | (header[27] << 8);
+  uint32_t extraLen = header[28] | (header[29] << 8);
+  uint64_t offset =
+      fileStat.m_local_header_ofs + sizeof(header) + nameLen + extraLen;
+  if (offset + fileStat.m_comp_size > io.Size())
+    return false;
+
+  *dataOffset = offset;
+  *compSize = (uint32_t)fileStat.m_comp_size;
+  *uncompSize = (uint32_t)fileStat.m_uncomp_size;
+  *crc = fileStat.m_crc32;
+  *deflated = fileStat.m_method == MZ_DEFLATED;
+  return true;
+}
+
+bool EpubReader::OpenEntryStream(uint32_t fileIndex, ChapterStream &stream) {
+  stream.Close();
+  uint64_t offset;
+  uint32_t compSize, uncompSize, crc;
+  bool deflated;
+  if (!LocateEntryData(fileIndex, &offset, &compSize, &uncompSize, &crc,
+                       &deflated))
+    return false;
+
+  if (deflated) {
+    stream.input = (uint8_t *)malloc(INFLATE_INPUT_SIZE);
+    stream.inflater = stream.input ? inflateBackend->Create() : nullptr;
+    if (!stream.inflater) {
+      stream.Close();
+      return false;
+    }
+    stream.compRemaining = compSize;
+  }
+
+  stream.io = &io;
+  stream.dataOffset = offset;
+  stream.remaining = uncompSize;
+  stream.expectedCrc = crc;
+  return true;
+}
+
+uint8_t *EpubReader::InflateBuffer(const uint8_t *src, uint32_t compSize,
+                                   uint32_t uncompSize) {
+  Inflater *inflater = inflateBackend->Create();
+  uint8_t *out = (uint8_t *)malloc(uncompSize > 0 ? uncompSize : 1);
+  if (!inflater || !out) {
+    delete inflater;
+    free(out);
+    return nullptr;
+  }
+
+  size_t inPos = 0, outPos = 0;
+  InflateResult result = InflateResult::OK;
+  while (result == InflateResult::OK && outPos < uncompSize) {
+    size_t inBytes = compSize - inPos;
+    size_t outBytes = uncompSize - outPos;
+    result = inflater->Run(src + inPos, &inBytes, out + outPos, &outBytes,
+                           false);
+    inPos += inBytes;
+    outPos += outBytes;
+    if (inBytes == 0 && outBytes == 0)
+      break;
+  }
+  delete inflater;
+
+  if (outPos != uncompSize) {
+    free(out);
+    return nullptr;
+  }
+  return out;
+}
+
+bool EpubReader::BeginLoadFile(const char *href, size_t maxSize, int priority,
+                               EpubFileLoad &load) {
+  CancelLoadFile(load);
+  if (!zipArchive || !href || href[0] == '\0')
+    return false;
+
+  uint64_t offset;
+  if (!LocateEntryData(LocateFile(href), &offset, &load.compSize,
+                       &load.uncompSize, &load.crc, &load.deflated))
+    return false;
+  if (load.uncompSize > maxSize) {
+    DebugLogger::Log("%s too large: %u bytes. Skipping.", href,
+                     load.uncompSize);
+    return false;
+  }
+
+  load.data = (uint8_t *)malloc(load.compSize > 0 ? load.compSize : 1);
+  if (!load.data)
+    return false;
+
+  load.id = io.SubmitRead(offset, load.data, load.compSize, priority);
+  if (load.id == 0) {
+    // No async service (or its queue is full)
+    if (io.Read(offset, load.data, load.compSize) != load.compSize) {
+      CancelLoadFile(load);
+      return false;
+    }
+    load.ready = true;
+  }
+  return true;
+}
+
+AsyncReadStatus EpubReader::PollLoadFile(EpubFileLoad &load, uint8_t **outData,
+                                         size_t *outSize) {
+  if (!load.data)
+    return AsyncReadStatus::INVALID;
+
+  if (!load.ready) {
+    AsyncReadStatus status = io.PollRead(load.id, nullptr);
+    if (status == AsyncReadStatus::QUEUED ||
+        status == AsyncReadStatus::RUNNING)
+      return status;
+    load.id = 0;
+    if (status != AsyncReadStatus::DONE) {
+      CancelLoadFile(load);
+      return AsyncReadStatus::FAILED;
+    }
+    load.ready = true;
+  }
+
+  uint8_t *out = load.data;
+  if (load.deflated) {
+    out = InflateBuffer(load.data, load.compSize, load.uncompSize);
+    free(load.data);
+  }
+  load.data = nullptr;
+  load.ready = false;
+  if (!out)
+    return AsyncReadStatus::FAILED;
+  uint32_t crc = (uint32_t)mz_crc32(MZ_CRC32_INIT, out, load.uncompSize);
+  if (crc != load.crc) {
+    DebugLogger::Log("Entry CRC mismatch: %08x, expected %08x", crc,
+                     load.crc);
+    free(out);
+    return AsyncReadStatus::FAILED;
+  }
+
+  *outData = out;
+  *outSize = load.uncompSize;
+  return AsyncReadStatus::DONE;
+}
+
+void EpubReader::CancelLoadFile(EpubFileLoad &load) {
+  if (load.id)
+    io.CancelRead(load.id);
+  free(load.data);
+  load.id = 0;
+  load.data = nullptr;
+  load.ready = false;
+}
+
+bool EpubReader::OpenChapterStream(int chapterIndex, ChapterStream &stream) {
+  stream.Close();
+  if (!zipArchive || chapterIndex < 0 ||
+      chapterIndex >= (int)metadata.spine.size())
+    return false;
+  ChapterInfo &chapter = metadata.spine[chapterIndex];
+
+  uint32_t fileIndex = chapter.fileIndex != EPUB_NO_FILE_INDEX
+                           ? chapter.fileIndex
+                           : LocateFile(chapter.href);
+  if (!OpenEntryStream(fileIndex, stream)) {
+    DebugLogger::Log("Chapter stream failed: %s", chapter.href);
+    return false;
+  }
+
+  // Callers that open ahead of time (the prefetcher) find the first block
+  // already cached by the time they start reading
+  uint32_t archiveBytes =
+      stream.IsStored() ? stream.remaining : stream.compRemaining;
+  stream.ReadAhead(archiveBytes < INFLATE_INPUT_SIZE ? archiveBytes
+                                                     : INFLATE_INPUT_SIZE);
+
+  if (stream.IsStored()) {
+    DebugLogger::Log("Chapter %d: stored, %u bytes (direct read)",
+                     chapterIndex, stream.remaining);
+  } else {
+    DebugLogger::Log("Chapter %d: deflated (%s), %u -> %u bytes",
+                     chapterIndex, inflateBackend->GetName(),
+                     stream.compRemaining, stream.remaining);
+  }
+  return true;
+}
+
+ChapterStream::ChapterStream()
+    : io(nullptr), dataOffset(0), remaining(0), crc(MZ_CRC32_INIT),
+      expectedCrc(0), checkCrc(true), corrupt(false), inflater(nullptr),
+      compRemaining(0), input(nullptr), inputPos(0), inputLen(0) {}
+
+ChapterStream::~ChapterStream() { Close(); }
+
+// Keep bulk reads block-aligned in the archive so ZipIo hands them to the
+// backend directly instead of staging them through its cache
+static size_t AlignedReadSize(uint64_t offset, size_t want, uint32_t align) {
+  size_t head = align - (size_t)(offset % align);
+  if (head < align && want > head)
+    return head;
+  if (want >= align)
+    return want - want % align;
+  return want;
+}
+
+size_t ChapterStream::ReadStored(void *buf, size_t size) {
+  size_t want = size < remaining ? size : remaining;
+  size_t n = io->Read(dataOffset, buf,
+                      AlignedReadSize(dataOffset, want, io->GetBlockSize()));
+  dataOffset += n;
+  if (n > 0 && n < remaining)
+    ReadAhead(n < remaining - n ? n : remaining - n);
+  return n;
+}
+
+// Queue the archive bytes the next Read will want, so the disk works on
+// them while the main loop lays out and renders
+void ChapterStream::ReadAhead(size_t size) { io->Prefetch(dataOffset, size); }
+
+size_t ChapterStream::Read(void *buf, size_t size) {
+  if (remaining == 0 || !io)
+    return 0;
+
+  size_t produced = 0;
+  if (!inflater) {
+    produced = ReadStored(buf, size);
+  } else {
+    uint8_t *out = (uint8_t *)buf;
+    if (size > remaining)
+      size = remaining;
+    while (produced < size) {
+      if (inputPos == inputLen && compRemaining > 0) {
+        size_t want = compRemaining < INFLATE_INPUT_SIZE ? compRemaining
+                                                         : INFLATE_INPUT_SIZE;
+        inputLen = (uint32_t)io->Read(
+            dataOffset, input,
+            AlignedReadSize(dataOffset, want, io->GetBlockSize()));
+        inputPos = 0;
+        if (inputLen == 0)
+          break;
+        dataOffset += inputLen;
+        compRemaining -= inputLen;
+        if (compRemaining > 0)
+          ReadAhead(compRemaining < INFLATE_INPUT_SIZE ? compRemaining
+                                                       : INFLATE_INPUT_SIZE);
+      }
+
+      size_t inBytes = inputLen - inputPos;
+      size_t outBytes = size - produced;
+      InflateResult result = inflater->Run(input + inputPos, &inBytes,
+                                           out + produced, &outBytes,
+                                           compRemaining > 0);
+      inputPos += (uint32_t)inBytes;
+      produced += outBytes;
+      if (result != InflateResult::OK)
+        break;
+      // No progress with input still pending means the decoder is stuck
+      if (inBytes == 0 && outBytes == 0 &&
+          (inputPos < inputLen || compRemaining == 0))
+        break;
+    }
+  }
+
+  if (produced == 0) {
+    // Corrupt or truncated entry; treat what we got as the whole chapter
+    DebugLogger::Log("Chapter stream ended early (%u bytes left)", remaining);
+    remaining = 0;
+    return 0;
+  }
+  remaining -= (produced < remaining) ? (uint32_t)produced : remaining;
+  if (checkCrc) {
+    crc = (uint32_t)mz_crc32(crc, (const uint8_t *)buf, produced);
+    if (remaining == 0 && crc != expectedCrc) {
+      DebugLogger::Log("Chapter stream CRC mismatch: %08x, expected %08x", crc,
+                       expectedCrc);
+      corrupt = true;
+      return 0;
+    }
+  }
+  return produced;
+}
+
+bool ChapterStream::Skip(uint32_t bytes, void *scratch, size_t scratchSize) {
+  if (bytes > remaining)
+    return false;
+  if (IsStored()) {
+    // Jumped over unread, so there's no CRC to finish
+    dataOffset += bytes;
+    remaining -= bytes;
+    if (bytes > 0)
+      checkCrc = false;
+    return true;
+  }
+  while (bytes > 0) {
+    size_t n = Read(scratch, bytes < scratchSize ? bytes : scratchSize);
+    if (n == 0)
+      return false;
+    bytes -= (uint32_t)n;
+  }
+  return true;
+}
 
-  return (uint8_t *)mz_zip_reader_extract_file_to_heap(zip, metadata.coverHref,
-                                                       outSize, 0);
+void ChapterStream::Close() {
+  delete inflater;
+  inflater = nullptr;
+  free(input);
+  input = nullptr;
+  io = nullptr;
+  remaining = 0;
+  compRemaining = 0;
+  inputPos = inputLen = 0;
+  crc = MZ_CRC32_INIT;
+  checkCrc = true;
+  corrupt = false;
 }
@@ -0,0 +1,163 @@
+#include "href_resolver.h"
+#include <cstdlib>
+#include <cstring>
+
+#define HREF_EMPTY_SLOT 0xFFFFFFFFu
+
+// FNV-1a
+static uint32_t HashPath(const char *path) {
+  uint32_t h = 2166136261u;
+  for (; *path; path++) {
+    h ^= (uint8_t)*path;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static int HexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+HrefResolver::HrefResolver() : slots(nullptr), mask(0), count(0) {}
+
+HrefResolver::~HrefResolver() { Clear(); }
+
+void HrefResolver::Begin(int entryCount) {
+  Clear();
+  // Keep the load factor at or below 1/2 so probe runs stay short
+  uint32_t capacity = 16;
+  while (capacity < (uint32_t)entryCount * 2)
+    capacity <<= 1;
+
+  slots = (Slot *)malloc(capacity * sizeof(Slot));
+  if (!slots)
+    return;
+  for (uint32_t i = 0; i < capacity; i++)
+    slots[i].fileIndex = HREF_EMPTY_SLOT;
+  mask = capacity - 1;
+  names.reserve(entryCount * 32);
+}
+
+void HrefResolver::Clear() {
+  free(slots);
+  slots = nullptr;
+  mask = 0;
+  count = 0;
+  names.clear();
+}
+
+void HrefResolver::Add(const char *archiveName, uint32_t fileIndex,
+                       uint32_t localHeaderOfs) {
+  if (!slots || !archiveName || (uint32_t)count >= (mask + 1) / 2)
+    return;
+
+  // Duplicate names: the first entry wins, as with a linear search
+  uint32_t hash = HashPath(archiveName);
+  uint32_t i = hash & mask;
+  while (slots[i].fileIndex != HREF_EMPTY_SLOT) {
+    if (slots[i].hash == hash &&
+        strcmp(&names[slots[i].nameOffset], archiveName) == 0)
+      return;
+    i = (i + 1) & mask;
+  }
+
+  slots[i].hash = hash;
+  slots[i].fileIndex = fileIndex;
+  slots[i].localHeaderOfs = localHeaderOfs;
+  slots[i].nameOffset = (uint32_t)names.size();
+  names.insert(names.end(), archiveName, archiveName + strlen(archiveName) + 1);
+  count++;
+}
+
+const HrefResolver::Slot *HrefResolver::Find(const char *path) const {
+  if (!slots || path[0] == '\0')
+    return nullptr;
+
+  uint32_t hash = HashPath(path);
+  for (uint32_t i = hash & mask; slots[i].fileIndex != HREF_EMPTY_SLOT;
+       i = (i + 1) & mask) {
+    if (slots[i].hash == hash &&
+        strcmp(&names[slots[i].nameOffset], path) == 0)
+      return &slots[i];
+  }
+  return nullptr;
+}
+
+bool HrefResolver::Lookup(const char *href, uint32_t *fileIndex,
+                          uint32_t *localHeaderOfs) const {
+  if (!href)
+    return false;
+
+  char path[HREF_MAX_PATH];
+  Normalize("", href, true, path, sizeof(path));
+  const Slot *slot = Find(path);
+  if (!slot) {
+    // Archive names may legitimately contain '%'
+    Normalize("", href, false, path, sizeof(path));
+    slot = Find(path);
+  }
+  if (!slot)
+    return false;
+
+  if (fileIndex)
+    *fileIndex = slot->fileIndex;
+  if (localHeaderOfs)
+    *localHeaderOfs = slot->localHeaderOfs;
+  return true;
+}
+
+void HrefResolver::Normalize(const char *baseDir, const char *href,
+                             bool decode, char *out, size_t outSize) {
+  char joined[HREF_MAX_PATH * 2];
+  size_t len = 0;
+
+  if (baseDir && href[0] != '/') {
+    for (const char *p = baseDir; *p && len < sizeof(joined) - 1; p++)
+      joined[len++] = *p == '\\' ? '/' : *p;
+  }
+  for (const char *p = href; *p && *p != '#' && len < sizeof(joined) - 1;
+       p++) {
+    char c = *p;
+    if (decode && c == '%' && HexValue(p[1]) >= 0 && HexValue(p[2]) >= 0) {
+      c = (char)(HexValue(p[1]) * 16 + HexValue(p[2]));
+      p += 2;
+    } else if (c == '\\') {
+      c = '/';
+    }
+    joined[len++] = c;
+  }
+  joined[len] = '\0';
+
+  // Collapse empty, "." and ".." segments
+  size_t o = 0;
+  const char *seg = joined;
+  while (*seg) {
+    const char *end = strchr(seg, '/');
+    size_t segLen = end ? (size_t)(end - seg) : strlen(seg);
+
+    if (segLen == 0 || (segLen == 1 && seg[0] == '.')) {
+      // Nothing to emit
+    } else if (segLen == 2 && seg[0] == '.' && seg[1] == '.') {
+      while (o > 0 && out[o - 1] != '/')
+        o--;
+      if (o > 0)
+        o--;
+    } else {
+      if (o > 0 && o < outSize - 1)
+        out[o++] = '/';
+      for (size_t i = 0; i < segLen && o < outSize - 1; i++)
+        out[o++] = seg[i];
+    }
+
+    if (!end)
+      break;
+    seg = end + 1;
+  }
+  out[o] = '\0';
+}
@@ -0,0 +1,217 @@
+#include "inflate_backend.h"
+#include "debug_logger.h"
+#include "perf_timer.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <zlib.h>
+
+// miniz otherwise #defines the zlib API names onto its own
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "miniz.h"
+
+Inflater::Inflater(InflateBackend *owner) : owner(owner), trackedBytes(0) {
+  owner->stats.entries++;
+}
+
+Inflater::~Inflater() { Untrack(trackedBytes); }
+
+void Inflater::Track(size_t bytes) {
+  trackedBytes += bytes;
+  owner->TrackAlloc(bytes);
+}
+
+void Inflater::Untrack(size_t bytes) {
+  trackedBytes -= bytes;
+  owner->TrackFree(bytes);
+}
+
+InflateResult Inflater::Run(const uint8_t *in, size_t *inSize, uint8_t *out,
+                            size_t *outSize, bool moreInput) {
+  uint64_t startUs = PerfNowUs();
+  InflateResult result = Decode(in, inSize, out, outSize, moreInput);
+  owner->stats.timeUs += PerfNowUs() - startUs;
+  owner->stats.bytesIn += *inSize;
+  owner->stats.bytesOut += *outSize;
+  return result;
+}
+
+InflateBackend::InflateBackend() { memset(&stats, 0, sizeof(stats)); }
+
+void InflateBackend::ResetStats() {
+  size_t live = stats.liveBytes;
+  memset(&stats, 0, sizeof(stats));
+  stats.liveBytes = live;
+  stats.peakBytes = live;
+}
+
+void InflateBackend::LogStats() const {
+  if (stats.entries == 0)
+    return;
+  // bytes per us == MB/s
+  uint32_t rateX10 =
+      stats.timeUs > 0 ? (uint32_t)(stats.bytesOut * 10 / stats.timeUs) : 0;
+  DebugLogger::Log("Inflate (%s): %u entries, %u KB -> %u KB in %u us "
+                   "(%u.%u MB/s), peak state %u KB",
+                   GetName(), stats.entries, (uint32_t)(stats.bytesIn / 1024),
+                   (uint32_t)(stats.bytesOut / 1024), (uint32_t)stats.timeUs,
+                   rateX10 / 10, rateX10 % 10,
+                   (uint32_t)((stats.peakBytes + 1023) / 1024));
+}
+
+void InflateBackend::TrackAlloc(size_t bytes) {
+  stats.liveBytes += bytes;
+  if (stats.liveBytes > stats.peakBytes)
+    stats.peakBytes = stats.liveBytes;
+}
+
+void InflateBackend::TrackFree(size_t bytes) {
+  stats.liveBytes -= bytes < stats.liveBytes ? bytes : stats.liveBytes;
+}
+
+InflateBackend *InflateBackend::GetDefault() {
+#ifdef INFLATE_DEFAULT_ZLIB
+  static ZlibInflateBackend backend;
+#else
+  static TinflInflateBackend backend;
+#endif
+  return &backend;
+}
+
+// tinfl ----------------------------------------------------------------------
+
+class TinflInflater : public Inflater {
+public:
+  explicit TinflInflater(InflateBackend *owner)
+      : Inflater(owner), dictPos(0), pendingPos(0), pendingLen(0),
+        status(TINFL_STATUS_NEEDS_MORE_INPUT) {
+    tinfl_init(&decomp);
+    Track(sizeof(*this));
+  }
+
+protected:
+  InflateResult Decode(const uint8_t *in, size_t *inSize, uint8_t *out,
+                       size_t *outSize, bool moreInput) override {
+    size_t inAvail = *inSize, outAvail = *outSize;
+    size_t consumed = 0, produced = 0;
+
+    while (produced < outAvail) {
+      // Hand out what the last call left in the dictionary first
+      if (pendingLen > 0) {
+        size_t n = pendingLen < outAvail - produced ? pendingLen
+                                                    : outAvail - produced;
+        memcpy(out + produced, dict + pendingPos, n);
+        produced += n;
+        pendingPos += n;
+        pendingLen -= n;
+        continue;
+      }
+      if (status == TINFL_STATUS_DONE || status < TINFL_STATUS_DONE)
+        break;
+      if (status == TINFL_STATUS_NEEDS_MORE_INPUT && consumed == inAvail &&
+          moreInput)
+        break;
+
+      size_t inBytes = inAvail - consumed;
+      size_t outBytes = TINFL_LZ_DICT_SIZE - dictPos;
+      status = tinfl_decompress(&decomp, in + consumed, &inBytes, dict,
+                                dict + dictPos, &outBytes,
+                                moreInput ? TINFL_FLAG_HAS_MORE_INPUT : 0);
+      consumed += inBytes;
+      pendingPos = dictPos;
+      pendingLen = outBytes;
+      dictPos = (dictPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+
+    *inSize = consumed;
+    *outSize = produced;
+    if (status < TINFL_STATUS_DONE)
+      return InflateResult::ERROR;
+    return status == TINFL_STATUS_DONE && pendingLen == 0 ? InflateResult::DONE
+                                                          : InflateResult::OK;
+  }
+
+private:
+  tinfl_decompressor decomp;
+  uint8_t dict[TINFL_LZ_DICT_SIZE]; // Doubles as the output staging buffer
+  size_t dictPos;                   // Next write position
+  size_t pendingPos, pendingLen;    // Decoded but not yet delivered
+  tinfl_status status;
+};
+
+Inflater *TinflInflateBackend::Create() {
+  return new (std::nothrow) TinflInflater(this);
+}
+
+// zlib -----------------------------------------------------------------------
+
+class ZlibInflater : public Inflater {
+public:
+  explicit ZlibInflater(InflateBackend *owner) : Inflater(owner), ok(false) {
+    memset(&zs, 0, sizeof(zs));
+    zs.zalloc = Alloc;
+    zs.zfree = Free;
+    zs.opaque = this;
+    Track(sizeof(*this));
+    // Negative window bits: raw deflate, no zlib header or adler32
+    ok = inflateInit2(&zs, -MAX_WBITS) == Z_OK;
+  }
+
+  ~ZlibInflater() {
+    if (ok)
+      inflateEnd(&zs);
+  }
+
+  bool IsValid() const { return ok; }
+
+protected:
+  InflateResult Decode(const uint8_t *in, size_t *inSize, uint8_t *out,
+                       size_t *outSize, bool moreInput) override {
+    zs.next_in = (Bytef *)in;
+    zs.avail_in = (uInt)*inSize;
+    zs.next_out = out;
+    zs.avail_out = (uInt)*outSize;
+    int ret = inflate(&zs, Z_NO_FLUSH);
+    *inSize -= zs.avail_in;
+    *outSize -= zs.avail_out;
+
+    if (ret == Z_STREAM_END)
+      return InflateResult::DONE;
+    // Z_BUF_ERROR only means no progress was possible with these buffers
+    if (ret == Z_OK || (ret == Z_BUF_ERROR && (moreInput || *outSize > 0)))
+      return InflateResult::OK;
+    return InflateResult::ERROR;
+  }
+
+private:
+  z_stream zs;
+  bool ok;
+
+  // Size-prefixed so zfree can report what it releases
+  static voidpf Alloc(voidpf opaque, uInt items, uInt size) {
+    size_t bytes = (size_t)items * size;
+    size_t *block = (size_t *)malloc(sizeof(size_t) + bytes);
+    if (!block)
+      return Z_NULL;
+    block[0] = bytes;
+    ((ZlibInflater *)opaque)->Track(bytes);
+    return block + 1;
+  }
+
+  static void Free(voidpf opaque, voidpf address) {
+    if (!address)
+      return;
+    size_t *block = (size_t *)address - 1;
+    ((ZlibInflater *)opaque)->Untrack(block[0]);
+    free(block);
+  }
+};
+
+Inflater *ZlibInflateBackend::Create() {
+  ZlibInflater *inflater = new (std::nothrow) ZlibInflater(this);
+  if (inflater && !inflater->IsValid()) {
+    delete inflater;
+    return nullptr;
+  }
+  return inflater;
+}
@@ -0,0 +1,398 @@
+#include "zip_io.h"
+#include "perf_timer.h"
+#include <cstdlib>
+#include <cstring>
+
+StdioFileBackend::StdioFileBackend() : file(nullptr), size(0), position(0) {}
+
+StdioFileBackend::~StdioFileBackend() { Close(); }
+
+bool StdioFileBackend::Open(const char *path) {
+  Close();
+  file = fopen(path, "rb");
+  if (!file)
+    return false;
+
+  // Our block cache does the buffering; stdio's would just add a copy
+  setvbuf(file, nullptr, _IONBF, 0);
+  fseek(file, 0, SEEK_END);
+  long end = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  size = end > 0 ? (uint64_t)end : 0;
+  position = 0;
+  return true;
+}
+
+void StdioFileBackend::Close() {
+  if (file) {
+    fclose(file);
+    file = nullptr;
+  }
+  size = 0;
+  position = 0;
+}
+
+size_t StdioFileBackend::ReadAt(uint64_t offset, void *buf, size_t n) {
+  if (!file)
+    return 0;
+  if (offset != position && fseek(file, (long)offset, SEEK_SET) != 0)
+    return 0;
+  size_t got = fread(buf, 1, n, file);
+  position = offset + got;
+  return got;
+}
+
+size_t ThrottledFileBackend::ReadAt(uint64_t offset, void *buf, size_t n) {
+  uint64_t until = PerfNowUs() + latencyUs;
+  while (PerfNowUs() < until) {
+  }
+  return StdioFileBackend::ReadAt(offset, buf, n);
+}
+
+ZipIo::ZipIo()
+    : customBackend(nullptr), backend(nullptr),
+      blockSize(ZIP_IO_DEFAULT_BLOCK_SIZE),
+      blockCount(ZIP_IO_DEFAULT_BLOCK_COUNT), blockData(nullptr),
+      blockTags(nullptr), blockAges(nullptr), clock(0),
+      asyncService(nullptr), pendingCount(0) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+ZipIo::~ZipIo() { Close(); }
+
+void ZipIo::Configure(uint32_t newBlockSize, int newBlockCount) {
+  // Takes effect on the next Open
+  if (newBlockSize < ZIP_IO_SECTOR_SIZE)
+    newBlockSize = ZIP_IO_SECTOR_SIZE;
+  blockSize = (newBlockSize + ZIP_IO_SECTOR_SIZE - 1) &
+              ~(uint32_t)(ZIP_IO_SECTOR_SIZE - 1);
+  blockCount = newBlockCount < 1 ? 1 : newBlockCount;
+}
+
+void ZipIo::SetBackend(FileBackend *newBackend) { customBackend = newBackend; }
+
+bool ZipIo::Open(const char *path) {
+  Close();
+  memset(&stats, 0, sizeof(stats));
+
+  FileBackend *candidate = customBackend ? customBackend : &stdioBackend;
+  if (!candidate->Open(path))
+    return false;
+
+  blockData = (uint8_t *)malloc((size_t)blockSize * blockCount);
+  blockTags = (uint64_t *)malloc(sizeof(uint64_t) * blockCount);
+  blockAges = (uint32_t *)malloc(sizeof(uint32_t) * blockCount);
+  if (!blockData || !blockTags || !blockAges) {
+    candidate->Close();
+    Close();
+    return false;
+  }
+  for (int i = 0; i < blockCount; i++) {
+    blockTags[i] = UINT64_MAX;
+    blockAges[i] = 0;
+  }
+
+  backend = candidate;
+  return true;
+}
+
+void ZipIo::Close() {
+  CancelAll();
+  if (backend) {
+    backend->Close();
+    backend = nullptr;
+  }
+  free(blockData);
+  free(blockTags);
+  free(blockAges);
+  blockData = nullptr;
+  blockTags = nullptr;
+  blockAges = nullptr;
+}
+
+int ZipIo::FindBlock(uint64_t blockNo) {
+  for (int i = 0; i < blockCount; i++) {
+    if (blockTags[i] == blockNo) {
+      blockAges[i] = ++clock;
+      return i;
+    }
+  }
+  return -1;
+}
+
+void ZipIo::SetAsyncService(AsyncReadService *service) {
+  CancelAll();
+  asyncService = service;
+}
+
+bool ZipIo::IsInFlight() const {
+  for (int i = 0; i < pendingCount; i++) {
+    if (!pending[i].finished)
+      return true;
+  }
+  return false;
+}
+
+bool ZipIo::IsSlotPending(int slot) const {
+  for (int i = 0; i < pendingCount; i++) {
+    if (pending[i].slot == slot)
+      return true;
+  }
+  return false;
+}
+
+bool ZipIo::IsBlockPending(uint64_t blockNo) const {
+  for (int i = 0; i < pendingCount; i++) {
+    if (pending[i].slot >= 0 && pending[i].blockNo == blockNo)
+      return true;
+  }
+  return false;
+}
+
+void ZipIo::Settle(bool wait) {
+  for (int i = 0; i < pendingCount;) {
+    PendingRead &p = pending[i];
+    if (p.finished) {
+      i++;
+      continue;
+    }
+
+    size_t bytes = 0;
+    AsyncReadStatus status = wait ? asyncService->Wait(p.id, &bytes)
+                                  : asyncService->Poll(p.id, &bytes);
+    if (status == AsyncReadStatus::QUEUED ||
+        status == AsyncReadStatus::RUNNING) {
+      i++;
+      continue;
+    }
+    if (status == AsyncReadStatus::DONE || status == AsyncReadStatus::FAILED) {
+      stats.backendReads++;
+      stats.backendBytes += bytes;
+      stats.asyncReads++;
+    }
+
+    if (p.slot < 0) {
+      // Held until the caller polls for it
+      p.finished = true;
+      p.status = status;
+      p.bytes = bytes;
+      i++;
+      continue;
+    }
+    if (status == AsyncReadStatus::DONE) {
+      blockTags[p.slot] = p.blockNo;
+      blockAges[p.slot] = ++clock;
+    }
+    pending[i] = pending[--pendingCount];
+  }
+}
+
+void ZipIo::CancelAll() {
+  for (int i = 0; i < pendingCount; i++) {
+    if (!pending[i].finished && !asyncService->Cancel(pending[i].id))
+      asyncService->Wait(pending[i].id, nullptr);
+  }
+  pendingCount = 0;
+}
+
+void ZipIo::Prefetch(uint64_t offset, size_t size) {
+  if (!asyncService || !backend || offset >= backend->Size() || size == 0)
+    return;
+  if (pendingCount > 0)
+    Settle(false);
+
+  uint64_t end = offset + size;
+  if (end > backend->Size())
+    end = backend->Size();
+
+  for (uint64_t blockNo = offset / blockSize;
+       blockNo <= (end - 1) / blockSize && pendingCount < ZIP_IO_MAX_PENDING;
+       blockNo++) {
+    bool cached = false;
+    int victim = -1;
+    int busy = 0;
+    for (int i = 0; i < blockCount; i++) {
+      if (blockTags[i] == blockNo)
+        cached = true;
+      if (IsSlotPending(i))
+        busy++;
+      else if (victim < 0 || blockAges[i] < blockAges[victim])
+        victim = i;
+    }
+    if (cached || IsBlockPending(blockNo))
+      continue;
+    // Always leave one slot for blocking reads (central directory, headers)
+    if (victim < 0 || busy + 1 >= blockCount)
+      break;
+
+    uint64_t start = blockNo * blockSize;
+    size_t want = (size_t)((backend->Size() - start < blockSize)
+                               ? backend->Size() - start
+                               : blockSize);
+    AsyncReadRequest request;
+    request.file = backend;
+    request.offset = start;
+    request.buf = blockData + (size_t)victim * blockSize;
+    request.size = want;
+    request.priority = ASYNC_PRIORITY_NORMAL;
+
+    blockTags[victim] = UINT64_MAX;
+    AsyncReadId id = asyncService->Submit(request);
+    if (!id)
+      break;
+
+    PendingRead &p = pending[pendingCount++];
+    p.id = id;
+    p.slot = victim;
+    p.blockNo = blockNo;
+    p.finished = false;
+    p.status = AsyncReadStatus::QUEUED;
+    p.bytes = 0;
+  }
+}
+
+AsyncReadId ZipIo::SubmitRead(uint64_t offset, void *buf, size_t size,
+                              int priority) {
+  if (!asyncService || !backend || pendingCount >= ZIP_IO_MAX_PENDING ||
+      offset > backend->Size() || size > backend->Size() - offset)
+    return 0;
+
+  AsyncReadRequest request;
+  request.file = backend;
+  request.offset = offset;
+  request.buf = buf;
+  request.size = size;
+  request.priority = priority;
+  AsyncReadId id = asyncService->Submit(request);
+  if (!id)
+    return 0;
+
+  PendingRead &p = pending[pendingCount++];
+  p.id = id;
+  p.slot = -1;
+  p.blockNo = 0;
+  p.finished = false;
+  p.status = AsyncReadStatus::QUEUED;
+  p.bytes = 0;
+  return id;
+}
+
+AsyncReadStatus ZipIo::PollRead(AsyncReadId id, size_t *bytesRead) {
+  if (pendingCount > 0)
+    Settle(false);
+  for (int i = 0; i < pendingCount; i++) {
+    PendingRead &p = pending[i];
+    if (p.id != id || p.slot >= 0)
+      continue;
+    if (!p.finished)
+      return AsyncReadStatus::QUEUED;
+    AsyncReadStatus status = p.status;
+    if (bytesRead)
+      *bytesRead = p.bytes;
+    pending[i] = pending[--pendingCount];
+    return status;
+  }
+  return AsyncReadStatus::INVALID;
+}
+
+void ZipIo::CancelRead(AsyncReadId id) {
+  for (int i = 0; i < pendingCount; i++) {
+    PendingRead &p = pending[i];
+    if (p.id != id || p.slot >= 0)
+      continue;
+    if (!p.finished && !asyncService->Cancel(id))
+      asyncService->Wait(id, nullptr);
+    pending[i] = pending[--pendingCount];
+    return;
+  }
+}
+
+int ZipIo::LoadBlock(uint64_t blockNo) {
+  int victim = 0;
+  for (int i = 1; i < blockCount; i++) {
+    if (blockAges[i] < blockAges[victim])
+      victim = i;
+  }
+
+  uint64_t start = blockNo * blockSize;
+  uint64_t fileSize = backend->Size();
+  size_t want = (size_t)((fileSize - start < blockSize) ? fileSize - start
+                                                         : blockSize);
+  uint8_t *dst = blockData + (size_t)victim * blockSize;
+
+  size_t got = backend->ReadAt(start, dst, want);
+  stats.backendReads++;
+  stats.backendBytes += got;
+  if (got != want) {
+    blockTags[victim] = UINT64_MAX;
+    return -1;
+  }
+
+  blockTags[victim] = blockNo;
+  blockAges[victim] = ++clock;
+  return victim;
+}
+
+size_t ZipIo::Read(uint64_t offset, void *buf, size_t size) {
+  if (!backend || offset >= backend->Size())
+    return 0;
+  if (size > backend->Size() - offset)
+    size = (size_t)(backend->Size() - offset);
+
+  if (pendingCount > 0)
+    Settle(false);
+
+  stats.reads++;
+  bool allHit = true;
+  uint8_t *out = (uint8_t *)buf;
+  uint64_t pos = offset;
+  size_t left = size;
+
+  while (left > 0) {
+    uint64_t blockNo = pos / blockSize;
+    size_t within = (size_t)(pos % blockSize);
+    int slot = FindBlock(blockNo);
+    if (slot < 0 && IsInFlight()) {
+      // The block may be on its way; either way the backend must be idle
+      // before we read from it here
+      stats.asyncWaits++;
+      Settle(true);
+      slot = FindBlock(blockNo);
+    }
+
+    if (slot < 0 && within == 0 && left >= blockSize) {
+      // Whole blocks (bulk compressed data) bypass the cache
+      size_t direct = left - left % blockSize;
+      size_t got = backend->ReadAt(pos, out, direct);
+      stats.backendReads++;
+      stats.backendBytes += got;
+      allHit = false;
+      out += got;
+      pos += got;
+      left -= got;
+      if (got != direct)
+        break;
+      continue;
+    }
+
+    if (slot < 0) {
+      allHit = false;
+      slot = LoadBlock(blockNo);
+      if (slot < 0)
+        break;
+    }
+
+    size_t chunk = blockSize - within;
+    if (chunk > left)
+      chunk = left;
+    memcpy(out, blockData + (size_t)slot * blockSize + within, chunk);
+    out += chunk;
+    pos += chunk;
+    left -= chunk;
+  }
+
+  if (allHit)
+    stats.hits++;
+  stats.bytes += size - left;
+  return size - left;
+}
@@ -2,6 +2,7 @@
 #include "debug_logger.h"
 #include <SDL2/SDL_image.h>
 #include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <dirent.h>
 #include <fstream>
@@ -9,11 +10,12 @@
 #include <sstream>
 #include <sys/stat.h>
 
-LibraryManager::LibraryManager() {}
+LibraryManager::LibraryManager() : thumbLoading(-1) {}
 
 LibraryManager::~LibraryManager() { Clear(); }
 
 void LibraryManager::Clear() {
+  CancelThumbnailLoad();
   for (auto &book : books) {
     if (book.thumbnail) {
       SDL_DestroyTexture(book.thumbnail);
@@ -27,16 +29,23 @@ bool LibraryManager::ScanDirectory(const std::string &path) {
   std::string cachePath = path + "/library.cache";
 
   // Load existing metadata from cache for faster scanning
-  std::map<std::string, std::pair<std::string, std::string>> cacheMap;
+  // Line format: filename|title|author|coverHref
+  std::map<std::string, BookEntry> cacheMap;
   std::ifstream cacheFile(cachePath);
   if (cacheFile.is_open()) {
     std::string line;
     while (std::getline(cacheFile, line)) {
+      // Entries written before cover hrefs were recorded get rescanned
+      if (std::count(line.begin(), line.end(), '|') < 3)
+        continue;
       std::stringstream ss(line);
-      std::string fname, title, author;
-      if (std::getline(ss, fname, '|') && std::getline(ss, title, '|') &&
-          std::getline(ss, author)) {
-        cacheMap[fname] = {title, author};
+      BookEntry book;
+      if (std::getline(ss, book.filename, '|') &&
+          std::getline(ss, book.title, '|') &&
+          std::getline(ss, book.author, '|')) {
+        std::getline(ss, book.coverHref);
+        book.coverKnown = true;
+        cacheMap[book.filename] = book;
       }
     }
     cacheFile.close();
@@ -59,18 +68,17 @@ bool LibraryManager::ScanDirectory(const std::string &path) {
       std::string fullPath = path + "/" + entry->d_name;
 
       if (cacheMap.count(fullPath)) {
-        BookEntry book;
-        book.filename = fullPath;
-        book.title = cacheMap[fullPath].first;
-        book.author = cacheMap[fullPath].second;
-        books.push_back(book);
+        books.push_back(cacheMap[fullPath]);
       } else {
+        // Only container.xml and the OPF up to </manifest> are read here
         static EpubReader sharedReader;
-        if (sharedReader.Open(fullPath.c_str())) {
+        if (sharedReader.Open(fullPath.c_str(), EpubOpenMode::METADATA)) {
           BookEntry book;
           book.filename = fullPath;
           book.title = sharedReader.GetMetadata().title;
           book.author = sharedReader.GetMetadata().author;
+          book.coverHref = sharedReader.GetMetadata().coverHref;
+          book.coverKnown = true;
 
           // Fallback if metadata is empty
           if (book.title.empty())
@@ -80,7 +88,7 @@ bool LibraryManager::ScanDirectory(const std::string &path) {
 
           books.push_back(book);
 
-          cacheMap[fullPath] = {book.title, book.author};
+          cacheMap[fullPath] = book;
           cacheDirty = true;
           // DebugLogger::Log("Library found (new): %s", book.title.c_str());
         } else {
@@ -91,11 +99,12 @@ bool LibraryManager::ScanDirectory(const std::string &path) {
           book.filename = fullPath;
           book.title = entry->d_name; // Use filename as title
           book.author = "Unknown (Parse Error)";
+          book.coverKnown = true; // No cover we could ever find
           books.push_back(book);
 
           // Add to cache so we don't retry parsing every boot (unless user
           // deletes cache)
-          cacheMap[fullPath] = {book.title, book.author};
+          cacheMap[fullPath] = book;
           cacheDirty = true;
         }
       }
@@ -108,7 +117,7 @@ bool LibraryManager::ScanDirectory(const std::string &path) {
     if (outFile.is_open()) {
       for (const auto &book : books) {
         outFile << book.filename << "|" << book.title << "|" << book.author
-                << "\n";
+                << "|" << book.coverHref << "\n";
       }
       outFile.close();
       // DebugLogger::Log("Library cache updated: %s", cachePath.c_str());
@@ -122,25 +131,72 @@ void LibraryManager::LoadThumbnail(SDL_Renderer *renderer, int index) {
   if (index < 0 || index >= (int)books.size() || books[index].thumbnail)
     return;
 
-  // DebugLogger::Log("Loading thumbnail for: %s",
-  // books[index].filename.c_str());
-  EpubReader reader;
-  if (reader.Open(books[index].filename.c_str())) {
-    books[index].thumbnail = CreateThumbnail(renderer, reader);
-    if (books[index].thumbnail) {
-      SDL_QueryTexture(books[index].thumbnail, nullptr, nullptr,
-                       &books[index].thumbW, &books[index].thumbH);
+  BookEntry &book = books[index];
+  if (book.coverKnown && book.coverHref.empty())
+    return; // Book has no cover; placeholder is drawn instead
+
+  if (thumbLoading != index) {
+    if (thumbLoading >= 0)
+      return; // Another cover is still loading; this one gets its turn next
+
+    // DebugLogger::Log("Loading thumbnail for: %s", book.filename.c_str());
+    if (book.coverKnown) {
+      // The href was recorded at scan time: only the central directory is
+      // read
+      if (!thumbReader.Open(book.filename.c_str(), EpubOpenMode::ARCHIVE)) {
+        DebugLogger::Log("Failed to open ebook for thumbnail: %s",
+                         book.filename.c_str());
+        return;
+      }
+    } else if (thumbReader.Open(book.filename.c_str(),
+                                EpubOpenMode::METADATA)) {
+      book.coverHref = thumbReader.GetMetadata().coverHref;
+      book.coverKnown = true;
     } else {
+      DebugLogger::Log("Failed to open ebook for thumbnail: %s",
+                       book.filename.c_str());
+      return;
+    }
+
+    if (!thumbReader.BeginLoadFile(book.coverHref.c_str(), EPUB_COVER_MAX_SIZE,
+                                   ASYNC_PRIORITY_LOW, thumbLoad)) {
+      thumbReader.Close();
       DebugLogger::Log("Thumbnail creation failed for: %s",
-                       books[index].filename.c_str());
+                       book.filename.c_str());
+      return;
     }
+    thumbLoading = index;
+  }
+
+  uint8_t *data = nullptr;
+  size_t size = 0;
+  AsyncReadStatus status = thumbReader.PollLoadFile(thumbLoad, &data, &size);
+  if (status == AsyncReadStatus::QUEUED || status == AsyncReadStatus::RUNNING)
+    return; // Placeholder stays up meanwhile
+  thumbReader.Close();
+  thumbLoading = -1;
+
+  book.thumbnail = CreateThumbnail(renderer, data, size);
+  if (book.thumbnail) {
+    SDL_QueryTexture(book.thumbnail, nullptr, nullptr, &book.thumbW,
+                     &book.thumbH);
   } else {
-    DebugLogger::Log("Failed to open ebook for thumbnail: %s",
-                     books[index].filename.c_str());
+    DebugLogger::Log("Thumbnail creation failed for: %s",
+                     book.filename.c_str());
   }
 }
 
+void LibraryManager::CancelThumbnailLoad() {
+  if (thumbLoading < 0)
+    return;
+  thumbReader.CancelLoadFile(thumbLoad);
+  thumbReader.Close();
+  thumbLoading = -1;
+}
+
 void LibraryManager::UnloadThumbnail(int index) {
+  if (index == thumbLoading)
+    CancelThumbnailLoad();
   if (index < 0 || index >= (int)books.size() || !books[index].thumbnail)
     return;
 
@@ -151,11 +207,11 @@ void LibraryManager::UnloadThumbnail(int index) {
 }
 
 SDL_Texture *LibraryManager::CreateThumbnail(SDL_Renderer *renderer,
-                                             EpubReader &reader) {
-  size_t size = 0;
-  uint8_t *data = reader.LoadCover(&size);
-  if (!data || size == 0)
+                                             uint8_t *data, size_t size) {
+  if (!data || size == 0) {
+    free(data);
     return nullptr;
+  }
 
   SDL_RWops *rw = SDL_RWFromMem(data, size);
   if (!rw) {
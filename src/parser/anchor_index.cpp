@@ -0,0 +1,74 @@
+#include "anchor_index.h"
+#include "epub_reader.h"
+#include <cstring>
+
+AnchorIndex::AnchorIndex() : reader(nullptr), chapter(-1) { Clear(); }
+
+void AnchorIndex::Clear() {
+  memset(slots, 0xFF, sizeof(slots));
+  anchorCount = 0;
+  linkCount = 0;
+}
+
+void AnchorIndex::SetSource(EpubReader *reader, int chapter) {
+  this->reader = reader;
+  this->chapter = chapter;
+}
+
+void AnchorIndex::AddAnchor(uint32_t id, int wordIndex) {
+  uint32_t i = id & (ANCHOR_SLOTS - 1);
+  for (; slots[i] != ANCHOR_NONE; i = (i + 1) & (ANCHOR_SLOTS - 1)) {
+    if (anchors[slots[i]].id == id)
+      return;
+  }
+  if (anchorCount == ANCHOR_MAX)
+    return;
+  anchors[anchorCount].id = id;
+  anchors[anchorCount].wordIndex = wordIndex;
+  slots[i] = (uint16_t)anchorCount++;
+}
+
+int AnchorIndex::FindAnchor(uint32_t id) const {
+  for (uint32_t i = id & (ANCHOR_SLOTS - 1); slots[i] != ANCHOR_NONE;
+       i = (i + 1) & (ANCHOR_SLOTS - 1)) {
+    if (anchors[slots[i]].id == id)
+      return anchors[slots[i]].wordIndex;
+  }
+  return -1;
+}
+
+int AnchorIndex::Resolve(const char *href, uint32_t *anchor) const {
+  *anchor = 0;
+  if (href[0] == '#') {
+    // Within the chapter: no path to resolve
+    if (href[1] != '\0')
+      *anchor = AnchorHash(href + 1, strlen(href + 1));
+    return chapter;
+  }
+  return reader ? reader->ResolveHref(chapter, href, anchor) : -1;
+}
+
+void AnchorIndex::AddLink(int firstWord, int endWord, int spineIndex,
+                          uint32_t anchor) {
+  if (endWord <= firstWord || linkCount == LINK_MAX ||
+      (linkCount > 0 && firstWord < links[linkCount - 1].endWord))
+    return;
+  ChapterLink &link = links[linkCount++];
+  link.firstWord = firstWord;
+  link.endWord = endWord;
+  link.spineIndex = spineIndex;
+  link.anchor = anchor;
+}
+
+int AnchorIndex::FindLink(int wordIndex) const {
+  int lo = 0;
+  int hi = linkCount;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (links[mid].endWord <= wordIndex)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
@@ -0,0 +1,160 @@
+#include "chapter_cache.h"
+#include "debug_logger.h"
+#include <cstdlib>
+#include <cstring>
+
+ChapterCache::ChapterCache() : budget(CHAPTER_CACHE_BUDGET), clock(0) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+ChapterCache::~ChapterCache() {
+  for (size_t i = 0; i < entries.size(); i++)
+    free(entries[i].data);
+}
+
+void ChapterCache::SetBudget(size_t bytes) {
+  budget = bytes;
+  EvictToFit(0);
+}
+
+void ChapterCache::Clear() {
+  if (stats.hits + stats.misses > 0) {
+    DebugLogger::Log("Chapter cache: %u hits, %u misses, %u evictions, "
+                     "%u KB in %d chapters",
+                     stats.hits, stats.misses, stats.evictions,
+                     (unsigned)(stats.bytesUsed / 1024), stats.entries);
+  }
+  for (size_t i = 0; i < entries.size(); i++)
+    free(entries[i].data);
+  entries.clear();
+  clock = 0;
+  memset(&stats, 0, sizeof(stats));
+}
+
+int ChapterCache::Find(int chapterIndex) {
+  for (int i = 0; i < (int)entries.size(); i++) {
+    if (entries[i].chapterIndex == chapterIndex)
+      return i;
+  }
+  return -1;
+}
+
+void ChapterCache::Evict(int slot) {
+  stats.bytesUsed -= entries[slot].size;
+  stats.entries--;
+  stats.evictions++;
+  free(entries[slot].data);
+  entries[slot] = entries.back();
+  entries.pop_back();
+}
+
+void ChapterCache::EvictToFit(size_t incoming) {
+  while (stats.bytesUsed + incoming > budget && !entries.empty()) {
+    int oldest = 0;
+    for (int i = 1; i < (int)entries.size(); i++) {
+      if (entries[i].lastUse < entries[oldest].lastUse)
+        oldest = i;
+    }
+    Evict(oldest);
+  }
+}
+
+bool ChapterCache::Store(const ChapterBuffer &chapter) {
+  // A slid window no longer holds the whole chapter
+  if (!chapter.IsComplete() || chapter.windowBase != 0)
+    return false;
+
+  int slot = Find(chapter.chapterIndex);
+  if (slot >= 0) {
+    entries[slot].lastUse = ++clock;
+    return true;
+  }
+
+  int count = chapter.WordCount();
+  int textBytes = 0;
+  for (int i = 0; i < count; i++)
+    textBytes += chapter.wordLens[i];
+  int runCount = chapter.RunCount();
+  int anchorCount = chapter.anchors.GetAnchorCount();
+  int linkCount = chapter.anchors.GetLinkCount();
+  size_t size = (size_t)count * 2 + (size_t)runCount * sizeof(StyleRun) +
+                anchorCount * sizeof(ChapterAnchor) +
+                linkCount * sizeof(ChapterLink) + textBytes;
+  if (size > budget)
+    return false;
+
+  EvictToFit(size);
+
+  uint8_t *data = (uint8_t *)malloc(size > 0 ? size : 1);
+  if (!data)
+    return false;
+
+  StyleRun *runs = (StyleRun *)data;
+  ChapterAnchor *anchors = (ChapterAnchor *)(runs + runCount);
+  ChapterLink *links = (ChapterLink *)(anchors + anchorCount);
+  uint8_t *lens = (uint8_t *)(links + linkCount);
+  uint8_t *flags = lens + count;
+  char *text = (char *)(flags + count);
+  memcpy(runs, chapter.styleRuns, runCount * sizeof(StyleRun));
+  memcpy(anchors, chapter.anchors.GetAnchors(),
+         anchorCount * sizeof(ChapterAnchor));
+  memcpy(links, chapter.anchors.GetLinks(), linkCount * sizeof(ChapterLink));
+  memcpy(lens, chapter.wordLens, count);
+  memcpy(flags, chapter.wordFlags, count);
+  if (chapter.inPlace) {
+    // Words still sit in the chapter text: gather them
+    for (int i = 0; i < count; i++) {
+      memcpy(text, chapter.WordText(i), lens[i]);
+      text += lens[i];
+    }
+  } else {
+    memcpy(text, chapter.wordBuffer, textBytes); // Already back to back
+  }
+
+  Entry e;
+  e.chapterIndex = chapter.chapterIndex;
+  e.wordCount = count;
+  e.textBytes = textBytes;
+  e.runCount = runCount;
+  e.anchorCount = anchorCount;
+  e.linkCount = linkCount;
+  e.data = data;
+  e.size = size;
+  e.lastUse = ++clock;
+  entries.push_back(e);
+  stats.bytesUsed += size;
+  stats.entries++;
+  return true;
+}
+
+bool ChapterCache::Restore(int chapterIndex, ChapterBuffer &chapter) {
+  int slot = Find(chapterIndex);
+  if (slot < 0) {
+    stats.misses++;
+    return false;
+  }
+
+  Entry &e = entries[slot];
+  e.lastUse = ++clock;
+  stats.hits++;
+
+  const StyleRun *runs = (const StyleRun *)e.data;
+  const ChapterAnchor *anchors = (const ChapterAnchor *)(runs + e.runCount);
+  const ChapterLink *links = (const ChapterLink *)(anchors + e.anchorCount);
+  const uint8_t *lens = (const uint8_t *)(links + e.linkCount);
+  const uint8_t *flags = lens + e.wordCount;
+  memcpy(chapter.wordBuffer, flags + e.wordCount, e.textBytes);
+  memcpy(chapter.wordLens, lens, e.wordCount);
+  memcpy(chapter.styleRuns, runs, e.runCount * sizeof(StyleRun));
+  memcpy(chapter.wordFlags, flags, e.wordCount);
+  chapter.Adopt(chapterIndex, e.wordCount, e.textBytes, e.runCount);
+  for (int i = 0; i < e.anchorCount; i++)
+    chapter.anchors.AddAnchor(anchors[i].id, anchors[i].wordIndex);
+  for (int i = 0; i < e.linkCount; i++)
+    chapter.anchors.AddLink(links[i].firstWord, links[i].endWord,
+                            links[i].spineIndex, links[i].anchor);
+
+  DebugLogger::Log("Chapter cache hit: Ch %d (%d words)", chapterIndex,
+                   e.wordCount);
+  return true;
+}
@@ -0,0 +1,387 @@
+#include "chapter_prefetcher.h"
+#include "chapter_cache.h"
+#include "debug_logger.h"
+#include "perf_timer.h"
+
+bool ChapterBuffer::Load(EpubReader &reader, int chapter) {
+  Reset();
+  if (!reader.OpenChapterStream(chapter, stream))
+    return false;
+
+  this->reader = &reader;
+  extractor.SetStyles(&reader.GetStyles());
+  BindTables(chapter);
+  anchors.SetSource(&reader, chapter);
+  inPlace = stream.Remaining() <= WORD_BUFFER_SIZE && chapter != copyChapter;
+  BeginWindow(0);
+  checkpointCount = 0;
+  checkpointSpacing = CHECKPOINT_SPACING;
+  chapterIndex = chapter;
+  return true;
+}
+
+// Reloading the same chapter (Seek, RestartCopying) keeps its tokens and
+// anchors
+void ChapterBuffer::BindTables(int chapter) {
+  if (chapter != tablesChapter) {
+    tokens.Clear();
+    anchors.Clear();
+    tablesChapter = chapter;
+  }
+  extractor.SetTokens(&tokens, wordTokens);
+  extractor.SetAnchors(&anchors);
+}
+
+void ChapterBuffer::BeginWindow(int wordIndex) {
+  extractor.Begin(wordOffsets, wordFlags, wordLens, MAX_WORDS, styleRuns,
+                  MAX_STYLE_RUNS, wordBuffer, WORD_BUFFER_SIZE, inPlace);
+  extractor.SetWordBase(wordIndex);
+  windowBase = wordIndex;
+  streamOffset = 0;
+  blockPos = 0;
+  blockLen = 0;
+}
+
+void ChapterBuffer::Checkpoint() {
+  int wordIndex = WindowEnd();
+  if (checkpointCount > 0 &&
+      wordIndex - checkpoints[checkpointCount - 1].wordIndex <
+          checkpointSpacing)
+    return;
+
+  if (checkpointCount == CHAPTER_CHECKPOINTS) {
+    // Out of slots: keep every other snapshot and space future ones wider
+    for (int i = 1; i < CHAPTER_CHECKPOINTS / 2; i++)
+      checkpoints[i] = checkpoints[i * 2];
+    checkpointCount = CHAPTER_CHECKPOINTS / 2;
+    checkpointSpacing *= 2;
+  }
+
+  ChapterCheckpoint &cp = checkpoints[checkpointCount++];
+  cp.streamOffset = streamOffset;
+  cp.wordIndex = wordIndex;
+  extractor.SaveState(cp.state);
+}
+
+bool ChapterBuffer::Pump(int maxBlocks, int maxBytes) {
+  if (inPlace)
+    return PumpInPlace(maxBlocks, maxBytes);
+
+  while (stream.IsOpen() && !extractor.IsFull() && maxBytes > 0) {
+    if (blockPos == blockLen) {
+      if (stream.IsDone()) {
+        extractor.Finish();
+        stream.Close();
+        break;
+      }
+      if (maxBlocks-- <= 0)
+        break;
+
+      Checkpoint();
+      size_t n = stream.Read(block, ReadSize(maxBytes));
+      if (n == 0) {
+        extractor.Finish();
+        stream.Close();
+        break;
+      }
+      blockPos = 0;
+      blockLen = (int)n;
+      streamOffset += (uint32_t)n;
+    }
+    int len = blockLen - blockPos < maxBytes ? blockLen - blockPos : maxBytes;
+    blockPos += extractor.Feed(block + blockPos, len);
+    maxBytes -= len;
+  }
+  return IsReady();
+}
+
+// Each block is inflated onto the end of the text already in wordBuffer and
+// tokenized where it lands
+bool ChapterBuffer::PumpInPlace(int maxBlocks, int maxBytes) {
+  while (stream.IsOpen() && !extractor.IsFull()) {
+    int avail = (int)streamOffset - blockPos;
+    int len = avail < maxBytes ? avail : maxBytes;
+    blockPos += extractor.Feed(wordBuffer + blockPos, len);
+    maxBytes -= len;
+    if (extractor.IsFull() || maxBytes <= 0)
+      break;
+    // Feed() only leaves a UTF-8 sequence cut off by the end of the text:
+    // the next block completes it, or Finish() drops it
+    if (stream.IsDone()) {
+      extractor.Finish();
+      stream.Close();
+      break;
+    }
+    if (maxBlocks-- <= 0)
+      break;
+
+    size_t n = stream.Read(wordBuffer + streamOffset, ReadSize(maxBytes));
+    if (n == 0) {
+      extractor.Finish();
+      stream.Close();
+      break;
+    }
+    streamOffset += (uint32_t)n;
+  }
+  if (extractor.HasOverflowed())
+    return RestartCopying(maxBlocks, maxBytes);
+  return IsReady();
+}
+
+// Inflate no further ahead than the caller means to tokenize, so a small
+// first slice doesn't wait for a whole block
+size_t ChapterBuffer::ReadSize(int maxBytes) {
+  return maxBytes < CHAPTER_BLOCK_SIZE ? (size_t)maxBytes : CHAPTER_BLOCK_SIZE;
+}
+
+bool ChapterBuffer::PumpFor(uint32_t budgetUs) {
+  uint64_t startUs = PerfNowUs();
+  while (!IsReady() && IsLoaded()) {
+    Pump(1, CHAPTER_SLICE_SIZE);
+    if (PerfNowUs() - startUs >= budgetUs)
+      break;
+  }
+  return IsReady();
+}
+
+// Something decoded longer than its source (malformed UTF-8, &nGt;) and
+// didn't fit in place. Tokenize the chapter again copying words out, back to
+// the same window; the words come out the same.
+bool ChapterBuffer::RestartCopying(int maxBlocks, int maxBytes) {
+  int chapter = chapterIndex;
+  int base = windowBase;
+  copyChapter = chapter;
+  DebugLogger::Log("Chapter %d: text doesn't fit in place, copying", chapter);
+  if (!Load(*reader, chapter) || !Seek(*reader, base))
+    return false;
+  return Pump(maxBlocks, maxBytes);
+}
+
+void ChapterBuffer::Reset() {
+  stream.Close();
+  chapterIndex = -1;
+  windowBase = 0;
+}
+
+void ChapterBuffer::Close() {
+  Reset();
+  tablesChapter = -1;
+  copyChapter = -1;
+}
+
+void ChapterBuffer::Adopt(int chapter, int wordCount, int bufferUsed,
+                          int runCount) {
+  Reset();
+  inPlace = false;
+  BindTables(chapter);
+  BeginWindow(0);
+  uint32_t pos = 0;
+  int r = 0;
+  for (int i = 0; i < wordCount; i++) {
+    wordOffsets[i] = pos;
+    while (r + 1 < runCount && styleRuns[r + 1].start <= i)
+      r++;
+    wordTokens[i] = (wordFlags[i] & WORD_NEWLINE)
+                        ? TOKEN_NONE
+                        : tokens.Intern(wordBuffer + pos, wordLens[i],
+                                        styleRuns[r].style,
+                                        styleRuns[r].emphasis);
+    pos += wordLens[i];
+  }
+  extractor.Adopt(wordCount, bufferUsed, runCount);
+  checkpointCount = 0;
+  checkpointSpacing = CHECKPOINT_SPACING;
+  chapterIndex = chapter;
+}
+
+void ChapterBuffer::Discard(int count) {
+  if (count > WordCount())
+    count = WordCount();
+  if (count <= 0)
+    return;
+  extractor.Discard(count);
+  windowBase += count;
+}
+
+bool ChapterBuffer::Seek(EpubReader &reader, int wordIndex) {
+  if (chapterIndex < 0)
+    return false;
+  if (wordIndex >= windowBase && wordIndex <= WindowEnd()) {
+    Discard(wordIndex - windowBase);
+    return true;
+  }
+
+  // Going backwards (or the window never got there): restart the stream and
+  // re-tokenize from the last snapshot at or before the target. Deflated
+  // entries replay inflate from the start (stored ones jump straight there),
+  // but only the tail is tokenized.
+  int cp = checkpointCount - 1;
+  while (cp > 0 && checkpoints[cp].wordIndex > wordIndex)
+    cp--;
+  if (cp < 0 || checkpoints[cp].wordIndex > wordIndex) {
+    int chapter = chapterIndex;
+    if (!Load(reader, chapter))
+      return false;
+    cp = -1;
+  } else {
+    if (!reader.OpenChapterStream(chapterIndex, stream)) {
+      Reset();
+      return false;
+    }
+    const ChapterCheckpoint &snap = checkpoints[cp];
+    if (!stream.Skip(snap.streamOffset, block, CHAPTER_BLOCK_SIZE)) {
+      Reset();
+      return false;
+    }
+    BeginWindow(snap.wordIndex);
+    streamOffset = snap.streamOffset;
+    extractor.RestoreState(snap.state);
+    checkpointCount = cp + 1;
+  }
+
+  // A chapter that has to be tokenized again copying (RestartCopying) and
+  // then fails to reopen is unloaded, and will never complete
+  uint64_t startUs = PerfNowUs();
+  while (WindowEnd() < wordIndex && !IsComplete()) {
+    Pump(1);
+    if (!IsLoaded())
+      return false;
+    if (extractor.IsFull())
+      Discard(wordIndex - windowBase);
+  }
+  Discard(wordIndex - windowBase);
+  DebugLogger::Log("Chapter seek: word %d from checkpoint %d in %u us",
+                   wordIndex, cp, (unsigned)(PerfNowUs() - startUs));
+  return true;
+}
+
+ChapterPrefetcher::ChapterPrefetcher() : cache(nullptr) {
+  for (int i = 0; i < PREFETCH_SLOTS; i++) {
+    slots[i] = nullptr;
+    targets[i] = -1;
+  }
+}
+
+void ChapterPrefetcher::Init(ChapterBuffer *spares[PREFETCH_SLOTS]) {
+  for (int i = 0; i < PREFETCH_SLOTS; i++)
+    slots[i] = spares[i];
+}
+
+void ChapterPrefetcher::Reset() {
+  for (int i = 0; i < PREFETCH_SLOTS; i++) {
+    if (slots[i])
+      slots[i]->Close();
+    targets[i] = -1;
+  }
+}
+
+void ChapterPrefetcher::SetTargets(int currentChapter, int menuSelection,
+                                   int chapterCount) {
+  int candidates[3] = {menuSelection, currentChapter + 1, currentChapter - 1};
+  int n = 0;
+  for (int i = 0; i < 3 && n < PREFETCH_SLOTS; i++) {
+    int c = candidates[i];
+    if (c < 0 || c >= chapterCount || c == currentChapter)
+      continue;
+    if (n > 0 && targets[0] == c)
+      continue;
+    targets[n++] = c;
+  }
+  while (n < PREFETCH_SLOTS)
+    targets[n++] = -1;
+}
+
+ChapterBuffer *ChapterPrefetcher::FindSlot(int chapterIndex) {
+  for (int i = 0; i < PREFETCH_SLOTS; i++) {
+    if (slots[i] && slots[i]->chapterIndex == chapterIndex)
+      return slots[i];
+  }
+  return nullptr;
+}
+
+bool ChapterPrefetcher::IsTarget(int chapterIndex) const {
+  for (int i = 0; i < PREFETCH_SLOTS; i++) {
+    if (targets[i] == chapterIndex)
+      return true;
+  }
+  return false;
+}
+
+void ChapterPrefetcher::Step(EpubReader &reader, int maxBlocks) {
+  // Work on the highest-priority target that isn't ready yet
+  for (int t = 0; t < PREFETCH_SLOTS; t++) {
+    int target = targets[t];
+    if (target < 0)
+      continue;
+
+    ChapterBuffer *slot = FindSlot(target);
+    if (slot && slot->IsReady())
+      continue;
+
+    if (!slot) {
+      // Recycle a slot holding nothing we currently want
+      for (int i = 0; i < PREFETCH_SLOTS && !slot; i++) {
+        if (slots[i] && !IsTarget(slots[i]->chapterIndex))
+          slot = slots[i];
+      }
+      if (!slot)
+        return;
+      if (cache) {
+        cache->Store(*slot);
+        if (cache->Restore(target, *slot)) {
+          DebugLogger::Log("Prefetch: Ch %d ready (cached)", target);
+          return;
+        }
+      }
+      // Tokenize from the next idle frame, so with async reads the first
+      // block arrives while this one renders
+      slot->Load(reader, target);
+      return;
+    }
+
+    if (slot->Pump(maxBlocks)) {
+      DebugLogger::Log("Prefetch: Ch %d ready (%d words%s)", target,
+                       slot->WordCount(),
+                       slot->IsStalled() ? ", window full" : "");
+    }
+    return;
+  }
+}
+
+ChapterBuffer *ChapterPrefetcher::Fetch(EpubReader &reader,
+                                        int chapterIndex) {
+  ChapterBuffer *slot = FindSlot(chapterIndex);
+  if (slot)
+    return slot;
+  // Preferably one holding nothing we currently want
+  slot = slots[0];
+  for (int i = 0; i < PREFETCH_SLOTS; i++) {
+    if (slots[i] && !IsTarget(slots[i]->chapterIndex)) {
+      slot = slots[i];
+      break;
+    }
+  }
+  if (!slot)
+    return nullptr;
+  if (cache) {
+    cache->Store(*slot);
+    if (cache->Restore(chapterIndex, *slot))
+      return slot;
+  }
+  return slot->Load(reader, chapterIndex) ? slot : nullptr;
+}
+
+bool ChapterPrefetcher::Take(int chapterIndex, ChapterBuffer *&active) {
+  for (int i = 0; i < PREFETCH_SLOTS; i++) {
+    if (slots[i] && slots[i]->chapterIndex == chapterIndex) {
+      // The outgoing chapter stays resident in the slot, so turning back
+      // is free as well
+      ChapterBuffer *prev = active;
+      active = slots[i];
+      slots[i] = prev;
+      DebugLogger::Log("Prefetch hit: Ch %d", chapterIndex);
+      return true;
+    }
+  }
+  return false;
+}
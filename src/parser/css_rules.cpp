@@ -0,0 +1,289 @@
+#include "css_rules.h"
+#include "debug_logger.h"
+#include "text_renderer.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+CssRuleTable::CssRuleTable() { Clear(); }
+
+void CssRuleTable::Clear() {
+  memset(slots, 0, sizeof(slots));
+  count = 0;
+}
+
+static uint32_t SlotOf(uint32_t tag, uint32_t cls) {
+  return (tag * 31u + cls) & (CSS_RULE_SLOTS - 1);
+}
+
+const CssRule *CssRuleTable::Find(uint32_t tag, uint32_t cls) const {
+  for (uint32_t i = SlotOf(tag, cls); slots[i].set;
+       i = (i + 1) & (CSS_RULE_SLOTS - 1)) {
+    if (slots[i].tag == tag && slots[i].cls == cls)
+      return &slots[i];
+  }
+  return nullptr;
+}
+
+// What from declares overrides to
+static void Apply(CssRule &to, const CssRule &from) {
+  if (from.set & CSS_SET_DISPLAY)
+    to.hidden = from.hidden;
+  if (from.set & CSS_SET_WEIGHT)
+    to.emphasis = (to.emphasis & ~TEXT_BOLD) | (from.emphasis & TEXT_BOLD);
+  if (from.set & CSS_SET_SLANT)
+    to.emphasis = (to.emphasis & ~TEXT_ITALIC) | (from.emphasis & TEXT_ITALIC);
+  if (from.set & CSS_SET_SIZE)
+    to.style = from.style;
+  to.set |= from.set;
+}
+
+void CssRuleTable::Add(const CssRule &rule) {
+  uint32_t i = SlotOf(rule.tag, rule.cls);
+  for (; slots[i].set; i = (i + 1) & (CSS_RULE_SLOTS - 1)) {
+    if (slots[i].tag == rule.tag && slots[i].cls == rule.cls) {
+      Apply(slots[i], rule);
+      return;
+    }
+  }
+  if (count == CSS_MAX_RULES)
+    return; // Table full; the rest of the book's rules are ignored
+  slots[i] = rule;
+  count++;
+}
+
+bool CssRuleTable::Match(uint32_t tag, const uint32_t *classes,
+                         int classCount, CssRule *out) const {
+  memset(out, 0, sizeof(*out));
+  if (count == 0)
+    return false;
+  const CssRule *rule = Find(tag, 0);
+  if (rule)
+    Apply(*out, *rule);
+  for (int i = 0; i < classCount; i++) {
+    if ((rule = Find(0, classes[i])) != nullptr)
+      Apply(*out, *rule);
+  }
+  for (int i = 0; i < classCount; i++) {
+    if ((rule = Find(tag, classes[i])) != nullptr)
+      Apply(*out, *rule);
+  }
+  return out->hidden || out->emphasis ||
+         out->style != (uint8_t)TextStyle::NORMAL;
+}
+
+// Parsing --------------------------------------------------------------------
+
+static const char *SkipSpace(const char *p, const char *end) {
+  while (p < end && isspace((unsigned char)*p))
+    p++;
+  return p;
+}
+
+static const char *TrimEnd(const char *start, const char *end) {
+  while (end > start && isspace((unsigned char)end[-1]))
+    end--;
+  return end;
+}
+
+static bool IsNameChar(char c) {
+  return isalnum((unsigned char)c) || c == '-' || c == '_';
+}
+
+static bool ValueIs(const char *value, const char *end, const char *word) {
+  size_t len = strlen(word);
+  return (size_t)(end - value) == len && strncasecmp(value, word, len) == 0;
+}
+
+// Headings are what a font-size can map to; relative sizes are taken
+// against the body text (16px, 12pt)
+static uint8_t StyleForSize(const char *value, const char *end) {
+  float size = 1.0f;
+  if (ValueIs(value, end, "xx-large") || ValueIs(value, end, "xxx-large"))
+    size = 2.0f;
+  else if (ValueIs(value, end, "x-large"))
+    size = 1.5f;
+  else if (ValueIs(value, end, "large") || ValueIs(value, end, "larger"))
+    size = 1.2f;
+  else if (value < end && (isdigit((unsigned char)*value) || *value == '.')) {
+    char *unit;
+    size = strtof(value, &unit);
+    if (unit >= end || strncasecmp(unit, "em", 2) == 0 ||
+        strncasecmp(unit, "rem", 3) == 0)
+      ; // Already relative
+    else if (*unit == '%')
+      size /= 100.0f;
+    else if (strncasecmp(unit, "px", 2) == 0)
+      size /= 16.0f;
+    else if (strncasecmp(unit, "pt", 2) == 0)
+      size /= 12.0f;
+    else
+      size = 1.0f;
+  }
+  if (size >= 1.7f)
+    return (uint8_t)TextStyle::H1;
+  if (size >= 1.35f)
+    return (uint8_t)TextStyle::H2;
+  if (size >= 1.15f)
+    return (uint8_t)TextStyle::H3;
+  return (uint8_t)TextStyle::NORMAL;
+}
+
+// One "name: value" declaration into decl
+static void ParseDeclaration(const char *p, const char *end, CssRule &decl) {
+  const char *colon = (const char *)memchr(p, ':', end - p);
+  if (!colon)
+    return;
+  const char *name = SkipSpace(p, colon);
+  const char *nameEnd = TrimEnd(name, colon);
+  const char *value = SkipSpace(colon + 1, end);
+  const char *valueEnd = value;
+  while (valueEnd < end && *valueEnd != '!') // "!important"
+    valueEnd++;
+  valueEnd = TrimEnd(value, valueEnd);
+
+  if (ValueIs(name, nameEnd, "display")) {
+    decl.set |= CSS_SET_DISPLAY;
+    decl.hidden = ValueIs(value, valueEnd, "none");
+  } else if (ValueIs(name, nameEnd, "font-weight")) {
+    decl.set |= CSS_SET_WEIGHT;
+    bool bold = ValueIs(value, valueEnd, "bold") ||
+                ValueIs(value, valueEnd, "bolder") ||
+                (isdigit((unsigned char)*value) && atoi(value) >= 600);
+    decl.emphasis = bold ? (decl.emphasis | TEXT_BOLD)
+                         : (decl.emphasis & ~TEXT_BOLD);
+  } else if (ValueIs(name, nameEnd, "font-style")) {
+    decl.set |= CSS_SET_SLANT;
+    bool italic = ValueIs(value, valueEnd, "italic") ||
+                  ValueIs(value, valueEnd, "oblique");
+    decl.emphasis = italic ? (decl.emphasis | TEXT_ITALIC)
+                           : (decl.emphasis & ~TEXT_ITALIC);
+  } else if (ValueIs(name, nameEnd, "font-size")) {
+    decl.set |= CSS_SET_SIZE;
+    decl.style = StyleForSize(value, valueEnd);
+  }
+}
+
+// "h1, p.note, .pagenum": each simple selector gets decl; anything with
+// combinators, ids, attributes or pseudo-classes is skipped
+void CssRuleTable::AddSelectors(const char *p, const char *end,
+                                const CssRule &decl) {
+  while (p < end) {
+    const char *comma = (const char *)memchr(p, ',', end - p);
+    const char *selEnd = comma ? comma : end;
+    const char *s = SkipSpace(p, selEnd);
+    const char *e = TrimEnd(s, selEnd);
+    p = comma ? comma + 1 : end;
+
+    uint32_t tag = 0;
+    uint32_t cls = 0;
+    const char *name = s;
+    if (s < e && isalpha((unsigned char)*s)) {
+      uint32_t h = CSS_HASH_INIT;
+      for (; s < e && isalnum((unsigned char)*s); s++)
+        h = CssHashStep(h, (char)tolower((unsigned char)*s));
+      if (ValueIs(name, s, "html") || ValueIs(name, s, "body"))
+        continue; // Would apply to the whole chapter
+      tag = CssHashEnd(h);
+    }
+    if (s < e && *s == '.') {
+      uint32_t h = CSS_HASH_INIT;
+      const char *start = ++s;
+      for (; s < e && IsNameChar(*s); s++)
+        h = CssHashStep(h, *s);
+      if (s == start)
+        continue;
+      cls = CssHashEnd(h);
+    }
+    if (s != e || (tag == 0 && cls == 0))
+      continue;
+
+    CssRule rule = decl;
+    rule.tag = tag;
+    rule.cls = cls;
+    Add(rule);
+  }
+}
+
+void CssRuleTable::Compile(char *css, size_t len) {
+  char *end = css + len;
+  for (char *c = css; c + 1 < end; c++) {
+    if (c[0] != '/' || c[1] != '*')
+      continue;
+    char *close = c + 2;
+    while (close + 1 < end && (close[0] != '*' || close[1] != '/'))
+      close++;
+    close = close + 1 < end ? close + 2 : end;
+    memset(c, ' ', close - c);
+    c = close - 1;
+  }
+
+  int before = count;
+  const char *p = css;
+  while ((p = SkipSpace(p, end)) < end) {
+    const char *open = (const char *)memchr(p, '{', end - p);
+    const char *semi = (const char *)memchr(p, ';', end - p);
+    if (*p == '@' && semi && (!open || semi < open)) {
+      p = semi + 1; // @import, @charset, @namespace
+      continue;
+    }
+    if (!open)
+      break;
+    if (*p == '@') {
+      // @media, @font-face, @page...: the whole block, nested braces and all
+      int depth = 0;
+      for (p = open; p < end; p++) {
+        if (*p == '{')
+          depth++;
+        else if (*p == '}' && --depth == 0)
+          break;
+      }
+      p = p < end ? p + 1 : end;
+      continue;
+    }
+
+    const char *close = (const char *)memchr(open, '}', end - open);
+    const char *blockEnd = close ? close : end;
+    CssRule decl;
+    memset(&decl, 0, sizeof(decl));
+    for (const char *d = open + 1; d < blockEnd;) {
+      const char *next = (const char *)memchr(d, ';', blockEnd - d);
+      ParseDeclaration(d, next ? next : blockEnd, decl);
+      d = next ? next + 1 : blockEnd;
+    }
+    if (decl.set)
+      AddSelectors(p, open, decl);
+    p = close ? close + 1 : end;
+  }
+  DebugLogger::Log("CSS: %d rules kept (%d total)", count - before, count);
+}
+
+// Serialization --------------------------------------------------------------
+
+bool CssRuleTable::Save(FILE *f) const {
+  uint32_t n = (uint32_t)count;
+  if (fwrite(&n, sizeof(n), 1, f) != 1)
+    return false;
+  for (int i = 0; i < CSS_RULE_SLOTS; i++) {
+    if (slots[i].set && fwrite(&slots[i], sizeof(CssRule), 1, f) != 1)
+      return false;
+  }
+  return true;
+}
+
+bool CssRuleTable::Load(FILE *f) {
+  Clear();
+  uint32_t n;
+  if (fread(&n, sizeof(n), 1, f) != 1 || n > CSS_MAX_RULES)
+    return false;
+  for (uint32_t i = 0; i < n; i++) {
+    CssRule rule;
+    if (fread(&rule, sizeof(rule), 1, f) != 1 || rule.set == 0) {
+      Clear();
+      return false;
+    }
+    Add(rule);
+  }
+  return true;
+}
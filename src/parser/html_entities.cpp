@@ -0,0 +1,1332 @@
+#include "html_entities.h"
+#include <cstring>
+
+// The HTML5 named character references (html.spec.whatwg.org/entities.json)
+// with the trailing semicolon dropped. legacy marks the names that are also
+// recognised without it.
+struct NamedEntity {
+  const char *name;
+  uint32_t cp;
+  uint16_t cp2; // Second code point of the few two-character references
+  bool legacy;
+};
+
+static constexpr NamedEntity namedEntities[] = {
+  {"AElig", 0x00C6, 0x0000, true}, {"AMP", 0x0026, 0x0000, true},
+  {"Aacute", 0x00C1, 0x0000, true}, {"Abreve", 0x0102, 0x0000, false},
+  {"Acirc", 0x00C2, 0x0000, true}, {"Acy", 0x0410, 0x0000, false},
+  {"Afr", 0x1D504, 0x0000, false}, {"Agrave", 0x00C0, 0x0000, true},
+  {"Alpha", 0x0391, 0x0000, false}, {"Amacr", 0x0100, 0x0000, false},
+  {"And", 0x2A53, 0x0000, false}, {"Aogon", 0x0104, 0x0000, false},
+  {"Aopf", 0x1D538, 0x0000, false}, {"ApplyFunction", 0x2061, 0x0000, false},
+  {"Aring", 0x00C5, 0x0000, true}, {"Ascr", 0x1D49C, 0x0000, false},
+  {"Assign", 0x2254, 0x0000, false}, {"Atilde", 0x00C3, 0x0000, true},
+  {"Auml", 0x00C4, 0x0000, true}, {"Backslash", 0x2216, 0x0000, false},
+  {"Barv", 0x2AE7, 0x0000, false}, {"Barwed", 0x2306, 0x0000, false},
+  {"Bcy", 0x0411, 0x0000, false}, {"Because", 0x2235, 0x0000, false},
+  {"Bernoullis", 0x212C, 0x0000, false}, {"Beta", 0x0392, 0x0000, false},
+  {"Bfr", 0x1D505, 0x0000, false}, {"Bopf", 0x1D539, 0x0000, false},
+  {"Breve", 0x02D8, 0x0000, false}, {"Bscr", 0x212C, 0x0000, false},
+  {"Bumpeq", 0x224E, 0x0000, false}, {"CHcy", 0x0427, 0x0000, false},
+  {"COPY", 0x00A9, 0x0000, true}, {"Cacute", 0x0106, 0x0000, false},
+  {"Cap", 0x22D2, 0x0000, false},
+  {"CapitalDifferentialD", 0x2145, 0x0000, false},
+  {"Cayleys", 0x212D, 0x0000, false}, {"Ccaron", 0x010C, 0x0000, false},
+  {"Ccedil", 0x00C7, 0x0000, true}, {"Ccirc", 0x0108, 0x0000, false},
+  {"Cconint", 0x2230, 0x0000, false}, {"Cdot", 0x010A, 0x0000, false},
+  {"Cedilla", 0x00B8, 0x0000, false}, {"CenterDot", 0x00B7, 0x0000, false},
+  {"Cfr", 0x212D, 0x0000, false}, {"Chi", 0x03A7, 0x0000, false},
+  {"CircleDot", 0x2299, 0x0000, false}, {"CircleMinus", 0x2296, 0x0000, false},
+  {"CirclePlus", 0x2295, 0x0000, false}, {"CircleTimes", 0x2297, 0x0000, false},
+  {"ClockwiseContourIntegral", 0x2232, 0x0000, false},
+  {"CloseCurlyDoubleQuote", 0x201D, 0x0000, false},
+  {"CloseCurlyQuote", 0x2019, 0x0000, false}, {"Colon", 0x2237, 0x0000, false},
+  {"Colone", 0x2A74, 0x0000, false}, {"Congruent", 0x2261, 0x0000, false},
+  {"Conint", 0x222F, 0x0000, false}, {"ContourIntegral", 0x222E, 0x0000, false},
+  {"Copf", 0x2102, 0x0000, false}, {"Coproduct", 0x2210, 0x0000, false},
+  {"CounterClockwiseContourIntegral", 0x2233, 0x0000, false},
+  {"Cross", 0x2A2F, 0x0000, false}, {"Cscr", 0x1D49E, 0x0000, false},
+  {"Cup", 0x22D3, 0x0000, false}, {"CupCap", 0x224D, 0x0000, false},
+  {"DD", 0x2145, 0x0000, false}, {"DDotrahd", 0x2911, 0x0000, false},
+  {"DJcy", 0x0402, 0x0000, false}, {"DScy", 0x0405, 0x0000, false},
+  {"DZcy", 0x040F, 0x0000, false}, {"Dagger", 0x2021, 0x0000, false},
+  {"Darr", 0x21A1, 0x0000, false}, {"Dashv", 0x2AE4, 0x0000, false},
+  {"Dcaron", 0x010E, 0x0000, false}, {"Dcy", 0x0414, 0x0000, false},
+  {"Del", 0x2207, 0x0000, false}, {"Delta", 0x0394, 0x0000, false},
+  {"Dfr", 0x1D507, 0x0000, false}, {"DiacriticalAcute", 0x00B4, 0x0000, false},
+  {"DiacriticalDot", 0x02D9, 0x0000, false},
+  {"DiacriticalDoubleAcute", 0x02DD, 0x0000, false},
+  {"DiacriticalGrave", 0x0060, 0x0000, false},
+  {"DiacriticalTilde", 0x02DC, 0x0000, false},
+  {"Diamond", 0x22C4, 0x0000, false}, {"DifferentialD", 0x2146, 0x0000, false},
+  {"Dopf", 0x1D53B, 0x0000, false}, {"Dot", 0x00A8, 0x0000, false},
+  {"DotDot", 0x20DC, 0x0000, false}, {"DotEqual", 0x2250, 0x0000, false},
+  {"DoubleContourIntegral", 0x222F, 0x0000, false},
+  {"DoubleDot", 0x00A8, 0x0000, false},
+  {"DoubleDownArrow", 0x21D3, 0x0000, false},
+  {"DoubleLeftArrow", 0x21D0, 0x0000, false},
+  {"DoubleLeftRightArrow", 0x21D4, 0x0000, false},
+  {"DoubleLeftTee", 0x2AE4, 0x0000, false},
+  {"DoubleLongLeftArrow", 0x27F8, 0x0000, false},
+  {"DoubleLongLeftRightArrow", 0x27FA, 0x0000, false},
+  {"DoubleLongRightArrow", 0x27F9, 0x0000, false},
+  {"DoubleRightArrow", 0x21D2, 0x0000, false},
+  {"DoubleRightTee", 0x22A8, 0x0000, false},
+  {"DoubleUpArrow", 0x21D1, 0x0000, false},
+  {"DoubleUpDownArrow", 0x21D5, 0x0000, false},
+  {"DoubleVerticalBar", 0x2225, 0x0000, false},
+  {"DownArrow", 0x2193, 0x0000, false}, {"DownArrowBar", 0x2913, 0x0000, false},
+  {"DownArrowUpArrow", 0x21F5, 0x0000, false},
+  {"DownBreve", 0x0311, 0x0000, false},
+  {"DownLeftRightVector", 0x2950, 0x0000, false},
+  {"DownLeftTeeVector", 0x295E, 0x0000, false},
+  {"DownLeftVector", 0x21BD, 0x0000, false},
+  {"DownLeftVectorBar", 0x2956, 0x0000, false},
+  {"DownRightTeeVector", 0x295F, 0x0000, false},
+  {"DownRightVector", 0x21C1, 0x0000, false},
+  {"DownRightVectorBar", 0x2957, 0x0000, false},
+  {"DownTee", 0x22A4, 0x0000, false}, {"DownTeeArrow", 0x21A7, 0x0000, false},
+  {"Downarrow", 0x21D3, 0x0000, false}, {"Dscr", 0x1D49F, 0x0000, false},
+  {"Dstrok", 0x0110, 0x0000, false}, {"ENG", 0x014A, 0x0000, false},
+  {"ETH", 0x00D0, 0x0000, true}, {"Eacute", 0x00C9, 0x0000, true},
+  {"Ecaron", 0x011A, 0x0000, false}, {"Ecirc", 0x00CA, 0x0000, true},
+  {"Ecy", 0x042D, 0x0000, false}, {"Edot", 0x0116, 0x0000, false},
+  {"Efr", 0x1D508, 0x0000, false}, {"Egrave", 0x00C8, 0x0000, true},
+  {"Element", 0x2208, 0x0000, false}, {"Emacr", 0x0112, 0x0000, false},
+  {"EmptySmallSquare", 0x25FB, 0x0000, false},
+  {"EmptyVerySmallSquare", 0x25AB, 0x0000, false},
+  {"Eogon", 0x0118, 0x0000, false}, {"Eopf", 0x1D53C, 0x0000, false},
+  {"Epsilon", 0x0395, 0x0000, false}, {"Equal", 0x2A75, 0x0000, false},
+  {"EqualTilde", 0x2242, 0x0000, false}, {"Equilibrium", 0x21CC, 0x0000, false},
+  {"Escr", 0x2130, 0x0000, false}, {"Esim", 0x2A73, 0x0000, false},
+  {"Eta", 0x0397, 0x0000, false}, {"Euml", 0x00CB, 0x0000, true},
+  {"Exists", 0x2203, 0x0000, false}, {"ExponentialE", 0x2147, 0x0000, false},
+  {"Fcy", 0x0424, 0x0000, false}, {"Ffr", 0x1D509, 0x0000, false},
+  {"FilledSmallSquare", 0x25FC, 0x0000, false},
+  {"FilledVerySmallSquare", 0x25AA, 0x0000, false},
+  {"Fopf", 0x1D53D, 0x0000, false}, {"ForAll", 0x2200, 0x0000, false},
+  {"Fouriertrf", 0x2131, 0x0000, false}, {"Fscr", 0x2131, 0x0000, false},
+  {"GJcy", 0x0403, 0x0000, false}, {"GT", 0x003E, 0x0000, true},
+  {"Gamma", 0x0393, 0x0000, false}, {"Gammad", 0x03DC, 0x0000, false},
+  {"Gbreve", 0x011E, 0x0000, false}, {"Gcedil", 0x0122, 0x0000, false},
+  {"Gcirc", 0x011C, 0x0000, false}, {"Gcy", 0x0413, 0x0000, false},
+  {"Gdot", 0x0120, 0x0000, false}, {"Gfr", 0x1D50A, 0x0000, false},
+  {"Gg", 0x22D9, 0x0000, false}, {"Gopf", 0x1D53E, 0x0000, false},
+  {"GreaterEqual", 0x2265, 0x0000, false},
+  {"GreaterEqualLess", 0x22DB, 0x0000, false},
+  {"GreaterFullEqual", 0x2267, 0x0000, false},
+  {"GreaterGreater", 0x2AA2, 0x0000, false},
+  {"GreaterLess", 0x2277, 0x0000, false},
+  {"GreaterSlantEqual", 0x2A7E, 0x0000, false},
+  {"GreaterTilde", 0x2273, 0x0000, false}, {"Gscr", 0x1D4A2, 0x0000, false},
+  {"Gt", 0x226B, 0x0000, false}, {"HARDcy", 0x042A, 0x0000, false},
+  {"Hacek", 0x02C7, 0x0000, false}, {"Hat", 0x005E, 0x0000, false},
+  {"Hcirc", 0x0124, 0x0000, false}, {"Hfr", 0x210C, 0x0000, false},
+  {"HilbertSpace", 0x210B, 0x0000, false}, {"Hopf", 0x210D, 0x0000, false},
+  {"HorizontalLine", 0x2500, 0x0000, false}, {"Hscr", 0x210B, 0x0000, false},
+  {"Hstrok", 0x0126, 0x0000, false}, {"HumpDownHump", 0x224E, 0x0000, false},
+  {"HumpEqual", 0x224F, 0x0000, false}, {"IEcy", 0x0415, 0x0000, false},
+  {"IJlig", 0x0132, 0x0000, false}, {"IOcy", 0x0401, 0x0000, false},
+  {"Iacute", 0x00CD, 0x0000, true}, {"Icirc", 0x00CE, 0x0000, true},
+  {"Icy", 0x0418, 0x0000, false}, {"Idot", 0x0130, 0x0000, false},
+  {"Ifr", 0x2111, 0x0000, false}, {"Igrave", 0x00CC, 0x0000, true},
+  {"Im", 0x2111, 0x0000, false}, {"Imacr", 0x012A, 0x0000, false},
+  {"ImaginaryI", 0x2148, 0x0000, false}, {"Implies", 0x21D2, 0x0000, false},
+  {"Int", 0x222C, 0x0000, false}, {"Integral", 0x222B, 0x0000, false},
+  {"Intersection", 0x22C2, 0x0000, false},
+  {"InvisibleComma", 0x2063, 0x0000, false},
+  {"InvisibleTimes", 0x2062, 0x0000, false}, {"Iogon", 0x012E, 0x0000, false},
+  {"Iopf", 0x1D540, 0x0000, false}, {"Iota", 0x0399, 0x0000, false},
+  {"Iscr", 0x2110, 0x0000, false}, {"Itilde", 0x0128, 0x0000, false},
+  {"Iukcy", 0x0406, 0x0000, false}, {"Iuml", 0x00CF, 0x0000, true},
+  {"Jcirc", 0x0134, 0x0000, false}, {"Jcy", 0x0419, 0x0000, false},
+  {"Jfr", 0x1D50D, 0x0000, false}, {"Jopf", 0x1D541, 0x0000, false},
+  {"Jscr", 0x1D4A5, 0x0000, false}, {"Jsercy", 0x0408, 0x0000, false},
+  {"Jukcy", 0x0404, 0x0000, false}, {"KHcy", 0x0425, 0x0000, false},
+  {"KJcy", 0x040C, 0x0000, false}, {"Kappa", 0x039A, 0x0000, false},
+  {"Kcedil", 0x0136, 0x0000, false}, {"Kcy", 0x041A, 0x0000, false},
+  {"Kfr", 0x1D50E, 0x0000, false}, {"Kopf", 0x1D542, 0x0000, false},
+  {"Kscr", 0x1D4A6, 0x0000, false}, {"LJcy", 0x0409, 0x0000, false},
+  {"LT", 0x003C, 0x0000, true}, {"Lacute", 0x0139, 0x0000, false},
+  {"Lambda", 0x039B, 0x0000, false}, {"Lang", 0x27EA, 0x0000, false},
+  {"Laplacetrf", 0x2112, 0x0000, false}, {"Larr", 0x219E, 0x0000, false},
+  {"Lcaron", 0x013D, 0x0000, false}, {"Lcedil", 0x013B, 0x0000, false},
+  {"Lcy", 0x041B, 0x0000, false}, {"LeftAngleBracket", 0x27E8, 0x0000, false},
+  {"LeftArrow", 0x2190, 0x0000, false}, {"LeftArrowBar", 0x21E4, 0x0000, false},
+  {"LeftArrowRightArrow", 0x21C6, 0x0000, false},
+  {"LeftCeiling", 0x2308, 0x0000, false},
+  {"LeftDoubleBracket", 0x27E6, 0x0000, false},
+  {"LeftDownTeeVector", 0x2961, 0x0000, false},
+  {"LeftDownVector", 0x21C3, 0x0000, false},
+  {"LeftDownVectorBar", 0x2959, 0x0000, false},
+  {"LeftFloor", 0x230A, 0x0000, false},
+  {"LeftRightArrow", 0x2194, 0x0000, false},
+  {"LeftRightVector", 0x294E, 0x0000, false},
+  {"LeftTee", 0x22A3, 0x0000, false}, {"LeftTeeArrow", 0x21A4, 0x0000, false},
+  {"LeftTeeVector", 0x295A, 0x0000, false},
+  {"LeftTriangle", 0x22B2, 0x0000, false},
+  {"LeftTriangleBar", 0x29CF, 0x0000, false},
+  {"LeftTriangleEqual", 0x22B4, 0x0000, false},
+  {"LeftUpDownVector", 0x2951, 0x0000, false},
+  {"LeftUpTeeVector", 0x2960, 0x0000, false},
+  {"LeftUpVector", 0x21BF, 0x0000, false},
+  {"LeftUpVectorBar", 0x2958, 0x0000, false},
+  {"LeftVector", 0x21BC, 0x0000, false},
+  {"LeftVectorBar", 0x2952, 0x0000, false},
+  {"Leftarrow", 0x21D0, 0x0000, false},
+  {"Leftrightarrow", 0x21D4, 0x0000, false},
+  {"LessEqualGreater", 0x22DA, 0x0000, false},
+  {"LessFullEqual", 0x2266, 0x0000, false},
+  {"LessGreater", 0x2276, 0x0000, false}, {"LessLess", 0x2AA1, 0x0000, false},
+  {"LessSlantEqual", 0x2A7D, 0x0000, false},
+  {"LessTilde", 0x2272, 0x0000, false}, {"Lfr", 0x1D50F, 0x0000, false},
+  {"Ll", 0x22D8, 0x0000, false}, {"Lleftarrow", 0x21DA, 0x0000, false},
+  {"Lmidot", 0x013F, 0x0000, false}, {"LongLeftArrow", 0x27F5, 0x0000, false},
+  {"LongLeftRightArrow", 0x27F7, 0x0000, false},
+  {"LongRightArrow", 0x27F6, 0x0000, false},
+  {"Longleftarrow", 0x27F8, 0x0000, false},
+  {"Longleftrightarrow", 0x27FA, 0x0000, false},
+  {"Longrightarrow", 0x27F9, 0x0000, false}, {"Lopf", 0x1D543, 0x0000, false},
+  {"LowerLeftArrow", 0x2199, 0x0000, false},
+  {"LowerRightArrow", 0x2198, 0x0000, false}, {"Lscr", 0x2112, 0x0000, false},
+  {"Lsh", 0x21B0, 0x0000, false}, {"Lstrok", 0x0141, 0x0000, false},
+  {"Lt", 0x226A, 0x0000, false}, {"Map", 0x2905, 0x0000, false},
+  {"Mcy", 0x041C, 0x0000, false}, {"MediumSpace", 0x205F, 0x0000, false},
+  {"Mellintrf", 0x2133, 0x0000, false}, {"Mfr", 0x1D510, 0x0000, false},
+  {"MinusPlus", 0x2213, 0x0000, false}, {"Mopf", 0x1D544, 0x0000, false},
+  {"Mscr", 0x2133, 0x0000, false}, {"Mu", 0x039C, 0x0000, false},
+  {"NJcy", 0x040A, 0x0000, false}, {"Nacute", 0x0143, 0x0000, false},
+  {"Ncaron", 0x0147, 0x0000, false}, {"Ncedil", 0x0145, 0x0000, false},
+  {"Ncy", 0x041D, 0x0000, false},
+  {"NegativeMediumSpace", 0x200B, 0x0000, false},
+  {"NegativeThickSpace", 0x200B, 0x0000, false},
+  {"NegativeThinSpace", 0x200B, 0x0000, false},
+  {"NegativeVeryThinSpace", 0x200B, 0x0000, false},
+  {"NestedGreaterGreater", 0x226B, 0x0000, false},
+  {"NestedLessLess", 0x226A, 0x0000, false}, {"NewLine", 0x000A, 0x0000, false},
+  {"Nfr", 0x1D511, 0x0000, false}, {"NoBreak", 0x2060, 0x0000, false},
+  {"NonBreakingSpace", 0x00A0, 0x0000, false}, {"Nopf", 0x2115, 0x0000, false},
+  {"Not", 0x2AEC, 0x0000, false}, {"NotCongruent", 0x2262, 0x0000, false},
+  {"NotCupCap", 0x226D, 0x0000, false},
+  {"NotDoubleVerticalBar", 0x2226, 0x0000, false},
+  {"NotElement", 0x2209, 0x0000, false}, {"NotEqual", 0x2260, 0x0000, false},
+  {"NotEqualTilde", 0x2242, 0x0338, false},
+  {"NotExists", 0x2204, 0x0000, false}, {"NotGreater", 0x226F, 0x0000, false},
+  {"NotGreaterEqual", 0x2271, 0x0000, false},
+  {"NotGreaterFullEqual", 0x2267, 0x0338, false},
+  {"NotGreaterGreater", 0x226B, 0x0338, false},
+  {"NotGreaterLess", 0x2279, 0x0000, false},
+  {"NotGreaterSlantEqual", 0x2A7E, 0x0338, false},
+  {"NotGreaterTilde", 0x2275, 0x0000, false},
+  {"NotHumpDownHump", 0x224E, 0x0338, false},
+  {"NotHumpEqual", 0x224F, 0x0338, false},
+  {"NotLeftTriangle", 0x22EA, 0x0000, false},
+  {"NotLeftTriangleBar", 0x29CF, 0x0338, false},
+  {"NotLeftTriangleEqual", 0x22EC, 0x0000, false},
+  {"NotLess", 0x226E, 0x0000, false}, {"NotLessEqual", 0x2270, 0x0000, false},
+  {"NotLessGreater", 0x2278, 0x0000, false},
+  {"NotLessLess", 0x226A, 0x0338, false},
+  {"NotLessSlantEqual", 0x2A7D, 0x0338, false},
+  {"NotLessTilde", 0x2274, 0x0000, false},
+  {"NotNestedGreaterGreater", 0x2AA2, 0x0338, false},
+  {"NotNestedLessLess", 0x2AA1, 0x0338, false},
+  {"NotPrecedes", 0x2280, 0x0000, false},
+  {"NotPrecedesEqual", 0x2AAF, 0x0338, false},
+  {"NotPrecedesSlantEqual", 0x22E0, 0x0000, false},
+  {"NotReverseElement", 0x220C, 0x0000, false},
+  {"NotRightTriangle", 0x22EB, 0x0000, false},
+  {"NotRightTriangleBar", 0x29D0, 0x0338, false},
+  {"NotRightTriangleEqual", 0x22ED, 0x0000, false},
+  {"NotSquareSubset", 0x228F, 0x0338, false},
+  {"NotSquareSubsetEqual", 0x22E2, 0x0000, false},
+  {"NotSquareSuperset", 0x2290, 0x0338, false},
+  {"NotSquareSupersetEqual", 0x22E3, 0x0000, false},
+  {"NotSubset", 0x2282, 0x20D2, false},
+  {"NotSubsetEqual", 0x2288, 0x0000, false},
+  {"NotSucceeds", 0x2281, 0x0000, false},
+  {"NotSucceedsEqual", 0x2AB0, 0x0338, false},
+  {"NotSucceedsSlantEqual", 0x22E1, 0x0000, false},
+  {"NotSucceedsTilde", 0x227F, 0x0338, false},
+  {"NotSuperset", 0x2283, 0x20D2, false},
+  {"NotSupersetEqual", 0x2289, 0x0000, false},
+  {"NotTilde", 0x2241, 0x0000, false}, {"NotTildeEqual", 0x2244, 0x0000, false},
+  {"NotTildeFullEqual", 0x2247, 0x0000, false},
+  {"NotTildeTilde", 0x2249, 0x0000, false},
+  {"NotVerticalBar", 0x2224, 0x0000, false}, {"Nscr", 0x1D4A9, 0x0000, false},
+  {"Ntilde", 0x00D1, 0x0000, true}, {"Nu", 0x039D, 0x0000, false},
+  {"OElig", 0x0152, 0x0000, false}, {"Oacute", 0x00D3, 0x0000, true},
+  {"Ocirc", 0x00D4, 0x0000, true}, {"Ocy", 0x041E, 0x0000, false},
+  {"Odblac", 0x0150, 0x0000, false}, {"Ofr", 0x1D512, 0x0000, false},
+  {"Ograve", 0x00D2, 0x0000, true}, {"Omacr", 0x014C, 0x0000, false},
+  {"Omega", 0x03A9, 0x0000, false}, {"Omicron", 0x039F, 0x0000, false},
+  {"Oopf", 0x1D546, 0x0000, false},
+  {"OpenCurlyDoubleQuote", 0x201C, 0x0000, false},
+  {"OpenCurlyQuote", 0x2018, 0x0000, false}, {"Or", 0x2A54, 0x0000, false},
+  {"Oscr", 0x1D4AA, 0x0000, false}, {"Oslash", 0x00D8, 0x0000, true},
+  {"Otilde", 0x00D5, 0x0000, true}, {"Otimes", 0x2A37, 0x0000, false},
+  {"Ouml", 0x00D6, 0x0000, true}, {"OverBar", 0x203E, 0x0000, false},
+  {"OverBrace", 0x23DE, 0x0000, false}, {"OverBracket", 0x23B4, 0x0000, false},
+  {"OverParenthesis", 0x23DC, 0x0000, false},
+  {"PartialD", 0x2202, 0x0000, false}, {"Pcy", 0x041F, 0x0000, false},
+  {"Pfr", 0x1D513, 0x0000, false}, {"Phi", 0x03A6, 0x0000, false},
+  {"Pi", 0x03A0, 0x0000, false}, {"PlusMinus", 0x00B1, 0x0000, false},
+  {"Poincareplane", 0x210C, 0x0000, false}, {"Popf", 0x2119, 0x0000, false},
+  {"Pr", 0x2ABB, 0x0000, false}, {"Precedes", 0x227A, 0x0000, false},
+  {"PrecedesEqual", 0x2AAF, 0x0000, false},
+  {"PrecedesSlantEqual", 0x227C, 0x0000, false},
+  {"PrecedesTilde", 0x227E, 0x0000, false}, {"Prime", 0x2033, 0x0000, false},
+  {"Product", 0x220F, 0x0000, false}, {"Proportion", 0x2237, 0x0000, false},
+  {"Proportional", 0x221D, 0x0000, false}, {"Pscr", 0x1D4AB, 0x0000, false},
+  {"Psi", 0x03A8, 0x0000, false}, {"QUOT", 0x0022, 0x0000, true},
+  {"Qfr", 0x1D514, 0x0000, false}, {"Qopf", 0x211A, 0x0000, false},
+  {"Qscr", 0x1D4AC, 0x0000, false}, {"RBarr", 0x2910, 0x0000, false},
+  {"REG", 0x00AE, 0x0000, true}, {"Racute", 0x0154, 0x0000, false},
+  {"Rang", 0x27EB, 0x0000, false}, {"Rarr", 0x21A0, 0x0000, false},
+  {"Rarrtl", 0x2916, 0x0000, false}, {"Rcaron", 0x0158, 0x0000, false},
+  {"Rcedil", 0x0156, 0x0000, false}, {"Rcy", 0x0420, 0x0000, false},
+  {"Re", 0x211C, 0x0000, false}, {"ReverseElement", 0x220B, 0x0000, false},
+  {"ReverseEquilibrium", 0x21CB, 0x0000, false},
+  {"ReverseUpEquilibrium", 0x296F, 0x0000, false},
+  {"Rfr", 0x211C, 0x0000, false}, {"Rho", 0x03A1, 0x0000, false},
+  {"RightAngleBracket", 0x27E9, 0x0000, false},
+  {"RightArrow", 0x2192, 0x0000, false},
+  {"RightArrowBar", 0x21E5, 0x0000, false},
+  {"RightArrowLeftArrow", 0x21C4, 0x0000, false},
+  {"RightCeiling", 0x2309, 0x0000, false},
+  {"RightDoubleBracket", 0x27E7, 0x0000, false},
+  {"RightDownTeeVector", 0x295D, 0x0000, false},
+  {"RightDownVector", 0x21C2, 0x0000, false},
+  {"RightDownVectorBar", 0x2955, 0x0000, false},
+  {"RightFloor", 0x230B, 0x0000, false}, {"RightTee", 0x22A2, 0x0000, false},
+  {"RightTeeArrow", 0x21A6, 0x0000, false},
+  {"RightTeeVector", 0x295B, 0x0000, false},
+  {"RightTriangle", 0x22B3, 0x0000, false},
+  {"RightTriangleBar", 0x29D0, 0x0000, false},
+  {"RightTriangleEqual", 0x22B5, 0x0000, false},
+  {"RightUpDownVector", 0x294F, 0x0000, false},
+  {"RightUpTeeVector", 0x295C, 0x0000, false},
+  {"RightUpVector", 0x21BE, 0x0000, false},
+  {"RightUpVectorBar", 0x2954, 0x0000, false},
+  {"RightVector", 0x21C0, 0x0000, false},
+  {"RightVectorBar", 0x2953, 0x0000, false},
+  {"Rightarrow", 0x21D2, 0x0000, false}, {"Ropf", 0x211D, 0x0000, false},
+  {"RoundImplies", 0x2970, 0x0000, false},
+  {"Rrightarrow", 0x21DB, 0x0000, false}, {"Rscr", 0x211B, 0x0000, false},
+  {"Rsh", 0x21B1, 0x0000, false}, {"RuleDelayed", 0x29F4, 0x0000, false},
+  {"SHCHcy", 0x0429, 0x0000, false}, {"SHcy", 0x0428, 0x0000, false},
+  {"SOFTcy", 0x042C, 0x0000, false}, {"Sacute", 0x015A, 0x0000, false},
+  {"Sc", 0x2ABC, 0x0000, false}, {"Scaron", 0x0160, 0x0000, false},
+  {"Scedil", 0x015E, 0x0000, false}, {"Scirc", 0x015C, 0x0000, false},
+  {"Scy", 0x0421, 0x0000, false}, {"Sfr", 0x1D516, 0x0000, false},
+  {"ShortDownArrow", 0x2193, 0x0000, false},
+  {"ShortLeftArrow", 0x2190, 0x0000, false},
+  {"ShortRightArrow", 0x2192, 0x0000, false},
+  {"ShortUpArrow", 0x2191, 0x0000, false}, {"Sigma", 0x03A3, 0x0000, false},
+  {"SmallCircle", 0x2218, 0x0000, false}, {"Sopf", 0x1D54A, 0x0000, false},
+  {"Sqrt", 0x221A, 0x0000, false}, {"Square", 0x25A1, 0x0000, false},
+  {"SquareIntersection", 0x2293, 0x0000, false},
+  {"SquareSubset", 0x228F, 0x0000, false},
+  {"SquareSubsetEqual", 0x2291, 0x0000, false},
+  {"SquareSuperset", 0x2290, 0x0000, false},
+  {"SquareSupersetEqual", 0x2292, 0x0000, false},
+  {"SquareUnion", 0x2294, 0x0000, false}, {"Sscr", 0x1D4AE, 0x0000, false},
+  {"Star", 0x22C6, 0x0000, false}, {"Sub", 0x22D0, 0x0000, false},
+  {"Subset", 0x22D0, 0x0000, false}, {"SubsetEqual", 0x2286, 0x0000, false},
+  {"Succeeds", 0x227B, 0x0000, false}, {"SucceedsEqual", 0x2AB0, 0x0000, false},
+  {"SucceedsSlantEqual", 0x227D, 0x0000, false},
+  {"SucceedsTilde", 0x227F, 0x0000, false}, {"SuchThat", 0x220B, 0x0000, false},
+  {"Sum", 0x2211, 0x0000, false}, {"Sup", 0x22D1, 0x0000, false},
+  {"Superset", 0x2283, 0x0000, false}, {"SupersetEqual", 0x2287, 0x0000, false},
+  {"Supset", 0x22D1, 0x0000, false}, {"THORN", 0x00DE, 0x0000, true},
+  {"TRADE", 0x2122, 0x0000, false}, {"TSHcy", 0x040B, 0x0000, false},
+  {"TScy", 0x0426, 0x0000, false}, {"Tab", 0x0009, 0x0000, false},
+  {"Tau", 0x03A4, 0x0000, false}, {"Tcaron", 0x0164, 0x0000, false},
+  {"Tcedil", 0x0162, 0x0000, false}, {"Tcy", 0x0422, 0x0000, false},
+  {"Tfr", 0x1D517, 0x0000, false}, {"Therefore", 0x2234, 0x0000, false},
+  {"Theta", 0x0398, 0x0000, false}, {"ThickSpace", 0x205F, 0x200A, false},
+  {"ThinSpace", 0x2009, 0x0000, false}, {"Tilde", 0x223C, 0x0000, false},
+  {"TildeEqual", 0x2243, 0x0000, false},
+  {"TildeFullEqual", 0x2245, 0x0000, false},
+  {"TildeTilde", 0x2248, 0x0000, false}, {"Topf", 0x1D54B, 0x0000, false},
+  {"TripleDot", 0x20DB, 0x0000, false}, {"Tscr", 0x1D4AF, 0x0000, false},
+  {"Tstrok", 0x0166, 0x0000, false}, {"Uacute", 0x00DA, 0x0000, true},
+  {"Uarr", 0x219F, 0x0000, false}, {"Uarrocir", 0x2949, 0x0000, false},
+  {"Ubrcy", 0x040E, 0x0000, false}, {"Ubreve", 0x016C, 0x0000, false},
+  {"Ucirc", 0x00DB, 0x0000, true}, {"Ucy", 0x0423, 0x0000, false},
+  {"Udblac", 0x0170, 0x0000, false}, {"Ufr", 0x1D518, 0x0000, false},
+  {"Ugrave", 0x00D9, 0x0000, true}, {"Umacr", 0x016A, 0x0000, false},
+  {"UnderBar", 0x005F, 0x0000, false}, {"UnderBrace", 0x23DF, 0x0000, false},
+  {"UnderBracket", 0x23B5, 0x0000, false},
+  {"UnderParenthesis", 0x23DD, 0x0000, false}, {"Union", 0x22C3, 0x0000, false},
+  {"UnionPlus", 0x228E, 0x0000, false}, {"Uogon", 0x0172, 0x0000, false},
+  {"Uopf", 0x1D54C, 0x0000, false}, {"UpArrow", 0x2191, 0x0000, false},
+  {"UpArrowBar", 0x2912, 0x0000, false},
+  {"UpArrowDownArrow", 0x21C5, 0x0000, false},
+  {"UpDownArrow", 0x2195, 0x0000, false},
+  {"UpEquilibrium", 0x296E, 0x0000, false}, {"UpTee", 0x22A5, 0x0000, false},
+  {"UpTeeArrow", 0x21A5, 0x0000, false}, {"Uparrow", 0x21D1, 0x0000, false},
+  {"Updownarrow", 0x21D5, 0x0000, false},
+  {"UpperLeftArrow", 0x2196, 0x0000, false},
+  {"UpperRightArrow", 0x2197, 0x0000, false}, {"Upsi", 0x03D2, 0x0000, false},
+  {"Upsilon", 0x03A5, 0x0000, false}, {"Uring", 0x016E, 0x0000, false},
+  {"Uscr", 0x1D4B0, 0x0000, false}, {"Utilde", 0x0168, 0x0000, false},
+  {"Uuml", 0x00DC, 0x0000, true}, {"VDash", 0x22AB, 0x0000, false},
+  {"Vbar", 0x2AEB, 0x0000, false}, {"Vcy", 0x0412, 0x0000, false},
+  {"Vdash", 0x22A9, 0x0000, false}, {"Vdashl", 0x2AE6, 0x0000, false},
+  {"Vee", 0x22C1, 0x0000, false}, {"Verbar", 0x2016, 0x0000, false},
+  {"Vert", 0x2016, 0x0000, false}, {"VerticalBar", 0x2223, 0x0000, false},
+  {"VerticalLine", 0x007C, 0x0000, false},
+  {"VerticalSeparator", 0x2758, 0x0000, false},
+  {"VerticalTilde", 0x2240, 0x0000, false},
+  {"VeryThinSpace", 0x200A, 0x0000, false}, {"Vfr", 0x1D519, 0x0000, false},
+  {"Vopf", 0x1D54D, 0x0000, false}, {"Vscr", 0x1D4B1, 0x0000, false},
+  {"Vvdash", 0x22AA, 0x0000, false}, {"Wcirc", 0x0174, 0x0000, false},
+  {"Wedge", 0x22C0, 0x0000, false}, {"Wfr", 0x1D51A, 0x0000, false},
+  {"Wopf", 0x1D54E, 0x0000, false}, {"Wscr", 0x1D4B2, 0x0000, false},
+  {"Xfr", 0x1D51B, 0x0000, false}, {"Xi", 0x039E, 0x0000, false},
+  {"Xopf", 0x1D54F, 0x0000, false}, {"Xscr", 0x1D4B3, 0x0000, false},
+  {"YAcy", 0x042F, 0x0000, false}, {"YIcy", 0x0407, 0x0000, false},
+  {"YUcy", 0x042E, 0x0000, false}, {"Yacute", 0x00DD, 0x0000, true},
+  {"Ycirc", 0x0176, 0x0000, false}, {"Ycy", 0x042B, 0x0000, false},
+  {"Yfr", 0x1D51C, 0x0000, false}, {"Yopf", 0x1D550, 0x0000, false},
+  {"Yscr", 0x1D4B4, 0x0000, false}, {"Yuml", 0x0178, 0x0000, false},
+  {"ZHcy", 0x0416, 0x0000, false}, {"Zacute", 0x0179, 0x0000, false},
+  {"Zcaron", 0x017D, 0x0000, false}, {"Zcy", 0x0417, 0x0000, false},
+  {"Zdot", 0x017B, 0x0000, false}, {"ZeroWidthSpace", 0x200B, 0x0000, false},
+  {"Zeta", 0x0396, 0x0000, false}, {"Zfr", 0x2128, 0x0000, false},
+  {"Zopf", 0x2124, 0x0000, false}, {"Zscr", 0x1D4B5, 0x0000, false},
+  {"aacute", 0x00E1, 0x0000, true}, {"abreve", 0x0103, 0x0000, false},
+  {"ac", 0x223E, 0x0000, false}, {"acE", 0x223E, 0x0333, false},
+  {"acd", 0x223F, 0x0000, false}, {"acirc", 0x00E2, 0x0000, true},
+  {"acute", 0x00B4, 0x0000, true}, {"acy", 0x0430, 0x0000, false},
+  {"aelig", 0x00E6, 0x0000, true}, {"af", 0x2061, 0x0000, false},
+  {"afr", 0x1D51E, 0x0000, false}, {"agrave", 0x00E0, 0x0000, true},
+  {"alefsym", 0x2135, 0x0000, false}, {"aleph", 0x2135, 0x0000, false},
+  {"alpha", 0x03B1, 0x0000, false}, {"amacr", 0x0101, 0x0000, false},
+  {"amalg", 0x2A3F, 0x0000, false}, {"amp", 0x0026, 0x0000, true},
+  {"and", 0x2227, 0x0000, false}, {"andand", 0x2A55, 0x0000, false},
+  {"andd", 0x2A5C, 0x0000, false}, {"andslope", 0x2A58, 0x0000, false},
+  {"andv", 0x2A5A, 0x0000, false}, {"ang", 0x2220, 0x0000, false},
+  {"ange", 0x29A4, 0x0000, false}, {"angle", 0x2220, 0x0000, false},
+  {"angmsd", 0x2221, 0x0000, false}, {"angmsdaa", 0x29A8, 0x0000, false},
+  {"angmsdab", 0x29A9, 0x0000, false}, {"angmsdac", 0x29AA, 0x0000, false},
+  {"angmsdad", 0x29AB, 0x0000, false}, {"angmsdae", 0x29AC, 0x0000, false},
+  {"angmsdaf", 0x29AD, 0x0000, false}, {"angmsdag", 0x29AE, 0x0000, false},
+  {"angmsdah", 0x29AF, 0x0000, false}, {"angrt", 0x221F, 0x0000, false},
+  {"angrtvb", 0x22BE, 0x0000, false}, {"angrtvbd", 0x299D, 0x0000, false},
+  {"angsph", 0x2222, 0x0000, false}, {"angst", 0x00C5, 0x0000, false},
+  {"angzarr", 0x237C, 0x0000, false}, {"aogon", 0x0105, 0x0000, false},
+  {"aopf", 0x1D552, 0x0000, false}, {"ap", 0x2248, 0x0000, false},
+  {"apE", 0x2A70, 0x0000, false}, {"apacir", 0x2A6F, 0x0000, false},
+  {"ape", 0x224A, 0x0000, false}, {"apid", 0x224B, 0x0000, false},
+  {"apos", 0x0027, 0x0000, false}, {"approx", 0x2248, 0x0000, false},
+  {"approxeq", 0x224A, 0x0000, false}, {"aring", 0x00E5, 0x0000, true},
+  {"ascr", 0x1D4B6, 0x0000, false}, {"ast", 0x002A, 0x0000, false},
+  {"asymp", 0x2248, 0x0000, false}, {"asympeq", 0x224D, 0x0000, false},
+  {"atilde", 0x00E3, 0x0000, true}, {"auml", 0x00E4, 0x0000, true},
+  {"awconint", 0x2233, 0x0000, false}, {"awint", 0x2A11, 0x0000, false},
+  {"bNot", 0x2AED, 0x0000, false}, {"backcong", 0x224C, 0x0000, false},
+  {"backepsilon", 0x03F6, 0x0000, false}, {"backprime", 0x2035, 0x0000, false},
+  {"backsim", 0x223D, 0x0000, false}, {"backsimeq", 0x22CD, 0x0000, false},
+  {"barvee", 0x22BD, 0x0000, false}, {"barwed", 0x2305, 0x0000, false},
+  {"barwedge", 0x2305, 0x0000, false}, {"bbrk", 0x23B5, 0x0000, false},
+  {"bbrktbrk", 0x23B6, 0x0000, false}, {"bcong", 0x224C, 0x0000, false},
+  {"bcy", 0x0431, 0x0000, false}, {"bdquo", 0x201E, 0x0000, false},
+  {"becaus", 0x2235, 0x0000, false}, {"because", 0x2235, 0x0000, false},
+  {"bemptyv", 0x29B0, 0x0000, false}, {"bepsi", 0x03F6, 0x0000, false},
+  {"bernou", 0x212C, 0x0000, false}, {"beta", 0x03B2, 0x0000, false},
+  {"beth", 0x2136, 0x0000, false}, {"between", 0x226C, 0x0000, false},
+  {"bfr", 0x1D51F, 0x0000, false}, {"bigcap", 0x22C2, 0x0000, false},
+  {"bigcirc", 0x25EF, 0x0000, false}, {"bigcup", 0x22C3, 0x0000, false},
+  {"bigodot", 0x2A00, 0x0000, false}, {"bigoplus", 0x2A01, 0x0000, false},
+  {"bigotimes", 0x2A02, 0x0000, false}, {"bigsqcup", 0x2A06, 0x0000, false},
+  {"bigstar", 0x2605, 0x0000, false},
+  {"bigtriangledown", 0x25BD, 0x0000, false},
+  {"bigtriangleup", 0x25B3, 0x0000, false}, {"biguplus", 0x2A04, 0x0000, false},
+  {"bigvee", 0x22C1, 0x0000, false}, {"bigwedge", 0x22C0, 0x0000, false},
+  {"bkarow", 0x290D, 0x0000, false}, {"blacklozenge", 0x29EB, 0x0000, false},
+  {"blacksquare", 0x25AA, 0x0000, false},
+  {"blacktriangle", 0x25B4, 0x0000, false},
+  {"blacktriangledown", 0x25BE, 0x0000, false},
+  {"blacktriangleleft", 0x25C2, 0x0000, false},
+  {"blacktriangleright", 0x25B8, 0x0000, false},
+  {"blank", 0x2423, 0x0000, false}, {"blk12", 0x2592, 0x0000, false},
+  {"blk14", 0x2591, 0x0000, false}, {"blk34", 0x2593, 0x0000, false},
+  {"block", 0x2588, 0x0000, false}, {"bne", 0x003D, 0x20E5, false},
+  {"bnequiv", 0x2261, 0x20E5, false}, {"bnot", 0x2310, 0x0000, false},
+  {"bopf", 0x1D553, 0x0000, false}, {"bot", 0x22A5, 0x0000, false},
+  {"bottom", 0x22A5, 0x0000, false}, {"bowtie", 0x22C8, 0x0000, false},
+  {"boxDL", 0x2557, 0x0000, false}, {"boxDR", 0x2554, 0x0000, false},
+  {"boxDl", 0x2556, 0x0000, false}, {"boxDr", 0x2553, 0x0000, false},
+  {"boxH", 0x2550, 0x0000, false}, {"boxHD", 0x2566, 0x0000, false},
+  {"boxHU", 0x2569, 0x0000, false}, {"boxHd", 0x2564, 0x0000, false},
+  {"boxHu", 0x2567, 0x0000, false}, {"boxUL", 0x255D, 0x0000, false},
+  {"boxUR", 0x255A, 0x0000, false}, {"boxUl", 0x255C, 0x0000, false},
+  {"boxUr", 0x2559, 0x0000, false}, {"boxV", 0x2551, 0x0000, false},
+  {"boxVH", 0x256C, 0x0000, false}, {"boxVL", 0x2563, 0x0000, false},
+  {"boxVR", 0x2560, 0x0000, false}, {"boxVh", 0x256B, 0x0000, false},
+  {"boxVl", 0x2562, 0x0000, false}, {"boxVr", 0x255F, 0x0000, false},
+  {"boxbox", 0x29C9, 0x0000, false}, {"boxdL", 0x2555, 0x0000, false},
+  {"boxdR", 0x2552, 0x0000, false}, {"boxdl", 0x2510, 0x0000, false},
+  {"boxdr", 0x250C, 0x0000, false}, {"boxh", 0x2500, 0x0000, false},
+  {"boxhD", 0x2565, 0x0000, false}, {"boxhU", 0x2568, 0x0000, false},
+  {"boxhd", 0x252C, 0x0000, false}, {"boxhu", 0x2534, 0x0000, false},
+  {"boxminus", 0x229F, 0x0000, false}, {"boxplus", 0x229E, 0x0000, false},
+  {"boxtimes", 0x22A0, 0x0000, false}, {"boxuL", 0x255B, 0x0000, false},
+  {"boxuR", 0x2558, 0x0000, false}, {"boxul", 0x2518, 0x0000, false},
+  {"boxur", 0x2514, 0x0000, false}, {"boxv", 0x2502, 0x0000, false},
+  {"boxvH", 0x256A, 0x0000, false}, {"boxvL", 0x2561, 0x0000, false},
+  {"boxvR", 0x255E, 0x0000, false}, {"boxvh", 0x253C, 0x0000, false},
+  {"boxvl", 0x2524, 0x0000, false}, {"boxvr", 0x251C, 0x0000, false},
+  {"bprime", 0x2035, 0x0000, false}, {"breve", 0x02D8, 0x0000, false},
+  {"brvbar", 0x00A6, 0x0000, true}, {"bscr", 0x1D4B7, 0x0000, false},
+  {"bsemi", 0x204F, 0x0000, false}, {"bsim", 0x223D, 0x0000, false},
+  {"bsime", 0x22CD, 0x0000, false}, {"bsol", 0x005C, 0x0000, false},
+  {"bsolb", 0x29C5, 0x0000, false}, {"bsolhsub", 0x27C8, 0x0000, false},
+  {"bull", 0x2022, 0x0000, false}, {"bullet", 0x2022, 0x0000, false},
+  {"bump", 0x224E, 0x0000, false}, {"bumpE", 0x2AAE, 0x0000, false},
+  {"bumpe", 0x224F, 0x0000, false}, {"bumpeq", 0x224F, 0x0000, false},
+  {"cacute", 0x0107, 0x0000, false}, {"cap", 0x2229, 0x0000, false},
+  {"capand", 0x2A44, 0x0000, false}, {"capbrcup", 0x2A49, 0x0000, false},
+  {"capcap", 0x2A4B, 0x0000, false}, {"capcup", 0x2A47, 0x0000, false},
+  {"capdot", 0x2A40, 0x0000, false}, {"caps", 0x2229, 0xFE00, false},
+  {"caret", 0x2041, 0x0000, false}, {"caron", 0x02C7, 0x0000, false},
+  {"ccaps", 0x2A4D, 0x0000, false}, {"ccaron", 0x010D, 0x0000, false},
+  {"ccedil", 0x00E7, 0x0000, true}, {"ccirc", 0x0109, 0x0000, false},
+  {"ccups", 0x2A4C, 0x0000, false}, {"ccupssm", 0x2A50, 0x0000, false},
+  {"cdot", 0x010B, 0x0000, false}, {"cedil", 0x00B8, 0x0000, true},
+  {"cemptyv", 0x29B2, 0x0000, false}, {"cent", 0x00A2, 0x0000, true},
+  {"centerdot", 0x00B7, 0x0000, false}, {"cfr", 0x1D520, 0x0000, false},
+  {"chcy", 0x0447, 0x0000, false}, {"check", 0x2713, 0x0000, false},
+  {"checkmark", 0x2713, 0x0000, false}, {"chi", 0x03C7, 0x0000, false},
+  {"cir", 0x25CB, 0x0000, false}, {"cirE", 0x29C3, 0x0000, false},
+  {"circ", 0x02C6, 0x0000, false}, {"circeq", 0x2257, 0x0000, false},
+  {"circlearrowleft", 0x21BA, 0x0000, false},
+  {"circlearrowright", 0x21BB, 0x0000, false},
+  {"circledR", 0x00AE, 0x0000, false}, {"circledS", 0x24C8, 0x0000, false},
+  {"circledast", 0x229B, 0x0000, false}, {"circledcirc", 0x229A, 0x0000, false},
+  {"circleddash", 0x229D, 0x0000, false}, {"cire", 0x2257, 0x0000, false},
+  {"cirfnint", 0x2A10, 0x0000, false}, {"cirmid", 0x2AEF, 0x0000, false},
+  {"cirscir", 0x29C2, 0x0000, false}, {"clubs", 0x2663, 0x0000, false},
+  {"clubsuit", 0x2663, 0x0000, false}, {"colon", 0x003A, 0x0000, false},
+  {"colone", 0x2254, 0x0000, false}, {"coloneq", 0x2254, 0x0000, false},
+  {"comma", 0x002C, 0x0000, false}, {"commat", 0x0040, 0x0000, false},
+  {"comp", 0x2201, 0x0000, false}, {"compfn", 0x2218, 0x0000, false},
+  {"complement", 0x2201, 0x0000, false}, {"complexes", 0x2102, 0x0000, false},
+  {"cong", 0x2245, 0x0000, false}, {"congdot", 0x2A6D, 0x0000, false},
+  {"conint", 0x222E, 0x0000, false}, {"copf", 0x1D554, 0x0000, false},
+  {"coprod", 0x2210, 0x0000, false}, {"copy", 0x00A9, 0x0000, true},
+  {"copysr", 0x2117, 0x0000, false}, {"crarr", 0x21B5, 0x0000, false},
+  {"cross", 0x2717, 0x0000, false}, {"cscr", 0x1D4B8, 0x0000, false},
+  {"csub", 0x2ACF, 0x0000, false}, {"csube", 0x2AD1, 0x0000, false},
+  {"csup", 0x2AD0, 0x0000, false}, {"csupe", 0x2AD2, 0x0000, false},
+  {"ctdot", 0x22EF, 0x0000, false}, {"cudarrl", 0x2938, 0x0000, false},
+  {"cudarrr", 0x2935, 0x0000, false}, {"cuepr", 0x22DE, 0x0000, false},
+  {"cuesc", 0x22DF, 0x0000, false}, {"cularr", 0x21B6, 0x0000, false},
+  {"cularrp", 0x293D, 0x0000, false}, {"cup", 0x222A, 0x0000, false},
+  {"cupbrcap", 0x2A48, 0x0000, false}, {"cupcap", 0x2A46, 0x0000, false},
+  {"cupcup", 0x2A4A, 0x0000, false}, {"cupdot", 0x228D, 0x0000, false},
+  {"cupor", 0x2A45, 0x0000, false}, {"cups", 0x222A, 0xFE00, false},
+  {"curarr", 0x21B7, 0x0000, false}, {"curarrm", 0x293C, 0x0000, false},
+  {"curlyeqprec", 0x22DE, 0x0000, false},
+  {"curlyeqsucc", 0x22DF, 0x0000, false}, {"curlyvee", 0x22CE, 0x0000, false},
+  {"curlywedge", 0x22CF, 0x0000, false}, {"curren", 0x00A4, 0x0000, true},
+  {"curvearrowleft", 0x21B6, 0x0000, false},
+  {"curvearrowright", 0x21B7, 0x0000, false}, {"cuvee", 0x22CE, 0x0000, false},
+  {"cuwed", 0x22CF, 0x0000, false}, {"cwconint", 0x2232, 0x0000, false},
+  {"cwint", 0x2231, 0x0000, false}, {"cylcty", 0x232D, 0x0000, false},
+  {"dArr", 0x21D3, 0x0000, false}, {"dHar", 0x2965, 0x0000, false},
+  {"dagger", 0x2020, 0x0000, false}, {"daleth", 0x2138, 0x0000, false},
+  {"darr", 0x2193, 0x0000, false}, {"dash", 0x2010, 0x0000, false},
+  {"dashv", 0x22A3, 0x0000, false}, {"dbkarow", 0x290F, 0x0000, false},
+  {"dblac", 0x02DD, 0x0000, false}, {"dcaron", 0x010F, 0x0000, false},
+  {"dcy", 0x0434, 0x0000, false}, {"dd", 0x2146, 0x0000, false},
+  {"ddagger", 0x2021, 0x0000, false}, {"ddarr", 0x21CA, 0x0000, false},
+  {"ddotseq", 0x2A77, 0x0000, false}, {"deg", 0x00B0, 0x0000, true},
+  {"delta", 0x03B4, 0x0000, false}, {"demptyv", 0x29B1, 0x0000, false},
+  {"dfisht", 0x297F, 0x0000, false}, {"dfr", 0x1D521, 0x0000, false},
+  {"dharl", 0x21C3, 0x0000, false}, {"dharr", 0x21C2, 0x0000, false},
+  {"diam", 0x22C4, 0x0000, false}, {"diamond", 0x22C4, 0x0000, false},
+  {"diamondsuit", 0x2666, 0x0000, false}, {"diams", 0x2666, 0x0000, false},
+  {"die", 0x00A8, 0x0000, false}, {"digamma", 0x03DD, 0x0000, false},
+  {"disin", 0x22F2, 0x0000, false}, {"div", 0x00F7, 0x0000, false},
+  {"divide", 0x00F7, 0x0000, true}, {"divideontimes", 0x22C7, 0x0000, false},
+  {"divonx", 0x22C7, 0x0000, false}, {"djcy", 0x0452, 0x0000, false},
+  {"dlcorn", 0x231E, 0x0000, false}, {"dlcrop", 0x230D, 0x0000, false},
+  {"dollar", 0x0024, 0x0000, false}, {"dopf", 0x1D555, 0x0000, false},
+  {"dot", 0x02D9, 0x0000, false}, {"doteq", 0x2250, 0x0000, false},
+  {"doteqdot", 0x2251, 0x0000, false}, {"dotminus", 0x2238, 0x0000, false},
+  {"dotplus", 0x2214, 0x0000, false}, {"dotsquare", 0x22A1, 0x0000, false},
+  {"doublebarwedge", 0x2306, 0x0000, false},
+  {"downarrow", 0x2193, 0x0000, false},
+  {"downdownarrows", 0x21CA, 0x0000, false},
+  {"downharpoonleft", 0x21C3, 0x0000, false},
+  {"downharpoonright", 0x21C2, 0x0000, false},
+  {"drbkarow", 0x2910, 0x0000, false}, {"drcorn", 0x231F, 0x0000, false},
+  {"drcrop", 0x230C, 0x0000, false}, {"dscr", 0x1D4B9, 0x0000, false},
+  {"dscy", 0x0455, 0x0000, false}, {"dsol", 0x29F6, 0x0000, false},
+  {"dstrok", 0x0111, 0x0000, false}, {"dtdot", 0x22F1, 0x0000, false},
+  {"dtri", 0x25BF, 0x0000, false}, {"dtrif", 0x25BE, 0x0000, false},
+  {"duarr", 0x21F5, 0x0000, false}, {"duhar", 0x296F, 0x0000, false},
+  {"dwangle", 0x29A6, 0x0000, false}, {"dzcy", 0x045F, 0x0000, false},
+  {"dzigrarr", 0x27FF, 0x0000, false}, {"eDDot", 0x2A77, 0x0000, false},
+  {"eDot", 0x2251, 0x0000, false}, {"eacute", 0x00E9, 0x0000, true},
+  {"easter", 0x2A6E, 0x0000, false}, {"ecaron", 0x011B, 0x0000, false},
+  {"ecir", 0x2256, 0x0000, false}, {"ecirc", 0x00EA, 0x0000, true},
+  {"ecolon", 0x2255, 0x0000, false}, {"ecy", 0x044D, 0x0000, false},
+  {"edot", 0x0117, 0x0000, false}, {"ee", 0x2147, 0x0000, false},
+  {"efDot", 0x2252, 0x0000, false}, {"efr", 0x1D522, 0x0000, false},
+  {"eg", 0x2A9A, 0x0000, false}, {"egrave", 0x00E8, 0x0000, true},
+  {"egs", 0x2A96, 0x0000, false}, {"egsdot", 0x2A98, 0x0000, false},
+  {"el", 0x2A99, 0x0000, false}, {"elinters", 0x23E7, 0x0000, false},
+  {"ell", 0x2113, 0x0000, false}, {"els", 0x2A95, 0x0000, false},
+  {"elsdot", 0x2A97, 0x0000, false}, {"emacr", 0x0113, 0x0000, false},
+  {"empty", 0x2205, 0x0000, false}, {"emptyset", 0x2205, 0x0000, false},
+  {"emptyv", 0x2205, 0x0000, false}, {"emsp", 0x2003, 0x0000, false},
+  {"emsp13", 0x2004, 0x0000, false}, {"emsp14", 0x2005, 0x0000, false},
+  {"eng", 0x014B, 0x0000, false}, {"ensp", 0x2002, 0x0000, false},
+  {"eogon", 0x0119, 0x0000, false}, {"eopf", 0x1D556, 0x0000, false},
+  {"epar", 0x22D5, 0x0000, false}, {"eparsl", 0x29E3, 0x0000, false},
+  {"eplus", 0x2A71, 0x0000, false}, {"epsi", 0x03B5, 0x0000, false},
+  {"epsilon", 0x03B5, 0x0000, false}, {"epsiv", 0x03F5, 0x0000, false},
+  {"eqcirc", 0x2256, 0x0000, false}, {"eqcolon", 0x2255, 0x0000, false},
+  {"eqsim", 0x2242, 0x0000, false}, {"eqslantgtr", 0x2A96, 0x0000, false},
+  {"eqslantless", 0x2A95, 0x0000, false}, {"equals", 0x003D, 0x0000, false},
+  {"equest", 0x225F, 0x0000, false}, {"equiv", 0x2261, 0x0000, false},
+  {"equivDD", 0x2A78, 0x0000, false}, {"eqvparsl", 0x29E5, 0x0000, false},
+  {"erDot", 0x2253, 0x0000, false}, {"erarr", 0x2971, 0x0000, false},
+  {"escr", 0x212F, 0x0000, false}, {"esdot", 0x2250, 0x0000, false},
+  {"esim", 0x2242, 0x0000, false}, {"eta", 0x03B7, 0x0000, false},
+  {"eth", 0x00F0, 0x0000, true}, {"euml", 0x00EB, 0x0000, true},
+  {"euro", 0x20AC, 0x0000, false}, {"excl", 0x0021, 0x0000, false},
+  {"exist", 0x2203, 0x0000, false}, {"expectation", 0x2130, 0x0000, false},
+  {"exponentiale", 0x2147, 0x0000, false},
+  {"fallingdotseq", 0x2252, 0x0000, false}, {"fcy", 0x0444, 0x0000, false},
+  {"female", 0x2640, 0x0000, false}, {"ffilig", 0xFB03, 0x0000, false},
+  {"fflig", 0xFB00, 0x0000, false}, {"ffllig", 0xFB04, 0x0000, false},
+  {"ffr", 0x1D523, 0x0000, false}, {"filig", 0xFB01, 0x0000, false},
+  {"fjlig", 0x0066, 0x006A, false}, {"flat", 0x266D, 0x0000, false},
+  {"fllig", 0xFB02, 0x0000, false}, {"fltns", 0x25B1, 0x0000, false},
+  {"fnof", 0x0192, 0x0000, false}, {"fopf", 0x1D557, 0x0000, false},
+  {"forall", 0x2200, 0x0000, false}, {"fork", 0x22D4, 0x0000, false},
+  {"forkv", 0x2AD9, 0x0000, false}, {"fpartint", 0x2A0D, 0x0000, false},
+  {"frac12", 0x00BD, 0x0000, true}, {"frac13", 0x2153, 0x0000, false},
+  {"frac14", 0x00BC, 0x0000, true}, {"frac15", 0x2155, 0x0000, false},
+  {"frac16", 0x2159, 0x0000, false}, {"frac18", 0x215B, 0x0000, false},
+  {"frac23", 0x2154, 0x0000, false}, {"frac25", 0x2156, 0x0000, false},
+  {"frac34", 0x00BE, 0x0000, true}, {"frac35", 0x2157, 0x0000, false},
+  {"frac38", 0x215C, 0x0000, false}, {"frac45", 0x2158, 0x0000, false},
+  {"frac56", 0x215A, 0x0000, false}, {"frac58", 0x215D, 0x0000, false},
+  {"frac78", 0x215E, 0x0000, false}, {"frasl", 0x2044, 0x0000, false},
+  {"frown", 0x2322, 0x0000, false}, {"fscr", 0x1D4BB, 0x0000, false},
+  {"gE", 0x2267, 0x0000, false}, {"gEl", 0x2A8C, 0x0000, false},
+  {"gacute", 0x01F5, 0x0000, false}, {"gamma", 0x03B3, 0x0000, false},
+  {"gammad", 0x03DD, 0x0000, false}, {"gap", 0x2A86, 0x0000, false},
+  {"gbreve", 0x011F, 0x0000, false}, {"gcirc", 0x011D, 0x0000, false},
+  {"gcy", 0x0433, 0x0000, false}, {"gdot", 0x0121, 0x0000, false},
+  {"ge", 0x2265, 0x0000, false}, {"gel", 0x22DB, 0x0000, false},
+  {"geq", 0x2265, 0x0000, false}, {"geqq", 0x2267, 0x0000, false},
+  {"geqslant", 0x2A7E, 0x0000, false}, {"ges", 0x2A7E, 0x0000, false},
+  {"gescc", 0x2AA9, 0x0000, false}, {"gesdot", 0x2A80, 0x0000, false},
+  {"gesdoto", 0x2A82, 0x0000, false}, {"gesdotol", 0x2A84, 0x0000, false},
+  {"gesl", 0x22DB, 0xFE00, false}, {"gesles", 0x2A94, 0x0000, false},
+  {"gfr", 0x1D524, 0x0000, false}, {"gg", 0x226B, 0x0000, false},
+  {"ggg", 0x22D9, 0x0000, false}, {"gimel", 0x2137, 0x0000, false},
+  {"gjcy", 0x0453, 0x0000, false}, {"gl", 0x2277, 0x0000, false},
+  {"glE", 0x2A92, 0x0000, false}, {"gla", 0x2AA5, 0x0000, false},
+  {"glj", 0x2AA4, 0x0000, false}, {"gnE", 0x2269, 0x0000, false},
+  {"gnap", 0x2A8A, 0x0000, false}, {"gnapprox", 0x2A8A, 0x0000, false},
+  {"gne", 0x2A88, 0x0000, false}, {"gneq", 0x2A88, 0x0000, false},
+  {"gneqq", 0x2269, 0x0000, false}, {"gnsim", 0x22E7, 0x0000, false},
+  {"gopf", 0x1D558, 0x0000, false}, {"grave", 0x0060, 0x0000, false},
+  {"gscr", 0x210A, 0x0000, false}, {"gsim", 0x2273, 0x0000, false},
+  {"gsime", 0x2A8E, 0x0000, false}, {"gsiml", 0x2A90, 0x0000, false},
+  {"gt", 0x003E, 0x0000, true}, {"gtcc", 0x2AA7, 0x0000, false},
+  {"gtcir", 0x2A7A, 0x0000, false}, {"gtdot", 0x22D7, 0x0000, false},
+  {"gtlPar", 0x2995, 0x0000, false}, {"gtquest", 0x2A7C, 0x0000, false},
+  {"gtrapprox", 0x2A86, 0x0000, false}, {"gtrarr", 0x2978, 0x0000, false},
+  {"gtrdot", 0x22D7, 0x0000, false}, {"gtreqless", 0x22DB, 0x0000, false},
+  {"gtreqqless", 0x2A8C, 0x0000, false}, {"gtrless", 0x2277, 0x0000, false},
+  {"gtrsim", 0x2273, 0x0000, false}, {"gvertneqq", 0x2269, 0xFE00, false},
+  {"gvnE", 0x2269, 0xFE00, false}, {"hArr", 0x21D4, 0x0000, false},
+  {"hairsp", 0x200A, 0x0000, false}, {"half", 0x00BD, 0x0000, false},
+  {"hamilt", 0x210B, 0x0000, false}, {"hardcy", 0x044A, 0x0000, false},
+  {"harr", 0x2194, 0x0000, false}, {"harrcir", 0x2948, 0x0000, false},
+  {"harrw", 0x21AD, 0x0000, false}, {"hbar", 0x210F, 0x0000, false},
+  {"hcirc", 0x0125, 0x0000, false}, {"hearts", 0x2665, 0x0000, false},
+  {"heartsuit", 0x2665, 0x0000, false}, {"hellip", 0x2026, 0x0000, false},
+  {"hercon", 0x22B9, 0x0000, false}, {"hfr", 0x1D525, 0x0000, false},
+  {"hksearow", 0x2925, 0x0000, false}, {"hkswarow", 0x2926, 0x0000, false},
+  {"hoarr", 0x21FF, 0x0000, false}, {"homtht", 0x223B, 0x0000, false},
+  {"hookleftarrow", 0x21A9, 0x0000, false},
+  {"hookrightarrow", 0x21AA, 0x0000, false}, {"hopf", 0x1D559, 0x0000, false},
+  {"horbar", 0x2015, 0x0000, false}, {"hscr", 0x1D4BD, 0x0000, false},
+  {"hslash", 0x210F, 0x0000, false}, {"hstrok", 0x0127, 0x0000, false},
+  {"hybull", 0x2043, 0x0000, false}, {"hyphen", 0x2010, 0x0000, false},
+  {"iacute", 0x00ED, 0x0000, true}, {"ic", 0x2063, 0x0000, false},
+  {"icirc", 0x00EE, 0x0000, true}, {"icy", 0x0438, 0x0000, false},
+  {"iecy", 0x0435, 0x0000, false}, {"iexcl", 0x00A1, 0x0000, true},
+  {"iff", 0x21D4, 0x0000, false}, {"ifr", 0x1D526, 0x0000, false},
+  {"igrave", 0x00EC, 0x0000, true}, {"ii", 0x2148, 0x0000, false},
+  {"iiiint", 0x2A0C, 0x0000, false}, {"iiint", 0x222D, 0x0000, false},
+  {"iinfin", 0x29DC, 0x0000, false}, {"iiota", 0x2129, 0x0000, false},
+  {"ijlig", 0x0133, 0x0000, false}, {"imacr", 0x012B, 0x0000, false},
+  {"image", 0x2111, 0x0000, false}, {"imagline", 0x2110, 0x0000, false},
+  {"imagpart", 0x2111, 0x0000, false}, {"imath", 0x0131, 0x0000, false},
+  {"imof", 0x22B7, 0x0000, false}, {"imped", 0x01B5, 0x0000, false},
+  {"in", 0x2208, 0x0000, false}, {"incare", 0x2105, 0x0000, false},
+  {"infin", 0x221E, 0x0000, false}, {"infintie", 0x29DD, 0x0000, false},
+  {"inodot", 0x0131, 0x0000, false}, {"int", 0x222B, 0x0000, false},
+  {"intcal", 0x22BA, 0x0000, false}, {"integers", 0x2124, 0x0000, false},
+  {"intercal", 0x22BA, 0x0000, false}, {"intlarhk", 0x2A17, 0x0000, false},
+  {"intprod", 0x2A3C, 0x0000, false}, {"iocy", 0x0451, 0x0000, false},
+  {"iogon", 0x012F, 0x0000, false}, {"iopf", 0x1D55A, 0x0000, false},
+  {"iota", 0x03B9, 0x0000, false}, {"iprod", 0x2A3C, 0x0000, false},
+  {"iquest", 0x00BF, 0x0000, true}, {"iscr", 0x1D4BE, 0x0000, false},
+  {"isin", 0x2208, 0x0000, false}, {"isinE", 0x22F9, 0x0000, false},
+  {"isindot", 0x22F5, 0x0000, false}, {"isins", 0x22F4, 0x0000, false},
+  {"isinsv", 0x22F3, 0x0000, false}, {"isinv", 0x2208, 0x0000, false},
+  {"it", 0x2062, 0x0000, false}, {"itilde", 0x0129, 0x0000, false},
+  {"iukcy", 0x0456, 0x0000, false}, {"iuml", 0x00EF, 0x0000, true},
+  {"jcirc", 0x0135, 0x0000, false}, {"jcy", 0x0439, 0x0000, false},
+  {"jfr", 0x1D527, 0x0000, false}, {"jmath", 0x0237, 0x0000, false},
+  {"jopf", 0x1D55B, 0x0000, false}, {"jscr", 0x1D4BF, 0x0000, false},
+  {"jsercy", 0x0458, 0x0000, false}, {"jukcy", 0x0454, 0x0000, false},
+  {"kappa", 0x03BA, 0x0000, false}, {"kappav", 0x03F0, 0x0000, false},
+  {"kcedil", 0x0137, 0x0000, false}, {"kcy", 0x043A, 0x0000, false},
+  {"kfr", 0x1D528, 0x0000, false}, {"kgreen", 0x0138, 0x0000, false},
+  {"khcy", 0x0445, 0x0000, false}, {"kjcy", 0x045C, 0x0000, false},
+  {"kopf", 0x1D55C, 0x0000, false}, {"kscr", 0x1D4C0, 0x0000, false},
+  {"lAarr", 0x21DA, 0x0000, false}, {"lArr", 0x21D0, 0x0000, false},
+  {"lAtail", 0x291B, 0x0000, false}, {"lBarr", 0x290E, 0x0000, false},
+  {"lE", 0x2266, 0x0000, false}, {"lEg", 0x2A8B, 0x0000, false},
+  {"lHar", 0x2962, 0x0000, false}, {"lacute", 0x013A, 0x0000, false},
+  {"laemptyv", 0x29B4, 0x0000, false}, {"lagran", 0x2112, 0x0000, false},
+  {"lambda", 0x03BB, 0x0000, false}, {"lang", 0x27E8, 0x0000, false},
+  {"langd", 0x2991, 0x0000, false}, {"langle", 0x27E8, 0x0000, false},
+  {"lap", 0x2A85, 0x0000, false}, {"laquo", 0x00AB, 0x0000, true},
+  {"larr", 0x2190, 0x0000, false}, {"larrb", 0x21E4, 0x0000, false},
+  {"larrbfs", 0x291F, 0x0000, false}, {"larrfs", 0x291D, 0x0000, false},
+  {"larrhk", 0x21A9, 0x0000, false}, {"larrlp", 0x21AB, 0x0000, false},
+  {"larrpl", 0x2939, 0x0000, false}, {"larrsim", 0x2973, 0x0000, false},
+  {"larrtl", 0x21A2, 0x0000, false}, {"lat", 0x2AAB, 0x0000, false},
+  {"latail", 0x2919, 0x0000, false}, {"late", 0x2AAD, 0x0000, false},
+  {"lates", 0x2AAD, 0xFE00, false}, {"lbarr", 0x290C, 0x0000, false},
+  {"lbbrk", 0x2772, 0x0000, false}, {"lbrace", 0x007B, 0x0000, false},
+  {"lbrack", 0x005B, 0x0000, false}, {"lbrke", 0x298B, 0x0000, false},
+  {"lbrksld", 0x298F, 0x0000, false}, {"lbrkslu", 0x298D, 0x0000, false},
+  {"lcaron", 0x013E, 0x0000, false}, {"lcedil", 0x013C, 0x0000, false},
+  {"lceil", 0x2308, 0x0000, false}, {"lcub", 0x007B, 0x0000, false},
+  {"lcy", 0x043B, 0x0000, false}, {"ldca", 0x2936, 0x0000, false},
+  {"ldquo", 0x201C, 0x0000, false}, {"ldquor", 0x201E, 0x0000, false},
+  {"ldrdhar", 0x2967, 0x0000, false}, {"ldrushar", 0x294B, 0x0000, false},
+  {"ldsh", 0x21B2, 0x0000, false}, {"le", 0x2264, 0x0000, false},
+  {"leftarrow", 0x2190, 0x0000, false},
+  {"leftarrowtail", 0x21A2, 0x0000, false},
+  {"leftharpoondown", 0x21BD, 0x0000, false},
+  {"leftharpoonup", 0x21BC, 0x0000, false},
+  {"leftleftarrows", 0x21C7, 0x0000, false},
+  {"leftrightarrow", 0x2194, 0x0000, false},
+  {"leftrightarrows", 0x21C6, 0x0000, false},
+  {"leftrightharpoons", 0x21CB, 0x0000, false},
+  {"leftrightsquigarrow", 0x21AD, 0x0000, false},
+  {"leftthreetimes", 0x22CB, 0x0000, false}, {"leg", 0x22DA, 0x0000, false},
+  {"leq", 0x2264, 0x0000, false}, {"leqq", 0x2266, 0x0000, false},
+  {"leqslant", 0x2A7D, 0x0000, false}, {"les", 0x2A7D, 0x0000, false},
+  {"lescc", 0x2AA8, 0x0000, false}, {"lesdot", 0x2A7F, 0x0000, false},
+  {"lesdoto", 0x2A81, 0x0000, false}, {"lesdotor", 0x2A83, 0x0000, false},
+  {"lesg", 0x22DA, 0xFE00, false}, {"lesges", 0x2A93, 0x0000, false},
+  {"lessapprox", 0x2A85, 0x0000, false}, {"lessdot", 0x22D6, 0x0000, false},
+  {"lesseqgtr", 0x22DA, 0x0000, false}, {"lesseqqgtr", 0x2A8B, 0x0000, false},
+  {"lessgtr", 0x2276, 0x0000, false}, {"lesssim", 0x2272, 0x0000, false},
+  {"lfisht", 0x297C, 0x0000, false}, {"lfloor", 0x230A, 0x0000, false},
+  {"lfr", 0x1D529, 0x0000, false}, {"lg", 0x2276, 0x0000, false},
+  {"lgE", 0x2A91, 0x0000, false}, {"lhard", 0x21BD, 0x0000, false},
+  {"lharu", 0x21BC, 0x0000, false}, {"lharul", 0x296A, 0x0000, false},
+  {"lhblk", 0x2584, 0x0000, false}, {"ljcy", 0x0459, 0x0000, false},
+  {"ll", 0x226A, 0x0000, false}, {"llarr", 0x21C7, 0x0000, false},
+  {"llcorner", 0x231E, 0x0000, false}, {"llhard", 0x296B, 0x0000, false},
+  {"lltri", 0x25FA, 0x0000, false}, {"lmidot", 0x0140, 0x0000, false},
+  {"lmoust", 0x23B0, 0x0000, false}, {"lmoustache", 0x23B0, 0x0000, false},
+  {"lnE", 0x2268, 0x0000, false}, {"lnap", 0x2A89, 0x0000, false},
+  {"lnapprox", 0x2A89, 0x0000, false}, {"lne", 0x2A87, 0x0000, false},
+  {"lneq", 0x2A87, 0x0000, false}, {"lneqq", 0x2268, 0x0000, false},
+  {"lnsim", 0x22E6, 0x0000, false}, {"loang", 0x27EC, 0x0000, false},
+  {"loarr", 0x21FD, 0x0000, false}, {"lobrk", 0x27E6, 0x0000, false},
+  {"longleftarrow", 0x27F5, 0x0000, false},
+  {"longleftrightarrow", 0x27F7, 0x0000, false},
+  {"longmapsto", 0x27FC, 0x0000, false},
+  {"longrightarrow", 0x27F6, 0x0000, false},
+  {"looparrowleft", 0x21AB, 0x0000, false},
+  {"looparrowright", 0x21AC, 0x0000, false}, {"lopar", 0x2985, 0x0000, false},
+  {"lopf", 0x1D55D, 0x0000, false}, {"loplus", 0x2A2D, 0x0000, false},
+  {"lotimes", 0x2A34, 0x0000, false}, {"lowast", 0x2217, 0x0000, false},
+  {"lowbar", 0x005F, 0x0000, false}, {"loz", 0x25CA, 0x0000, false},
+  {"lozenge", 0x25CA, 0x0000, false}, {"lozf", 0x29EB, 0x0000, false},
+  {"lpar", 0x0028, 0x0000, false}, {"lparlt", 0x2993, 0x0000, false},
+  {"lrarr", 0x21C6, 0x0000, false}, {"lrcorner", 0x231F, 0x0000, false},
+  {"lrhar", 0x21CB, 0x0000, false}, {"lrhard", 0x296D, 0x0000, false},
+  {"lrm", 0x200E, 0x0000, false}, {"lrtri", 0x22BF, 0x0000, false},
+  {"lsaquo", 0x2039, 0x0000, false}, {"lscr", 0x1D4C1, 0x0000, false},
+  {"lsh", 0x21B0, 0x0000, false}, {"lsim", 0x2272, 0x0000, false},
+  {"lsime", 0x2A8D, 0x0000, false}, {"lsimg", 0x2A8F, 0x0000, false},
+  {"lsqb", 0x005B, 0x0000, false}, {"lsquo", 0x2018, 0x0000, false},
+  {"lsquor", 0x201A, 0x0000, false}, {"lstrok", 0x0142, 0x0000, false},
+  {"lt", 0x003C, 0x0000, true}, {"ltcc", 0x2AA6, 0x0000, false},
+  {"ltcir", 0x2A79, 0x0000, false}, {"ltdot", 0x22D6, 0x0000, false},
+  {"lthree", 0x22CB, 0x0000, false}, {"ltimes", 0x22C9, 0x0000, false},
+  {"ltlarr", 0x2976, 0x0000, false}, {"ltquest", 0x2A7B, 0x0000, false},
+  {"ltrPar", 0x2996, 0x0000, false}, {"ltri", 0x25C3, 0x0000, false},
+  {"ltrie", 0x22B4, 0x0000, false}, {"ltrif", 0x25C2, 0x0000, false},
+  {"lurdshar", 0x294A, 0x0000, false}, {"luruhar", 0x2966, 0x0000, false},
+  {"lvertneqq", 0x2268, 0xFE00, false}, {"lvnE", 0x2268, 0xFE00, false},
+  {"mDDot", 0x223A, 0x0000, false}, {"macr", 0x00AF, 0x0000, true},
+  {"male", 0x2642, 0x0000, false}, {"malt", 0x2720, 0x0000, false},
+  {"maltese", 0x2720, 0x0000, false}, {"map", 0x21A6, 0x0000, false},
+  {"mapsto", 0x21A6, 0x0000, false}, {"mapstodown", 0x21A7, 0x0000, false},
+  {"mapstoleft", 0x21A4, 0x0000, false}, {"mapstoup", 0x21A5, 0x0000, false},
+  {"marker", 0x25AE, 0x0000, false}, {"mcomma", 0x2A29, 0x0000, false},
+  {"mcy", 0x043C, 0x0000, false}, {"mdash", 0x2014, 0x0000, false},
+  {"measuredangle", 0x2221, 0x0000, false}, {"mfr", 0x1D52A, 0x0000, false},
+  {"mho", 0x2127, 0x0000, false}, {"micro", 0x00B5, 0x0000, true},
+  {"mid", 0x2223, 0x0000, false}, {"midast", 0x002A, 0x0000, false},
+  {"midcir", 0x2AF0, 0x0000, false}, {"middot", 0x00B7, 0x0000, true},
+  {"minus", 0x2212, 0x0000, false}, {"minusb", 0x229F, 0x0000, false},
+  {"minusd", 0x2238, 0x0000, false}, {"minusdu", 0x2A2A, 0x0000, false},
+  {"mlcp", 0x2ADB, 0x0000, false}, {"mldr", 0x2026, 0x0000, false},
+  {"mnplus", 0x2213, 0x0000, false}, {"models", 0x22A7, 0x0000, false},
+  {"mopf", 0x1D55E, 0x0000, false}, {"mp", 0x2213, 0x0000, false},
+  {"mscr", 0x1D4C2, 0x0000, false}, {"mstpos", 0x223E, 0x0000, false},
+  {"mu", 0x03BC, 0x0000, false}, {"multimap", 0x22B8, 0x0000, false},
+  {"mumap", 0x22B8, 0x0000, false}, {"nGg", 0x22D9, 0x0338, false},
+  {"nGt", 0x226B, 0x20D2, false}, {"nGtv", 0x226B, 0x0338, false},
+  {"nLeftarrow", 0x21CD, 0x0000, false},
+  {"nLeftrightarrow", 0x21CE, 0x0000, false}, {"nLl", 0x22D8, 0x0338, false},
+  {"nLt", 0x226A, 0x20D2, false}, {"nLtv", 0x226A, 0x0338, false},
+  {"nRightarrow", 0x21CF, 0x0000, false}, {"nVDash", 0x22AF, 0x0000, false},
+  {"nVdash", 0x22AE, 0x0000, false}, {"nabla", 0x2207, 0x0000, false},
+  {"nacute", 0x0144, 0x0000, false}, {"nang", 0x2220, 0x20D2, false},
+  {"nap", 0x2249, 0x0000, false}, {"napE", 0x2A70, 0x0338, false},
+  {"napid", 0x224B, 0x0338, false}, {"napos", 0x0149, 0x0000, false},
+  {"napprox", 0x2249, 0x0000, false}, {"natur", 0x266E, 0x0000, false},
+  {"natural", 0x266E, 0x0000, false}, {"naturals", 0x2115, 0x0000, false},
+  {"nbsp", 0x00A0, 0x0000, true}, {"nbump", 0x224E, 0x0338, false},
+  {"nbumpe", 0x224F, 0x0338, false}, {"ncap", 0x2A43, 0x0000, false},
+  {"ncaron", 0x0148, 0x0000, false}, {"ncedil", 0x0146, 0x0000, false},
+  {"ncong", 0x2247, 0x0000, false}, {"ncongdot", 0x2A6D, 0x0338, false},
+  {"ncup", 0x2A42, 0x0000, false}, {"ncy", 0x043D, 0x0000, false},
+  {"ndash", 0x2013, 0x0000, false}, {"ne", 0x2260, 0x0000, false},
+  {"neArr", 0x21D7, 0x0000, false}, {"nearhk", 0x2924, 0x0000, false},
+  {"nearr", 0x2197, 0x0000, false}, {"nearrow", 0x2197, 0x0000, false},
+  {"nedot", 0x2250, 0x0338, false}, {"nequiv", 0x2262, 0x0000, false},
+  {"nesear", 0x2928, 0x0000, false}, {"nesim", 0x2242, 0x0338, false},
+  {"nexist", 0x2204, 0x0000, false}, {"nexists", 0x2204, 0x0000, false},
+  {"nfr", 0x1D52B, 0x0000, false}, {"ngE", 0x2267, 0x0338, false},
+  {"nge", 0x2271, 0x0000, false}, {"ngeq", 0x2271, 0x0000, false},
+  {"ngeqq", 0x2267, 0x0338, false}, {"ngeqslant", 0x2A7E, 0x0338, false},
+  {"nges", 0x2A7E, 0x0338, false}, {"ngsim", 0x2275, 0x0000, false},
+  {"ngt", 0x226F, 0x0000, false}, {"ngtr", 0x226F, 0x0000, false},
+  {"nhArr", 0x21CE, 0x0000, false}, {"nharr", 0x21AE, 0x0000, false},
+  {"nhpar", 0x2AF2, 0x0000, false}, {"ni", 0x220B, 0x0000, false},
+  {"nis", 0x22FC, 0x0000, false}, {"nisd", 0x22FA, 0x0000, false},
+  {"niv", 0x220B, 0x0000, false}, {"njcy", 0x045A, 0x0000, false},
+  {"nlArr", 0x21CD, 0x0000, false}, {"nlE", 0x2266, 0x0338, false},
+  {"nlarr", 0x219A, 0x0000, false}, {"nldr", 0x2025, 0x0000, false},
+  {"nle", 0x2270, 0x0000, false}, {"nleftarrow", 0x219A, 0x0000, false},
+  {"nleftrightarrow", 0x21AE, 0x0000, false}, {"nleq", 0x2270, 0x0000, false},
+  {"nleqq", 0x2266, 0x0338, false}, {"nleqslant", 0x2A7D, 0x0338, false},
+  {"nles", 0x2A7D, 0x0338, false}, {"nless", 0x226E, 0x0000, false},
+  {"nlsim", 0x2274, 0x0000, false}, {"nlt", 0x226E, 0x0000, false},
+  {"nltri", 0x22EA, 0x0000, false}, {"nltrie", 0x22EC, 0x0000, false},
+  {"nmid", 0x2224, 0x0000, false}, {"nopf", 0x1D55F, 0x0000, false},
+  {"not", 0x00AC, 0x0000, true}, {"notin", 0x2209, 0x0000, false},
+  {"notinE", 0x22F9, 0x0338, false}, {"notindot", 0x22F5, 0x0338, false},
+  {"notinva", 0x2209, 0x0000, false}, {"notinvb", 0x22F7, 0x0000, false},
+  {"notinvc", 0x22F6, 0x0000, false}, {"notni", 0x220C, 0x0000, false},
+  {"notniva", 0x220C, 0x0000, false}, {"notnivb", 0x22FE, 0x0000, false},
+  {"notnivc", 0x22FD, 0x0000, false}, {"npar", 0x2226, 0x0000, false},
+  {"nparallel", 0x2226, 0x0000, false}, {"nparsl", 0x2AFD, 0x20E5, false},
+  {"npart", 0x2202, 0x0338, false}, {"npolint", 0x2A14, 0x0000, false},
+  {"npr", 0x2280, 0x0000, false}, {"nprcue", 0x22E0, 0x0000, false},
+  {"npre", 0x2AAF, 0x0338, false}, {"nprec", 0x2280, 0x0000, false},
+  {"npreceq", 0x2AAF, 0x0338, false}, {"nrArr", 0x21CF, 0x0000, false},
+  {"nrarr", 0x219B, 0x0000, false}, {"nrarrc", 0x2933, 0x0338, false},
+  {"nrarrw", 0x219D, 0x0338, false}, {"nrightarrow", 0x219B, 0x0000, false},
+  {"nrtri", 0x22EB, 0x0000, false}, {"nrtrie", 0x22ED, 0x0000, false},
+  {"nsc", 0x2281, 0x0000, false}, {"nsccue", 0x22E1, 0x0000, false},
+  {"nsce", 0x2AB0, 0x0338, false}, {"nscr", 0x1D4C3, 0x0000, false},
+  {"nshortmid", 0x2224, 0x0000, false},
+  {"nshortparallel", 0x2226, 0x0000, false}, {"nsim", 0x2241, 0x0000, false},
+  {"nsime", 0x2244, 0x0000, false}, {"nsimeq", 0x2244, 0x0000, false},
+  {"nsmid", 0x2224, 0x0000, false}, {"nspar", 0x2226, 0x0000, false},
+  {"nsqsube", 0x22E2, 0x0000, false}, {"nsqsupe", 0x22E3, 0x0000, false},
+  {"nsub", 0x2284, 0x0000, false}, {"nsubE", 0x2AC5, 0x0338, false},
+  {"nsube", 0x2288, 0x0000, false}, {"nsubset", 0x2282, 0x20D2, false},
+  {"nsubseteq", 0x2288, 0x0000, false}, {"nsubseteqq", 0x2AC5, 0x0338, false},
+  {"nsucc", 0x2281, 0x0000, false}, {"nsucceq", 0x2AB0, 0x0338, false},
+  {"nsup", 0x2285, 0x0000, false}, {"nsupE", 0x2AC6, 0x0338, false},
+  {"nsupe", 0x2289, 0x0000, false}, {"nsupset", 0x2283, 0x20D2, false},
+  {"nsupseteq", 0x2289, 0x0000, false}, {"nsupseteqq", 0x2AC6, 0x0338, false},
+  {"ntgl", 0x2279, 0x0000, false}, {"ntilde", 0x00F1, 0x0000, true},
+  {"ntlg", 0x2278, 0x0000, false}, {"ntriangleleft", 0x22EA, 0x0000, false},
+  {"ntrianglelefteq", 0x22EC, 0x0000, false},
+  {"ntriangleright", 0x22EB, 0x0000, false},
+  {"ntrianglerighteq", 0x22ED, 0x0000, false}, {"nu", 0x03BD, 0x0000, false},
+  {"num", 0x0023, 0x0000, false}, {"numero", 0x2116, 0x0000, false},
+  {"numsp", 0x2007, 0x0000, false}, {"nvDash", 0x22AD, 0x0000, false},
+  {"nvHarr", 0x2904, 0x0000, false}, {"nvap", 0x224D, 0x20D2, false},
+  {"nvdash", 0x22AC, 0x0000, false}, {"nvge", 0x2265, 0x20D2, false},
+  {"nvgt", 0x003E, 0x20D2, false}, {"nvinfin", 0x29DE, 0x0000, false},
+  {"nvlArr", 0x2902, 0x0000, false}, {"nvle", 0x2264, 0x20D2, false},
+  {"nvlt", 0x003C, 0x20D2, false}, {"nvltrie", 0x22B4, 0x20D2, false},
+  {"nvrArr", 0x2903, 0x0000, false}, {"nvrtrie", 0x22B5, 0x20D2, false},
+  {"nvsim", 0x223C, 0x20D2, false}, {"nwArr", 0x21D6, 0x0000, false},
+  {"nwarhk", 0x2923, 0x0000, false}, {"nwarr", 0x2196, 0x0000, false},
+  {"nwarrow", 0x2196, 0x0000, false}, {"nwnear", 0x2927, 0x0000, false},
+  {"oS", 0x24C8, 0x0000, false}, {"oacute", 0x00F3, 0x0000, true},
+  {"oast", 0x229B, 0x0000, false}, {"ocir", 0x229A, 0x0000, false},
+  {"ocirc", 0x00F4, 0x0000, true}, {"ocy", 0x043E, 0x0000, false},
+  {"odash", 0x229D, 0x0000, false}, {"odblac", 0x0151, 0x0000, false},
+  {"odiv", 0x2A38, 0x0000, false}, {"odot", 0x2299, 0x0000, false},
+  {"odsold", 0x29BC, 0x0000, false}, {"oelig", 0x0153, 0x0000, false},
+  {"ofcir", 0x29BF, 0x0000, false}, {"ofr", 0x1D52C, 0x0000, false},
+  {"ogon", 0x02DB, 0x0000, false}, {"ograve", 0x00F2, 0x0000, true},
+  {"ogt", 0x29C1, 0x0000, false}, {"ohbar", 0x29B5, 0x0000, false},
+  {"ohm", 0x03A9, 0x0000, false}, {"oint", 0x222E, 0x0000, false},
+  {"olarr", 0x21BA, 0x0000, false}, {"olcir", 0x29BE, 0x0000, false},
+  {"olcross", 0x29BB, 0x0000, false}, {"oline", 0x203E, 0x0000, false},
+  {"olt", 0x29C0, 0x0000, false}, {"omacr", 0x014D, 0x0000, false},
+  {"omega", 0x03C9, 0x0000, false}, {"omicron", 0x03BF, 0x0000, false},
+  {"omid", 0x29B6, 0x0000, false}, {"ominus", 0x2296, 0x0000, false},
+  {"oopf", 0x1D560, 0x0000, false}, {"opar", 0x29B7, 0x0000, false},
+  {"operp", 0x29B9, 0x0000, false}, {"oplus", 0x2295, 0x0000, false},
+  {"or", 0x2228, 0x0000, false}, {"orarr", 0x21BB, 0x0000, false},
+  {"ord", 0x2A5D, 0x0000, false}, {"order", 0x2134, 0x0000, false},
+  {"orderof", 0x2134, 0x0000, false}, {"ordf", 0x00AA, 0x0000, true},
+  {"ordm", 0x00BA, 0x0000, true}, {"origof", 0x22B6, 0x0000, false},
+  {"oror", 0x2A56, 0x0000, false}, {"orslope", 0x2A57, 0x0000, false},
+  {"orv", 0x2A5B, 0x0000, false}, {"oscr", 0x2134, 0x0000, false},
+  {"oslash", 0x00F8, 0x0000, true}, {"osol", 0x2298, 0x0000, false},
+  {"otilde", 0x00F5, 0x0000, true}, {"otimes", 0x2297, 0x0000, false},
+  {"otimesas", 0x2A36, 0x0000, false}, {"ouml", 0x00F6, 0x0000, true},
+  {"ovbar", 0x233D, 0x0000, false}, {"par", 0x2225, 0x0000, false},
+  {"para", 0x00B6, 0x0000, true}, {"parallel", 0x2225, 0x0000, false},
+  {"parsim", 0x2AF3, 0x0000, false}, {"parsl", 0x2AFD, 0x0000, false},
+  {"part", 0x2202, 0x0000, false}, {"pcy", 0x043F, 0x0000, false},
+  {"percnt", 0x0025, 0x0000, false}, {"period", 0x002E, 0x0000, false},
+  {"permil", 0x2030, 0x0000, false}, {"perp", 0x22A5, 0x0000, false},
+  {"pertenk", 0x2031, 0x0000, false}, {"pfr", 0x1D52D, 0x0000, false},
+  {"phi", 0x03C6, 0x0000, false}, {"phiv", 0x03D5, 0x0000, false},
+  {"phmmat", 0x2133, 0x0000, false}, {"phone", 0x260E, 0x0000, false},
+  {"pi", 0x03C0, 0x0000, false}, {"pitchfork", 0x22D4, 0x0000, false},
+  {"piv", 0x03D6, 0x0000, false}, {"planck", 0x210F, 0x0000, false},
+  {"planckh", 0x210E, 0x0000, false}, {"plankv", 0x210F, 0x0000, false},
+  {"plus", 0x002B, 0x0000, false}, {"plusacir", 0x2A23, 0x0000, false},
+  {"plusb", 0x229E, 0x0000, false}, {"pluscir", 0x2A22, 0x0000, false},
+  {"plusdo", 0x2214, 0x0000, false}, {"plusdu", 0x2A25, 0x0000, false},
+  {"pluse", 0x2A72, 0x0000, false}, {"plusmn", 0x00B1, 0x0000, true},
+  {"plussim", 0x2A26, 0x0000, false}, {"plustwo", 0x2A27, 0x0000, false},
+  {"pm", 0x00B1, 0x0000, false}, {"pointint", 0x2A15, 0x0000, false},
+  {"popf", 0x1D561, 0x0000, false}, {"pound", 0x00A3, 0x0000, true},
+  {"pr", 0x227A, 0x0000, false}, {"prE", 0x2AB3, 0x0000, false},
+  {"prap", 0x2AB7, 0x0000, false}, {"prcue", 0x227C, 0x0000, false},
+  {"pre", 0x2AAF, 0x0000, false}, {"prec", 0x227A, 0x0000, false},
+  {"precapprox", 0x2AB7, 0x0000, false}, {"preccurlyeq", 0x227C, 0x0000, false},
+  {"preceq", 0x2AAF, 0x0000, false}, {"precnapprox", 0x2AB9, 0x0000, false},
+  {"precneqq", 0x2AB5, 0x0000, false}, {"precnsim", 0x22E8, 0x0000, false},
+  {"precsim", 0x227E, 0x0000, false}, {"prime", 0x2032, 0x0000, false},
+  {"primes", 0x2119, 0x0000, false}, {"prnE", 0x2AB5, 0x0000, false},
+  {"prnap", 0x2AB9, 0x0000, false}, {"prnsim", 0x22E8, 0x0000, false},
+  {"prod", 0x220F, 0x0000, false}, {"profalar", 0x232E, 0x0000, false},
+  {"profline", 0x2312, 0x0000, false}, {"profsurf", 0x2313, 0x0000, false},
+  {"prop", 0x221D, 0x0000, false}, {"propto", 0x221D, 0x0000, false},
+  {"prsim", 0x227E, 0x0000, false}, {"prurel", 0x22B0, 0x0000, false},
+  {"pscr", 0x1D4C5, 0x0000, false}, {"psi", 0x03C8, 0x0000, false},
+  {"puncsp", 0x2008, 0x0000, false}, {"qfr", 0x1D52E, 0x0000, false},
+  {"qint", 0x2A0C, 0x0000, false}, {"qopf", 0x1D562, 0x0000, false},
+  {"qprime", 0x2057, 0x0000, false}, {"qscr", 0x1D4C6, 0x0000, false},
+  {"quaternions", 0x210D, 0x0000, false}, {"quatint", 0x2A16, 0x0000, false},
+  {"quest", 0x003F, 0x0000, false}, {"questeq", 0x225F, 0x0000, false},
+  {"quot", 0x0022, 0x0000, true}, {"rAarr", 0x21DB, 0x0000, false},
+  {"rArr", 0x21D2, 0x0000, false}, {"rAtail", 0x291C, 0x0000, false},
+  {"rBarr", 0x290F, 0x0000, false}, {"rHar", 0x2964, 0x0000, false},
+  {"race", 0x223D, 0x0331, false}, {"racute", 0x0155, 0x0000, false},
+  {"radic", 0x221A, 0x0000, false}, {"raemptyv", 0x29B3, 0x0000, false},
+  {"rang", 0x27E9, 0x0000, false}, {"rangd", 0x2992, 0x0000, false},
+  {"range", 0x29A5, 0x0000, false}, {"rangle", 0x27E9, 0x0000, false},
+  {"raquo", 0x00BB, 0x0000, true}, {"rarr", 0x2192, 0x0000, false},
+  {"rarrap", 0x2975, 0x0000, false}, {"rarrb", 0x21E5, 0x0000, false},
+  {"rarrbfs", 0x2920, 0x0000, false}, {"rarrc", 0x2933, 0x0000, false},
+  {"rarrfs", 0x291E, 0x0000, false}, {"rarrhk", 0x21AA, 0x0000, false},
+  {"rarrlp", 0x21AC, 0x0000, false}, {"rarrpl", 0x2945, 0x0000, false},
+  {"rarrsim", 0x2974, 0x0000, false}, {"rarrtl", 0x21A3, 0x0000, false},
+  {"rarrw", 0x219D, 0x0000, false}, {"ratail", 0x291A, 0x0000, false},
+  {"ratio", 0x2236, 0x0000, false}, {"rationals", 0x211A, 0x0000, false},
+  {"rbarr", 0x290D, 0x0000, false}, {"rbbrk", 0x2773, 0x0000, false},
+  {"rbrace", 0x007D, 0x0000, false}, {"rbrack", 0x005D, 0x0000, false},
+  {"rbrke", 0x298C, 0x0000, false}, {"rbrksld", 0x298E, 0x0000, false},
+  {"rbrkslu", 0x2990, 0x0000, false}, {"rcaron", 0x0159, 0x0000, false},
+  {"rcedil", 0x0157, 0x0000, false}, {"rceil", 0x2309, 0x0000, false},
+  {"rcub", 0x007D, 0x0000, false}, {"rcy", 0x0440, 0x0000, false},
+  {"rdca", 0x2937, 0x0000, false}, {"rdldhar", 0x2969, 0x0000, false},
+  {"rdquo", 0x201D, 0x0000, false}, {"rdquor", 0x201D, 0x0000, false},
+  {"rdsh", 0x21B3, 0x0000, false}, {"real", 0x211C, 0x0000, false},
+  {"realine", 0x211B, 0x0000, false}, {"realpart", 0x211C, 0x0000, false},
+  {"reals", 0x211D, 0x0000, false}, {"rect", 0x25AD, 0x0000, false},
+  {"reg", 0x00AE, 0x0000, true}, {"rfisht", 0x297D, 0x0000, false},
+  {"rfloor", 0x230B, 0x0000, false}, {"rfr", 0x1D52F, 0x0000, false},
+  {"rhard", 0x21C1, 0x0000, false}, {"rharu", 0x21C0, 0x0000, false},
+  {"rharul", 0x296C, 0x0000, false}, {"rho", 0x03C1, 0x0000, false},
+  {"rhov", 0x03F1, 0x0000, false}, {"rightarrow", 0x2192, 0x0000, false},
+  {"rightarrowtail", 0x21A3, 0x0000, false},
+  {"rightharpoondown", 0x21C1, 0x0000, false},
+  {"rightharpoonup", 0x21C0, 0x0000, false},
+  {"rightleftarrows", 0x21C4, 0x0000, false},
+  {"rightleftharpoons", 0x21CC, 0x0000, false},
+  {"rightrightarrows", 0x21C9, 0x0000, false},
+  {"rightsquigarrow", 0x219D, 0x0000, false},
+  {"rightthreetimes", 0x22CC, 0x0000, false}, {"ring", 0x02DA, 0x0000, false},
+  {"risingdotseq", 0x2253, 0x0000, false}, {"rlarr", 0x21C4, 0x0000, false},
+  {"rlhar", 0x21CC, 0x0000, false}, {"rlm", 0x200F, 0x0000, false},
+  {"rmoust", 0x23B1, 0x0000, false}, {"rmoustache", 0x23B1, 0x0000, false},
+  {"rnmid", 0x2AEE, 0x0000, false}, {"roang", 0x27ED, 0x0000, false},
+  {"roarr", 0x21FE, 0x0000, false}, {"robrk", 0x27E7, 0x0000, false},
+  {"ropar", 0x2986, 0x0000, false}, {"ropf", 0x1D563, 0x0000, false},
+  {"roplus", 0x2A2E, 0x0000, false}, {"rotimes", 0x2A35, 0x0000, false},
+  {"rpar", 0x0029, 0x0000, false}, {"rpargt", 0x2994, 0x0000, false},
+  {"rppolint", 0x2A12, 0x0000, false}, {"rrarr", 0x21C9, 0x0000, false},
+  {"rsaquo", 0x203A, 0x0000, false}, {"rscr", 0x1D4C7, 0x0000, false},
+  {"rsh", 0x21B1, 0x0000, false}, {"rsqb", 0x005D, 0x0000, false},
+  {"rsquo", 0x2019, 0x0000, false}, {"rsquor", 0x2019, 0x0000, false},
+  {"rthree", 0x22CC, 0x0000, false}, {"rtimes", 0x22CA, 0x0000, false},
+  {"rtri", 0x25B9, 0x0000, false}, {"rtrie", 0x22B5, 0x0000, false},
+  {"rtrif", 0x25B8, 0x0000, false}, {"rtriltri", 0x29CE, 0x0000, false},
+  {"ruluhar", 0x2968, 0x0000, false}, {"rx", 0x211E, 0x0000, false},
+  {"sacute", 0x015B, 0x0000, false}, {"sbquo", 0x201A, 0x0000, false},
+  {"sc", 0x227B, 0x0000, false}, {"scE", 0x2AB4, 0x0000, false},
+  {"scap", 0x2AB8, 0x0000, false}, {"scaron", 0x0161, 0x0000, false},
+  {"sccue", 0x227D, 0x0000, false}, {"sce", 0x2AB0, 0x0000, false},
+  {"scedil", 0x015F, 0x0000, false}, {"scirc", 0x015D, 0x0000, false},
+  {"scnE", 0x2AB6, 0x0000, false}, {"scnap", 0x2ABA, 0x0000, false},
+  {"scnsim", 0x22E9, 0x0000, false}, {"scpolint", 0x2A13, 0x0000, false},
+  {"scsim", 0x227F, 0x0000, false}, {"scy", 0x0441, 0x0000, false},
+  {"sdot", 0x22C5, 0x0000, false}, {"sdotb", 0x22A1, 0x0000, false},
+  {"sdote", 0x2A66, 0x0000, false}, {"seArr", 0x21D8, 0x0000, false},
+  {"searhk", 0x2925, 0x0000, false}, {"searr", 0x2198, 0x0000, false},
+  {"searrow", 0x2198, 0x0000, false}, {"sect", 0x00A7, 0x0000, true},
+  {"semi", 0x003B, 0x0000, false}, {"seswar", 0x2929, 0x0000, false},
+  {"setminus", 0x2216, 0x0000, false}, {"setmn", 0x2216, 0x0000, false},
+  {"sext", 0x2736, 0x0000, false}, {"sfr", 0x1D530, 0x0000, false},
+  {"sfrown", 0x2322, 0x0000, false}, {"sharp", 0x266F, 0x0000, false},
+  {"shchcy", 0x0449, 0x0000, false}, {"shcy", 0x0448, 0x0000, false},
+  {"shortmid", 0x2223, 0x0000, false}, {"shortparallel", 0x2225, 0x0000, false},
+  {"shy", 0x00AD, 0x0000, true}, {"sigma", 0x03C3, 0x0000, false},
+  {"sigmaf", 0x03C2, 0x0000, false}, {"sigmav", 0x03C2, 0x0000, false},
+  {"sim", 0x223C, 0x0000, false}, {"simdot", 0x2A6A, 0x0000, false},
+  {"sime", 0x2243, 0x0000, false}, {"simeq", 0x2243, 0x0000, false},
+  {"simg", 0x2A9E, 0x0000, false}, {"simgE", 0x2AA0, 0x0000, false},
+  {"siml", 0x2A9D, 0x0000, false}, {"simlE", 0x2A9F, 0x0000, false},
+  {"simne", 0x2246, 0x0000, false}, {"simplus", 0x2A24, 0x0000, false},
+  {"simrarr", 0x2972, 0x0000, false}, {"slarr", 0x2190, 0x0000, false},
+  {"smallsetminus", 0x2216, 0x0000, false}, {"smashp", 0x2A33, 0x0000, false},
+  {"smeparsl", 0x29E4, 0x0000, false}, {"smid", 0x2223, 0x0000, false},
+  {"smile", 0x2323, 0x0000, false}, {"smt", 0x2AAA, 0x0000, false},
+  {"smte", 0x2AAC, 0x0000, false}, {"smtes", 0x2AAC, 0xFE00, false},
+  {"softcy", 0x044C, 0x0000, false}, {"sol", 0x002F, 0x0000, false},
+  {"solb", 0x29C4, 0x0000, false}, {"solbar", 0x233F, 0x0000, false},
+  {"sopf", 0x1D564, 0x0000, false}, {"spades", 0x2660, 0x0000, false},
+  {"spadesuit", 0x2660, 0x0000, false}, {"spar", 0x2225, 0x0000, false},
+  {"sqcap", 0x2293, 0x0000, false}, {"sqcaps", 0x2293, 0xFE00, false},
+  {"sqcup", 0x2294, 0x0000, false}, {"sqcups", 0x2294, 0xFE00, false},
+  {"sqsub", 0x228F, 0x0000, false}, {"sqsube", 0x2291, 0x0000, false},
+  {"sqsubset", 0x228F, 0x0000, false}, {"sqsubseteq", 0x2291, 0x0000, false},
+  {"sqsup", 0x2290, 0x0000, false}, {"sqsupe", 0x2292, 0x0000, false},
+  {"sqsupset", 0x2290, 0x0000, false}, {"sqsupseteq", 0x2292, 0x0000, false},
+  {"squ", 0x25A1, 0x0000, false}, {"square", 0x25A1, 0x0000, false},
+  {"squarf", 0x25AA, 0x0000, false}, {"squf", 0x25AA, 0x0000, false},
+  {"srarr", 0x2192, 0x0000, false}, {"sscr", 0x1D4C8, 0x0000, false},
+  {"ssetmn", 0x2216, 0x0000, false}, {"ssmile", 0x2323, 0x0000, false},
+  {"sstarf", 0x22C6, 0x0000, false}, {"star", 0x2606, 0x0000, false},
+  {"starf", 0x2605, 0x0000, false}, {"straightepsilon", 0x03F5, 0x0000, false},
+  {"straightphi", 0x03D5, 0x0000, false}, {"strns", 0x00AF, 0x0000, false},
+  {"sub", 0x2282, 0x0000, false}, {"subE", 0x2AC5, 0x0000, false},
+  {"subdot", 0x2ABD, 0x0000, false}, {"sube", 0x2286, 0x0000, false},
+  {"subedot", 0x2AC3, 0x0000, false}, {"submult", 0x2AC1, 0x0000, false},
+  {"subnE", 0x2ACB, 0x0000, false}, {"subne", 0x228A, 0x0000, false},
+  {"subplus", 0x2ABF, 0x0000, false}, {"subrarr", 0x2979, 0x0000, false},
+  {"subset", 0x2282, 0x0000, false}, {"subseteq", 0x2286, 0x0000, false},
+  {"subseteqq", 0x2AC5, 0x0000, false}, {"subsetneq", 0x228A, 0x0000, false},
+  {"subsetneqq", 0x2ACB, 0x0000, false}, {"subsim", 0x2AC7, 0x0000, false},
+  {"subsub", 0x2AD5, 0x0000, false}, {"subsup", 0x2AD3, 0x0000, false},
+  {"succ", 0x227B, 0x0000, false}, {"succapprox", 0x2AB8, 0x0000, false},
+  {"succcurlyeq", 0x227D, 0x0000, false}, {"succeq", 0x2AB0, 0x0000, false},
+  {"succnapprox", 0x2ABA, 0x0000, false}, {"succneqq", 0x2AB6, 0x0000, false},
+  {"succnsim", 0x22E9, 0x0000, false}, {"succsim", 0x227F, 0x0000, false},
+  {"sum", 0x2211, 0x0000, false}, {"sung", 0x266A, 0x0000, false},
+  {"sup", 0x2283, 0x0000, false}, {"sup1", 0x00B9, 0x0000, true},
+  {"sup2", 0x00B2, 0x0000, true}, {"sup3", 0x00B3, 0x0000, true},
+  {"supE", 0x2AC6, 0x0000, false}, {"supdot", 0x2ABE, 0x0000, false},
+  {"supdsub", 0x2AD8, 0x0000, false}, {"supe", 0x2287, 0x0000, false},
+  {"supedot", 0x2AC4, 0x0000, false}, {"suphsol", 0x27C9, 0x0000, false},
+  {"suphsub", 0x2AD7, 0x0000, false}, {"suplarr", 0x297B, 0x0000, false},
+  {"supmult", 0x2AC2, 0x0000, false}, {"supnE", 0x2ACC, 0x0000, false},
+  {"supne", 0x228B, 0x0000, false}, {"supplus", 0x2AC0, 0x0000, false},
+  {"supset", 0x2283, 0x0000, false}, {"supseteq", 0x2287, 0x0000, false},
+  {"supseteqq", 0x2AC6, 0x0000, false}, {"supsetneq", 0x228B, 0x0000, false},
+  {"supsetneqq", 0x2ACC, 0x0000, false}, {"supsim", 0x2AC8, 0x0000, false},
+  {"supsub", 0x2AD4, 0x0000, false}, {"supsup", 0x2AD6, 0x0000, false},
+  {"swArr", 0x21D9, 0x0000, false}, {"swarhk", 0x2926, 0x0000, false},
+  {"swarr", 0x2199, 0x0000, false}, {"swarrow", 0x2199, 0x0000, false},
+  {"swnwar", 0x292A, 0x0000, false}, {"szlig", 0x00DF, 0x0000, true},
+  {"target", 0x2316, 0x0000, false}, {"tau", 0x03C4, 0x0000, false},
+  {"tbrk", 0x23B4, 0x0000, false}, {"tcaron", 0x0165, 0x0000, false},
+  {"tcedil", 0x0163, 0x0000, false}, {"tcy", 0x0442, 0x0000, false},
+  {"tdot", 0x20DB, 0x0000, false}, {"telrec", 0x2315, 0x0000, false},
+  {"tfr", 0x1D531, 0x0000, false}, {"there4", 0x2234, 0x0000, false},
+  {"therefore", 0x2234, 0x0000, false}, {"theta", 0x03B8, 0x0000, false},
+  {"thetasym", 0x03D1, 0x0000, false}, {"thetav", 0x03D1, 0x0000, false},
+  {"thickapprox", 0x2248, 0x0000, false}, {"thicksim", 0x223C, 0x0000, false},
+  {"thinsp", 0x2009, 0x0000, false}, {"thkap", 0x2248, 0x0000, false},
+  {"thksim", 0x223C, 0x0000, false}, {"thorn", 0x00FE, 0x0000, true},
+  {"tilde", 0x02DC, 0x0000, false}, {"times", 0x00D7, 0x0000, true},
+  {"timesb", 0x22A0, 0x0000, false}, {"timesbar", 0x2A31, 0x0000, false},
+  {"timesd", 0x2A30, 0x0000, false}, {"tint", 0x222D, 0x0000, false},
+  {"toea", 0x2928, 0x0000, false}, {"top", 0x22A4, 0x0000, false},
+  {"topbot", 0x2336, 0x0000, false}, {"topcir", 0x2AF1, 0x0000, false},
+  {"topf", 0x1D565, 0x0000, false}, {"topfork", 0x2ADA, 0x0000, false},
+  {"tosa", 0x2929, 0x0000, false}, {"tprime", 0x2034, 0x0000, false},
+  {"trade", 0x2122, 0x0000, false}, {"triangle", 0x25B5, 0x0000, false},
+  {"triangledown", 0x25BF, 0x0000, false},
+  {"triangleleft", 0x25C3, 0x0000, false},
+  {"trianglelefteq", 0x22B4, 0x0000, false},
+  {"triangleq", 0x225C, 0x0000, false},
+  {"triangleright", 0x25B9, 0x0000, false},
+  {"trianglerighteq", 0x22B5, 0x0000, false}, {"tridot", 0x25EC, 0x0000, false},
+  {"trie", 0x225C, 0x0000, false}, {"triminus", 0x2A3A, 0x0000, false},
+  {"triplus", 0x2A39, 0x0000, false}, {"trisb", 0x29CD, 0x0000, false},
+  {"tritime", 0x2A3B, 0x0000, false}, {"trpezium", 0x23E2, 0x0000, false},
+  {"tscr", 0x1D4C9, 0x0000, false}, {"tscy", 0x0446, 0x0000, false},
+  {"tshcy", 0x045B, 0x0000, false}, {"tstrok", 0x0167, 0x0000, false},
+  {"twixt", 0x226C, 0x0000, false}, {"twoheadleftarrow", 0x219E, 0x0000, false},
+  {"twoheadrightarrow", 0x21A0, 0x0000, false}, {"uArr", 0x21D1, 0x0000, false},
+  {"uHar", 0x2963, 0x0000, false}, {"uacute", 0x00FA, 0x0000, true},
+  {"uarr", 0x2191, 0x0000, false}, {"ubrcy", 0x045E, 0x0000, false},
+  {"ubreve", 0x016D, 0x0000, false}, {"ucirc", 0x00FB, 0x0000, true},
+  {"ucy", 0x0443, 0x0000, false}, {"udarr", 0x21C5, 0x0000, false},
+  {"udblac", 0x0171, 0x0000, false}, {"udhar", 0x296E, 0x0000, false},
+  {"ufisht", 0x297E, 0x0000, false}, {"ufr", 0x1D532, 0x0000, false},
+  {"ugrave", 0x00F9, 0x0000, true}, {"uharl", 0x21BF, 0x0000, false},
+  {"uharr", 0x21BE, 0x0000, false}, {"uhblk", 0x2580, 0x0000, false},
+  {"ulcorn", 0x231C, 0x0000, false}, {"ulcorner", 0x231C, 0x0000, false},
+  {"ulcrop", 0x230F, 0x0000, false}, {"ultri", 0x25F8, 0x0000, false},
+  {"umacr", 0x016B, 0x0000, false}, {"uml", 0x00A8, 0x0000, true},
+  {"uogon", 0x0173, 0x0000, false}, {"uopf", 0x1D566, 0x0000, false},
+  {"uparrow", 0x2191, 0x0000, false}, {"updownarrow", 0x2195, 0x0000, false},
+  {"upharpoonleft", 0x21BF, 0x0000, false},
+  {"upharpoonright", 0x21BE, 0x0000, false}, {"uplus", 0x228E, 0x0000, false},
+  {"upsi", 0x03C5, 0x0000, false}, {"upsih", 0x03D2, 0x0000, false},
+  {"upsilon", 0x03C5, 0x0000, false}, {"upuparrows", 0x21C8, 0x0000, false},
+  {"urcorn", 0x231D, 0x0000, false}, {"urcorner", 0x231D, 0x0000, false},
+  {"urcrop", 0x230E, 0x0000, false}, {"uring", 0x016F, 0x0000, false},
+  {"urtri", 0x25F9, 0x0000, false}, {"uscr", 0x1D4CA, 0x0000, false},
+  {"utdot", 0x22F0, 0x0000, false}, {"utilde", 0x0169, 0x0000, false},
+  {"utri", 0x25B5, 0x0000, false}, {"utrif", 0x25B4, 0x0000, false},
+  {"uuarr", 0x21C8, 0x0000, false}, {"uuml", 0x00FC, 0x0000, true},
+  {"uwangle", 0x29A7, 0x0000, false}, {"vArr", 0x21D5, 0x0000, false},
+  {"vBar", 0x2AE8, 0x0000, false}, {"vBarv", 0x2AE9, 0x0000, false},
+  {"vDash", 0x22A8, 0x0000, false}, {"vangrt", 0x299C, 0x0000, false},
+  {"varepsilon", 0x03F5, 0x0000, false}, {"varkappa", 0x03F0, 0x0000, false},
+  {"varnothing", 0x2205, 0x0000, false}, {"varphi", 0x03D5, 0x0000, false},
+  {"varpi", 0x03D6, 0x0000, false}, {"varpropto", 0x221D, 0x0000, false},
+  {"varr", 0x2195, 0x0000, false}, {"varrho", 0x03F1, 0x0000, false},
+  {"varsigma", 0x03C2, 0x0000, false}, {"varsubsetneq", 0x228A, 0xFE00, false},
+  {"varsubsetneqq", 0x2ACB, 0xFE00, false},
+  {"varsupsetneq", 0x228B, 0xFE00, false},
+  {"varsupsetneqq", 0x2ACC, 0xFE00, false}, {"vartheta", 0x03D1, 0x0000, false},
+  {"vartriangleleft", 0x22B2, 0x0000, false},
+  {"vartriangleright", 0x22B3, 0x0000, false}, {"vcy", 0x0432, 0x0000, false},
+  {"vdash", 0x22A2, 0x0000, false}, {"vee", 0x2228, 0x0000, false},
+  {"veebar", 0x22BB, 0x0000, false}, {"veeeq", 0x225A, 0x0000, false},
+  {"vellip", 0x22EE, 0x0000, false}, {"verbar", 0x007C, 0x0000, false},
+  {"vert", 0x007C, 0x0000, false}, {"vfr", 0x1D533, 0x0000, false},
+  {"vltri", 0x22B2, 0x0000, false}, {"vnsub", 0x2282, 0x20D2, false},
+  {"vnsup", 0x2283, 0x20D2, false}, {"vopf", 0x1D567, 0x0000, false},
+  {"vprop", 0x221D, 0x0000, false}, {"vrtri", 0x22B3, 0x0000, false},
+  {"vscr", 0x1D4CB, 0x0000, false}, {"vsubnE", 0x2ACB, 0xFE00, false},
+  {"vsubne", 0x228A, 0xFE00, false}, {"vsupnE", 0x2ACC, 0xFE00, false},
+  {"vsupne", 0x228B, 0xFE00, false}, {"vzigzag", 0x299A, 0x0000, false},
+  {"wcirc", 0x0175, 0x0000, false}, {"wedbar", 0x2A5F, 0x0000, false},
+  {"wedge", 0x2227, 0x0000, false}, {"wedgeq", 0x2259, 0x0000, false},
+  {"weierp", 0x2118, 0x0000, false}, {"wfr", 0x1D534, 0x0000, false},
+  {"wopf", 0x1D568, 0x0000, false}, {"wp", 0x2118, 0x0000, false},
+  {"wr", 0x2240, 0x0000, false}, {"wreath", 0x2240, 0x0000, false},
+  {"wscr", 0x1D4CC, 0x0000, false}, {"xcap", 0x22C2, 0x0000, false},
+  {"xcirc", 0x25EF, 0x0000, false}, {"xcup", 0x22C3, 0x0000, false},
+  {"xdtri", 0x25BD, 0x0000, false}, {"xfr", 0x1D535, 0x0000, false},
+  {"xhArr", 0x27FA, 0x0000, false}, {"xharr", 0x27F7, 0x0000, false},
+  {"xi", 0x03BE, 0x0000, false}, {"xlArr", 0x27F8, 0x0000, false},
+  {"xlarr", 0x27F5, 0x0000, false}, {"xmap", 0x27FC, 0x0000, false},
+  {"xnis", 0x22FB, 0x0000, false}, {"xodot", 0x2A00, 0x0000, false},
+  {"xopf", 0x1D569, 0x0000, false}, {"xoplus", 0x2A01, 0x0000, false},
+  {"xotime", 0x2A02, 0x0000, false}, {"xrArr", 0x27F9, 0x0000, false},
+  {"xrarr", 0x27F6, 0x0000, false}, {"xscr", 0x1D4CD, 0x0000, false},
+  {"xsqcup", 0x2A06, 0x0000, false}, {"xuplus", 0x2A04, 0x0000, false},
+  {"xutri", 0x25B3, 0x0000, false}, {"xvee", 0x22C1, 0x0000, false},
+  {"xwedge", 0x22C0, 0x0000, false}, {"yacute", 0x00FD, 0x0000, true},
+  {"yacy", 0x044F, 0x0000, false}, {"ycirc", 0x0177, 0x0000, false},
+  {"ycy", 0x044B, 0x0000, false}, {"yen", 0x00A5, 0x0000, true},
+  {"yfr", 0x1D536, 0x0000, false}, {"yicy", 0x0457, 0x0000, false},
+  {"yopf", 0x1D56A, 0x0000, false}, {"yscr", 0x1D4CE, 0x0000, false},
+  {"yucy", 0x044E, 0x0000, false}, {"yuml", 0x00FF, 0x0000, true},
+  {"zacute", 0x017A, 0x0000, false}, {"zcaron", 0x017E, 0x0000, false},
+  {"zcy", 0x0437, 0x0000, false}, {"zdot", 0x017C, 0x0000, false},
+  {"zeetrf", 0x2128, 0x0000, false}, {"zeta", 0x03B6, 0x0000, false},
+  {"zfr", 0x1D537, 0x0000, false}, {"zhcy", 0x0436, 0x0000, false},
+  {"zigrarr", 0x21DD, 0x0000, false}, {"zopf", 0x1D56B, 0x0000, false},
+  {"zscr", 0x1D4CF, 0x0000, false}, {"zwj", 0x200D, 0x0000, false},
+  {"zwnj", 0x200C, 0x0000, false},
+};
+
+#define ENTITY_COUNT (int)(sizeof(namedEntities) / sizeof(namedEntities[0]))
+
+// Perfect hash ----------------------------------------------------------------
+//
+// Hash and displace: a name's hash picks a bucket, and every bucket has a
+// seed that sends each of its names to a slot of its own. The seeds are
+// searched for while compiling, so a lookup is two hashes, one table probe
+// and a single compare against the one candidate.
+
+#define ENTITY_BUCKETS (ENTITY_COUNT / 4)
+#define ENTITY_SLOTS (ENTITY_COUNT + ENTITY_COUNT / 4)
+#define ENTITY_EMPTY 0xFFFF
+#define ENTITY_MAX_BUCKET 32 // Bucket sizes the seed search can handle
+
+static constexpr uint32_t HashName(const char *s, int len) {
+  uint32_t h = 2166136261u; // FNV-1a
+  for (int i = 0; i < len; i++)
+    h = (h ^ (uint8_t)s[i]) * 16777619u;
+  return h;
+}
+
+static constexpr uint32_t SlotOf(uint32_t h, uint32_t seed) {
+  h ^= seed * 0x9E3779B9u;
+  h ^= h >> 16; // Murmur3 finalizer
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h % ENTITY_SLOTS;
+}
+
+static constexpr int NameLength(const char *s) {
+  int n = 0;
+  while (s[n])
+    n++;
+  return n;
+}
+
+struct PerfectHash {
+  uint16_t seeds[ENTITY_BUCKETS];
+  uint16_t slots[ENTITY_SLOTS]; // namedEntities index, or ENTITY_EMPTY
+  bool complete;
+};
+
+static constexpr PerfectHash BuildPerfectHash() {
+  PerfectHash t{};
+  uint32_t hashes[ENTITY_COUNT] = {};
+  int bucketSize[ENTITY_BUCKETS] = {};
+  int maxSize = 0;
+  for (int i = 0; i < ENTITY_COUNT; i++) {
+    const char *name = namedEntities[i].name;
+    hashes[i] = HashName(name, NameLength(name));
+    int size = ++bucketSize[hashes[i] % ENTITY_BUCKETS];
+    if (size > maxSize)
+      maxSize = size;
+  }
+
+  // Members of each bucket, stored contiguously
+  int start[ENTITY_BUCKETS + 1] = {};
+  for (int b = 0; b < ENTITY_BUCKETS; b++)
+    start[b + 1] = start[b] + bucketSize[b];
+  int members[ENTITY_COUNT] = {};
+  int filled[ENTITY_BUCKETS] = {};
+  for (int i = 0; i < ENTITY_COUNT; i++) {
+    int b = hashes[i] % ENTITY_BUCKETS;
+    members[start[b] + filled[b]++] = i;
+  }
+
+  for (int s = 0; s < ENTITY_SLOTS; s++)
+    t.slots[s] = ENTITY_EMPTY;
+  t.complete = maxSize <= ENTITY_MAX_BUCKET;
+
+  // Biggest buckets first, while most slots are still free
+  for (int size = maxSize; size > 0 && t.complete; size--) {
+    for (int b = 0; b < ENTITY_BUCKETS && t.complete; b++) {
+      if (bucketSize[b] != size)
+        continue;
+      bool placed = false;
+      for (uint32_t seed = 0; seed < 0x10000 && !placed; seed++) {
+        uint32_t slot[ENTITY_MAX_BUCKET] = {};
+        placed = true;
+        for (int k = 0; k < size && placed; k++) {
+          slot[k] = SlotOf(hashes[members[start[b] + k]], seed);
+          if (t.slots[slot[k]] != ENTITY_EMPTY)
+            placed = false;
+          for (int j = 0; j < k; j++) {
+            if (slot[j] == slot[k])
+              placed = false;
+          }
+        }
+        if (placed) {
+          t.seeds[b] = (uint16_t)seed;
+          for (int k = 0; k < size; k++)
+            t.slots[slot[k]] = (uint16_t)members[start[b] + k];
+        }
+      }
+      t.complete = placed;
+    }
+  }
+  return t;
+}
+
+static constexpr PerfectHash perfectHash = BuildPerfectHash();
+static_assert(perfectHash.complete, "entity hash seed search failed");
+static_assert(ENTITY_COUNT < ENTITY_EMPTY, "entity index no longer fits");
+
+int LookupNamedEntity(const char *name, int len, uint32_t *cps, bool *legacy) {
+  if (len <= 0 || len >= ENTITY_MAX_NAME)
+    return 0;
+  uint32_t h = HashName(name, len);
+  uint16_t index =
+      perfectHash.slots[SlotOf(h, perfectHash.seeds[h % ENTITY_BUCKETS])];
+  if (index == ENTITY_EMPTY)
+    return 0;
+
+  const NamedEntity &e = namedEntities[index];
+  if (strncmp(e.name, name, len) != 0 || e.name[len] != '\0')
+    return 0;
+  cps[0] = e.cp;
+  *legacy = e.legacy;
+  if (e.cp2 == 0)
+    return 1;
+  cps[1] = e.cp2;
+  return 2;
+}
+
+// Numeric references ----------------------------------------------------------
+
+// What windows-1252 puts at 0x80-0x9F; old converters wrote &#151; and the
+// like for these
+static const uint16_t windows1252[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178};
+
+uint32_t ResolveNumericEntity(uint32_t value) {
+  if (value >= 0x80 && value <= 0x9F)
+    return windows1252[value - 0x80];
+  if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF))
+    return 0xFFFD;
+  return value;
+}
@@ -1,136 +1,1055 @@
 #include "html_text_extractor.h"
+#include "byte_scan.h"
 #include "debug_logger.h"
 #include <cctype>
 #include <cstring>
 #include <strings.h>
 
-HtmlTextExtractor::HtmlTextExtractor() {}
+HtmlTextExtractor::HtmlTextExtractor()
+    : wordOffsets(nullptr), flags(nullptr), wordLens(nullptr), maxWords(0),
+      runs(nullptr), maxRuns(0), runCount(0), runStale(true), wordLimit(0),
+      wordBuffer(nullptr), bufferSize(0), wordCount(0), bufferPos(0),
+      inPlace(false), overflowed(false), wordOut(state.currentWord),
+      entitySrc(nullptr), styles(nullptr), tokens(nullptr),
+      wordTokens(nullptr), anchors(nullptr), wordBase(0), attrsRead(0) {}
 
 HtmlTextExtractor::~HtmlTextExtractor() {}
 
+// Where ScanAttributes() is within a tag
+enum {
+  ATTR_SPACE,       // Between attributes
+  ATTR_NAME,        // In an attribute name
+  ATTR_AFTER_NAME,  // Space after a name: '=' or the next attribute follows
+  ATTR_VALUE_START, // After '='
+  ATTR_VALUE
+};
+
+// Attributes it reads, as bits of ParseState::attrNames and attrKind. Names
+// are matched as they stream past, dropping each candidate on a mismatch.
+enum {
+  ATTR_IS_CLASS = 0x01,
+  ATTR_IS_ID = 0x02,
+  ATTR_IS_NAME = 0x04, // <a name="...">: anchors in older books
+  ATTR_IS_HREF = 0x08
+};
+static const char *const attrNames[] = {"class", "id", "name", "href"};
+#define ATTR_NAME_COUNT 4
+
 bool HtmlTextExtractor::IsWhitespace(char c) {
   return (c == ' ' || c == '\t' || c == '\n' || c == '\r');
 }
 
-int HtmlTextExtractor::ExtractWords(const char *html, char **words,
-                                    TextStyle *styles, int *wordLens,
-                                    int maxWords, char *wordBuffer,
-                                    int bufferSize) {
-  if (!html || !words || !styles || !wordLens || maxWords == 0 || !wordBuffer ||
-      bufferSize == 0)
+int HtmlTextExtractor::ExtractWords(const char *html, uint32_t *wordOffsets,
+                                    uint8_t *flags, uint8_t *wordLens,
+                                    int maxWords, StyleRun *runs, int maxRuns,
+                                    char *wordBuffer, int bufferSize) {
+  if (!html)
     return 0;
 
-  int wordCount = 0;
-  int bufferPos = 0;
-  bool inTag = false;
-  bool inScript = false;
-  bool inStyle = false;
-  TextStyle currentStyle = TextStyle::NORMAL;
-
-  char currentWord[256];
-  int currentWordLen = 0;
-
-  auto commitWord = [&]() {
-    if (currentWordLen > 0 && wordCount < maxWords) {
-      currentWord[currentWordLen] = '\0';
-      if (bufferPos + currentWordLen + 1 < bufferSize) {
-        strcpy(wordBuffer + bufferPos, currentWord);
-        words[wordCount] = wordBuffer + bufferPos;
-        styles[wordCount] = currentStyle;
-        wordLens[wordCount] = currentWordLen;
-        wordCount++;
-        bufferPos += currentWordLen + 1;
+  Begin(wordOffsets, flags, wordLens, maxWords, runs, maxRuns, wordBuffer,
+        bufferSize);
+  Feed(html, (int)strlen(html));
+  return Finish();
+}
+
+void HtmlTextExtractor::Begin(uint32_t *wordOffsets, uint8_t *flags,
+                              uint8_t *wordLens, int maxWords, StyleRun *runs,
+                              int maxRuns, char *wordBuffer, int bufferSize,
+                              bool inPlace) {
+  this->wordOffsets = wordOffsets;
+  this->flags = flags;
+  this->wordLens = wordLens;
+  this->maxWords = maxWords;
+  this->runs = runs;
+  this->maxRuns = maxRuns;
+  runCount = 0;
+  runStale = true;
+  wordLimit = maxWords;
+  this->wordBuffer = wordBuffer;
+  this->bufferSize = bufferSize;
+  wordCount = 0;
+  bufferPos = 0;
+  wordBase = 0;
+  this->inPlace = inPlace;
+  overflowed = false;
+  wordOut = state.currentWord;
+  entitySrc = nullptr;
+
+  state.inTag = false;
+  state.inScript = false;
+  state.inStyle = false;
+  state.readingTagName = false;
+  state.closingTag = false;
+  state.tagName[0] = '\0';
+  state.tagNameLen = 0;
+  state.currentStyle = TextStyle::NORMAL;
+  state.currentWordLen = 0;
+  state.wordGlued = false;
+  state.pendingSpace = false;
+  state.lastClass = LB_COUNT;
+  state.utf8.Reset();
+  state.inEntity = false;
+  state.entityLen = 0;
+  state.inlineDepth = 0;
+  state.emphasis = 0;
+  state.wordEmphasis = 0;
+  state.tagHash = CSS_HASH_INIT;
+  state.attrState = ATTR_SPACE;
+  state.attrMatch = -1;
+  state.attrNames = 0;
+  state.attrKind = 0;
+  state.attrQuote = 0;
+  state.tagSlash = false;
+  state.valueHash = CSS_HASH_INIT;
+  state.valueLen = 0;
+  state.classCount = 0;
+  state.elementId = 0;
+  state.hrefLen = 0;
+  state.inLink = false;
+  state.styledDepth = 0;
+  state.hiddenDepth = 0;
+}
+
+void HtmlTextExtractor::SetTokens(TokenTable *tokens, uint16_t *wordTokens) {
+  this->tokens = wordTokens ? tokens : nullptr;
+  this->wordTokens = wordTokens;
+}
+
+void HtmlTextExtractor::SetStyles(const CssRuleTable *styles) {
+  this->styles = styles && !styles->IsEmpty() ? styles : nullptr;
+  attrsRead = (this->styles ? ATTR_IS_CLASS : 0) |
+              (anchors ? ATTR_IS_ID | ATTR_IS_NAME | ATTR_IS_HREF : 0);
+}
+
+void HtmlTextExtractor::SetAnchors(AnchorIndex *anchors) {
+  this->anchors = anchors;
+  SetStyles(styles);
+}
+
+// Starts a run at the word about to be stored
+void HtmlTextExtractor::OpenRun(uint8_t style, uint8_t emphasis) {
+  if (runCount == maxRuns)
+    return; // IsFull() normally stops short of this; join the last run
+  StyleRun &run = runs[runCount++];
+  run.start = wordCount;
+  run.style = style;
+  run.emphasis = emphasis;
+  if (runCount + 2 >= maxRuns)
+    wordLimit = wordCount; // Pause until Discard() frees some runs
+}
+
+// Slow path of CommitWord() after a style or emphasis change: the word may
+// need a new run, and so may the one after it
+void HtmlTextExtractor::SyncRun() {
+  uint8_t style = (uint8_t)state.currentStyle;
+  if (runCount == 0 || runs[runCount - 1].style != style ||
+      runs[runCount - 1].emphasis != state.wordEmphasis)
+    OpenRun(style, state.wordEmphasis);
+  runStale = state.wordEmphasis != state.emphasis;
+  state.wordEmphasis = state.emphasis;
+}
+
+void HtmlTextExtractor::CommitWord() {
+  int len = state.currentWordLen;
+  if (len > 0 && wordCount < maxWords) {
+    if (inPlace || bufferPos + len < bufferSize) {
+      if (runStale)
+        SyncRun(); // Otherwise the word just extends the last run
+      int offset = (int)(wordOut - wordBuffer); // In place it's already there
+      if (!inPlace) {
+        offset = bufferPos;
+        char *dest = wordBuffer + bufferPos;
+        if (len < 8 && bufferPos + 8 <= bufferSize)
+          memcpy(dest, state.currentWord, 8); // Short words (CJK): one move
+        else
+          memcpy(dest, state.currentWord, len);
+        bufferPos += len;
+      }
+      wordOffsets[wordCount] = (uint32_t)offset;
+      flags[wordCount] = state.wordGlued ? WORD_GLUED : 0;
+      wordLens[wordCount] = (uint8_t)len;
+      if (tokens) {
+        const StyleRun &run = runs[runCount - 1]; // The word's own
+        wordTokens[wordCount] = tokens->Intern(wordBuffer + offset, len,
+                                               run.style, run.emphasis);
       }
-      currentWordLen = 0;
-    }
-  };
-
-  auto pushNewline = [&]() {
-    if (wordCount < maxWords && bufferPos + 2 < bufferSize) {
-      strcpy(wordBuffer + bufferPos, "\n");
-      words[wordCount] = wordBuffer + bufferPos;
-      styles[wordCount] = TextStyle::NORMAL; // Newlines are style-neutral
-      wordLens[wordCount] = 1;
       wordCount++;
-      bufferPos += 2;
     }
-  };
+    state.currentWordLen = 0;
+  }
+}
 
-  for (int i = 0; html[i] && wordCount < maxWords; i++) {
-    char c = html[i];
+void HtmlTextExtractor::PushNewline() {
+  CommitWord();
+  state.wordGlued = false;
+  state.pendingSpace = false;
+  state.lastClass = LB_COUNT;
 
-    if (c == '<') {
-      commitWord();
-      inTag = true;
-
-      const char *t = &html[i + 1];
-      if (*t == '/') {
-        // Closing tags
-        t++;
-        if (t[0] == 'h' || t[0] == 'H') {
-          if (t[1] >= '1' && t[1] <= '3') {
-            currentStyle = TextStyle::NORMAL;
-            pushNewline();
-          }
-        } else if (strncasecmp(t, "script", 6) == 0) {
-          inScript = false;
-        } else if (strncasecmp(t, "style", 5) == 0) {
-          inStyle = false;
+  if (wordCount < maxWords) {
+    // Newlines are style-neutral: they join whatever run precedes them
+    if (runCount == 0)
+      OpenRun((uint8_t)TextStyle::NORMAL, 0);
+    wordOffsets[wordCount] = bufferPos;
+    flags[wordCount] = WORD_NEWLINE;
+    wordLens[wordCount] = 0;
+    if (tokens)
+      wordTokens[wordCount] = TOKEN_NONE;
+    wordCount++;
+  }
+}
+
+// Phrasing elements that don't separate the text around them, so
+// "<em>word</em>," stays one word. Any other tag counts as whitespace.
+static bool IsInlineTag(const char *name) {
+  switch (name[0]) {
+  case 'a':
+    return name[1] == '\0' || strcmp(name, "abbr") == 0;
+  case 'b':
+    return name[1] == '\0' || strcmp(name, "bdi") == 0 ||
+           strcmp(name, "bdo") == 0;
+  case 'c':
+    return strcmp(name, "cite") == 0 || strcmp(name, "code") == 0;
+  case 'd':
+    return strcmp(name, "dfn") == 0;
+  case 'e':
+    return strcmp(name, "em") == 0;
+  case 'f':
+    return strcmp(name, "font") == 0;
+  case 'i':
+  case 'q':
+  case 'u':
+    return name[1] == '\0';
+  case 'k':
+    return strcmp(name, "kbd") == 0;
+  case 'm':
+    return strcmp(name, "mark") == 0;
+  case 's':
+    return name[1] == '\0' || strcmp(name, "span") == 0 ||
+           strcmp(name, "strong") == 0 || strcmp(name, "small") == 0 ||
+           strcmp(name, "sub") == 0 || strcmp(name, "sup") == 0 ||
+           strcmp(name, "samp") == 0;
+  case 't':
+    return strcmp(name, "time") == 0 || strcmp(name, "tt") == 0;
+  case 'v':
+    return strcmp(name, "var") == 0;
+  }
+  return false;
+}
+
+// Emphasis an inline element adds, if any
+static uint8_t EmphasisOf(const char *name) {
+  if (strcmp(name, "b") == 0 || strcmp(name, "strong") == 0)
+    return TEXT_BOLD;
+  if (strcmp(name, "i") == 0 || strcmp(name, "em") == 0 ||
+      strcmp(name, "cite") == 0 || strcmp(name, "dfn") == 0 ||
+      strcmp(name, "var") == 0)
+    return TEXT_ITALIC;
+  return 0;
+}
+
+void HtmlTextExtractor::PushEmphasis(uint8_t bits) {
+  if (state.inlineDepth < INLINE_STACK_DEPTH)
+    state.inlineStack[state.inlineDepth++] = bits;
+  state.emphasis |= bits;
+  if (state.currentWordLen == 0)
+    state.wordEmphasis = state.emphasis;
+  runStale = true;
+}
+
+// Closes the innermost open element with this emphasis, so misnested
+// "<b><i>x</b>y</i>" still leaves y italic
+void HtmlTextExtractor::PopEmphasis(uint8_t bits) {
+  int i = state.inlineDepth - 1;
+  while (i >= 0 && state.inlineStack[i] != bits)
+    i--;
+  if (i < 0)
+    return; // Stray end tag
+  state.inlineDepth--;
+  for (; i < state.inlineDepth; i++)
+    state.inlineStack[i] = state.inlineStack[i + 1];
+  UpdateEmphasis();
+}
+
+// Emphasis after an element closed: the union of what is still open
+void HtmlTextExtractor::UpdateEmphasis() {
+  state.emphasis = 0;
+  for (int i = 0; i < state.inlineDepth; i++)
+    state.emphasis |= state.inlineStack[i];
+  for (int i = 0; i < state.styledDepth; i++)
+    state.emphasis |= state.styled[i].emphasis;
+  if (state.currentWordLen == 0)
+    state.wordEmphasis = state.emphasis;
+  runStale = true;
+}
+
+// Attribute bytes up to the next tag delimiter, read only when there are CSS
+// rules to match the element's classes against or anchors to record.
+// Returns the bytes consumed.
+int HtmlTextExtractor::ScanAttributes(const char *data, int len) {
+  int i = 0;
+  for (; i < len; i++) {
+    char c = data[i];
+    if (c == '<' || c == '>')
+      break;
+    bool space = IsWhitespace(c);
+    state.tagSlash = c == '/';
+    switch (state.attrState) {
+    case ATTR_AFTER_NAME:
+      if (c == '=') {
+        state.attrState = ATTR_VALUE_START;
+        break;
+      }
+      if (space)
+        break;
+      state.attrState = ATTR_SPACE; // Valueless attribute; c starts the next
+      // Fall through
+    case ATTR_SPACE:
+      if (space || c == '/')
+        break;
+      state.attrState = ATTR_NAME;
+      state.attrMatch = 0;
+      state.attrNames = attrsRead;
+      // Fall through
+    case ATTR_NAME:
+      if (c == '=' || space) {
+        state.attrKind = 0;
+        for (int k = 0; k < ATTR_NAME_COUNT; k++) {
+          if ((state.attrNames >> k & 1) &&
+              attrNames[k][(int)state.attrMatch] == '\0')
+            state.attrKind = (uint8_t)(1 << k);
         }
-      } else {
-        // Opening tags
-        if (t[0] == 'h' || t[0] == 'H') {
-          if (t[1] == '1') {
-            currentStyle = TextStyle::H1;
-            pushNewline();
-          } else if (t[1] == '2') {
-            currentStyle = TextStyle::H2;
-            pushNewline();
-          } else if (t[1] == '3') {
-            currentStyle = TextStyle::H3;
-            pushNewline();
-          }
-        } else if (t[0] == 'p' || t[0] == 'P' ||
-                   (t[0] == 'b' && (t[1] == 'r' || t[1] == 'R')) ||
-                   (t[0] == 'd' && (t[1] == 'i' || t[1] == 'I'))) {
-          // Basic check for p, br, div
-          pushNewline();
-        } else if (strncasecmp(t, "script", 6) == 0) {
-          inScript = true;
-        } else if (strncasecmp(t, "style", 5) == 0) {
-          inStyle = true;
+        // name and href only mean something on <a>
+        if ((state.attrKind & (ATTR_IS_NAME | ATTR_IS_HREF)) &&
+            !(state.tagNameLen == 1 && state.tagName[0] == 'a'))
+          state.attrKind = 0;
+        state.attrState = c == '=' ? ATTR_VALUE_START : ATTR_AFTER_NAME;
+      } else if (state.attrNames) {
+        int at = state.attrMatch;
+        char lower = (char)(c | 0x20);
+        for (int k = 0; k < ATTR_NAME_COUNT; k++) {
+          if ((state.attrNames >> k & 1) && attrNames[k][at] != lower)
+            state.attrNames &= ~(1 << k); // (Stops at its terminator too)
         }
+        state.attrMatch = (int8_t)(at + 1);
       }
-    } else if (c == '>') {
-      inTag = false;
-    } else if (!inTag && !inScript && !inStyle) {
-      unsigned char uc = (unsigned char)c;
-      // Check for CJK start byte (roughly 0xE0 - 0xEF for common CJK)
-      if (uc >= 0xE0 && uc <= 0xEF) {
-        // Commit pending word first
-        commitWord();
-
-        // Capture the 3-byte char as a standalone "word"
-        if (html[i + 1] && html[i + 2]) {
-          currentWord[0] = c;
-          currentWord[1] = html[i + 1];
-          currentWord[2] = html[i + 2];
-          currentWordLen = 3;
-          commitWord(); // Commit this character immediately
-          i += 2;       // Skip next 2 bytes (loop adds 1 more)
+      break;
+    case ATTR_VALUE_START:
+      if (space)
+        break;
+      state.attrState = ATTR_VALUE;
+      state.attrQuote = c == '"' || c == '\'' ? c : 0;
+      state.valueHash = CSS_HASH_INIT;
+      state.valueLen = 0;
+      if (state.attrKind == ATTR_IS_HREF)
+        state.hrefLen = 0;
+      if (state.attrQuote)
+        break;
+      // Fall through: the first byte of an unquoted value
+    case ATTR_VALUE:
+      if (state.attrQuote ? c == state.attrQuote : space) {
+        EndAttribute();
+        state.attrState = ATTR_SPACE;
+      } else if (state.attrKind == ATTR_IS_CLASS && space) {
+        EndClassName();
+      } else if (state.attrKind == ATTR_IS_HREF) {
+        if (state.hrefLen >= 0 && state.hrefLen < LINK_HREF_MAX - 1)
+          state.href[state.hrefLen++] = c;
+        else
+          state.hrefLen = -1;
+      } else if (state.attrKind) {
+        state.valueHash = CssHashStep(state.valueHash, c);
+        state.valueLen++;
+      }
+      break;
+    }
+  }
+  return i;
+}
+
+void HtmlTextExtractor::EndClassName() {
+  if (state.valueLen > 0 && state.classCount < CSS_MAX_CLASSES)
+    state.classes[state.classCount++] = CssHashEnd(state.valueHash);
+  state.valueHash = CSS_HASH_INIT;
+  state.valueLen = 0;
+}
+
+// End of an attribute value
+void HtmlTextExtractor::EndAttribute() {
+  if (state.attrKind == ATTR_IS_CLASS)
+    EndClassName();
+  else if ((state.attrKind & (ATTR_IS_ID | ATTR_IS_NAME)) && state.valueLen)
+    state.elementId = CssHashEnd(state.valueHash);
+  state.attrKind = 0;
+}
+
+// '>' of a start tag
+void HtmlTextExtractor::OpenElement() {
+  if (state.attrState == ATTR_VALUE)
+    EndAttribute(); // Unquoted value cut off by the '>'
+  if (anchors) {
+    // The element's first word is the next one stored, or the one in
+    // progress if it started before an inline tag
+    if (state.elementId)
+      anchors->AddAnchor(state.elementId, wordBase + wordCount);
+    if (state.hrefLen > 0 && !state.tagSlash)
+      OpenLink();
+  }
+  if (styles)
+    OpenStyledElement();
+}
+
+void HtmlTextExtractor::OpenLink() {
+  if (state.inLink)
+    CloseLink(); // <a> doesn't nest; an unclosed one ends here
+  state.href[state.hrefLen] = '\0';
+  state.linkSpine = anchors->Resolve(state.href, &state.linkAnchor);
+  state.inLink = state.linkSpine >= 0;
+  state.linkStart = wordBase + wordCount;
+}
+
+// </a>: the link covers the words since OpenLink(), including one still
+// being read (its end may be glued to what follows)
+void HtmlTextExtractor::CloseLink() {
+  int end = wordBase + wordCount + (state.currentWordLen > 0 ? 1 : 0);
+  anchors->AddLink(state.linkStart, end, state.linkSpine, state.linkAnchor);
+  state.inLink = false;
+}
+
+// '>' of a start tag: the element goes on the styled stack if the rules do
+// anything to it, or if it could otherwise close an outer one of its name
+void HtmlTextExtractor::OpenStyledElement() {
+  if (state.tagSlash || state.inScript || state.inStyle)
+    return; // <span class="x"/> holds nothing
+  // (HandleTagName() terminated any name that fits)
+  bool named = state.tagNameLen < (int)sizeof(state.tagName);
+  if (named && (strcmp(state.tagName, "html") == 0 ||
+                strcmp(state.tagName, "body") == 0))
+    return; // Would restyle the whole chapter
+
+  uint32_t tag = CssHashEnd(state.tagHash);
+  CssRule rule;
+  if (!styles->Match(tag, state.classes, state.classCount, &rule)) {
+    int i = state.styledDepth - 1;
+    while (i >= 0 && state.styled[i].tagHash != tag)
+      i--;
+    if (i < 0)
+      return;
+  }
+  if (state.styledDepth == STYLED_STACK_DEPTH)
+    return;
+
+  StyledElement &element = state.styled[state.styledDepth++];
+  element.tagHash = tag;
+  element.emphasis = rule.emphasis;
+  element.hidden = rule.hidden;
+  element.restyled = false;
+  element.prevStyle = (uint8_t)state.currentStyle;
+  if (element.hidden) {
+    state.hiddenDepth++;
+  } else if (rule.style != (uint8_t)TextStyle::NORMAL &&
+             state.currentStyle == TextStyle::NORMAL &&
+             !(named && IsInlineTag(state.tagName))) {
+    // Body text styled as a heading: "<p class="title">". Real headings
+    // keep the reader's own sizes.
+    PushNewline();
+    state.currentStyle = (TextStyle)rule.style;
+    element.restyled = true;
+    runStale = true;
+  }
+  if (element.emphasis)
+    UpdateEmphasis();
+}
+
+// End tag: pops the innermost open element of that name
+void HtmlTextExtractor::CloseStyledElement() {
+  uint32_t tag = CssHashEnd(state.tagHash);
+  int i = state.styledDepth - 1;
+  while (i >= 0 && state.styled[i].tagHash != tag)
+    i--;
+  if (i < 0)
+    return;
+  StyledElement element = state.styled[i];
+  state.styledDepth--;
+  for (; i < state.styledDepth; i++)
+    state.styled[i] = state.styled[i + 1];
+
+  if (element.hidden)
+    state.hiddenDepth--;
+  if (element.restyled) {
+    PushNewline();
+    state.currentStyle = (TextStyle)element.prevStyle;
+    runStale = true;
+  }
+  if (element.emphasis)
+    UpdateEmphasis();
+}
+
+void HtmlTextExtractor::HandleTagName() {
+  if (styles && state.closingTag)
+    CloseStyledElement();
+  if (state.inLink && state.closingTag && state.tagNameLen == 1 &&
+      state.tagName[0] == 'a')
+    CloseLink();
+
+  // Names longer than the buffer can't match anything we care about
+  if (state.tagNameLen == 0 ||
+      state.tagNameLen >= (int)sizeof(state.tagName)) {
+    state.pendingSpace = state.lastClass != LB_COUNT;
+    return;
+  }
+  state.tagName[state.tagNameLen] = '\0';
+
+  if (IsInlineTag(state.tagName)) {
+    uint8_t bits = EmphasisOf(state.tagName);
+    if (bits && state.closingTag)
+      PopEmphasis(bits);
+    else if (bits)
+      PushEmphasis(bits);
+    return; // Nothing below applies to these either
+  }
+  if (strcmp(state.tagName, "wbr") == 0) {
+    // Explicit break opportunity, no space
+    state.lastClass = LB_ZW;
+    return;
+  }
+  state.pendingSpace = state.lastClass != LB_COUNT;
+
+  bool isHeading = state.tagName[0] == 'h' && state.tagName[1] >= '1' &&
+                   state.tagName[1] <= '3' && state.tagName[2] == '\0';
+
+  if (state.closingTag) {
+    if (isHeading) {
+      PushNewline(); // Commits the heading's last word first
+      state.currentStyle = TextStyle::NORMAL;
+      runStale = true;
+    } else if (strcmp(state.tagName, "script") == 0) {
+      state.inScript = false;
+    } else if (strcmp(state.tagName, "style") == 0) {
+      state.inStyle = false;
+    }
+    return;
+  }
+
+  if (isHeading) {
+    PushNewline();
+    if (state.tagName[1] == '1')
+      state.currentStyle = TextStyle::H1;
+    else if (state.tagName[1] == '2')
+      state.currentStyle = TextStyle::H2;
+    else
+      state.currentStyle = TextStyle::H3;
+    runStale = true;
+  } else if (strcmp(state.tagName, "p") == 0 ||
+             strcmp(state.tagName, "br") == 0 ||
+             strcmp(state.tagName, "div") == 0) {
+    PushNewline();
+  } else if (strcmp(state.tagName, "script") == 0) {
+    state.inScript = true;
+  } else if (strcmp(state.tagName, "style") == 0) {
+    state.inStyle = true;
+  }
+}
+
+// Characters that only carry a break property: ZWSP, soft hyphen, word
+// joiners and the BOM are classified but never stored
+static bool IsInvisible(uint32_t cp) {
+  return cp == 0x200B || cp == 0x00AD || cp == 0x2060 || cp == 0xFEFF;
+}
+
+// bytes is the character's UTF-8 encoding, len its length. In place,
+// [src, srcEnd) is the text it was decoded from.
+void HtmlTextExtractor::PushCodepoint(uint32_t cp, LineBreakClass cls,
+                                      const char *bytes, int len,
+                                      const char *src, const char *srcEnd) {
+  if (cls == LB_SP) {
+    state.pendingSpace = state.lastClass != LB_COUNT;
+    return;
+  }
+
+  if ((cls == LB_CM || cls == LB_ZWJ) && state.lastClass != LB_COUNT &&
+      !state.pendingSpace) {
+    // LB9: marks take on the class of their base and never break from it.
+    // (LB10: after a space or at a line start they act as AL.)
+    cls = (LineBreakClass)state.lastClass;
+  } else {
+    if (cls == LB_CM || cls == LB_ZWJ)
+      cls = LB_AL;
+    if (state.lastClass != LB_COUNT) {
+      LineBreakAction action =
+          GetLineBreakAction((LineBreakClass)state.lastClass, cls);
+      if (state.pendingSpace) {
+        if (action == LB_BREAK_PROHIBITED && state.currentWordLen > 0 &&
+            state.currentWordLen + 1 + len < (int)sizeof(state.currentWord)) {
+          // "mot !", "« word": the space stays inside the word
+          wordOut[state.currentWordLen++] = ' ';
+        } else {
+          CommitWord();
+          state.wordGlued = false;
         }
-      } else if (IsWhitespace(c)) {
-        commitWord();
-      } else if (currentWordLen < 255) {
-        currentWord[currentWordLen++] = c;
+      } else if (action == LB_BREAK_DIRECT) {
+        CommitWord();
+        state.wordGlued = true;
       }
     }
+    state.pendingSpace = false;
+    state.lastClass = cls;
   }
 
-  commitWord();
-  if (wordCount < maxWords) {
-    words[wordCount] = nullptr;
+  if (IsInvisible(cp))
+    return;
+
+  if (state.currentWordLen + len >= (int)sizeof(state.currentWord)) {
+    // Emergency break (no opportunity in 255 bytes, e.g. a long Thai run)
+    CommitWord();
+    state.wordGlued = true;
+  }
+  int wordLen = state.currentWordLen;
+  if (inPlace) {
+    if (wordLen == 0)
+      wordOut = TextAt(src);
+    char *dest = wordOut + wordLen;
+    if (dest + len > srcEnd) {
+      Overflow();
+      return;
+    }
+    if (dest != bytes)
+      memmove(dest, bytes, len);
+  } else {
+    for (int i = 0; i < len; i++)
+      state.currentWord[wordLen + i] = bytes[i];
+  }
+  state.currentWordLen = wordLen + len;
+}
+
+void HtmlTextExtractor::Overflow() {
+  DebugLogger::Log("In-place text overflow after %d words", wordCount);
+  overflowed = true;
+  wordLimit = 0; // IsFull() from here on
+}
+
+// Text that turned out not to be a reference; ASCII only. at is where it
+// starts counting from the reference's '&'.
+void HtmlTextExtractor::PushLiteral(const char *text, int len, int at) {
+  const char *src = inPlace ? entitySrc + at : text;
+  for (int i = 0; i < len; i++)
+    PushCodepoint((uint8_t)text[i], GetAsciiLineBreakClass(text[i]),
+                  text + i, 1, src + i, src + i + 1);
+}
+
+// One byte after the '&' of a character reference. Returns false if c isn't
+// part of it; the reference is then resolved and c is processed as usual.
+bool HtmlTextExtractor::FeedEntity(char c) {
+  if ((isalnum((unsigned char)c) || (c == '#' && state.entityLen == 0)) &&
+      state.entityLen < ENTITY_MAX_NAME) {
+    state.entity[state.entityLen++] = c;
+    return true;
+  }
+  ResolveEntity(c == ';');
+  return c == ';';
+}
+
+void HtmlTextExtractor::ResolveEntity(bool semicolon) {
+  state.inEntity = false;
+  const char *name = state.entity;
+  int len = state.entityLen;
+  uint32_t cps[2];
+  int count = 0;
+  int used = len; // Name characters the reference stands for
+
+  if (len > 1 && name[0] == '#') {
+    // &#8212; or &#x2014; (the semicolon is optional here too)
+    bool hex = name[1] == 'x' || name[1] == 'X';
+    int first = hex ? 2 : 1;
+    uint32_t value = 0;
+    int digits = 0;
+    for (int i = first; i < len; i++) {
+      char c = name[i];
+      int d = -1;
+      if (c >= '0' && c <= '9')
+        d = c - '0';
+      else if (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        d = (c | 0x20) - 'a' + 10;
+      if (d < 0)
+        break;
+      value = value * (hex ? 16 : 10) + d;
+      if (value > 0x10FFFF)
+        value = 0x110000; // Saturate; resolves to U+FFFD
+      digits++;
+    }
+    if (digits > 0) {
+      cps[0] = ResolveNumericEntity(value);
+      count = 1;
+      used = first + digits;
+    }
+  } else {
+    bool legacy = false;
+    count = LookupNamedEntity(name, len, cps, &legacy);
+    if (count > 0 && !semicolon && !legacy)
+      count = 0;
+    // "&copy2024": the legacy names (six characters at most) also match as
+    // a prefix
+    for (int n = len - 1 < 6 ? len - 1 : 6; count == 0 && n >= 2; n--) {
+      count = LookupNamedEntity(name, n, cps, &legacy);
+      if (count > 0 && !legacy)
+        count = 0;
+      used = n;
+    }
+  }
+
+  if (count == 0) {
+    PushLiteral("&", 1, 0);
+    PushLiteral(name, len, 1);
+    if (semicolon)
+      PushLiteral(";", 1, 1 + len);
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    char bytes[4];
+    int n = EncodeUtf8(cps[i], bytes);
+    // In place the result has the reference's own bytes to go in
+    const char *src = inPlace ? entitySrc : bytes;
+    int srcLen = inPlace ? 1 + used + (semicolon && used == len) : n;
+    PushCodepoint(cps[i], GetLineBreakClass(cps[i]), bytes, n, src,
+                  src + srcLen);
+  }
+  if (used < len) {
+    PushLiteral(name + used, len - used, 1 + used);
+    if (semicolon)
+      PushLiteral(";", 1, 1 + len);
   }
+}
+
+// Letters and digits after an AL or NU character never break from it or
+// each other (LB23, LB28, LB29), so the whole run is copied at once
+template <bool InPlace>
+int HtmlTextExtractor::CopyAlnumRun(const char *text, int len, int *pos,
+                                    int wordLen, uint8_t *lastClass) {
+  int i = *pos;
+  int room = (int)sizeof(state.currentWord) - 1 - wordLen;
+  int run = ScanAlnumRun(text + i, len - i < room ? len - i : room);
+  if (run == 0)
+    return 0;
+  char *dest = (InPlace ? wordOut : state.currentWord) + wordLen;
+  if (InPlace) {
+    if (dest != text + i)
+      memmove(dest, text + i, run);
+  } else if (run <= 8 && i + 8 <= len && room > 8)
+    memcpy(dest, text + i, 8);
+  else
+    memcpy(dest, text + i, run);
+  *pos = i + run;
+  *lastClass = GetAsciiLineBreakClass((uint8_t)text[i + run - 1]);
+  return run;
+}
+
+// Characters up to the next tag delimiter; returns the bytes consumed. The
+// two modes get separate copies so neither pays for the other's branches.
+template <bool InPlace>
+int HtmlTextExtractor::FeedText(const char *text, int len) {
+  const uint8_t *s = (const uint8_t *)text;
+  // The common case is kept in locals: writes to currentWord would
+  // otherwise force every state field to be reloaded
+  int wordLen = state.currentWordLen;
+  uint8_t lastClass = state.lastClass;
+  bool pendingSpace = state.pendingSpace;
+  char *word = InPlace ? wordOut : state.currentWord;
+  int i = 0;
+  while (i < len) {
+    uint32_t cp = s[i];
+    int n = 1;
+    LineBreakClass cls;
+    if (cp < 0x80) {
+      if (cp == '<' || cp == '>')
+        break;
+      if (cp == '&') {
+        state.currentWordLen = wordLen;
+        state.lastClass = lastClass;
+        state.pendingSpace = pendingSpace;
+        state.inEntity = true;
+        state.entityLen = 0;
+        entitySrc = text + i;
+        i++;
+        while (i < len && state.inEntity && FeedEntity(text[i]))
+          i++;
+        if (InPlace)
+          word = wordOut;
+        wordLen = state.currentWordLen;
+        lastClass = state.lastClass;
+        pendingSpace = state.pendingSpace;
+        if (IsFull())
+          break;
+        continue;
+      }
+      if (IsWhitespace((char)cp)) {
+        pendingSpace = lastClass != LB_COUNT;
+        i++;
+        continue;
+      }
+      cls = GetAsciiLineBreakClass((uint8_t)cp);
+    } else {
+      // Two- and three-byte sequences (Cyrillic, CJK) decoded in line
+      if ((cp & 0xE0) == 0xC0 && cp >= 0xC2 && i + 1 < len &&
+          (s[i + 1] & 0xC0) == 0x80) {
+        cp = ((cp & 0x1F) << 6) | (s[i + 1] & 0x3F);
+        n = 2;
+      } else if ((cp & 0xF0) == 0xE0 && i + 2 < len &&
+                 ((s[i + 1] & 0xC0) | ((s[i + 2] & 0xC0) >> 2)) == 0xA0) {
+        // (Both continuation tags at once: 10xxxxxx 10xxxxxx -> 0xA0)
+        cp = ((cp & 0x0F) << 12) | ((s[i + 1] & 0x3F) << 6) |
+             (s[i + 2] & 0x3F);
+        n = 3;
+        if (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))
+          cp = UTF8_REPLACEMENT; // Overlong or surrogate
+      } else {
+        // Four-byte and malformed sequences
+        n = DecodeUtf8(s + i, len - i, &cp);
+        if (n == 0) {
+          // The sequence continues in the next block. In place, that block
+          // is inflated right after this one, so the bytes just wait.
+          if (InPlace)
+            break;
+          bool again;
+          while (i < len)
+            state.utf8.Push(s[i++], &again);
+          break;
+        }
+      }
+      cls = GetLineBreakClass(cp);
+    }
+
+    if (!pendingSpace && lastClass != LB_COUNT && cls < LB_ZW &&
+        cls != LB_SP && cp != 0x00AD && cp != UTF8_REPLACEMENT &&
+        wordLen + n < (int)sizeof(state.currentWord)) {
+      // No space before and nothing special about the character: the pair
+      // table alone decides
+      if (GetLineBreakAction((LineBreakClass)lastClass, cls) ==
+          LB_BREAK_DIRECT) {
+        state.currentWordLen = wordLen;
+        CommitWord();
+        state.wordGlued = true;
+        lastClass = cls;
+        if (InPlace)
+          word = wordOut = TextAt(text + i); // Already where it belongs
+        else if (i + 4 <= len)
+          memcpy(word, s + i, 4);
+        else
+          for (int k = 0; k < n; k++)
+            word[k] = (char)s[i + k];
+        wordLen = n;
+        i += n;
+        if (IsFull())
+          break;
+        continue;
+      }
+      if (InPlace) {
+        if (wordLen == 0) // After an invisible character
+          word = wordOut = TextAt(text + i);
+        else if (word + wordLen != text + i)
+          memmove(word + wordLen, s + i, n);
+      } else if (i + 4 <= len && wordLen + 4 < (int)sizeof(state.currentWord))
+        memcpy(word + wordLen, s + i, 4);
+      else
+        for (int k = 0; k < n; k++)
+          word[wordLen + k] = (char)s[i + k];
+      wordLen += n;
+      lastClass = cls;
+      i += n;
+      if (n == 1 && (cls == LB_AL || cls == LB_NU))
+        wordLen += CopyAlnumRun<InPlace>(text, len, &i, wordLen, &lastClass);
+      continue;
+    }
+    if (pendingSpace && lastClass != LB_COUNT && cls < LB_ZW && cls != LB_SP &&
+        cp != 0x00AD && cp != UTF8_REPLACEMENT &&
+        GetLineBreakAction((LineBreakClass)lastClass, cls) !=
+            LB_BREAK_PROHIBITED) {
+      // A word after a space
+      state.currentWordLen = wordLen;
+      CommitWord();
+      state.wordGlued = false;
+      pendingSpace = false;
+      lastClass = cls;
+      if (InPlace)
+        word = wordOut = TextAt(text + i);
+      else if (i + 4 <= len)
+        memcpy(word, s + i, 4);
+      else
+        for (int k = 0; k < n; k++)
+          word[k] = (char)s[i + k];
+      wordLen = n;
+      i += n;
+      if (n == 1 && (cls == LB_AL || cls == LB_NU))
+        wordLen += CopyAlnumRun<InPlace>(text, len, &i, wordLen, &lastClass);
+      if (IsFull())
+        break;
+      continue;
+    }
+
+    state.currentWordLen = wordLen;
+    state.lastClass = lastClass;
+    state.pendingSpace = pendingSpace;
+    if (cp == UTF8_REPLACEMENT)
+      PushCodepoint(cp, cls, "\xEF\xBF\xBD", 3, text + i, text + i + n);
+    else
+      PushCodepoint(cp, cls, text + i, n, text + i, text + i + n);
+    if (InPlace)
+      word = wordOut;
+    wordLen = state.currentWordLen;
+    lastClass = state.lastClass;
+    pendingSpace = state.pendingSpace;
+    i += n;
+    if (IsFull())
+      break;
+  }
+  state.currentWordLen = wordLen;
+  state.lastClass = lastClass;
+  state.pendingSpace = pendingSpace;
+  return i;
+}
+
+int HtmlTextExtractor::Feed(const char *data, int len) {
+  if (!data || !wordOffsets || !flags || !wordLens || maxWords == 0 || !runs ||
+      maxRuns == 0 || !wordBuffer || bufferSize == 0)
+    return len;
+
+  int i = 0;
+  for (; i < len && !IsFull(); i++) {
+    char c = data[i];
+
+    // Finish a UTF-8 sequence split across blocks
+    if (state.utf8.need > 0) {
+      bool again;
+      if (state.utf8.Push((uint8_t)c, &again)) {
+        char bytes[4];
+        int n = EncodeUtf8(state.utf8.cp, bytes);
+        PushCodepoint(state.utf8.cp, GetLineBreakClass(state.utf8.cp), bytes,
+                      n, bytes, bytes + n);
+      }
+      if (!again)
+        continue;
+      // Sequence cut short: this byte starts something new
+    }
+
+    // Finish a character reference split across blocks
+    if (state.inEntity && FeedEntity(c))
+      continue;
+
+    if (state.readingTagName) {
+      if (c == '/' && state.tagNameLen == 0 && !state.closingTag) {
+        state.closingTag = true;
+        continue;
+      }
+      if (isalnum((unsigned char)c)) {
+        char lower = (char)tolower((unsigned char)c);
+        if (state.tagNameLen < (int)sizeof(state.tagName))
+          state.tagName[state.tagNameLen] = lower;
+        state.tagNameLen++;
+        state.tagHash = CssHashStep(state.tagHash, lower);
+        continue;
+      }
+      state.readingTagName = false;
+      HandleTagName();
+      // Fall through: this byte may be the closing '>'
+    }
+
+    if (c == '<') {
+      // Whether the tag separates words depends on its name
+      state.inTag = true;
+      state.readingTagName = true;
+      state.closingTag = false;
+      state.tagNameLen = 0;
+      state.tagHash = CSS_HASH_INIT;
+      state.attrState = ATTR_SPACE;
+      state.tagSlash = false;
+      state.classCount = 0;
+      state.elementId = 0;
+      state.hrefLen = 0;
+    } else if (c == '>') {
+      if (attrsRead && state.inTag && !state.closingTag &&
+          state.tagNameLen > 0)
+        OpenElement();
+      state.inTag = false;
+    } else if (!state.inTag && !state.inScript && !state.inStyle &&
+               state.hiddenDepth == 0) {
+      int used = inPlace ? FeedText<true>(data + i, len - i)
+                         : FeedText<false>(data + i, len - i);
+      if (used == 0)
+        break; // In place: the block ends inside a UTF-8 sequence
+      i += used - 1;
+    } else if (state.inTag && attrsRead) {
+      i += ScanAttributes(data + i, len - i) - 1;
+    } else {
+      // Attributes, scripts, styles and hidden text: nothing matters until
+      // the next delimiter
+      i += ScanTagDelimiter(data + i, len - i) - 1;
+    }
+  }
+
+  return i;
+}
+
+bool HtmlTextExtractor::IsFull() const {
+  // Leave room for the longest word so a commit is never dropped, and for the
+  // most one character adds: the '>' of <p class="title"> commits a word and
+  // pushes two newlines. The caller makes space with Discard() and feeds the
+  // rest of the block.
+  return wordCount + 3 > wordLimit ||
+         bufferPos + (int)sizeof(state.currentWord) + 2 >= bufferSize;
+}
+
+void HtmlTextExtractor::Discard(int count) {
+  if (count <= 0)
+    return;
+  if (count > wordCount)
+    count = wordCount;
+
+  // Copied words are laid out back to back in wordBuffer, so the survivors
+  // are one contiguous run. In place the text stays where it is.
+  int byteOffset = 0;
+  if (!inPlace) {
+    byteOffset = count < wordCount ? (int)wordOffsets[count] : bufferPos;
+    memmove(wordBuffer, wordBuffer + byteOffset, bufferPos - byteOffset);
+  }
+  int keep = wordCount - count;
+  wordBase += count;
+  for (int i = 0; i < keep; i++)
+    wordOffsets[i] = wordOffsets[i + count] - byteOffset;
+  memmove(flags, flags + count, keep);
+  memmove(wordLens, wordLens + count, keep);
+  if (tokens)
+    memmove(wordTokens, wordTokens + count, keep * sizeof(uint16_t));
+
+  // Runs that ended among the dropped words go; the one straddling the cut
+  // now starts the window. The last run is kept even if all its words went,
+  // since words still to come may continue it.
+  int r = 0;
+  while (r + 1 < runCount && runs[r + 1].start <= count)
+    r++;
+  runCount -= r;
+  memmove(runs, runs + r, runCount * sizeof(StyleRun));
+  if (runCount > 0)
+    runs[0].start = count;
+  for (int i = 0; i < runCount; i++)
+    runs[i].start -= count;
+  wordLimit = runCount + 2 >= maxRuns ? keep : maxWords;
+
+  wordCount = keep;
+  bufferPos -= byteOffset;
+}
+
+void HtmlTextExtractor::Adopt(int wordCount, int bufferUsed, int runCount) {
+  this->wordCount = wordCount;
+  bufferPos = bufferUsed;
+  this->runCount = runCount;
+  runStale = true;
+  wordLimit = runCount + 2 >= maxRuns ? wordCount : maxWords;
+}
+
+int HtmlTextExtractor::Finish() {
+  // A sequence truncated at the end of the input is dropped
+  state.utf8.Reset();
+  if (state.inEntity)
+    ResolveEntity(false);
+  CommitWord();
   DebugLogger::Log("Extracted %d words", wordCount);
   return wordCount;
 }
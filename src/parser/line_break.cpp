@@ -0,0 +1,372 @@
+#include "line_break.h"
+
+// Class ranges from LineBreak.txt (Unicode 14.0) with the LB1 resolutions in
+// line_break.h applied. Only the blocks a book is likely to use are listed:
+// Latin, Greek, Cyrillic, Thai, general punctuation and symbols, CJK, kana,
+// Hangul, the compatibility and full-width forms, emoji and the
+// supplementary ideographic planes. Anything else is AL.
+struct ClassRange {
+  uint32_t first;
+  uint32_t last;
+  LineBreakClass cls;
+};
+
+static constexpr ClassRange classRanges[] = {
+  {0x0000, 0x0008, LB_CM}, {0x0009, 0x0009, LB_BA}, {0x000A, 0x000D, LB_SP},
+  {0x000E, 0x001F, LB_CM}, {0x0020, 0x0020, LB_SP}, {0x0021, 0x0021, LB_EX},
+  {0x0022, 0x0022, LB_QU}, {0x0024, 0x0024, LB_PR}, {0x0025, 0x0025, LB_PO},
+  {0x0027, 0x0027, LB_QU}, {0x0028, 0x0028, LB_OP}, {0x0029, 0x0029, LB_CP},
+  {0x002B, 0x002B, LB_PR}, {0x002C, 0x002C, LB_IS}, {0x002D, 0x002D, LB_HY},
+  {0x002E, 0x002E, LB_IS}, {0x002F, 0x002F, LB_SY}, {0x0030, 0x0039, LB_NU},
+  {0x003A, 0x003B, LB_IS}, {0x003F, 0x003F, LB_EX}, {0x005B, 0x005B, LB_OP},
+  {0x005C, 0x005C, LB_PR}, {0x005D, 0x005D, LB_CP}, {0x007B, 0x007B, LB_OP},
+  {0x007C, 0x007C, LB_BA}, {0x007D, 0x007D, LB_CL}, {0x007F, 0x0084, LB_CM},
+  {0x0085, 0x0085, LB_SP}, {0x0086, 0x009F, LB_CM}, {0x00A0, 0x00A0, LB_GL},
+  {0x00A1, 0x00A1, LB_OP}, {0x00A2, 0x00A2, LB_PO}, {0x00A3, 0x00A5, LB_PR},
+  {0x00AB, 0x00AB, LB_QU}, {0x00AD, 0x00AD, LB_BA}, {0x00B0, 0x00B0, LB_PO},
+  {0x00B1, 0x00B1, LB_PR}, {0x00B4, 0x00B4, LB_BB}, {0x00BB, 0x00BB, LB_QU},
+  {0x00BF, 0x00BF, LB_OP}, {0x02C8, 0x02C8, LB_BB}, {0x02CC, 0x02CC, LB_BB},
+  {0x02DF, 0x02DF, LB_BB}, {0x0300, 0x034E, LB_CM}, {0x034F, 0x034F, LB_GL},
+  {0x0350, 0x035B, LB_CM}, {0x035C, 0x0362, LB_GL}, {0x0363, 0x036F, LB_CM},
+  {0x037E, 0x037E, LB_IS}, {0x0483, 0x0489, LB_CM}, {0x0E3F, 0x0E3F, LB_PR},
+  {0x0E50, 0x0E59, LB_NU}, {0x0E5A, 0x0E5B, LB_BA}, {0x1DC0, 0x1DFF, LB_CM},
+  {0x2000, 0x2006, LB_BA}, {0x2007, 0x2007, LB_GL}, {0x2008, 0x200A, LB_BA},
+  {0x200B, 0x200B, LB_ZW}, {0x200C, 0x200C, LB_CM}, {0x200D, 0x200D, LB_ZWJ},
+  {0x200E, 0x200F, LB_CM}, {0x2010, 0x2010, LB_BA}, {0x2011, 0x2011, LB_GL},
+  {0x2012, 0x2013, LB_BA}, {0x2014, 0x2014, LB_B2}, {0x2018, 0x2019, LB_QU},
+  {0x201A, 0x201A, LB_OP}, {0x201B, 0x201D, LB_QU}, {0x201E, 0x201E, LB_OP},
+  {0x201F, 0x201F, LB_QU}, {0x2024, 0x2026, LB_IN}, {0x2027, 0x2027, LB_BA},
+  {0x2028, 0x2029, LB_SP}, {0x202A, 0x202E, LB_CM}, {0x202F, 0x202F, LB_GL},
+  {0x2030, 0x2037, LB_PO}, {0x2039, 0x203A, LB_QU}, {0x203C, 0x203D, LB_NS},
+  {0x2044, 0x2044, LB_IS}, {0x2045, 0x2045, LB_OP}, {0x2046, 0x2046, LB_CL},
+  {0x2047, 0x2049, LB_NS}, {0x2056, 0x2056, LB_BA}, {0x2058, 0x205B, LB_BA},
+  {0x205D, 0x205F, LB_BA}, {0x2060, 0x2060, LB_WJ}, {0x2066, 0x206F, LB_CM},
+  {0x207D, 0x207D, LB_OP}, {0x207E, 0x207E, LB_CL}, {0x208D, 0x208D, LB_OP},
+  {0x208E, 0x208E, LB_CL}, {0x20A0, 0x20A6, LB_PR}, {0x20A7, 0x20A7, LB_PO},
+  {0x20A8, 0x20B5, LB_PR}, {0x20B6, 0x20B6, LB_PO}, {0x20B7, 0x20BA, LB_PR},
+  {0x20BB, 0x20BB, LB_PO}, {0x20BC, 0x20BD, LB_PR}, {0x20BE, 0x20BE, LB_PO},
+  {0x20BF, 0x20BF, LB_PR}, {0x20C0, 0x20C0, LB_PO}, {0x20C1, 0x20CF, LB_PR},
+  {0x20D0, 0x20F0, LB_CM}, {0x2103, 0x2103, LB_PO}, {0x2109, 0x2109, LB_PO},
+  {0x2116, 0x2116, LB_PR}, {0x2212, 0x2213, LB_PR}, {0x22EF, 0x22EF, LB_IN},
+  {0x2308, 0x2308, LB_OP}, {0x2309, 0x2309, LB_CL}, {0x230A, 0x230A, LB_OP},
+  {0x230B, 0x230B, LB_CL}, {0x231A, 0x231B, LB_ID}, {0x2329, 0x2329, LB_OP},
+  {0x232A, 0x232A, LB_CL}, {0x23F0, 0x23F3, LB_ID}, {0x2600, 0x2603, LB_ID},
+  {0x2614, 0x2615, LB_ID}, {0x2618, 0x2618, LB_ID}, {0x261A, 0x261F, LB_ID},
+  {0x2639, 0x263B, LB_ID}, {0x2668, 0x2668, LB_ID}, {0x267F, 0x267F, LB_ID},
+  {0x26BD, 0x26C8, LB_ID}, {0x26CD, 0x26CD, LB_ID}, {0x26CF, 0x26D1, LB_ID},
+  {0x26D3, 0x26D4, LB_ID}, {0x26D8, 0x26D9, LB_ID}, {0x26DC, 0x26DC, LB_ID},
+  {0x26DF, 0x26E1, LB_ID}, {0x26EA, 0x26EA, LB_ID}, {0x26F1, 0x26F5, LB_ID},
+  {0x26F7, 0x26FA, LB_ID}, {0x26FD, 0x2704, LB_ID}, {0x2708, 0x270D, LB_ID},
+  {0x275B, 0x2760, LB_QU}, {0x2762, 0x2763, LB_EX}, {0x2764, 0x2764, LB_ID},
+  {0x2768, 0x2768, LB_OP}, {0x2769, 0x2769, LB_CL}, {0x276A, 0x276A, LB_OP},
+  {0x276B, 0x276B, LB_CL}, {0x276C, 0x276C, LB_OP}, {0x276D, 0x276D, LB_CL},
+  {0x276E, 0x276E, LB_OP}, {0x276F, 0x276F, LB_CL}, {0x2770, 0x2770, LB_OP},
+  {0x2771, 0x2771, LB_CL}, {0x2772, 0x2772, LB_OP}, {0x2773, 0x2773, LB_CL},
+  {0x2774, 0x2774, LB_OP}, {0x2775, 0x2775, LB_CL}, {0x27C5, 0x27C5, LB_OP},
+  {0x27C6, 0x27C6, LB_CL}, {0x27E6, 0x27E6, LB_OP}, {0x27E7, 0x27E7, LB_CL},
+  {0x27E8, 0x27E8, LB_OP}, {0x27E9, 0x27E9, LB_CL}, {0x27EA, 0x27EA, LB_OP},
+  {0x27EB, 0x27EB, LB_CL}, {0x27EC, 0x27EC, LB_OP}, {0x27ED, 0x27ED, LB_CL},
+  {0x27EE, 0x27EE, LB_OP}, {0x27EF, 0x27EF, LB_CL}, {0x2983, 0x2983, LB_OP},
+  {0x2984, 0x2984, LB_CL}, {0x2985, 0x2985, LB_OP}, {0x2986, 0x2986, LB_CL},
+  {0x2987, 0x2987, LB_OP}, {0x2988, 0x2988, LB_CL}, {0x2989, 0x2989, LB_OP},
+  {0x298A, 0x298A, LB_CL}, {0x298B, 0x298B, LB_OP}, {0x298C, 0x298C, LB_CL},
+  {0x298D, 0x298D, LB_OP}, {0x298E, 0x298E, LB_CL}, {0x298F, 0x298F, LB_OP},
+  {0x2990, 0x2990, LB_CL}, {0x2991, 0x2991, LB_OP}, {0x2992, 0x2992, LB_CL},
+  {0x2993, 0x2993, LB_OP}, {0x2994, 0x2994, LB_CL}, {0x2995, 0x2995, LB_OP},
+  {0x2996, 0x2996, LB_CL}, {0x2997, 0x2997, LB_OP}, {0x2998, 0x2998, LB_CL},
+  {0x29D8, 0x29D8, LB_OP}, {0x29D9, 0x29D9, LB_CL}, {0x29DA, 0x29DA, LB_OP},
+  {0x29DB, 0x29DB, LB_CL}, {0x29FC, 0x29FC, LB_OP}, {0x29FD, 0x29FD, LB_CL},
+  {0x2E00, 0x2E0D, LB_QU}, {0x2E0E, 0x2E15, LB_BA}, {0x2E17, 0x2E17, LB_BA},
+  {0x2E18, 0x2E18, LB_OP}, {0x2E19, 0x2E19, LB_BA}, {0x2E1C, 0x2E1D, LB_QU},
+  {0x2E20, 0x2E21, LB_QU}, {0x2E22, 0x2E22, LB_OP}, {0x2E23, 0x2E23, LB_CL},
+  {0x2E24, 0x2E24, LB_OP}, {0x2E25, 0x2E25, LB_CL}, {0x2E26, 0x2E26, LB_OP},
+  {0x2E27, 0x2E27, LB_CL}, {0x2E28, 0x2E28, LB_OP}, {0x2E29, 0x2E29, LB_CL},
+  {0x2E2A, 0x2E2D, LB_BA}, {0x2E2E, 0x2E2E, LB_EX}, {0x2E30, 0x2E31, LB_BA},
+  {0x2E33, 0x2E34, LB_BA}, {0x2E3A, 0x2E3B, LB_B2}, {0x2E3C, 0x2E3E, LB_BA},
+  {0x2E40, 0x2E41, LB_BA}, {0x2E42, 0x2E42, LB_OP}, {0x2E43, 0x2E4A, LB_BA},
+  {0x2E4C, 0x2E4C, LB_BA}, {0x2E4E, 0x2E4F, LB_BA}, {0x2E53, 0x2E54, LB_EX},
+  {0x2E55, 0x2E55, LB_OP}, {0x2E56, 0x2E56, LB_CL}, {0x2E57, 0x2E57, LB_OP},
+  {0x2E58, 0x2E58, LB_CL}, {0x2E59, 0x2E59, LB_OP}, {0x2E5A, 0x2E5A, LB_CL},
+  {0x2E5B, 0x2E5B, LB_OP}, {0x2E5C, 0x2E5C, LB_CL}, {0x2E5D, 0x2E5D, LB_BA},
+  {0x2E80, 0x2E99, LB_ID}, {0x2E9B, 0x2EF3, LB_ID}, {0x2F00, 0x2FD5, LB_ID},
+  {0x2FF0, 0x2FFB, LB_ID}, {0x3000, 0x3000, LB_BA}, {0x3001, 0x3002, LB_CL},
+  {0x3003, 0x3004, LB_ID}, {0x3005, 0x3005, LB_NS}, {0x3006, 0x3007, LB_ID},
+  {0x3008, 0x3008, LB_OP}, {0x3009, 0x3009, LB_CL}, {0x300A, 0x300A, LB_OP},
+  {0x300B, 0x300B, LB_CL}, {0x300C, 0x300C, LB_OP}, {0x300D, 0x300D, LB_CL},
+  {0x300E, 0x300E, LB_OP}, {0x300F, 0x300F, LB_CL}, {0x3010, 0x3010, LB_OP},
+  {0x3011, 0x3011, LB_CL}, {0x3012, 0x3013, LB_ID}, {0x3014, 0x3014, LB_OP},
+  {0x3015, 0x3015, LB_CL}, {0x3016, 0x3016, LB_OP}, {0x3017, 0x3017, LB_CL},
+  {0x3018, 0x3018, LB_OP}, {0x3019, 0x3019, LB_CL}, {0x301A, 0x301A, LB_OP},
+  {0x301B, 0x301B, LB_CL}, {0x301C, 0x301C, LB_NS}, {0x301D, 0x301D, LB_OP},
+  {0x301E, 0x301F, LB_CL}, {0x3020, 0x3029, LB_ID}, {0x302A, 0x302F, LB_CM},
+  {0x3030, 0x3034, LB_ID}, {0x3035, 0x3035, LB_CM}, {0x3036, 0x303A, LB_ID},
+  {0x303B, 0x303C, LB_NS}, {0x303D, 0x303F, LB_ID}, {0x3041, 0x3041, LB_NS},
+  {0x3042, 0x3042, LB_ID}, {0x3043, 0x3043, LB_NS}, {0x3044, 0x3044, LB_ID},
+  {0x3045, 0x3045, LB_NS}, {0x3046, 0x3046, LB_ID}, {0x3047, 0x3047, LB_NS},
+  {0x3048, 0x3048, LB_ID}, {0x3049, 0x3049, LB_NS}, {0x304A, 0x3062, LB_ID},
+  {0x3063, 0x3063, LB_NS}, {0x3064, 0x3082, LB_ID}, {0x3083, 0x3083, LB_NS},
+  {0x3084, 0x3084, LB_ID}, {0x3085, 0x3085, LB_NS}, {0x3086, 0x3086, LB_ID},
+  {0x3087, 0x3087, LB_NS}, {0x3088, 0x308D, LB_ID}, {0x308E, 0x308E, LB_NS},
+  {0x308F, 0x3094, LB_ID}, {0x3095, 0x3096, LB_NS}, {0x3099, 0x309A, LB_CM},
+  {0x309B, 0x309E, LB_NS}, {0x309F, 0x309F, LB_ID}, {0x30A0, 0x30A1, LB_NS},
+  {0x30A2, 0x30A2, LB_ID}, {0x30A3, 0x30A3, LB_NS}, {0x30A4, 0x30A4, LB_ID},
+  {0x30A5, 0x30A5, LB_NS}, {0x30A6, 0x30A6, LB_ID}, {0x30A7, 0x30A7, LB_NS},
+  {0x30A8, 0x30A8, LB_ID}, {0x30A9, 0x30A9, LB_NS}, {0x30AA, 0x30C2, LB_ID},
+  {0x30C3, 0x30C3, LB_NS}, {0x30C4, 0x30E2, LB_ID}, {0x30E3, 0x30E3, LB_NS},
+  {0x30E4, 0x30E4, LB_ID}, {0x30E5, 0x30E5, LB_NS}, {0x30E6, 0x30E6, LB_ID},
+  {0x30E7, 0x30E7, LB_NS}, {0x30E8, 0x30ED, LB_ID}, {0x30EE, 0x30EE, LB_NS},
+  {0x30EF, 0x30F4, LB_ID}, {0x30F5, 0x30F6, LB_NS}, {0x30F7, 0x30FA, LB_ID},
+  {0x30FB, 0x30FE, LB_NS}, {0x30FF, 0x30FF, LB_ID}, {0x3105, 0x312F, LB_ID},
+  {0x3131, 0x318E, LB_ID}, {0x3190, 0x31E3, LB_ID}, {0x31F0, 0x31FF, LB_NS},
+  {0x3200, 0x321E, LB_ID}, {0x3220, 0x3247, LB_ID}, {0x3250, 0x4DBF, LB_ID},
+  {0x4E00, 0xA014, LB_ID}, {0xA015, 0xA015, LB_NS}, {0xA016, 0xA48C, LB_ID},
+  {0xA490, 0xA4C6, LB_ID}, {0xAC00, 0xD7A3, LB_ID}, {0xF900, 0xFAFF, LB_ID},
+  {0xFE00, 0xFE0F, LB_CM}, {0xFE10, 0xFE10, LB_IS}, {0xFE11, 0xFE12, LB_CL},
+  {0xFE13, 0xFE14, LB_IS}, {0xFE15, 0xFE16, LB_EX}, {0xFE17, 0xFE17, LB_OP},
+  {0xFE18, 0xFE18, LB_CL}, {0xFE19, 0xFE19, LB_IN}, {0xFE20, 0xFE2F, LB_CM},
+  {0xFE30, 0xFE34, LB_ID}, {0xFE35, 0xFE35, LB_OP}, {0xFE36, 0xFE36, LB_CL},
+  {0xFE37, 0xFE37, LB_OP}, {0xFE38, 0xFE38, LB_CL}, {0xFE39, 0xFE39, LB_OP},
+  {0xFE3A, 0xFE3A, LB_CL}, {0xFE3B, 0xFE3B, LB_OP}, {0xFE3C, 0xFE3C, LB_CL},
+  {0xFE3D, 0xFE3D, LB_OP}, {0xFE3E, 0xFE3E, LB_CL}, {0xFE3F, 0xFE3F, LB_OP},
+  {0xFE40, 0xFE40, LB_CL}, {0xFE41, 0xFE41, LB_OP}, {0xFE42, 0xFE42, LB_CL},
+  {0xFE43, 0xFE43, LB_OP}, {0xFE44, 0xFE44, LB_CL}, {0xFE45, 0xFE46, LB_ID},
+  {0xFE47, 0xFE47, LB_OP}, {0xFE48, 0xFE48, LB_CL}, {0xFE49, 0xFE4F, LB_ID},
+  {0xFE50, 0xFE50, LB_CL}, {0xFE51, 0xFE51, LB_ID}, {0xFE52, 0xFE52, LB_CL},
+  {0xFE54, 0xFE55, LB_NS}, {0xFE56, 0xFE57, LB_EX}, {0xFE58, 0xFE58, LB_ID},
+  {0xFE59, 0xFE59, LB_OP}, {0xFE5A, 0xFE5A, LB_CL}, {0xFE5B, 0xFE5B, LB_OP},
+  {0xFE5C, 0xFE5C, LB_CL}, {0xFE5D, 0xFE5D, LB_OP}, {0xFE5E, 0xFE5E, LB_CL},
+  {0xFE5F, 0xFE66, LB_ID}, {0xFE68, 0xFE68, LB_ID}, {0xFE69, 0xFE69, LB_PR},
+  {0xFE6A, 0xFE6A, LB_PO}, {0xFE6B, 0xFE6B, LB_ID}, {0xFEFF, 0xFEFF, LB_WJ},
+  {0xFF01, 0xFF01, LB_EX}, {0xFF02, 0xFF03, LB_ID}, {0xFF04, 0xFF04, LB_PR},
+  {0xFF05, 0xFF05, LB_PO}, {0xFF06, 0xFF07, LB_ID}, {0xFF08, 0xFF08, LB_OP},
+  {0xFF09, 0xFF09, LB_CL}, {0xFF0A, 0xFF0B, LB_ID}, {0xFF0C, 0xFF0C, LB_CL},
+  {0xFF0D, 0xFF0D, LB_ID}, {0xFF0E, 0xFF0E, LB_CL}, {0xFF0F, 0xFF19, LB_ID},
+  {0xFF1A, 0xFF1B, LB_NS}, {0xFF1C, 0xFF1E, LB_ID}, {0xFF1F, 0xFF1F, LB_EX},
+  {0xFF20, 0xFF3A, LB_ID}, {0xFF3B, 0xFF3B, LB_OP}, {0xFF3C, 0xFF3C, LB_ID},
+  {0xFF3D, 0xFF3D, LB_CL}, {0xFF3E, 0xFF5A, LB_ID}, {0xFF5B, 0xFF5B, LB_OP},
+  {0xFF5C, 0xFF5C, LB_ID}, {0xFF5D, 0xFF5D, LB_CL}, {0xFF5E, 0xFF5E, LB_ID},
+  {0xFF5F, 0xFF5F, LB_OP}, {0xFF60, 0xFF61, LB_CL}, {0xFF62, 0xFF62, LB_OP},
+  {0xFF63, 0xFF64, LB_CL}, {0xFF65, 0xFF65, LB_NS}, {0xFF66, 0xFF66, LB_ID},
+  {0xFF67, 0xFF70, LB_NS}, {0xFF71, 0xFF9D, LB_ID}, {0xFF9E, 0xFF9F, LB_NS},
+  {0xFFA0, 0xFFBE, LB_ID}, {0xFFC2, 0xFFC7, LB_ID}, {0xFFCA, 0xFFCF, LB_ID},
+  {0xFFD2, 0xFFD7, LB_ID}, {0xFFDA, 0xFFDC, LB_ID}, {0xFFE0, 0xFFE0, LB_PO},
+  {0xFFE1, 0xFFE1, LB_PR}, {0xFFE2, 0xFFE4, LB_ID}, {0xFFE5, 0xFFE6, LB_PR},
+  {0x1F000, 0x1FAFF, LB_ID}, {0x20000, 0x2FFFD, LB_ID}, {0x30000, 0x3FFFD, LB_ID},
+};
+
+// Compile-time two-stage table for the BMP: a block index per 64 code points
+// into deduplicated 64-entry blocks. Most blocks are all AL or all ID, so the
+// whole plane fits in a few KB. The flat 64K expansion below only exists
+// while compiling.
+
+struct FlatClasses {
+  LineBreakClass cls[0x10000];
+};
+
+static constexpr FlatClasses ExpandBmp() {
+  FlatClasses flat{};
+  for (const ClassRange &r : classRanges) {
+    for (uint32_t cp = r.first; cp <= r.last && cp < 0x10000; cp++)
+      flat.cls[cp] = r.cls;
+  }
+  return flat;
+}
+
+static constexpr FlatClasses flatBmp = ExpandBmp();
+
+static constexpr bool SameBlock(int a, int b) {
+  for (int i = 0; i < LB_BLOCK_SIZE; i++) {
+    if (flatBmp.cls[(a << LB_BLOCK_SHIFT) + i] !=
+        flatBmp.cls[(b << LB_BLOCK_SHIFT) + i])
+      return false;
+  }
+  return true;
+}
+
+// Each distinct block is stored once; first maps a block to its first copy
+struct BlockDedup {
+  int first[LB_BMP_BLOCKS];
+  int count;
+};
+
+static constexpr BlockDedup DedupBlocks() {
+  BlockDedup d{};
+  // Only compare against distinct blocks seen so far
+  int distinct[LB_BMP_BLOCKS] = {};
+  for (int b = 0; b < LB_BMP_BLOCKS; b++) {
+    d.first[b] = b;
+    for (int i = 0; i < d.count; i++) {
+      if (SameBlock(distinct[i], b)) {
+        d.first[b] = distinct[i];
+        break;
+      }
+    }
+    if (d.first[b] == b)
+      distinct[d.count++] = b;
+  }
+  return d;
+}
+
+static constexpr BlockDedup blockDedup = DedupBlocks();
+
+template <int Blocks> struct BmpTable {
+  uint8_t index[LB_BMP_BLOCKS];
+  LineBreakClass data[Blocks * LB_BLOCK_SIZE];
+};
+
+static constexpr BmpTable<blockDedup.count> BuildBmpTable() {
+  BmpTable<blockDedup.count> t{};
+  int stored[LB_BMP_BLOCKS] = {};
+  int count = 0;
+  for (int b = 0; b < LB_BMP_BLOCKS; b++) {
+    int first = blockDedup.first[b];
+    if (first == b) {
+      stored[b] = count++;
+      for (int i = 0; i < LB_BLOCK_SIZE; i++)
+        t.data[(stored[b] << LB_BLOCK_SHIFT) + i] =
+            flatBmp.cls[(b << LB_BLOCK_SHIFT) + i];
+    }
+    t.index[b] = (uint8_t)stored[first];
+  }
+  return t;
+}
+
+static constexpr BmpTable<blockDedup.count> bmpTable = BuildBmpTable();
+static_assert(blockDedup.count <= 256, "block index no longer fits a byte");
+static_assert(bmpTable.index[0] == 0 && bmpTable.index[1] == 1,
+              "GetAsciiLineBreakClass relies on ASCII leading the data");
+static_assert(sizeof(bmpTable) <= 6 * 1024, "line break table grew");
+
+// The few ranges beyond the BMP, copied out so the full range list isn't
+// needed at runtime
+static constexpr int CountSupplementary() {
+  int n = 0;
+  for (const ClassRange &r : classRanges) {
+    if (r.last >= 0x10000)
+      n++;
+  }
+  return n;
+}
+
+template <int Count> struct RangeList {
+  ClassRange ranges[Count];
+};
+
+static constexpr RangeList<CountSupplementary()> BuildSupplementary() {
+  RangeList<CountSupplementary()> list{};
+  int n = 0;
+  for (const ClassRange &r : classRanges) {
+    if (r.last >= 0x10000)
+      list.ranges[n++] = r;
+  }
+  return list;
+}
+
+static constexpr RangeList<CountSupplementary()> supplementary =
+    BuildSupplementary();
+
+const uint8_t *const lineBreakBlockIndex = bmpTable.index;
+const LineBreakClass *const lineBreakData = bmpTable.data;
+
+LineBreakClass GetSupplementaryLineBreakClass(uint32_t cp) {
+  for (const ClassRange &r : supplementary.ranges) {
+    if (cp >= r.first && cp <= r.last)
+      return r.cls;
+  }
+  return LB_AL;
+}
+
+// Pair rules ------------------------------------------------------------------
+
+static constexpr bool IsIn(LineBreakClass c, LineBreakClass a,
+                           LineBreakClass b) {
+  return c == a || c == b;
+}
+
+// UAX #14 rules LB11-LB31 for a pair of non-space, non-combining classes.
+// "X SP* ×" rules are PROHIBITED, plain "X ×" rules INDIRECT (the spaces
+// themselves are a break opportunity, LB18), everything else DIRECT (LB31).
+// CM and ZWJ are dealt with by the tokenizer before it gets here.
+static constexpr LineBreakAction PairRule(LineBreakClass b, LineBreakClass a) {
+  // LB8: ZW SP* ÷; LB7: × ZW
+  if (b == LB_ZW)
+    return LB_BREAK_DIRECT;
+  if (a == LB_ZW)
+    return LB_BREAK_PROHIBITED;
+  // LB11: × WJ, WJ ×
+  if (a == LB_WJ)
+    return LB_BREAK_PROHIBITED;
+  if (b == LB_WJ)
+    return LB_BREAK_INDIRECT;
+  // LB12: GL ×; LB12a: [^SP BA HY] × GL
+  if (b == LB_GL)
+    return LB_BREAK_INDIRECT;
+  if (a == LB_GL)
+    return IsIn(b, LB_BA, LB_HY) ? LB_BREAK_DIRECT : LB_BREAK_INDIRECT;
+  // LB13: × CL, × CP, × EX, × IS, × SY (even after spaces)
+  if (a == LB_CL || a == LB_CP || a == LB_EX || a == LB_IS || a == LB_SY)
+    return LB_BREAK_PROHIBITED;
+  // LB14: OP SP* ×
+  if (b == LB_OP)
+    return LB_BREAK_PROHIBITED;
+  // LB15: QU SP* × OP
+  if (b == LB_QU && a == LB_OP)
+    return LB_BREAK_PROHIBITED;
+  // LB16: (CL | CP) SP* × NS -- the closing half of kinsoku
+  if (IsIn(b, LB_CL, LB_CP) && a == LB_NS)
+    return LB_BREAK_PROHIBITED;
+  // LB17: B2 SP* × B2
+  if (b == LB_B2 && a == LB_B2)
+    return LB_BREAK_PROHIBITED;
+  // LB19: × QU, QU ×
+  if (a == LB_QU || b == LB_QU)
+    return LB_BREAK_INDIRECT;
+  // LB21: × BA, × HY, × NS, BB ×
+  if (a == LB_BA || a == LB_HY || a == LB_NS || b == LB_BB)
+    return LB_BREAK_INDIRECT;
+  // LB22: × IN
+  if (a == LB_IN)
+    return LB_BREAK_INDIRECT;
+  // LB23: AL × NU, NU × AL
+  if ((b == LB_AL && a == LB_NU) || (b == LB_NU && a == LB_AL))
+    return LB_BREAK_INDIRECT;
+  // LB23a: PR × ID, ID × PO
+  if ((b == LB_PR && a == LB_ID) || (b == LB_ID && a == LB_PO))
+    return LB_BREAK_INDIRECT;
+  // LB24: (PR | PO) × AL, AL × (PR | PO)
+  if ((IsIn(b, LB_PR, LB_PO) && a == LB_AL) ||
+      (b == LB_AL && IsIn(a, LB_PR, LB_PO)))
+    return LB_BREAK_INDIRECT;
+  // LB25, in its pair-table form
+  if ((IsIn(b, LB_CL, LB_CP) && IsIn(a, LB_PO, LB_PR)) ||
+      (b == LB_NU && IsIn(a, LB_PO, LB_PR)) ||
+      (IsIn(b, LB_PO, LB_PR) && IsIn(a, LB_OP, LB_NU)) ||
+      (IsIn(b, LB_HY, LB_IS) && a == LB_NU) ||
+      (IsIn(b, LB_NU, LB_SY) && a == LB_NU))
+    return LB_BREAK_INDIRECT;
+  // LB28: AL × AL; LB29: IS × AL
+  if (IsIn(b, LB_AL, LB_IS) && a == LB_AL)
+    return LB_BREAK_INDIRECT;
+  // LB30: (AL | NU) × OP, CP × (AL | NU)
+  if ((IsIn(b, LB_AL, LB_NU) && a == LB_OP) ||
+      (b == LB_CP && IsIn(a, LB_AL, LB_NU)))
+    return LB_BREAK_INDIRECT;
+  return LB_BREAK_DIRECT;
+}
+
+struct PairTable {
+  LineBreakAction action[LB_COUNT][LB_COUNT];
+};
+
+static constexpr PairTable BuildPairTable() {
+  PairTable t{};
+  for (int b = 0; b < LB_COUNT; b++) {
+    for (int a = 0; a < LB_COUNT; a++)
+      t.action[b][a] = PairRule((LineBreakClass)b, (LineBreakClass)a);
+  }
+  return t;
+}
+
+static constexpr PairTable pairTable = BuildPairTable();
+
+const LineBreakAction *const lineBreakPairs = &pairTable.action[0][0];
@@ -0,0 +1,47 @@
+#include "token_table.h"
+#include <cstring>
+
+TokenTable::TokenTable() { Clear(); }
+
+void TokenTable::Clear() {
+  memset(slots, 0xFF, sizeof(slots));
+  count = 0;
+}
+
+// Two 32-bit lanes fed four bytes at a time: 64 bits of key for a couple of
+// multiplies per word, where FNV-64 would take several per byte
+static uint64_t TokenKey(const char *text, int len, uint8_t style,
+                         uint8_t emphasis) {
+  uint32_t a = 0x9E3779B9u ^ ((uint32_t)len << 16) ^ (style | emphasis << 8);
+  uint32_t b = 0x85EBCA6Bu + (uint32_t)len;
+  for (int i = 0; i < len; i += 4) {
+    uint32_t w = 0;
+    if (i + 4 <= len)
+      memcpy(&w, text + i, 4);
+    else
+      for (int k = i; k < len; k++)
+        w = (w << 8) | (uint8_t)text[k];
+    a = (a ^ w) * 0x9E3779B1u;
+    a ^= a >> 15;
+    b = (b + w) * 0xC2B2AE35u;
+    b ^= b >> 13;
+  }
+  a ^= b * 0x27D4EB2Fu;
+  a ^= a >> 16;
+  return ((uint64_t)a << 32) | b;
+}
+
+uint16_t TokenTable::Intern(const char *text, int len, uint8_t style,
+                            uint8_t emphasis) {
+  uint64_t key = TokenKey(text, len, style, emphasis);
+  uint32_t i = (uint32_t)(key >> 32) & (TOKEN_SLOTS - 1);
+  for (; slots[i] != TOKEN_NONE; i = (i + 1) & (TOKEN_SLOTS - 1)) {
+    if (keys[slots[i]] == key)
+      return slots[i];
+  }
+  if (count == TOKEN_MAX)
+    return TOKEN_NONE;
+  keys[count] = key;
+  slots[i] = (uint16_t)count;
+  return (uint16_t)count++;
+}
@@ -1,15 +1,41 @@
 #include "text_renderer.h"
 #include "debug_logger.h"
+#include "line_break.h"
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 
+#define GLYPH_UNKNOWN INT16_MIN
+#define KERN_UNKNOWN INT8_MIN
+
+// FreeType lets each thread use faces of its own, but opening and closing
+// them goes through SDL_ttf's one FT_Library. The layout worker measures
+// with faces of its own, so that much is serialized.
+static SDL_mutex *fontLock = nullptr;
+
+static TTF_Font *OpenFont(const char *path, int size) {
+  SDL_LockMutex(fontLock);
+  TTF_Font *font = TTF_OpenFont(path, size);
+  SDL_UnlockMutex(fontLock);
+  return font;
+}
+
+static void CloseFont(TTF_Font *font) {
+  SDL_LockMutex(fontLock);
+  TTF_CloseFont(font);
+  SDL_UnlockMutex(fontLock);
+}
+
 TextRenderer::TextRenderer()
-    : renderer(nullptr), fontScale(1.0f), currentMode(FontMode::SMART) {}
+    : renderer(nullptr), fontSizes{}, fontScale(1.0f),
+      currentMode(FontMode::SMART) {}
 
 TextRenderer::~TextRenderer() { Shutdown(); }
 
 bool TextRenderer::Initialize(SDL_Renderer *sdlRenderer) {
   renderer = sdlRenderer;
+  if (!fontLock)
+    fontLock = SDL_CreateMutex(); // Kept for the life of the program
   if (TTF_Init() == -1) {
     DebugLogger::Log("TTF_Init failed: %s", TTF_GetError());
     return false;
@@ -18,7 +44,7 @@ bool TextRenderer::Initialize(SDL_Renderer *sdlRenderer) {
 }
 
 // Helper to check for CJK/Wide characters
-static bool HasWideChars(const char *text) {
+static bool HasWideChars(const char *text, int len) {
   if (!text)
     return false;
   // Simple check: if any byte is > 127, it's non-ASCII.
@@ -31,8 +57,7 @@ static bool HasWideChars(const char *text) {
   // Kana/Hangul etc also high up.
   // Quick heuristic: If we find a 3-byte sequence (0xE0-0xEF), assume CJK
   // and use fallback.
-  size_t len = strlen(text);
-  for (size_t i = 0; i < len; i++) {
+  for (int i = 0; i < len; i++) {
     unsigned char c = (unsigned char)text[i];
     if (c >= 0xE0 && c <= 0xEF) {
       return true;
@@ -51,14 +76,20 @@ void TextRenderer::Shutdown() {
 void TextRenderer::CloseFonts() {
   for (auto &pair : fonts) {
     if (pair.second)
-      TTF_CloseFont(pair.second);
+      CloseFont(pair.second);
   }
   for (auto &pair : fallbackFonts) {
     if (pair.second)
-      TTF_CloseFont(pair.second);
+      CloseFont(pair.second);
+  }
+  for (auto &pair : variantFonts) {
+    if (pair.second)
+      CloseFont(pair.second);
   }
   fonts.clear();
   fallbackFonts.clear();
+  variantFonts.clear();
+  glyphTables.clear();
 }
 
 void TextRenderer::CleanupCache() {
@@ -102,14 +133,15 @@ bool TextRenderer::LoadFont(float scale) {
     int size = (int)(baseSize * fontScale);
     if (size < 8)
       size = 8;
+    fontSizes[(int)style] = size;
 
-    fonts[style] = TTF_OpenFont(primaryPath, size);
+    fonts[style] = OpenFont(primaryPath, size);
     if (!fonts[style]) {
       DebugLogger::Log("Failed loading primary font %d: %s", (int)style,
                        TTF_GetError());
     }
 
-    fallbackFonts[style] = TTF_OpenFont(fallbackPath, size);
+    fallbackFonts[style] = OpenFont(fallbackPath, size);
   };
 
   loadOne(TextStyle::NORMAL, 18);
@@ -122,9 +154,171 @@ bool TextRenderer::LoadFont(float scale) {
   return !fonts.empty();
 }
 
-uint64_t TextRenderer::GetCacheKey(const char *text, TextStyle style) {
+static int VariantKey(TextStyle style, uint8_t emphasis, bool fallback) {
+  return ((int)style << 3) | (emphasis << 1) | (fallback ? 1 : 0);
+}
+
+// Bold and italic faces are only opened once a chapter uses them. Inter's
+// own Bold/Italic files are used when installed; otherwise (and always for
+// the CJK fallback) FreeType emboldens/slants the regular face.
+TTF_Font *TextRenderer::GetVariant(TextStyle style, uint8_t emphasis,
+                                   bool fallback) {
+  int key = VariantKey(style, emphasis, fallback);
+  auto it = variantFonts.find(key);
+  if (it != variantFonts.end())
+    return it->second;
+
+  int size = fontSizes[(int)style];
+  TTF_Font *font = nullptr;
+  if (!fallback) {
+    const char *path = emphasis == TEXT_BOLD     ? "fonts/Inter-Bold.ttf"
+                       : emphasis == TEXT_ITALIC ? "fonts/Inter-Italic.ttf"
+                                                 : "fonts/Inter-BoldItalic.ttf";
+    font = OpenFont(path, size);
+  }
+  if (!font) {
+    font = OpenFont(fallback ? "fonts/DroidSansFallback.ttf"
+                                 : "fonts/Inter-Regular.ttf",
+                        size);
+    if (font) {
+      TTF_SetFontStyle(font, ((emphasis & TEXT_BOLD) ? TTF_STYLE_BOLD : 0) |
+                                 ((emphasis & TEXT_ITALIC) ? TTF_STYLE_ITALIC
+                                                           : 0));
+    }
+  }
+  if (!font) {
+    DebugLogger::Log("Failed loading font variant %d/%d: %s", (int)style,
+                     emphasis, TTF_GetError());
+  }
+  variantFonts[key] = font;
+  return font;
+}
+
+TTF_Font *TextRenderer::GetFont(const char *text, int len, TextStyle style,
+                                uint8_t emphasis, int *face) {
+  TTF_Font *font = nullptr;
+  bool fallback = false;
+  if (currentMode == FontMode::INTER_ONLY) {
+    font = fonts[style];
+  } else if (currentMode == FontMode::FALLBACK_ONLY) {
+    fallback = fallbackFonts[style] != nullptr;
+    font = fallback ? fallbackFonts[style] : fonts[style];
+  } else {
+    font = fonts[style];
+    if (HasWideChars(text, len) && fallbackFonts[style]) {
+      font = fallbackFonts[style];
+      fallback = true;
+    }
+  }
+
+  uint8_t used = 0;
+  if (font && emphasis) {
+    TTF_Font *variant = GetVariant(style, emphasis, fallback);
+    if (variant) {
+      font = variant;
+      used = emphasis;
+    }
+  }
+  if (face)
+    *face = VariantKey(style, used, fallback);
+  return font;
+}
+
+TextRenderer::GlyphTable *TextRenderer::GetGlyphTable(const char *text,
+                                                      int len, TextStyle style,
+                                                      uint8_t emphasis) {
+  int face;
+  TTF_Font *font = GetFont(text, len, style, emphasis, &face);
+  if (!font)
+    return nullptr;
+  auto it = glyphTables.find(face);
+  if (it != glyphTables.end())
+    return &it->second;
+
+  GlyphTable &table = glyphTables[face];
+  table.font = font;
+  GlyphMetrics unknown = {GLYPH_UNKNOWN, 0, 0};
+  table.dense.assign(GLYPH_DENSE_COUNT, unknown);
+  table.asciiKerning.assign(GLYPH_KERN_COUNT * GLYPH_KERN_COUNT,
+                            KERN_UNKNOWN);
+  return &table;
+}
+
+const TextRenderer::GlyphMetrics &TextRenderer::Glyph(GlyphTable &table,
+                                                      uint32_t cp) {
+  GlyphMetrics *glyph;
+  if (cp < GLYPH_DENSE_COUNT) {
+    glyph = &table.dense[cp];
+    if (glyph->advance != GLYPH_UNKNOWN)
+      return *glyph;
+  } else {
+    auto it = table.wide.find(cp);
+    if (it != table.wide.end())
+      return it->second;
+    glyph = &table.wide[cp];
+  }
+  int minx, maxx, miny, maxy, advance;
+  if (TTF_GlyphMetrics32(table.font, cp, &minx, &maxx, &miny, &maxy,
+                         &advance) != 0) {
+    minx = maxx = advance = 0;
+  }
+  glyph->advance = (int16_t)advance;
+  glyph->minx = (int16_t)minx;
+  glyph->maxx = (int16_t)maxx;
+  return *glyph;
+}
+
+int TextRenderer::Kerning(GlyphTable &table, uint32_t prev, uint32_t cp) {
+  int8_t *kern;
+  if (prev - GLYPH_KERN_FIRST < GLYPH_KERN_COUNT &&
+      cp - GLYPH_KERN_FIRST < GLYPH_KERN_COUNT) {
+    kern = &table.asciiKerning[(prev - GLYPH_KERN_FIRST) * GLYPH_KERN_COUNT +
+                               cp - GLYPH_KERN_FIRST];
+    if (*kern != KERN_UNKNOWN)
+      return *kern;
+  } else {
+    uint64_t pair = ((uint64_t)prev << 32) | cp;
+    auto it = table.kerning.find(pair);
+    if (it != table.kerning.end())
+      return it->second;
+    kern = &table.kerning[pair];
+  }
+  int k = TTF_GetFontKerningSizeGlyphs32(table.font, prev, cp);
+  *kern = (int8_t)std::min(std::max(k, -127), 127);
+  return *kern;
+}
+
+// TTF_SizeUTF8's width: from the leftmost ink (or the pen's start) to the
+// furthest of the last advance and the rightmost ink
+int TextRenderer::SumAdvances(GlyphTable &table, const char *text, int len) {
+  const uint8_t *s = (const uint8_t *)text;
+  int x = 0, minx = 0, maxx = 0;
+  uint32_t prev = 0;
+  for (int i = 0; i < len;) {
+    uint32_t cp;
+    int n = DecodeUtf8(s + i, len - i, &cp);
+    if (n == 0) { // Cut off mid-sequence
+      cp = UTF8_REPLACEMENT;
+      n = len - i;
+    }
+    i += n;
+    if (cp == 0xFEFF || cp == 0xFFFE) // SDL_ttf skips byte order marks
+      continue;
+    const GlyphMetrics &glyph = Glyph(table, cp);
+    if (prev)
+      x += Kerning(table, prev, cp);
+    minx = std::min(minx, x + glyph.minx);
+    maxx = std::max(maxx, x + std::max((int)glyph.advance, (int)glyph.maxx));
+    x += glyph.advance;
+    prev = cp;
+  }
+  return maxx - minx;
+}
+
+uint64_t TextRenderer::GetCacheKey(const char *text, TextStyle style,
+                                   uint8_t emphasis) {
   uint64_t hash = 14695981039346656037ULL;
-  hash ^= (uint64_t)style;
+  hash ^= (uint64_t)style | ((uint64_t)emphasis << 8);
   hash *= 1099511628211ULL;
   hash ^= (uint64_t)currentMode;
   hash *= 1099511628211ULL;
@@ -137,28 +331,18 @@ uint64_t TextRenderer::GetCacheKey(const char *text, TextStyle style) {
 }
 
 void TextRenderer::RenderText(const char *text, int x, int y, uint32_t color,
-                              TextStyle style, float angle) {
-  RenderTextWithKey(text, GetCacheKey(text, style), x, y, color, style, angle);
+                              TextStyle style, float angle, uint8_t emphasis) {
+  RenderTextWithKey(text, GetCacheKey(text, style, emphasis), x, y, color,
+                    style, angle, emphasis);
 }
 
 void TextRenderer::RenderTextWithKey(const char *text, uint64_t key, int x,
                                      int y, uint32_t color, TextStyle style,
-                                     float angle) {
+                                     float angle, uint8_t emphasis) {
   if (!renderer || !text || text[0] == '\0')
     return;
 
-  TTF_Font *font = nullptr;
-  if (currentMode == FontMode::INTER_ONLY) {
-    font = fonts[style];
-  } else if (currentMode == FontMode::FALLBACK_ONLY) {
-    font = fallbackFonts[style] ? fallbackFonts[style] : fonts[style];
-  } else {
-    font = fonts[style];
-    if (HasWideChars(text) && fallbackFonts[style]) {
-      font = fallbackFonts[style];
-    }
-  }
-
+  TTF_Font *font = GetFont(text, (int)strlen(text), style, emphasis);
   if (!font)
     return;
 
@@ -220,30 +404,44 @@ void TextRenderer::RenderTextWithKey(const char *text, uint64_t key, int x,
 }
 
 void TextRenderer::RenderTextCentered(const char *text, int y, uint32_t color,
-                                      TextStyle style, float angle) {
-  RenderTextCenteredWithKey(text, GetCacheKey(text, style), y, color, style,
-                            angle);
+                                      TextStyle style, float angle,
+                                      uint8_t emphasis) {
+  RenderTextCenteredWithKey(text, GetCacheKey(text, style, emphasis), y, color,
+                            style, angle, emphasis);
 }
 
 void TextRenderer::RenderTextCenteredWithKey(const char *text, uint64_t key,
                                              int y, uint32_t color,
-                                             TextStyle style, float angle) {
-  int width = MeasureTextWidthWithKey(text, key, style);
+                                             TextStyle style, float angle,
+                                             uint8_t emphasis) {
+  int width = MeasureTextWidthWithKey(text, key, style, emphasis);
   if (angle != 0.0f) {
     int tx = (272 - width) / 2;
-    RenderTextWithKey(text, key, 480 - y, tx, color, style, angle);
+    RenderTextWithKey(text, key, 480 - y, tx, color, style, angle, emphasis);
   } else {
     int x = (480 - width) / 2;
-    RenderTextWithKey(text, key, x, y, color, style, 0.0f);
+    RenderTextWithKey(text, key, x, y, color, style, 0.0f, emphasis);
   }
 }
 
-int TextRenderer::MeasureTextWidth(const char *text, TextStyle style) {
-  return MeasureTextWidthWithKey(text, GetCacheKey(text, style), style);
+int TextRenderer::MeasureTextWidth(const char *text, TextStyle style,
+                                   uint8_t emphasis) {
+  return MeasureTextWidthWithKey(text, GetCacheKey(text, style, emphasis),
+                                 style, emphasis);
+}
+
+int TextRenderer::MeasureWordWidth(const char *text, int len, TextStyle style,
+                                   uint8_t emphasis) {
+  if (len <= 0)
+    return 0;
+  GlyphTable *table = GetGlyphTable(text, len, style, emphasis);
+  if (!table)
+    return 0;
+  return SumAdvances(*table, text, len);
 }
 
 int TextRenderer::MeasureTextWidthWithKey(const char *text, uint64_t key,
-                                          TextStyle style) {
+                                          TextStyle style, uint8_t emphasis) {
   if (!text || text[0] == '\0')
     return 0;
 
@@ -256,36 +454,23 @@ int TextRenderer::MeasureTextWidthWithKey(const char *text, uint64_t key,
     return it->second.width;
   }
 
-  TTF_Font *font = nullptr;
-  if (currentMode == FontMode::INTER_ONLY) {
-    font = fonts[style];
-  } else if (currentMode == FontMode::FALLBACK_ONLY) {
-    font = fallbackFonts[style] ? fallbackFonts[style] : fonts[style];
-  } else {
-    font = fonts[style];
-    if (HasWideChars(text) && fallbackFonts[style]) {
-      font = fallbackFonts[style];
-    }
-  }
-
-  if (!font)
+  int len = (int)strlen(text);
+  GlyphTable *table = GetGlyphTable(text, len, style, emphasis);
+  if (!table)
     return 0;
-
-  int w, h;
-  if (TTF_SizeUTF8(font, text, &w, &h) == 0) {
-    // Evict if metrics cache full
-    if (metricsCache.size() >= MAX_METRICS_CACHE_SIZE &&
-        !metricsLruList.empty()) {
-      uint64_t oldKey = metricsLruList.front();
-      metricsLruList.pop_front();
-      metricsCache.erase(oldKey);
-    }
-
-    metricsLruList.push_back(key);
-    metricsCache[key] = {w, std::prev(metricsLruList.end())};
-    return w;
+  int w = SumAdvances(*table, text, len);
+
+  // Evict if metrics cache full
+  if (metricsCache.size() >= MAX_METRICS_CACHE_SIZE &&
+      !metricsLruList.empty()) {
+    uint64_t oldKey = metricsLruList.front();
+    metricsLruList.pop_front();
+    metricsCache.erase(oldKey);
   }
-  return 0;
+
+  metricsLruList.push_back(key);
+  metricsCache[key] = {w, std::prev(metricsLruList.end())};
+  return w;
 }
 
 int TextRenderer::GetLineHeight(TextStyle style) {
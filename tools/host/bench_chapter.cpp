@@ -0,0 +1,113 @@
+// Chapter open cost, tokenizing in place over the inflated text against
+// copying words out of a separate block (what every chapter did before, and
+// what one too big for wordBuffer still does). Per spine item: time to the
+// first slice (what a chapter turn waits for) and to the whole chapter. The
+// memory is the fixed ChapterBuffer plus what an open allocates: the staged
+// input and decoder state of a deflated entry.
+//
+//   make bench-chapter [BOOKS="a.epub b.epub"] [RUNS=20]
+
+#include "chapter_prefetcher.h"
+#include "perf_timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct Timing {
+  uint64_t firstUs; // Best of the runs
+  uint64_t fullUs;
+  size_t peakBytes; // Stream heap: staged input and decoder state
+  int words;
+  bool inPlace;
+};
+
+static ChapterBuffer buffer;
+
+static bool TimeChapter(EpubReader &reader, int chapter, bool copy, int runs,
+                        Timing *t) {
+  InflateBackend *inflate = reader.GetInflateBackend();
+  t->firstUs = t->fullUs = UINT64_MAX;
+  t->peakBytes = 0;
+  for (int r = 0; r < runs; r++) {
+    // Load() picks the mode; the copying one is forced the way an overflow
+    // forces it
+    buffer.Close();
+    buffer.copyChapter = copy ? chapter : -1;
+    inflate->ResetStats();
+
+    uint64_t startUs = PerfNowUs();
+    if (!buffer.Load(reader, chapter))
+      return false;
+    buffer.Pump(1, CHAPTER_SLICE_SIZE);
+    uint64_t firstUs = PerfNowUs() - startUs;
+    while (buffer.IsLoaded() && !buffer.IsComplete()) {
+      if (buffer.IsStalled())
+        buffer.Discard(buffer.WordCount());
+      buffer.Pump(1);
+    }
+    uint64_t fullUs = PerfNowUs() - startUs;
+    if (!buffer.IsLoaded())
+      return false;
+
+    t->firstUs = std::min(t->firstUs, firstUs);
+    t->fullUs = std::min(t->fullUs, fullUs);
+    t->words = buffer.WindowEnd();
+    t->inPlace = buffer.inPlace;
+  }
+  // Peak decoder state plus the staging block, for a deflated entry
+  if (inflate->GetStats().entries > 0)
+    t->peakBytes = inflate->GetStats().peakBytes + INFLATE_INPUT_SIZE;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s runs book.epub...\n", argv[0]);
+    return 2;
+  }
+  int runs = std::max(1, atoi(argv[1]));
+  printf("ChapterBuffer: %zu KB, fixed\n", sizeof(ChapterBuffer) / 1024);
+
+  int failed = 0;
+  for (int b = 2; b < argc; b++) {
+    EpubReader reader;
+    if (!reader.Open(argv[b])) {
+      printf("%s: open failed\n", argv[b]);
+      failed++;
+      continue;
+    }
+    const EpubMetadata &meta = reader.GetMetadata();
+    printf("%s (microseconds, best of %d)\n", argv[b], runs);
+    printf("  item     size   words   first slice     whole chapter\n");
+    printf("                          copy in place   copy in place\n");
+    uint64_t total[2] = {0, 0};
+    size_t peakBytes = 0;
+    for (int c = 0; c < (int)meta.spine.size(); c++) {
+      Timing copy, inPlace;
+      if (!TimeChapter(reader, c, true, runs, &copy) ||
+          !TimeChapter(reader, c, false, runs, &inPlace)) {
+        printf("  %4d  can't be read\n", c);
+        failed++;
+        continue;
+      }
+      total[0] += copy.fullUs;
+      total[1] += inPlace.fullUs;
+      peakBytes = std::max(peakBytes, std::max(copy.peakBytes,
+                                               inPlace.peakBytes));
+      printf("  %4d %7uK %7d %6llu %6llu %7llu %7llu%s\n", c,
+             (unsigned)((meta.spine[c].uncompSize + 1023) / 1024),
+             inPlace.words, (unsigned long long)copy.firstUs,
+             (unsigned long long)inPlace.firstUs,
+             (unsigned long long)copy.fullUs,
+             (unsigned long long)inPlace.fullUs,
+             inPlace.inPlace ? "" : "  (too big: copies)");
+    }
+    printf("  whole book: copy %llu us, in place %llu us; peak open heap "
+           "%zu KB\n",
+           (unsigned long long)total[0], (unsigned long long)total[1],
+           (peakBytes + 1023) / 1024);
+    reader.Close();
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// Inflate backends compared over every deflated entry of a directory of
+// books, decoded the way ChapterStream does: INFLATE_INPUT_SIZE compressed
+// bytes staged at a time into CHAPTER_BLOCK_SIZE output blocks. Reports the
+// decoders' throughput and peak state per backend and checks each entry's
+// CRC-32.
+//
+//   make bench-inflate [EPUB_DIR=dir] [RUNS=20]
+
+#include "chapter_prefetcher.h"
+#include "inflate_backend.h"
+#include "miniz.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+struct Entry {
+  std::vector<uint8_t> data; // As stored in the archive
+  uint32_t uncompSize;
+  uint32_t crc;
+};
+
+// The book's deflated entries, read raw
+static bool LoadEntries(const char *path, std::vector<Entry> &entries) {
+  mz_zip_archive zip;
+  memset(&zip, 0, sizeof(zip));
+  if (!mz_zip_reader_init_file(&zip, path, 0))
+    return false;
+  for (mz_uint i = 0; i < mz_zip_reader_get_num_files(&zip); i++) {
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(&zip, i, &stat) ||
+        stat.m_method != MZ_DEFLATED || stat.m_is_encrypted)
+      continue;
+    Entry entry;
+    entry.data.resize(stat.m_comp_size > 0 ? stat.m_comp_size : 1);
+    entry.uncompSize = (uint32_t)stat.m_uncomp_size;
+    entry.crc = stat.m_crc32;
+    if (!mz_zip_reader_extract_to_mem(&zip, i, entry.data.data(),
+                                      stat.m_comp_size,
+                                      MZ_ZIP_FLAG_COMPRESSED_DATA))
+      continue;
+    entry.data.resize(stat.m_comp_size);
+    entries.push_back(std::move(entry));
+  }
+  mz_zip_reader_end(&zip);
+  return true;
+}
+
+// One entry through a fresh decoder; false if it doesn't come out whole
+static bool Decode(InflateBackend &backend, const Entry &entry) {
+  static uint8_t out[CHAPTER_BLOCK_SIZE];
+  Inflater *inflater = backend.Create();
+  if (!inflater)
+    return false;
+
+  const uint8_t *in = entry.data.data();
+  size_t compSize = entry.data.size();
+  size_t inPos = 0;
+  uint32_t produced = 0;
+  mz_ulong crc = MZ_CRC32_INIT;
+  InflateResult result = InflateResult::OK;
+  while (result == InflateResult::OK && produced < entry.uncompSize) {
+    size_t stage = std::min<size_t>(compSize - inPos, INFLATE_INPUT_SIZE);
+    size_t inBytes = stage;
+    size_t outBytes =
+        std::min<size_t>(entry.uncompSize - produced, sizeof(out));
+    result = inflater->Run(in + inPos, &inBytes, out, &outBytes,
+                           inPos + stage < compSize);
+    inPos += inBytes;
+    produced += (uint32_t)outBytes;
+    crc = mz_crc32(crc, out, outBytes);
+    if (inBytes == 0 && outBytes == 0)
+      break;
+  }
+  delete inflater;
+  return produced == entry.uncompSize && crc == entry.crc;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s runs epub-dir\n", argv[0]);
+    return 2;
+  }
+  int runs = std::max(1, atoi(argv[1]));
+
+  std::vector<std::string> books;
+  DIR *dir = opendir(argv[2]);
+  if (!dir) {
+    fprintf(stderr, "%s: can't open\n", argv[2]);
+    return 2;
+  }
+  while (struct dirent *e = readdir(dir)) {
+    size_t len = strlen(e->d_name);
+    if (len > 5 && strcmp(e->d_name + len - 5, ".epub") == 0)
+      books.push_back(std::string(argv[2]) + "/" + e->d_name);
+  }
+  closedir(dir);
+  std::sort(books.begin(), books.end());
+
+  std::vector<Entry> entries;
+  for (const std::string &book : books) {
+    if (!LoadEntries(book.c_str(), entries))
+      fprintf(stderr, "%s: not a zip archive\n", book.c_str());
+  }
+  if (entries.empty()) {
+    fprintf(stderr, "%s: no deflated entries\n", argv[2]);
+    return 2;
+  }
+
+  TinflInflateBackend tinfl;
+  ZlibInflateBackend zlib;
+  InflateBackend *backends[] = {&tinfl, &zlib};
+  int failed = 0;
+  printf("%zu books, %zu deflated entries, %d runs\n", books.size(),
+         entries.size(), runs);
+  for (InflateBackend *backend : backends) {
+    backend->ResetStats();
+    int bad = 0;
+    for (int r = 0; r < runs; r++) {
+      for (const Entry &entry : entries)
+        bad += Decode(*backend, entry) ? 0 : 1;
+    }
+    const InflateStats &st = backend->GetStats();
+    // bytes per us == MB/s
+    printf("%-6s %8.1f MB/s  %6u KB -> %6u KB per run  peak state %u KB%s\n",
+           backend->GetName(),
+           (double)st.bytesOut / std::max<uint64_t>(st.timeUs, 1),
+           (uint32_t)(st.bytesIn / runs / 1024),
+           (uint32_t)(st.bytesOut / runs / 1024),
+           (uint32_t)((st.peakBytes + 1023) / 1024),
+           bad ? "  CRC/size MISMATCH" : "");
+    failed += bad;
+  }
+  return failed ? 1 : 0;
+}
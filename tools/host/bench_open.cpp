@@ -0,0 +1,73 @@
+// Book open latency, cold vs. warm. A cold open parses container.xml, the
+// OPF and the NCX and writes the <book>.idx sidecar; a warm one reads the
+// sidecar back instead.
+//
+//   make bench-open [BOOKS="a.epub b.epub"] [RUNS=20]
+
+#include "epub_reader.h"
+#include "perf_timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct Timing {
+  uint64_t minUs;
+  uint64_t medianUs;
+};
+
+static Timing Summarize(std::vector<uint64_t> &samples) {
+  std::sort(samples.begin(), samples.end());
+  Timing t = {samples.front(), samples[samples.size() / 2]};
+  return t;
+}
+
+// One open; cold ones start without a sidecar
+static bool TimeOpen(const char *path, bool cold, uint64_t *us) {
+  std::string indexPath = std::string(path) + ".idx";
+  if (cold)
+    remove(indexPath.c_str());
+  EpubReader reader;
+  uint64_t startUs = PerfNowUs();
+  bool ok = reader.Open(path);
+  *us = PerfNowUs() - startUs;
+  reader.Close();
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s runs book.epub...\n", argv[0]);
+    return 2;
+  }
+  int runs = std::max(1, atoi(argv[1]));
+
+  int failed = 0;
+  for (int b = 2; b < argc; b++) {
+    const char *path = argv[b];
+    std::vector<uint64_t> cold, warm;
+    bool ok = true;
+    for (int i = 0; i < runs && ok; i++) {
+      uint64_t us;
+      ok = TimeOpen(path, true, &us);
+      cold.push_back(us);
+      ok = ok && TimeOpen(path, false, &us);
+      warm.push_back(us);
+    }
+    remove((std::string(path) + ".idx").c_str());
+    if (!ok) {
+      printf("%s: open failed\n", path);
+      failed++;
+      continue;
+    }
+
+    Timing c = Summarize(cold);
+    Timing w = Summarize(warm);
+    printf("%s: cold %llu us (min %llu), warm %llu us (min %llu), %.1fx\n",
+           path, (unsigned long long)c.medianUs, (unsigned long long)c.minUs,
+           (unsigned long long)w.medianUs, (unsigned long long)w.minUs,
+           (double)c.medianUs / std::max<uint64_t>(w.medianUs, 1));
+  }
+  return failed ? 1 : 0;
+}
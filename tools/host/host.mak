@@ -0,0 +1,118 @@
+# Host (Linux) builds of the benchmarks and tests in tools/host, included by
+# the top-level Makefile for the goals below instead of the PSP SDK's
+# build.mak. They compile the reader's own sources with the host compiler;
+# SDL comes from the shim in tools/host/shim unless HOST_SDL=system, which
+# links the installed SDL2 instead.
+
+HOST_CC ?= gcc
+HOST_CXX ?= g++
+HOST_DIR = _host
+HOST_SDL ?= shim
+
+HOST_INC = -Iinclude -Ilib/pugixml -Ilib/miniz
+HOST_LIBS = -lz -lpthread
+ifeq ($(HOST_SDL),system)
+HOST_INC += $(shell pkg-config --cflags sdl2 SDL2_ttf)
+HOST_LIBS += $(shell pkg-config --libs sdl2 SDL2_ttf)
+HOST_SHIM =
+else
+HOST_INC += -Itools/host/shim
+HOST_SHIM = tools/host/shim/sdl_shim.cpp
+# SDL_ttf, for the tests that measure text, over the installed FreeType
+HOST_TTF_SHIM = tools/host/shim/ttf_shim.cpp
+HOST_INC += $(shell pkg-config --cflags freetype2)
+HOST_TTF_LIBS = $(shell pkg-config --libs freetype2)
+endif
+
+HOST_CFLAGS = -O2 -g $(HOST_INC)
+HOST_CXXFLAGS = $(HOST_CFLAGS) -std=gnu++17 -Wall
+
+HOST_READER = src/epub/epub_reader.cpp src/epub/zip_io.cpp \
+	src/epub/inflate_backend.cpp src/epub/async_read.cpp \
+	src/epub/href_resolver.cpp src/parser/css_rules.cpp \
+	src/parser/anchor_index.cpp src/core/bump_arena.cpp \
+	src/core/debug_logger.cpp lib/pugixml/pugixml.cpp lib/miniz/miniz.c \
+	$(HOST_SHIM)
+
+# The tokenizer on top
+HOST_PARSER = src/parser/chapter_prefetcher.cpp src/parser/chapter_cache.cpp \
+	src/parser/html_text_extractor.cpp src/parser/line_break.cpp \
+	src/parser/html_entities.cpp src/parser/token_table.cpp
+
+host_objs = $(addprefix $(HOST_DIR)/,$(addsuffix .o,$(basename $(1))))
+
+BOOKS ?= epub-with-cyrillic.epub
+EPUB_DIR ?= .
+RUNS ?= 20
+
+.PHONY: bench-open bench-inflate bench-chapter test-glyphs test-window \
+	stress-layout host-clean
+
+bench-open: $(HOST_DIR)/bench_open
+	$(HOST_DIR)/bench_open $(RUNS) $(BOOKS)
+
+$(HOST_DIR)/bench_open: $(call host_objs,tools/host/bench_open.cpp $(HOST_READER))
+	$(HOST_CXX) -o $@ $^ $(HOST_LIBS)
+
+bench-inflate: $(HOST_DIR)/bench_inflate
+	$(HOST_DIR)/bench_inflate $(RUNS) $(EPUB_DIR)
+
+$(HOST_DIR)/bench_inflate: $(call host_objs,tools/host/bench_inflate.cpp \
+		src/epub/inflate_backend.cpp src/core/debug_logger.cpp \
+		lib/miniz/miniz.c)
+	$(HOST_CXX) -o $@ $^ $(HOST_LIBS)
+
+bench-chapter: $(HOST_DIR)/bench_chapter
+	$(HOST_DIR)/bench_chapter $(RUNS) $(BOOKS)
+
+$(HOST_DIR)/bench_chapter: $(call host_objs,tools/host/bench_chapter.cpp \
+		$(HOST_PARSER) $(HOST_READER))
+	$(HOST_CXX) -o $@ $^ $(HOST_LIBS)
+
+test-glyphs: $(HOST_DIR)/test_glyphs
+	$(HOST_DIR)/test_glyphs $(BOOKS)
+
+$(HOST_DIR)/test_glyphs: $(call host_objs,tools/host/test_glyphs.cpp \
+		src/renderer/text_renderer.cpp $(HOST_TTF_SHIM) $(HOST_PARSER) \
+		$(HOST_READER))
+	$(HOST_CXX) -o $@ $^ $(HOST_LIBS) $(HOST_TTF_LIBS)
+
+test-window: $(HOST_DIR)/test_window
+	$(HOST_DIR)/test_window
+
+$(HOST_DIR)/test_window: $(call host_objs,tools/host/test_window.cpp \
+		$(HOST_PARSER) $(HOST_READER))
+	$(HOST_CXX) -o $@ $^ $(HOST_LIBS)
+
+# Built with ThreadSanitizer, which stops at the first data race
+HOST_TSAN = -fsanitize=thread
+SEED ?= 1
+
+stress-layout: $(HOST_DIR)/tsan/stress_layout
+	SEED=$(SEED) TSAN_OPTIONS=halt_on_error=1 \
+		$(HOST_DIR)/tsan/stress_layout $(RUNS) $(BOOKS)
+
+$(HOST_DIR)/tsan/stress_layout: $(addprefix $(HOST_DIR)/tsan/,$(addsuffix .o,\
+		$(basename tools/host/stress_layout.cpp src/core/layout_worker.cpp \
+		src/renderer/text_renderer.cpp $(HOST_TTF_SHIM) $(HOST_PARSER) \
+		$(HOST_READER))))
+	$(HOST_CXX) $(HOST_TSAN) -o $@ $^ $(HOST_LIBS) $(HOST_TTF_LIBS)
+
+$(HOST_DIR)/tsan/%.o: %.cpp
+	@mkdir -p $(dir $@)
+	$(HOST_CXX) $(HOST_CXXFLAGS) $(HOST_TSAN) -c $< -o $@
+
+$(HOST_DIR)/tsan/%.o: %.c
+	@mkdir -p $(dir $@)
+	$(HOST_CC) $(HOST_CFLAGS) $(HOST_TSAN) -c $< -o $@
+
+$(HOST_DIR)/%.o: %.cpp
+	@mkdir -p $(dir $@)
+	$(HOST_CXX) $(HOST_CXXFLAGS) -c $< -o $@
+
+$(HOST_DIR)/%.o: %.c
+	@mkdir -p $(dir $@)
+	$(HOST_CC) $(HOST_CFLAGS) -c $< -o $@
+
+host-clean:
+	rm -rf $(HOST_DIR)
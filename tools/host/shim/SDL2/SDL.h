@@ -0,0 +1,74 @@
+#pragma once
+
+// The part of SDL2 the reader's non-UI sources use, for host builds of the
+// benchmarks and tests without SDL installed. Threads, mutexes and condition
+// variables are pthreads; drawing calls do nothing.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t Uint8;
+typedef uint32_t Uint32;
+
+typedef struct SDL_Renderer SDL_Renderer;
+typedef struct SDL_Texture SDL_Texture;
+typedef struct SDL_Thread SDL_Thread;
+typedef struct SDL_mutex SDL_mutex;
+typedef struct SDL_cond SDL_cond;
+
+typedef struct SDL_Surface {
+  int w, h;
+  void *pixels;
+} SDL_Surface;
+
+typedef struct SDL_Color {
+  Uint8 r, g, b, a;
+} SDL_Color;
+
+typedef struct SDL_Rect {
+  int x, y, w, h;
+} SDL_Rect;
+
+typedef struct SDL_Point {
+  int x, y;
+} SDL_Point;
+
+typedef enum { SDL_FLIP_NONE = 0 } SDL_RendererFlip;
+
+typedef enum {
+  SDL_THREAD_PRIORITY_LOW,
+  SDL_THREAD_PRIORITY_NORMAL,
+  SDL_THREAD_PRIORITY_HIGH
+} SDL_ThreadPriority;
+
+typedef int (*SDL_ThreadFunction)(void *data);
+
+const char *SDL_GetError(void);
+
+SDL_Thread *SDL_CreateThread(SDL_ThreadFunction fn, const char *name,
+                             void *data);
+void SDL_WaitThread(SDL_Thread *thread, int *status);
+int SDL_SetThreadPriority(SDL_ThreadPriority priority);
+
+SDL_mutex *SDL_CreateMutex(void);
+void SDL_DestroyMutex(SDL_mutex *mutex);
+int SDL_LockMutex(SDL_mutex *mutex);
+int SDL_UnlockMutex(SDL_mutex *mutex);
+
+SDL_cond *SDL_CreateCond(void);
+void SDL_DestroyCond(SDL_cond *cond);
+int SDL_CondSignal(SDL_cond *cond);
+int SDL_CondBroadcast(SDL_cond *cond);
+int SDL_CondWait(SDL_cond *cond, SDL_mutex *mutex);
+
+SDL_Texture *SDL_CreateTextureFromSurface(SDL_Renderer *renderer,
+                                          SDL_Surface *surface);
+void SDL_DestroyTexture(SDL_Texture *texture);
+void SDL_FreeSurface(SDL_Surface *surface);
+int SDL_SetTextureColorMod(SDL_Texture *texture, Uint8 r, Uint8 g, Uint8 b);
+int SDL_SetTextureAlphaMod(SDL_Texture *texture, Uint8 alpha);
+int SDL_RenderCopy(SDL_Renderer *renderer, SDL_Texture *texture,
+                   const SDL_Rect *src, const SDL_Rect *dst);
+int SDL_RenderCopyEx(SDL_Renderer *renderer, SDL_Texture *texture,
+                     const SDL_Rect *src, const SDL_Rect *dst, double angle,
+                     const SDL_Point *center, SDL_RendererFlip flip);
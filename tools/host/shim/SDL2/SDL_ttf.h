@@ -0,0 +1,29 @@
+#pragma once
+
+// The part of SDL_ttf the text renderer uses, for host builds without it
+// installed
+
+#include <SDL2/SDL.h>
+
+typedef struct _TTF_Font TTF_Font;
+
+#define TTF_STYLE_NORMAL 0x00
+#define TTF_STYLE_BOLD 0x01
+#define TTF_STYLE_ITALIC 0x02
+
+int TTF_Init(void);
+void TTF_Quit(void);
+const char *TTF_GetError(void);
+
+TTF_Font *TTF_OpenFont(const char *file, int ptsize);
+void TTF_CloseFont(TTF_Font *font);
+void TTF_SetFontStyle(TTF_Font *font, int style);
+int TTF_FontHeight(const TTF_Font *font);
+
+int TTF_GlyphMetrics32(TTF_Font *font, Uint32 ch, int *minx, int *maxx,
+                       int *miny, int *maxy, int *advance);
+int TTF_GetFontKerningSizeGlyphs32(TTF_Font *font, Uint32 previous_ch,
+                                   Uint32 ch);
+int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h);
+SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *font, const char *text,
+                                    SDL_Color fg);
@@ -0,0 +1,115 @@
+#include <SDL2/SDL.h>
+#include <pthread.h>
+
+struct SDL_Thread {
+  pthread_t handle;
+  SDL_ThreadFunction fn;
+  void *data;
+  int status;
+};
+
+struct SDL_mutex {
+  pthread_mutex_t handle;
+};
+
+struct SDL_cond {
+  pthread_cond_t handle;
+};
+
+static void *ThreadMain(void *arg) {
+  SDL_Thread *thread = (SDL_Thread *)arg;
+  thread->status = thread->fn(thread->data);
+  return nullptr;
+}
+
+const char *SDL_GetError(void) { return "host shim"; }
+
+SDL_Thread *SDL_CreateThread(SDL_ThreadFunction fn, const char *,
+                             void *data) {
+  SDL_Thread *thread = new SDL_Thread;
+  thread->fn = fn;
+  thread->data = data;
+  thread->status = 0;
+  if (pthread_create(&thread->handle, nullptr, ThreadMain, thread) != 0) {
+    delete thread;
+    return nullptr;
+  }
+  return thread;
+}
+
+void SDL_WaitThread(SDL_Thread *thread, int *status) {
+  if (!thread)
+    return;
+  pthread_join(thread->handle, nullptr);
+  if (status)
+    *status = thread->status;
+  delete thread;
+}
+
+// Host threads all share the default policy; priorities only matter on the
+// PSP's single core
+int SDL_SetThreadPriority(SDL_ThreadPriority) { return 0; }
+
+SDL_mutex *SDL_CreateMutex(void) {
+  SDL_mutex *mutex = new SDL_mutex;
+  pthread_mutex_init(&mutex->handle, nullptr);
+  return mutex;
+}
+
+void SDL_DestroyMutex(SDL_mutex *mutex) {
+  if (!mutex)
+    return;
+  pthread_mutex_destroy(&mutex->handle);
+  delete mutex;
+}
+
+int SDL_LockMutex(SDL_mutex *mutex) {
+  return pthread_mutex_lock(&mutex->handle);
+}
+
+int SDL_UnlockMutex(SDL_mutex *mutex) {
+  return pthread_mutex_unlock(&mutex->handle);
+}
+
+SDL_cond *SDL_CreateCond(void) {
+  SDL_cond *cond = new SDL_cond;
+  pthread_cond_init(&cond->handle, nullptr);
+  return cond;
+}
+
+void SDL_DestroyCond(SDL_cond *cond) {
+  if (!cond)
+    return;
+  pthread_cond_destroy(&cond->handle);
+  delete cond;
+}
+
+int SDL_CondSignal(SDL_cond *cond) {
+  return pthread_cond_signal(&cond->handle);
+}
+
+int SDL_CondBroadcast(SDL_cond *cond) {
+  return pthread_cond_broadcast(&cond->handle);
+}
+
+int SDL_CondWait(SDL_cond *cond, SDL_mutex *mutex) {
+  return pthread_cond_wait(&cond->handle, &mutex->handle);
+}
+
+// Nothing is drawn on the host
+SDL_Texture *SDL_CreateTextureFromSurface(SDL_Renderer *, SDL_Surface *) {
+  return nullptr;
+}
+void SDL_DestroyTexture(SDL_Texture *) {}
+void SDL_FreeSurface(SDL_Surface *) {}
+int SDL_SetTextureColorMod(SDL_Texture *, Uint8, Uint8, Uint8) { return 0; }
+int SDL_SetTextureAlphaMod(SDL_Texture *, Uint8) { return 0; }
+int SDL_RenderCopy(SDL_Renderer *, SDL_Texture *, const SDL_Rect *,
+                   const SDL_Rect *) {
+  return 0;
+}
+int SDL_RenderCopyEx(SDL_Renderer *, SDL_Texture *, const SDL_Rect *,
+                     const SDL_Rect *, double, const SDL_Point *,
+                     SDL_RendererFlip) {
+  return 0;
+}
@@ -0,0 +1,183 @@
+// SDL_ttf over FreeType, for host tests of the text renderer without
+// SDL_ttf installed. Glyphs are loaded and rounded the way SDL_ttf 2.0.15
+// does and TTF_SizeUTF8 is its (non-HarfBuzz) loop, written separately from
+// TextRenderer's glyph tables so the two can be checked against each other.
+// Bold and italic aren't synthesized: a styled face measures as the plain
+// one.
+
+#include <SDL2/SDL_ttf.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <string.h>
+
+struct Glyph {
+  int minx, maxx;
+  int advance;
+};
+
+struct _TTF_Font {
+  FT_Face face;
+  int style;
+  int height;
+};
+
+static FT_Library library;
+static int initCount = 0;
+
+int TTF_Init(void) {
+  if (initCount == 0 && FT_Init_FreeType(&library) != 0)
+    return -1;
+  initCount++;
+  return 0;
+}
+
+void TTF_Quit(void) {
+  if (initCount > 0 && --initCount == 0)
+    FT_Done_FreeType(library);
+}
+
+const char *TTF_GetError(void) { return "FreeType error"; }
+
+TTF_Font *TTF_OpenFont(const char *file, int ptsize) {
+  FT_Face face;
+  if (FT_New_Face(library, file, 0, &face) != 0)
+    return nullptr;
+  if (FT_Set_Char_Size(face, 0, ptsize * 64, 0, 0) != 0) {
+    FT_Done_Face(face);
+    return nullptr;
+  }
+  TTF_Font *font = new TTF_Font;
+  font->face = face;
+  font->style = TTF_STYLE_NORMAL;
+  // Scalable faces: ascent - descent, as SDL_ttf rounds them
+  FT_Fixed scale = face->size->metrics.y_scale;
+  int ascent = (int)((FT_MulFix(face->ascender, scale) + 63) >> 6);
+  int descent = (int)((FT_MulFix(face->descender, scale) + 63) >> 6);
+  font->height = ascent - descent + 1;
+  return font;
+}
+
+void TTF_CloseFont(TTF_Font *font) {
+  if (!font)
+    return;
+  FT_Done_Face(font->face);
+  delete font;
+}
+
+void TTF_SetFontStyle(TTF_Font *font, int style) { font->style = style; }
+
+int TTF_FontHeight(const TTF_Font *font) { return font->height; }
+
+// Metrics of glyph index idx, in whole pixels
+static Glyph LoadGlyph(TTF_Font *font, FT_UInt idx) {
+  Glyph g = {0, 0, 0};
+  if (FT_Load_Glyph(font->face, idx, FT_LOAD_DEFAULT) != 0)
+    return g;
+  const FT_Glyph_Metrics &m = font->face->glyph->metrics;
+  g.minx = (int)(m.horiBearingX & -64) / 64;
+  g.maxx = g.minx + (int)((m.width + 63) & -64) / 64;
+  g.advance = (int)((m.horiAdvance + 63) & -64) / 64;
+  return g;
+}
+
+int TTF_GlyphMetrics32(TTF_Font *font, Uint32 ch, int *minx, int *maxx,
+                       int *miny, int *maxy, int *advance) {
+  Glyph g = LoadGlyph(font, FT_Get_Char_Index(font->face, ch));
+  if (minx)
+    *minx = g.minx;
+  if (maxx)
+    *maxx = g.maxx;
+  if (miny)
+    *miny = 0;
+  if (maxy)
+    *maxy = 0;
+  if (advance)
+    *advance = g.advance;
+  return 0;
+}
+
+int TTF_GetFontKerningSizeGlyphs32(TTF_Font *font, Uint32 previous_ch,
+                                   Uint32 ch) {
+  if (!FT_HAS_KERNING(font->face))
+    return 0;
+  FT_Vector delta;
+  if (FT_Get_Kerning(font->face, FT_Get_Char_Index(font->face, previous_ch),
+                     FT_Get_Char_Index(font->face, ch), FT_KERNING_DEFAULT,
+                     &delta) != 0)
+    return 0;
+  return (int)(delta.x >> 6);
+}
+
+// SDL_ttf's UTF8_getch: a bad lead byte is U+FFFD on its own; a sequence
+// broken by a non-continuation byte, or cut off by the end of the text, is
+// U+FFFD covering what it had, and the breaking byte is read again
+static Uint32 GetChar(const unsigned char **src, size_t *left) {
+  const unsigned char *p = *src;
+  Uint32 ch = 0xFFFD, minimum = 0;
+  int more = 0;
+  if (p[0] < 0x80) {
+    ch = p[0];
+  } else if ((p[0] & 0xE0) == 0xC0) {
+    ch = p[0] & 0x1F;
+    more = 1;
+    minimum = 0x80;
+  } else if ((p[0] & 0xF0) == 0xE0) {
+    ch = p[0] & 0x0F;
+    more = 2;
+    minimum = 0x800;
+  } else if ((p[0] & 0xF8) == 0xF0) {
+    ch = p[0] & 0x07;
+    more = 3;
+    minimum = 0x10000;
+  }
+  (*src)++;
+  (*left)--;
+  for (; more > 0 && *left > 0; more--) {
+    if ((**src & 0xC0) != 0x80)
+      break;
+    ch = (ch << 6) | (**src & 0x3F);
+    (*src)++;
+    (*left)--;
+  }
+  if (more > 0 || ch < minimum || ch > 0x10FFFF ||
+      (ch >= 0xD800 && ch <= 0xDFFF))
+    ch = 0xFFFD;
+  return ch;
+}
+
+int TTF_SizeUTF8(TTF_Font *font, const char *text, int *w, int *h) {
+  bool kerning = FT_HAS_KERNING(font->face);
+  int x = 0, minx = 0, maxx = 0;
+  FT_UInt prev = 0;
+  const unsigned char *p = (const unsigned char *)text;
+  size_t left = strlen(text);
+  while (left > 0) {
+    Uint32 ch = GetChar(&p, &left);
+    if (ch == 0xFEFF || ch == 0xFFFE) // Byte order marks aren't drawn
+      continue;
+    FT_UInt idx = FT_Get_Char_Index(font->face, ch);
+    Glyph g = LoadGlyph(font, idx);
+    if (kerning && prev && idx) {
+      FT_Vector delta;
+      FT_Get_Kerning(font->face, prev, idx, FT_KERNING_DEFAULT, &delta);
+      x += (int)(delta.x >> 6);
+    }
+    if (minx > x + g.minx)
+      minx = x + g.minx;
+    int right = x + (g.advance > g.maxx ? g.advance : g.maxx);
+    if (maxx < right)
+      maxx = right;
+    x += g.advance;
+    prev = idx;
+  }
+  if (w)
+    *w = maxx - minx;
+  if (h)
+    *h = font->height;
+  return 0;
+}
+
+// Nothing is drawn on the host
+SDL_Surface *TTF_RenderUTF8_Blended(TTF_Font *, const char *, SDL_Color) {
+  return nullptr;
+}
@@ -0,0 +1,270 @@
+// LayoutWorker under ThreadSanitizer. Each chapter is first laid out on this
+// thread with the same greedy fill as fillLine() and the spans processLayout()
+// copies; then jobs start at random lines of it, fed from a ChapterBuffer
+// that streams, fills up and slides the way the reader's does, and are
+// cancelled or replaced at random while the worker is mid-line. Every line
+// the worker hands back has to match the reference, and a job left to run
+// has to end exactly at the chapter's last line.
+//
+//   make stress-layout [BOOKS="a.epub b.epub"] [RUNS=20] [SEED=1]
+
+#include "chapter_prefetcher.h"
+#include "layout_worker.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct RefWord {
+  std::string text;
+  uint16_t token;
+  uint8_t flags;
+  uint8_t style;
+  uint8_t emphasis;
+};
+
+static ChapterBuffer buffer;
+static LayoutWorker worker;
+
+// The chapter's words in order, through a window that slides as it fills
+static bool ReadChapter(EpubReader &reader, int chapter,
+                        std::vector<RefWord> &words) {
+  words.clear();
+  if (!buffer.Load(reader, chapter))
+    return false;
+  int cursor = 0;
+  for (;;) {
+    buffer.Pump(1);
+    if (!buffer.IsLoaded())
+      return false;
+    if (!buffer.IsReady())
+      continue;
+    for (int i = (int)words.size() - buffer.windowBase;
+         i < buffer.WordCount(); i++) {
+      const StyleRun &run = buffer.RunAt(i, &cursor);
+      words.push_back({std::string(buffer.WordText(i), buffer.wordLens[i]),
+                       buffer.wordTokens[i], buffer.wordFlags[i], run.style,
+                       run.emphasis});
+    }
+    if (buffer.IsComplete())
+      return true;
+    buffer.Discard(buffer.WordCount());
+    cursor = 0;
+  }
+}
+
+// Reference lines from word 0, laid out on this thread
+static void LayOut(TextRenderer &renderer, const std::vector<RefWord> &words,
+                   const LayoutJob &job, std::vector<LayoutLine> &lines) {
+  lines.clear();
+  LayoutLine line = {};
+  int fill = 0, len = 0, x = 0;
+  for (int i = 0; i <= (int)words.size(); i++) {
+    bool end = i == (int)words.size() || (words[i].flags & WORD_NEWLINE);
+    int wordW = 0, spaceW = 0;
+    bool glued = false;
+    if (!end) {
+      const RefWord &w = words[i];
+      wordW = renderer.MeasureWordWidth(w.text.data(), (int)w.text.size(),
+                                        (TextStyle)w.style, w.emphasis);
+      glued = (w.flags & WORD_GLUED) != 0;
+      spaceW = (fill == 0 || glued) ? 0 : job.spaceWidths[w.style];
+    }
+    if (line.wordCount > 0 &&
+        (end || (fill + spaceW + wordW > job.maxWidth && fill > 0))) {
+      line.width = (int16_t)x;
+      lines.push_back(line);
+      line = LayoutLine();
+      fill = len = x = 0;
+      spaceW = 0;
+    }
+    if (end)
+      continue;
+
+    const RefWord &w = words[i];
+    if (line.wordCount == 0) {
+      line.startWord = i;
+      line.style = w.style;
+    }
+    fill += spaceW + wordW;
+    if (len + (int)w.text.size() + 2 < MAX_LINE_LEN) {
+      if (line.wordCount > 0 && !glued) {
+        len++;
+        x += job.spaceWidths[w.style];
+      }
+      if (line.spanCount == 0 ||
+          (w.emphasis != line.spans[line.spanCount - 1].emphasis &&
+           line.spanCount < LINE_MAX_SPANS)) {
+        LineSpan &span = line.spans[line.spanCount++];
+        span.start = (uint8_t)len;
+        span.emphasis = w.emphasis;
+        span.x = (int16_t)x;
+      }
+      len += (int)w.text.size();
+      x += wordW;
+    }
+    line.wordCount++;
+  }
+}
+
+static bool SameLine(const LayoutLine &a, const LayoutLine &b) {
+  if (a.startWord != b.startWord || a.wordCount != b.wordCount ||
+      a.style != b.style || a.width != b.width || a.spanCount != b.spanCount)
+    return false;
+  for (int s = 0; s < a.spanCount; s++) {
+    if (a.spans[s].start != b.spans[s].start ||
+        a.spans[s].emphasis != b.spans[s].emphasis ||
+        a.spans[s].x != b.spans[s].x)
+      return false;
+  }
+  return true;
+}
+
+// The worker's next line against the reference
+static bool TakeLine(const LayoutLine &line,
+                     const std::vector<LayoutLine> &lines, int *expect,
+                     int chapter) {
+  if (*expect == (int)lines.size() || !SameLine(line, lines[*expect])) {
+    printf("  ch %d: line %d at word %d differs from the reference\n",
+           chapter, *expect, line.startWord);
+    return false;
+  }
+  worker.Pop();
+  (*expect)++;
+  return true;
+}
+
+// One job from a random reference line; false on a wrong or missing line
+static bool RunJob(EpubReader &reader, const LayoutJob &base,
+                   const std::vector<LayoutLine> &lines, int chapter) {
+  int expect = rand() % (int)lines.size();
+  LayoutJob job = base;
+  job.startWord = lines[expect].startWord;
+  if (!buffer.Seek(reader, job.startWord)) {
+    printf("  ch %d: can't seek to word %d\n", chapter, job.startWord);
+    return false;
+  }
+  worker.Begin(job);
+  int fed = job.startWord; // Chapter-wide
+  int cursor = 0;
+  for (;;) {
+    int r = rand() % 100;
+    if (r < 2) {
+      worker.Cancel();
+      return true;
+    }
+    if (r < 4)
+      return true; // The next Begin() cancels it
+
+    fed = buffer.windowBase +
+          worker.Feed(buffer, fed - buffer.windowBase, &cursor);
+    for (int n = rand() % 40; n > 0; n--) {
+      const LayoutLine *line = worker.Peek(rand() % 2 == 0);
+      if (!line)
+        break;
+      if (!TakeLine(*line, lines, &expect, chapter))
+        return false;
+    }
+
+    if (buffer.IsComplete() && fed == buffer.WindowEnd()) {
+      // All handed over but maybe the end, which waits for room
+      for (;;) {
+        const LayoutLine *line = worker.Peek(true);
+        if (!line) {
+          worker.Feed(buffer, buffer.WordCount(), &cursor);
+          line = worker.Peek(true);
+        }
+        if (!line)
+          break;
+        if (!TakeLine(*line, lines, &expect, chapter))
+          return false;
+      }
+      if (expect != (int)lines.size()) {
+        printf("  ch %d: worker stopped at line %d of %zu\n", chapter, expect,
+               lines.size());
+        return false;
+      }
+      return true;
+    }
+    if (buffer.IsStalled() && fed == buffer.WindowEnd()) {
+      // The worker has its own copies of what it was handed
+      buffer.Discard(buffer.WordCount());
+      cursor = 0;
+    }
+    if (!buffer.IsComplete())
+      buffer.Pump(1, 1 + rand() % 8000);
+    if (!buffer.IsLoaded()) {
+      printf("  ch %d: read failed\n", chapter);
+      return false;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s runs book.epub...\n", argv[0]);
+    return 2;
+  }
+  int runs = atoi(argv[1]) > 0 ? atoi(argv[1]) : 1;
+  srand(getenv("SEED") ? atoi(getenv("SEED")) : 1);
+
+  TextRenderer renderer;
+  if (!renderer.Initialize(nullptr) || !renderer.LoadFont(1.0f) ||
+      !worker.Start()) {
+    fprintf(stderr, "fonts failed to load (run from the repo root)\n");
+    return 1;
+  }
+  LayoutJob job = {};
+  job.fontScale = 1.0f;
+  job.fontMode = renderer.GetFontMode();
+  for (int s = 0; s < 6; s++)
+    job.spaceWidths[s] = renderer.MeasureTextWidth(" ", (TextStyle)s);
+  const int maxWidths[] = {440, 250}; // Landscape and rotated
+
+  int failed = 0;
+  long jobs = 0, lineCount = 0;
+  std::vector<RefWord> words;
+  std::vector<LayoutLine> lines;
+  for (int b = 2; b < argc; b++) {
+    EpubReader reader;
+    if (!reader.Open(argv[b])) {
+      printf("%s: open failed\n", argv[b]);
+      failed++;
+      continue;
+    }
+    int chapters = (int)reader.GetMetadata().spine.size();
+    for (int c = 0; c < chapters; c++) {
+      if (!ReadChapter(reader, c, words)) {
+        printf("  ch %d can't be read\n", c);
+        failed++;
+        continue;
+      }
+      job.widthsEpoch++; // Token ids are the chapter's own
+      for (int maxWidth : maxWidths) {
+        job.maxWidth = maxWidth;
+        LayOut(renderer, words, job, lines);
+        if (lines.empty())
+          continue;
+        // The chapter's first window, as a chapter turn leaves it
+        if (!buffer.Load(reader, c)) {
+          failed++;
+          continue;
+        }
+        for (int r = 0; r < runs; r++, jobs++) {
+          if (!RunJob(reader, job, lines, c)) {
+            failed++;
+            break;
+          }
+        }
+        lineCount += (long)lines.size();
+      }
+    }
+    worker.Cancel();
+    buffer.Close();
+    reader.Close();
+  }
+  worker.Stop();
+  printf("%ld jobs over %ld reference lines, %d failed\n", jobs, lineCount,
+         failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+// Word widths from TextRenderer's glyph tables against TTF_SizeUTF8 with the
+// same font, for every distinct word (with its style and emphasis) of the
+// given books plus a few that exercise kerning, CJK and broken UTF-8. Each
+// font mode at a few scales; any difference fails.
+//
+//   make test-glyphs [BOOKS="a.epub b.epub"] [HOST_SDL=system]
+
+#include "chapter_prefetcher.h"
+#include "text_renderer.h"
+#include <cstdio>
+#include <set>
+#include <string>
+#include <tuple>
+
+typedef std::tuple<std::string, int, int> Word; // Text, style, emphasis
+
+static const char *extraWords[] = {
+    "AVATAR", "Wave", "To,", "T.", "ffi", "\xe4\xb8\xad\xe6\x96\x87",
+    "\xe3\x81\x8b\xe3\x81\xaa", "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2",
+    "caf\xc3\xa9", "cut\xe4\xb8", "stray\x80", "bro\xe4ken", "\xef\xbf\xbd",
+    "\xef\xbb\xbf" "BOM"};
+
+static ChapterBuffer buffer;
+
+static bool CollectWords(const char *path, std::set<Word> &words) {
+  EpubReader reader;
+  if (!reader.Open(path))
+    return false;
+  for (int c = 0; c < (int)reader.GetMetadata().spine.size(); c++) {
+    if (!buffer.Load(reader, c))
+      continue;
+    int cursor = 0;
+    for (;;) {
+      buffer.Pump(1);
+      if (buffer.IsStalled() || buffer.IsComplete() || !buffer.IsLoaded()) {
+        for (int i = 0; i < buffer.WordCount(); i++) {
+          if (buffer.wordFlags[i] & WORD_NEWLINE)
+            continue;
+          const StyleRun &run = buffer.RunAt(i, &cursor);
+          words.insert(Word(std::string(buffer.WordText(i),
+                                        buffer.wordLens[i]),
+                            run.style, run.emphasis));
+        }
+        if (!buffer.IsStalled())
+          break;
+        buffer.Discard(buffer.WordCount());
+        cursor = 0;
+      }
+    }
+  }
+  buffer.Close();
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::set<Word> words;
+  for (int b = 1; b < argc; b++) {
+    if (!CollectWords(argv[b], words)) {
+      fprintf(stderr, "%s: open failed\n", argv[b]);
+      return 1;
+    }
+  }
+  for (const char *w : extraWords) {
+    for (int em = 0; em <= (TEXT_BOLD | TEXT_ITALIC); em++)
+      words.insert(Word(w, (int)TextStyle::NORMAL, em));
+  }
+
+  TextRenderer renderer;
+  if (!renderer.Initialize(nullptr))
+    return 1;
+  const FontMode modes[] = {FontMode::SMART, FontMode::INTER_ONLY,
+                            FontMode::FALLBACK_ONLY};
+  const float scales[] = {0.6f, 1.0f, 1.7f};
+  long checked = 0, mismatches = 0;
+  for (FontMode mode : modes) {
+    renderer.SetFontMode(mode);
+    for (float scale : scales) {
+      if (!renderer.LoadFont(scale)) {
+        fprintf(stderr, "fonts failed to load (run from the repo root)\n");
+        return 1;
+      }
+      for (const Word &word : words) {
+        const std::string &text = std::get<0>(word);
+        TextStyle style = (TextStyle)std::get<1>(word);
+        uint8_t emphasis = (uint8_t)std::get<2>(word);
+        int w = renderer.MeasureWordWidth(text.data(), (int)text.size(),
+                                          style, emphasis);
+        TTF_Font *font =
+            renderer.GetFont(text.data(), (int)text.size(), style, emphasis);
+        int ttfW = 0, ttfH;
+        if (font)
+          TTF_SizeUTF8(font, text.c_str(), &ttfW, &ttfH);
+        checked++;
+        if (w != ttfW && ++mismatches <= 20) {
+          printf("mode %d scale %.1f style %d/%d \"%s\": %d px, "
+                 "TTF_SizeUTF8 %d px\n",
+                 (int)mode, scale, (int)style, emphasis, text.c_str(), w,
+                 ttfW);
+        }
+      }
+    }
+  }
+  printf("%zu distinct words, %ld widths checked, %ld differ from "
+         "TTF_SizeUTF8\n",
+         words.size(), checked, mismatches);
+  return mismatches ? 1 : 0;
+}
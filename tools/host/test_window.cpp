@@ -0,0 +1,118 @@
+// Windowed tokenization against tokenizing in one go. The same chapter is fed
+// to HtmlTextExtractor with every window size from WINDOW_MIN words up, the
+// window emptied with Discard() each time Feed() stops on IsFull(); the
+// words, their flags and the style and emphasis they are drawn in have to
+// come out exactly as without a window. The chapter is made of the markup
+// that stores most at once: a closing heading commits its last word and a
+// newline, and <p class="title"> (body text the stylesheet makes a heading)
+// commits a word and two newlines, so every window size puts one of them at
+// the window's edge.
+//
+//   make test-window
+
+#include "css_rules.h"
+#include "html_text_extractor.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define WINDOW_MIN 4
+#define WINDOW_MAX 64
+#define TEST_MAX_WORDS 8192
+#define TEST_MAX_RUNS 256
+#define TEST_BUFFER_SIZE (256 * 1024)
+
+struct Word {
+  std::string text;
+  uint8_t flags;
+  uint8_t style;
+  uint8_t emphasis;
+
+  bool operator==(const Word &o) const {
+    return text == o.text && flags == o.flags && style == o.style &&
+           emphasis == o.emphasis;
+  }
+};
+
+static uint32_t wordOffsets[TEST_MAX_WORDS];
+static uint8_t wordFlags[TEST_MAX_WORDS];
+static uint8_t wordLens[TEST_MAX_WORDS];
+static StyleRun runs[TEST_MAX_RUNS];
+static char wordBuffer[TEST_BUFFER_SIZE];
+
+// Moves the window's words to out and empties it
+static void Drain(HtmlTextExtractor &extractor, std::vector<Word> &out) {
+  int r = 0;
+  for (int i = 0; i < extractor.GetWordCount(); i++) {
+    while (r + 1 < extractor.GetRunCount() && runs[r + 1].start <= i)
+      r++;
+    out.push_back({std::string(wordBuffer + wordOffsets[i], wordLens[i]),
+                   wordFlags[i], runs[r].style, runs[r].emphasis});
+  }
+  extractor.Discard(extractor.GetWordCount());
+}
+
+static bool Tokenize(const std::string &html, const CssRuleTable &styles,
+                     int maxWords, std::vector<Word> &out) {
+  HtmlTextExtractor extractor;
+  extractor.SetStyles(&styles);
+  extractor.Begin(wordOffsets, wordFlags, wordLens, maxWords, runs,
+                  TEST_MAX_RUNS, wordBuffer, TEST_BUFFER_SIZE);
+  out.clear();
+  int pos = 0;
+  while (pos < (int)html.size()) {
+    int n = extractor.Feed(html.data() + pos, (int)html.size() - pos);
+    pos += n;
+    if (extractor.IsFull())
+      Drain(extractor, out);
+    else if (n == 0)
+      return false; // Stopped without filling up
+  }
+  extractor.Finish();
+  Drain(extractor, out);
+  return true;
+}
+
+int main() {
+  char css[] = ".title { font-size: 2em }";
+  CssRuleTable styles;
+  styles.Compile(css, strlen(css));
+
+  // Blocks of different lengths, so the edge cases land at every offset
+  std::string html = "<html><body>";
+  for (int b = 0; b < 40; b++) {
+    html += "<h3>Part " + std::to_string(b) + "</h3><p>";
+    for (int w = 0; w < b % 7; w++)
+      html += w % 3 == 1 ? "<em>word</em> " : "word ";
+    html += "end.</p><p class=\"title\">Title " + std::to_string(b) +
+            "</p><h2>Heading</h2>";
+  }
+  html += "</body></html>";
+
+  std::vector<Word> whole, windowed;
+  if (!Tokenize(html, styles, TEST_MAX_WORDS, whole)) {
+    printf("tokenizing in one go stopped short\n");
+    return 1;
+  }
+  int failed = 0;
+  for (int window = WINDOW_MIN; window <= WINDOW_MAX; window++) {
+    if (!Tokenize(html, styles, window, windowed)) {
+      printf("window %d: Feed() stopped without filling up\n", window);
+      failed++;
+      continue;
+    }
+    size_t i = 0;
+    while (i < whole.size() && i < windowed.size() && whole[i] == windowed[i])
+      i++;
+    if (i < whole.size() || i < windowed.size()) {
+      printf("window %d: %zu words, %zu in one go; first difference at word "
+             "%zu\n",
+             window, windowed.size(), whole.size(), i);
+      failed++;
+    }
+  }
+  printf("%zu words, window sizes %d-%d: %d differ\n", whole.size(),
+         WINDOW_MIN, WINDOW_MAX, failed);
+  return failed ? 1 : 0;
+}